@@ -18,7 +18,7 @@
 //********************************************************************************************
 
 /// @file egolib/AI/AStar.c
-/// @brief
+/// @brief A* pathfinding.
 /// @details
 
 #include "egolib/AI/AStar.hpp"
@@ -27,26 +27,123 @@
 #include "egolib/Script/script.h"  // for waypoint list control
 #include "egolib/game/mesh.h"
 
-AStar::AStar() : 
-    final_node(nullptr), 
-    start_node(nullptr)
+AStar::AStar() :
+    _cost(),
+    _parent(),
+    _generation(),
+    _heapIndex(),
+    _currentGeneration(0),
+    _heap(),
+    _path(),
+    _tileCountX(0),
+    _startTile(INVALID),
+    _finalTile(INVALID),
+    _exploredNodes(0)
 {}
 
-void AStar::reset()
+void AStar::reset(size_t tileCount)
 {
     /// @author ZF
     /// @details Reset AStar memory.
-    final_node = nullptr;
-    start_node = nullptr;
+    _startTile = INVALID;
+    _finalTile = INVALID;
+    _exploredNodes = 0;
+    _heap.clear();
+
+    // (re)size the per-tile arrays if the mesh changed
+    if (_generation.size() != tileCount)
+    {
+        _cost.assign(tileCount, 0.0f);
+        _parent.assign(tileCount, INVALID);
+        _generation.assign(tileCount, 0);
+        _heapIndex.assign(tileCount, INVALID);
+        _currentGeneration = 0;
+    }
+
+    // start a new generation, this invalidates the state of all tiles at once
+    if (++_currentGeneration == 0)
+    {
+        std::fill(_generation.begin(), _generation.end(), 0);
+        _currentGeneration = 1;
+    }
+}
+
+bool AStar::less(const HeapEntry& first, const HeapEntry& second) const
+{
+    // lowest estimate first, prefer nodes closer to the goal on ties
+    if (first.priority != second.priority) return first.priority < second.priority;
+    return first.cost > second.cost;
+}
+
+void AStar::place(uint32_t index, const HeapEntry& entry)
+{
+    _heap[index] = entry;
+    _heapIndex[entry.tile] = index;
+}
+
+void AStar::siftUp(uint32_t index)
+{
+    const HeapEntry entry = _heap[index];
+    while (index > 0)
+    {
+        const uint32_t parent = (index - 1) / 2;
+        if (!less(entry, _heap[parent])) break;
+        place(index, _heap[parent]);
+        index = parent;
+    }
+    place(index, entry);
 }
 
-/// Functor to determine the distance of point (sourceX, sourceY) to point (targetX, targetY).
+void AStar::siftDown(uint32_t index)
+{
+    const HeapEntry entry = _heap[index];
+    const uint32_t size = static_cast<uint32_t>(_heap.size());
+    while (true)
+    {
+        uint32_t child = 2 * index + 1;
+        if (child >= size) break;
+        if (child + 1 < size && less(_heap[child + 1], _heap[child])) child++;
+        if (!less(_heap[child], entry)) break;
+        place(index, _heap[child]);
+        index = child;
+    }
+    place(index, entry);
+}
+
+void AStar::push(const HeapEntry& entry)
+{
+    _heap.push_back(entry);
+    siftUp(static_cast<uint32_t>(_heap.size() - 1));
+}
+
+void AStar::decrease(uint32_t index, const HeapEntry& entry)
+{
+    _heap[index] = entry;
+    siftUp(index);
+}
+
+uint32_t AStar::pop()
+{
+    const uint32_t tile = _heap.front().tile;
+    _heapIndex[tile] = CLOSED;
+    if (_heap.size() > 1)
+    {
+        _heap.front() = _heap.back();
+        _heap.pop_back();
+        siftDown(0);
+    }
+    else
+    {
+        _heap.pop_back();
+    }
+    return tile;
+}
+
+/// Functor to estimate the distance of point (sourceX, sourceY) to point (targetX, targetY).
+/// Paths only use horizontal and vertical steps, so the Manhattan distance never overestimates.
 struct Distance {
     float operator()(int sourceX, int sourceY, int targetX, int targetY) const {
-        int distanceX = targetX - sourceX,
-            distanceY = targetY - sourceY;
-        float distance = std::sqrt(distanceX * distanceX + distanceY * distanceY);
-        return distance;
+        return static_cast<float>(std::abs(targetX - sourceX) + std::abs(targetY - sourceY));
     }
 };
 
@@ -56,10 +153,14 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
     /// @details Explores up to MAX_ASTAR_NODES number of nodes to find a path between the source coordinates and destination coordinates.
     //              The result is stored in a node list and can be accessed through AStar_get_path(). Returns false if no path was found.
 
-    float weight;
+    // restart the algorithm
+    const Ego::MeshInfo& info = mesh->getInfo();
+    reset(info.getTileCount());
+    _tileCountX = info.getTileCountX();
 
     // do not start if the initial point is off the mesh
-    if (Index1D::Invalid == mesh->getTileIndex(Index2D(src_ix, src_iy)))
+    Index1D srcTile = mesh->getTileIndex(Index2D(src_ix, src_iy));
+    if (Index1D::Invalid == srcTile)
     {
 #ifdef DEBUG_ASTAR
         Log::get().debug("AStar failed because source position is off the mesh.\n");
@@ -68,7 +169,8 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
     }
 
     //Is the destination is inside a wall or outside the map?
-    if (mesh->tile_has_bits(Index2D(dst_ix, dst_iy), stoppedby) != 0 || Index1D::Invalid == mesh->getTileIndex(Index2D(dst_ix, dst_iy)))
+    Index1D dstTile = mesh->getTileIndex(Index2D(dst_ix, dst_iy));
+    if (Index1D::Invalid == dstTile || mesh->tile_has_bits(Index2D(dst_ix, dst_iy), stoppedby))
     {
 #ifdef DEBUG_ASTAR
         Log::get().debug("AStar failed because goal position is impassable.\n");
@@ -76,7 +178,6 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
         return false;
     }
 
-
     struct Offset
     {
         Offset(int setX, int setY) : x(setX), y(setY) {}
@@ -90,30 +191,22 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
         Offset(1, 0), Offset(0, 1)
     };
 
-    //Node sorting algorithm (lowest weight first)
-    auto comparator = [](const std::shared_ptr<Node> &first, const std::shared_ptr<Node> &second){
-        return first->weight < second->weight;
-    };
-
-    //Set of closed nodes
-    std::unordered_set<int> closedNodes;
-    std::priority_queue<std::shared_ptr<Node>, 
-                        std::vector<std::shared_ptr<Node>>,
-                        decltype(comparator)> openNodes(comparator);
-
-    // restart the algorithm
-    reset();
+    const int tileCountX = static_cast<int>(info.getTileCountX());
+    const int tileCountY = static_cast<int>(info.getTileCountY());
+    const uint32_t goal = static_cast<uint32_t>(dstTile.i());
 
     // initialize the starting node
-    weight = Distance()(src_ix, src_iy, dst_ix, dst_iy);
-    start_node = std::make_shared<AStar::Node>(src_ix, src_iy, weight, nullptr);
-    openNodes.push(start_node);
+    const uint32_t start = static_cast<uint32_t>(srcTile.i());
+    _cost[start] = 0.0f;
+    _parent[start] = INVALID;
+    _generation[start] = _currentGeneration;
+    push({Distance()(src_ix, src_iy, dst_ix, dst_iy), 0.0f, start});
 
     // do the algorithm
-    while (!openNodes.empty())
+    while (!_heap.empty())
     {
-        // list is completely full... we failed
-        if (closedNodes.size() >= MAX_ASTAR_NODES) {
+        // explored too much... we failed
+        if (_exploredNodes >= MAX_ASTAR_NODES) {
 #ifdef DEBUG_ASTAR
             Log::get().debug("AStar failed because maximum number of nodes were explored (%lu)\n", MAX_ASTAR_NODES);
 #endif
@@ -121,63 +214,79 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
         }
 
         //Get the cheapest open node
-        std::shared_ptr<Node> currentNode = openNodes.top();
-        openNodes.pop();
+        const uint32_t current = pop();
+        _exploredNodes++;
 
-        // find some child nodes
-        for(const auto& offset: EXPLORE_NODES) {
-
-            // do not check diagonals
-            if (offset.x != 0 && offset.y != 0) continue;
+        // is this the destination node?
+        if (current == goal)
+        {
+            _startTile = start;
+            _finalTile = current;
+            return true;
+        }
 
-            //The node to explore
-            int tmp_x = currentNode->ix + offset.x;
-            int tmp_y = currentNode->iy + offset.y;
+        const int current_x = static_cast<int>(current % tileCountX);
+        const int current_y = static_cast<int>(current / tileCountX);
+        const float cost = _cost[current] + 1.0f;
 
-            //Do not explore any node more than once
-            if(closedNodes.find(tmp_x | tmp_y << 16) != closedNodes.end()) {
-                continue;
-            }
-            closedNodes.insert(tmp_x | tmp_y << 16);
+        // find some child nodes
+        for (const auto& offset : EXPLORE_NODES) {
 
-            // check for the simplest case, is this the destination node?
-            if (tmp_x == dst_ix && tmp_y == dst_iy)
-            {
-                weight = Distance()(tmp_x, tmp_y, currentNode->ix, currentNode->iy);
-                final_node = std::make_shared<AStar::Node>(tmp_x, tmp_y, weight, currentNode);
-                return true;
-            }
+            //The node to explore
+            const int tmp_x = current_x + offset.x;
+            const int tmp_y = current_y + offset.y;
 
             // is the test node on the mesh?
-            Index1D itile = mesh->getTileIndex(Index2D(tmp_x, tmp_y));
-            if (Index1D::Invalid == itile)
+            if (tmp_x < 0 || tmp_y < 0 || tmp_x >= tileCountX || tmp_y >= tileCountY)
             {
                 continue;
             }
+            const uint32_t tile = static_cast<uint32_t>(tmp_y * tileCountX + tmp_x);
 
-            //Dont walk into pits
-            //@todo: might need to check tile Z level here instead
-            const ego_tile_info_t& ptile = mesh->getTileInfo(itile);
-            if (ptile.isFanOff())
+            if (_generation[tile] == _currentGeneration)
             {
-                // add the invalid tile to the list as a closed tile
+                //Do not explore any node more than once
+                if (CLOSED == _heapIndex[tile] || cost >= _cost[tile]) continue;
+
+                // found a cheaper path to an open node
+                _cost[tile] = cost;
+                _parent[tile] = current;
+                decrease(_heapIndex[tile], {cost + Distance()(tmp_x, tmp_y, dst_ix, dst_iy), cost, tile});
                 continue;
             }
 
-            // is this a wall or impassable?
-            if (mesh->tile_has_bits(Index2D(tmp_x, tmp_y), stoppedby))
+            // first visit of this node by this search
+            _generation[tile] = _currentGeneration;
+
+            // the destination was already checked
+            if (tile != goal)
             {
-                // add the invalid tile to the list as a closed tile
-                continue;
+                //Dont walk into pits
+                //@todo: might need to check tile Z level here instead
+                const ego_tile_info_t& ptile = mesh->getTileInfo(Index1D(tile));
+                if (ptile.isFanOff())
+                {
+                    // add the invalid tile to the list as a closed tile
+                    _heapIndex[tile] = CLOSED;
+                    continue;
+                }
+
+                // is this a wall or impassable?
+                if (HAS_SOME_BITS(ptile.getFX(), stoppedby))
+                {
+                    // add the invalid tile to the list as a closed tile
+                    _heapIndex[tile] = CLOSED;
+                    continue;
+                }
             }
 
             ///
             /// @todo  I need to check for collisions with static objects, like trees
 
             // OK. determine the weight (F + H)
-            weight = Distance()(tmp_x, tmp_y, currentNode->ix, currentNode->iy)
-                   + Distance()(tmp_x, tmp_y, dst_ix, dst_iy);
-            openNodes.push(std::make_shared<AStar::Node>(tmp_x, tmp_y, weight, currentNode));
+            _cost[tile] = cost;
+            _parent[tile] = current;
+            push({cost + Distance()(tmp_x, tmp_y, dst_ix, dst_iy), cost, tile});
         }
     }
 
@@ -185,6 +294,24 @@ bool AStar::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t st
 }
 
 bool AStar::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
+{
+    if (INVALID == _finalTile)
+    {
+        return false;
+    }
+
+    //Build the local node path tree
+    _path.clear();
+    for (uint32_t current_node = _finalTile; _path.size() < MAX_ASTAR_PATH && current_node != _startTile; current_node = _parent[current_node])
+    {
+        // add the node to the end of the path
+        _path.push_back(current_node);
+    }
+
+    return add_waypoints(_path, _startTile, _tileCountX, pos_x, dst_y, wplst);
+}
+
+bool AStar::add_waypoints(const std::vector<uint32_t>& path, const uint32_t startTile, const size_t tileCountX, const int pos_x, const int dst_y, waypoint_list_t& wplst)
 {
     /// @author ZF
     /// @details Fills a waypoint list with sensible waypoints. It will return false if it failed to add at least one waypoint.
@@ -192,56 +319,33 @@ bool AStar::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
     //              creates a corner. The function automatically prunes away all non-critical nodes. The final waypoint will always be
     //              the destination coordinates.
 
-    int i;
-    size_t path_length, waypoint_num;
-    //bool diagonal_movement = false;
-
-    Node *current_node, *last_waypoint, *safe_waypoint;
-    Node *node_path[MAX_ASTAR_PATH];
+    const int width = static_cast<int>(tileCountX);
+    auto tile_x = [width](uint32_t tile) { return static_cast<int>(tile % width); };
+    auto tile_y = [width](uint32_t tile) { return static_cast<int>(tile / width); };
 
     //Fill the waypoint list as much as we can, the final waypoint will always be the destination waypoint
-    waypoint_num = 0;
-    current_node = final_node.get();
-    last_waypoint = start_node.get();
+    size_t waypoint_num = 0;
+    uint32_t last_waypoint = startTile;
 
-    //Build the local node path tree
-    path_length = 0;
-    while (path_length < MAX_ASTAR_PATH && current_node != start_node.get())
+    //Already at the destination? Just go there
+    if (path.empty())
     {
-        // add the node to the end of the path
-        node_path[path_length++] = current_node;
-
-        // get next node
-        current_node = current_node->parent.get();
+        waypoint_list_t::push(wplst, pos_x, dst_y);
+        return true;
     }
 
     //Begin at the end of the list, which contains the starting node
-    safe_waypoint = nullptr;
-    for (i = path_length - 1; i >= 0 && waypoint_num < MAXWAY; i--)
+    uint32_t safe_waypoint = INVALID;
+    for (int i = static_cast<int>(path.size()) - 1; i >= 0 && waypoint_num < MAXWAY; i--)
     {
-        bool change_direction;
-
         //get current node
-        current_node = node_path[i];
+        const uint32_t current_node = path[i];
 
         //the first node should be safe
-        if (nullptr == safe_waypoint) safe_waypoint = current_node;
+        if (INVALID == safe_waypoint) safe_waypoint = current_node;
 
         //is there a change in direction?
-        change_direction = (last_waypoint->ix != current_node->ix && last_waypoint->iy != current_node->iy);
-
-        //are we moving diagonally? if so, then don't fill the waypoint list with unessecary waypoints
-        /*if( i != 0 )
-        {
-            if( diagonal_movement ) diagonal_movement = (ABS(current_node->ix - safe_waypoint->ix) == 1)  && (ABS(current_node->iy - safe_waypoint->iy) == 1);
-            else                    diagonal_movement = (ABS(current_node->ix - last_waypoint->ix) == 1)  && (ABS(current_node->iy - last_waypoint->iy) == 1);
-
-            if( diagonal_movement )
-            {
-                safe_waypoint = current_node;
-                continue;
-            }
-        }*/
+        const bool change_direction = (tile_x(last_waypoint) != tile_x(current_node) && tile_y(last_waypoint) != tile_y(current_node));
 
         //If we have a change in direction, we need to add it as a waypoint, always add the last waypoint
         if (i == 0 || change_direction)
@@ -258,8 +362,8 @@ bool AStar::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
             else
             {
                 // translate to raw coordinates
-                way_x = safe_waypoint->ix * Info<int>::Grid::Size() + (Info<int>::Grid::Size() / 2);
-                way_y = safe_waypoint->iy * Info<int>::Grid::Size() + (Info<int>::Grid::Size() / 2);
+                way_x = tile_x(safe_waypoint) * Info<int>::Grid::Size() + (Info<int>::Grid::Size() / 2);
+                way_y = tile_y(safe_waypoint) * Info<int>::Grid::Size() + (Info<int>::Grid::Size() / 2);
             }
 
 #ifdef DEBUG_ASTAR
@@ -268,7 +372,7 @@ bool AStar::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
             Log::get().debug("Waypoint %lu: X: %d, Y: %d \n", waypoint_num, static_cast<int>(way_x / Info<int>::Grid::Size()), static_cast<int>(way_y / Info<int>::Grid::Size()));
             Renderer3D::pointList.add(Vector3f(way_x, way_y, 100.0f), 800);
             Renderer3D::lineSegmentList.add(
-                Vector3f(last_waypoint->ix*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), last_waypoint->iy*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), 200.0f),
+                Vector3f(tile_x(last_waypoint)*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), tile_y(last_waypoint)*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), 200.0f),
                 Vector3f(way_x, way_y, 100.0f),
                 800
             );
@@ -292,7 +396,7 @@ bool AStar::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
 
 #ifdef DEBUG_ASTAR
     if (waypoint_num > 0) {
-        Renderer3D::pointList.add(Vector3f(start_node->ix*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), start_node->iy*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), 100.0f), 800);
+        Renderer3D::pointList.add(Vector3f(tile_x(startTile)*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), tile_y(startTile)*Info<float>::Grid::Size() + (Info<int>::Grid::Size() / 2), 100.0f), 800);
     }
 #endif
 
@@ -19,8 +19,9 @@
 
 /// @file egolib/AI/AStar.h
 /// @brief A* pathfinding.
-/// @details A very ugly implementation of the A* pathfinding agorithm.
-///          There is lots of room for improvement.
+/// @details A* over the tile grid of a mesh. All per-tile search state lives in flat arrays which are
+///          reused between searches, so a search does not allocate once the arrays have grown to the
+///          size of the mesh.
 
 #pragma once
 
@@ -35,36 +36,63 @@ struct waypoint_list_t;
 /// Implementation of A* pathfinding algorithm.
 class AStar {
 
-public:
-    struct Node {
-        Node(int x, int y, float setWeight, const std::shared_ptr<Node>& setParent) :
-            ix(x),
-            iy(y),
-            weight(setWeight),
-            parent(setParent)
-        {
-            //ctor
-        }
-
-        float weight;
-        int ix, iy;
-        std::shared_ptr<Node> parent;
-    };
-
 public:
     AStar();
     bool find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t stoppedBy, const int src_ix, const int src_iy, int dst_ix, int dst_iy);
     bool get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst);
 
+    /// @brief Get the number of nodes explored by the last call to find_path().
+    /// @return the number of nodes explored by the last call to find_path()
+    size_t getExploredNodeCount() const { return _exploredNodes; }
+
+    /// @brief Fill a waypoint list with the corners of a tile path.
+    /// @param path the tiles of the path, beginning with the destination tile and excluding the start tile
+    /// @param startTile the start tile
+    /// @param tileCountX the width of the mesh (to convert tile indices into grid coordinates)
+    /// @param pos_x, dst_y the destination (world coordinates), always used as the final waypoint
+    /// @param wplst the waypoint list
+    /// @return @a true if at least one waypoint was added
+    static bool add_waypoints(const std::vector<uint32_t>& path, const uint32_t startTile, const size_t tileCountX, const int pos_x, const int dst_y, waypoint_list_t& wplst);
+
+    static constexpr size_t MAX_ASTAR_NODES = 8192;  ///< Maximum number of nodes to explore
+
 private:
-    static constexpr size_t MAX_ASTAR_NODES = 512;   ///< Maximum number of nodes to explore
-    static constexpr size_t MAX_ASTAR_PATH = 128;    ///< Maximum length of the final path (before pruning)
+    static constexpr size_t MAX_ASTAR_PATH = 1024;   ///< Maximum length of the final path (before pruning)
+    static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t CLOSED = INVALID - 1;  ///< Heap index of a node which was explored
+
+    /// An entry of the open list.
+    struct HeapEntry {
+        float priority;     ///< estimated total cost of a path through this node
+        float cost;         ///< cost of the path from the start to this node (to break ties)
+        uint32_t tile;      ///< index of the tile
+    };
+
+    // Per-tile search state, indexed by tile index.
+    // A tile was touched by the current search iff _generation[tile] == _currentGeneration.
+    std::vector<float> _cost;            ///< cost of the cheapest known path from the start
+    std::vector<uint32_t> _parent;       ///< predecessor on the cheapest known path
+    std::vector<uint32_t> _generation;   ///< search which touched the tile last
+    std::vector<uint32_t> _heapIndex;    ///< position in _heap, CLOSED if explored
+    uint32_t _currentGeneration;
+
+    std::vector<HeapEntry> _heap;        ///< the open list (an indexed binary min-heap)
+    std::vector<uint32_t> _path;         ///< scratch list for get_path()
 
-    std::shared_ptr<Node> final_node;
-    std::shared_ptr<Node> start_node;
+    size_t _tileCountX;                  ///< width of the mesh of the last search
+    uint32_t _startTile;                 ///< start of the last path found or INVALID
+    uint32_t _finalTile;                 ///< end of the last path found or INVALID
+    size_t _exploredNodes;
 
 private:
-    void reset();
+    void reset(size_t tileCount);
+    bool less(const HeapEntry& first, const HeapEntry& second) const;
+    void push(const HeapEntry& entry);
+    void decrease(uint32_t index, const HeapEntry& entry);
+    uint32_t pop();
+    void siftUp(uint32_t index);
+    void siftDown(uint32_t index);
+    void place(uint32_t index, const HeapEntry& entry);
 };
 
 extern AStar g_astar;
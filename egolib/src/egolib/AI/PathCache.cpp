@@ -0,0 +1,241 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/AI/PathCache.cpp
+/// @brief Shared pathfinding towards common destinations.
+
+#include "egolib/AI/PathCache.hpp"
+
+#include "egolib/game/mesh.h"
+
+PathCache::PathCache() :
+    _mesh(),
+    _fxRevision(0),
+    _fields(),
+    _clock(0),
+    _builds(0),
+    _queue(),
+    _path(),
+    _startTile(INVALID),
+    _tileCountX(0),
+    _usedAStar(false)
+{}
+
+void PathCache::clear()
+{
+    for (FlowField& field : _fields)
+    {
+        field.goal = INVALID;
+        field.requests = 0;
+        field.built = false;
+        field.complete = false;
+    }
+}
+
+PathCache::FlowField& PathCache::acquire(uint32_t goal, uint32_t stoppedBy)
+{
+    FlowField *oldest = &_fields[0];
+    for (FlowField& field : _fields)
+    {
+        if (field.goal == goal && field.stoppedBy == stoppedBy)
+        {
+            return field;
+        }
+        if (field.lastUse < oldest->lastUse)
+        {
+            oldest = &field;
+        }
+    }
+
+    // evict the least recently used flow field (keeping its memory)
+    oldest->goal = goal;
+    oldest->stoppedBy = stoppedBy;
+    oldest->requests = 0;
+    oldest->built = false;
+    oldest->complete = false;
+    return *oldest;
+}
+
+void PathCache::build(const ego_mesh_t& mesh, FlowField& field)
+{
+    /// @details Breadth-first search backwards from the goal. Only passable tiles (and the goal itself)
+    ///          are entered, the same rules as in AStar::find_path(). At most AStar::MAX_ASTAR_NODES tiles
+    ///          are explored, so building a flow field never costs more than a failing A* search.
+    const Ego::MeshInfo& info = mesh.getInfo();
+    const int tileCountX = static_cast<int>(info.getTileCountX());
+    const int tileCountY = static_cast<int>(info.getTileCountY());
+
+    field.distance.assign(info.getTileCount(), UNREACHABLE);
+    field.distance[field.goal] = 0;
+    _queue.clear();
+    _queue.push_back(field.goal);
+
+    size_t head = 0;
+    for (; head < _queue.size() && head < AStar::MAX_ASTAR_NODES; ++head)
+    {
+        const uint32_t current = _queue[head];
+        const int x = static_cast<int>(current % tileCountX);
+        const int y = static_cast<int>(current / tileCountX);
+        const uint32_t distance = field.distance[current] + 1;
+
+        const int neighbours[4][2] = { { x - 1, y }, { x, y - 1 }, { x + 1, y }, { x, y + 1 } };
+        for (const auto& neighbour : neighbours)
+        {
+            if (neighbour[0] < 0 || neighbour[1] < 0 || neighbour[0] >= tileCountX || neighbour[1] >= tileCountY) continue;
+            const uint32_t tile = static_cast<uint32_t>(neighbour[1] * tileCountX + neighbour[0]);
+            if (UNREACHABLE != field.distance[tile]) continue;
+
+            // do not walk into pits, walls or impassable tiles
+            const ego_tile_info_t& ptile = mesh.getTileInfo(Index1D(tile));
+            if (ptile.isFanOff() || HAS_SOME_BITS(ptile.getFX(), field.stoppedBy)) continue;
+
+            field.distance[tile] = distance;
+            _queue.push_back(tile);
+        }
+    }
+
+    field.built = true;
+    field.complete = (head == _queue.size());
+    _builds++;
+}
+
+bool PathCache::descend(const ego_mesh_t& mesh, const FlowField& field, uint32_t start)
+{
+    const Ego::MeshInfo& info = mesh.getInfo();
+    const int tileCountX = static_cast<int>(info.getTileCountX());
+    const int tileCountY = static_cast<int>(info.getTileCountY());
+
+    static const int OFFSETS[4][2] = { { -1, 0 }, { 0, -1 }, { 1, 0 }, { 0, 1 } };
+
+    // Follow the steepest descent, keep going straight whenever possible to get less corners.
+    _path.clear();
+    uint32_t current = start;
+    uint32_t distance = field.distance[start];
+    int direction = -1;
+    while (current != field.goal && _path.size() < MAX_PATH)
+    {
+        const int x = static_cast<int>(current % tileCountX);
+        const int y = static_cast<int>(current / tileCountX);
+
+        uint32_t next = INVALID, nextDistance = UNREACHABLE;
+        int nextDirection = -1;
+        for (int i = 0; i < 4; ++i)
+        {
+            // try the current direction first
+            const int d = (direction < 0) ? i : (direction + i) % 4;
+            const int tx = x + OFFSETS[d][0], ty = y + OFFSETS[d][1];
+            if (tx < 0 || ty < 0 || tx >= tileCountX || ty >= tileCountY) continue;
+            const uint32_t tile = static_cast<uint32_t>(ty * tileCountX + tx);
+            if (field.distance[tile] < nextDistance)
+            {
+                next = tile;
+                nextDistance = field.distance[tile];
+                nextDirection = d;
+            }
+        }
+
+        // stuck (only possible if the start itself is not part of the flow field)
+        if (INVALID == next || (UNREACHABLE != distance && nextDistance >= distance))
+        {
+            return false;
+        }
+
+        _path.push_back(next);
+        current = next;
+        distance = nextDistance;
+        direction = nextDirection;
+    }
+
+    // AStar::add_waypoints() expects the destination first
+    std::reverse(_path.begin(), _path.end());
+    return true;
+}
+
+bool PathCache::find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t stoppedBy, const int src_ix, const int src_iy, int dst_ix, int dst_iy)
+{
+    _usedAStar = false;
+    _startTile = INVALID;
+
+    // do not start if the initial point is off the mesh
+    Index1D srcTile = mesh->getTileIndex(Index2D(src_ix, src_iy));
+    if (Index1D::Invalid == srcTile)
+    {
+        return false;
+    }
+
+    //Is the destination is inside a wall or outside the map?
+    Index1D dstTile = mesh->getTileIndex(Index2D(dst_ix, dst_iy));
+    if (Index1D::Invalid == dstTile || mesh->tile_has_bits(Index2D(dst_ix, dst_iy), stoppedBy))
+    {
+        return false;
+    }
+
+    // a different mesh or opened/closed passages invalidate all flow fields
+    if (_mesh.lock() != mesh || _fxRevision != mesh->getFXRevision())
+    {
+        clear();
+        _mesh = mesh;
+        _fxRevision = mesh->getFXRevision();
+    }
+
+    FlowField& field = acquire(static_cast<uint32_t>(dstTile.i()), stoppedBy);
+    field.requests++;
+    field.lastUse = ++_clock;
+
+    // a single request is cheaper to answer with A*
+    if (!field.built && field.requests < 2)
+    {
+        _usedAStar = true;
+        return g_astar.find_path(mesh, stoppedBy, src_ix, src_iy, dst_ix, dst_iy);
+    }
+
+    if (!field.built)
+    {
+        build(*mesh, field);
+    }
+
+    if (!descend(*mesh, field, static_cast<uint32_t>(srcTile.i())))
+    {
+        // the source might be beyond the tiles the flow field explored
+        if (!field.complete)
+        {
+            _usedAStar = true;
+            return g_astar.find_path(mesh, stoppedBy, src_ix, src_iy, dst_ix, dst_iy);
+        }
+        return false;
+    }
+    _startTile = static_cast<uint32_t>(srcTile.i());
+    _tileCountX = mesh->getInfo().getTileCountX();
+    return true;
+}
+
+bool PathCache::get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst)
+{
+    if (_usedAStar)
+    {
+        return g_astar.get_path(pos_x, dst_y, wplst);
+    }
+    if (INVALID == _startTile)
+    {
+        return false;
+    }
+    return AStar::add_waypoints(_path, _startTile, _tileCountX, pos_x, dst_y, wplst);
+}
+
+PathCache g_pathCache;
@@ -0,0 +1,87 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/AI/PathCache.hpp
+/// @brief Shared pathfinding towards common destinations.
+/// @details Many characters often walk towards the same destination (e.g. monsters chasing a player).
+///          Instead of running A* for each of them, the cache computes a flow field (the distance of
+///          every tile to the destination) once and lets every character descend it.
+
+#pragma once
+
+#include "egolib/AI/AStar.hpp"
+
+/// Pathfinding with per-destination flow fields.
+class PathCache {
+
+public:
+    PathCache();
+
+    /// @brief Find a path between the source and the destination (grid coordinates).
+    /// @details The first request for a destination is answered by A*. If the same destination
+    ///          (and the same passability bits) is requested again, a flow field for that destination
+    ///          is built and used by all following requests until the mesh FX change. Like A*, building a
+    ///          flow field explores at most AStar::MAX_ASTAR_NODES tiles, sources not covered by it are
+    ///          answered by A*.
+    /// @return @a true if a path was found, it can be retrieved using get_path()
+    bool find_path(const std::shared_ptr<const ego_mesh_t>& mesh, uint32_t stoppedBy, const int src_ix, const int src_iy, int dst_ix, int dst_iy);
+
+    /// @brief Fill a waypoint list with the path found by the last successful call to find_path().
+    bool get_path(const int pos_x, const int dst_y, waypoint_list_t& wplst);
+
+    /// @brief Remove all flow fields.
+    void clear();
+
+    /// @brief Get the number of flow fields built so far.
+    size_t getBuildCount() const { return _builds; }
+
+private:
+    static constexpr size_t MAX_FLOW_FIELDS = 8;        ///< Maximum number of cached flow fields
+    static constexpr size_t MAX_PATH = 1024;            ///< Maximum length of a path (before pruning)
+    static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+    struct FlowField {
+        uint32_t goal = INVALID;            ///< the destination tile
+        uint32_t stoppedBy = 0;             ///< the passability bits
+        uint32_t requests = 0;              ///< number of requests since the last invalidation
+        uint32_t lastUse = 0;               ///< clock of the last request (for eviction)
+        bool built = false;                 ///< is distance up-to-date?
+        bool complete = false;              ///< were all tiles connected to the goal reached within the node budget?
+        std::vector<uint32_t> distance;     ///< number of steps from a tile to the goal or UNREACHABLE
+    };
+
+    FlowField& acquire(uint32_t goal, uint32_t stoppedBy);
+    void build(const ego_mesh_t& mesh, FlowField& field);
+    bool descend(const ego_mesh_t& mesh, const FlowField& field, uint32_t start);
+
+    std::weak_ptr<const ego_mesh_t> _mesh;  ///< the mesh the flow fields were built for
+    uint32_t _fxRevision;                   ///< the FX revision the flow fields were built for
+    std::array<FlowField, MAX_FLOW_FIELDS> _fields;
+    uint32_t _clock;
+    size_t _builds;
+
+    std::vector<uint32_t> _queue;           ///< scratch queue for building flow fields
+    std::vector<uint32_t> _path;            ///< the last path found (destination first, start excluded)
+    uint32_t _startTile;
+    size_t _tileCountX;
+    bool _usedAStar;                        ///< was the last path found by g_astar?
+};
+
+extern PathCache g_pathCache;
@@ -68,9 +68,12 @@ static const std::array<const char*, GSND_COUNT> wavenames =
 };
 
 AudioSystem::AudioSystem() :
+    _musicFiles(),
     _musicLoaded(),
     _musicIDToNameMap(),
     _soundsLoaded(),
+    _soundsDecodedSize(0),
+    _soundPlayCounter(0),
     _globalSounds(),
     _loopingSounds(),
     _currentSongPlaying(),
@@ -123,7 +126,7 @@ void AudioSystem::loadGlobalSounds()
     // Load global sounds.
     for (size_t i = 0; i < GSND_COUNT; ++i)
     {
-        _globalSounds[i] = loadSound(std::string("mp_data/") + wavenames[i]);
+        _globalSounds[i] = loadSound(std::string("mp_data/") + wavenames[i], true);
         if (_globalSounds[i] == INVALID_SOUND_ID)
         {
 			Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "global sound ",
@@ -136,7 +139,7 @@ void AudioSystem::loadGlobalSounds()
     {
         const std::string fileName = "mp_data/sound" + std::to_string(cnt);
 
-        SoundID sound = loadSound(fileName);
+        SoundID sound = loadSound(fileName, true);
 
         // only overwrite with a valid sound file
         if (sound != INVALID_SOUND_ID)
@@ -149,14 +152,19 @@ void AudioSystem::loadGlobalSounds()
 AudioSystem::~AudioSystem()
 {
     for (auto& music : _musicLoaded) {
-        Mix_FreeMusic(music.second);
+        if (music.second) {
+            Mix_FreeMusic(music.second);
+        }
     }
     _musicLoaded.clear();
+    _musicFiles.clear();
     _musicIDToNameMap.clear();
 
-    for (Mix_Chunk *chunk : _soundsLoaded)
+    for (Sound& sound : _soundsLoaded)
     {
-        Mix_FreeChunk(chunk);
+        if (sound.chunk) {
+            Mix_FreeChunk(sound.chunk);
+        }
     }
     _soundsLoaded.clear();
     _loopingSounds.clear();
@@ -193,10 +201,10 @@ void AudioSystem::download(egoboo_config_t& cfg)
 
         // Start playing queued/paused song.
         if(!_currentSongPlaying.empty()) {
-            const auto& result = _musicLoaded.find(_currentSongPlaying);
-            if (result != _musicLoaded.end()) {
+            Mix_Music *music = getMusic(_currentSongPlaying);
+            if (music) {
                 Mix_HaltMusic();
-                Mix_FadeInMusic(result->second, -1, 500);
+                Mix_FadeInMusic(music, -1, 500);
             }            
         }
     }
@@ -215,7 +223,7 @@ void AudioSystem::stopMusic()
     }
 }
 
-SoundID AudioSystem::loadSound(const std::string &fileName)
+SoundID AudioSystem::loadSound(const std::string &fileName, bool resident)
 {
     // Valid filename?
     if (fileName.empty())
@@ -224,43 +232,104 @@ SoundID AudioSystem::loadSound(const std::string &fileName)
         return INVALID_SOUND_ID;
     }
 
-    // blank out the data
-    std::string fullFileName;
-    Mix_Chunk* loadedSound = nullptr;
-    bool fileExists = false;
+    // there is an error only if the file exists and can't be decoded
+    if (!vfs_exists(fileName + ".ogg") && !vfs_exists(fileName + ".wav"))
+    {
+        return INVALID_SOUND_ID;
+    }
+
+    _soundsLoaded.push_back({fileName, nullptr, resident, false, 0});
+    const SoundID soundID = _soundsLoaded.size() - 1;
+
+    // Resident sounds are decoded immediately, all other sounds when they are played first.
+    if (resident && !getSound(soundID))
+    {
+        _soundsLoaded.pop_back();
+        return INVALID_SOUND_ID;
+    }
+
+    //Sound loaded!
+    return soundID;
+}
+
+Mix_Chunk *AudioSystem::getSound(const SoundID soundID)
+{
+    if (soundID < 0 || soundID >= _soundsLoaded.size())
+    {
+        return nullptr;
+    }
+    Sound& sound = _soundsLoaded[soundID];
+    sound.lastPlayed = ++_soundPlayCounter;
+    if (sound.chunk || sound.failed)
+    {
+        return sound.chunk;
+    }
 
     // try an ogg file
-    fullFileName = fileName + ".ogg";
-    if (vfs_exists(fullFileName.c_str()))
+    std::string fullFileName = sound.fileName + ".ogg";
+    if (vfs_exists(fullFileName))
     {
-        fileExists = true;
-        loadedSound = Mix_LoadWAV_RW(vfs_openRWopsRead(fullFileName.c_str()), 1);
+        sound.chunk = Mix_LoadWAV_RW(vfs_openRWopsRead(fullFileName), 1);
     }
 
     //OGG failed, try WAV instead
-    if (nullptr == loadedSound)
+    if (nullptr == sound.chunk)
     {
-        fullFileName = fileName + ".wav";
-        if (vfs_exists(fullFileName.c_str()))
+        fullFileName = sound.fileName + ".wav";
+        if (vfs_exists(fullFileName))
         {
-            fileExists = true;
-            loadedSound = Mix_LoadWAV_RW(vfs_openRWopsRead(fullFileName.c_str()), 1);
+            sound.chunk = Mix_LoadWAV_RW(vfs_openRWopsRead(fullFileName), 1);
         }
     }
 
-    if (nullptr == loadedSound)
+    if (nullptr == sound.chunk)
     {
-        // there is an error only if the file exists and can't be loaded
-        if (fileExists) {
-			Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load sound file ", "`", fileName, "`: ", Mix_GetError(), Log::EndOfEntry);
-        }
+		Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load sound file ", "`", sound.fileName, "`: ", Mix_GetError(), Log::EndOfEntry);
+        // Do not try again.
+        sound.failed = true;
+        return nullptr;
+    }
 
-        return INVALID_SOUND_ID;
+    if (!sound.resident)
+    {
+        _soundsDecodedSize += sound.chunk->alen;
+        releaseSounds(soundID);
     }
+    return sound.chunk;
+}
 
-    //Sound loaded!
-    _soundsLoaded.push_back(loadedSound);
-    return _soundsLoaded.size() - 1;
+void AudioSystem::releaseSounds(const SoundID soundID)
+{
+    const size_t maximumSize = size_t(egoboo_config_t::get().sound_effectsCache_max.getValue()) * 1024;
+    while (_soundsDecodedSize > maximumSize)
+    {
+        // Find the least recently played sound which is not playing.
+        Sound *leastRecentlyPlayed = nullptr;
+        for (size_t i = 0; i < _soundsLoaded.size(); ++i)
+        {
+            Sound& sound = _soundsLoaded[i];
+            if (!sound.chunk || sound.resident || static_cast<size_t>(soundID) == i) {
+                continue;
+            }
+            if (leastRecentlyPlayed && leastRecentlyPlayed->lastPlayed <= sound.lastPlayed) {
+                continue;
+            }
+            bool playing = false;
+            for (int channel = 0, channelCount = Mix_AllocateChannels(-1); channel < channelCount && !playing; ++channel) {
+                playing = Mix_Playing(channel) && Mix_GetChunk(channel) == sound.chunk;
+            }
+            if (!playing) {
+                leastRecentlyPlayed = &sound;
+            }
+        }
+        if (!leastRecentlyPlayed)
+        {
+            break;
+        }
+        _soundsDecodedSize -= leastRecentlyPlayed->chunk->alen;
+        Mix_FreeChunk(leastRecentlyPlayed->chunk);
+        leastRecentlyPlayed->chunk = nullptr;
+    }
 }
 
 MusicID AudioSystem::loadMusic(const std::string &fileName)
@@ -270,23 +339,44 @@ MusicID AudioSystem::loadMusic(const std::string &fileName)
         return INVALID_SOUND_ID;
     }
 
-    Mix_Music* loadedMusic = Mix_LoadMUSType_RW(vfs_openRWopsRead(fileName.c_str()), MUS_NONE, 1);
-
-    if (!loadedMusic)
+    if (!vfs_exists(fileName))
     {
-		Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load music file", "`", fileName, "`: ", Mix_GetError(), Log::EndOfEntry);
+		Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to find music file", "`", fileName, "`", Log::EndOfEntry);
         return INVALID_SOUND_ID;
     }
 
-    // Got it!
+    // Got it! The music is opened when it is played first.
     const std::string songName = fileName.substr(fileName.find_last_of('/') + 1);
-    const MusicID id = _musicLoaded.size();
-    _musicLoaded[songName] = loadedMusic;
+    const MusicID id = _musicIDToNameMap.size();
+    _musicFiles[songName] = fileName;
     _musicIDToNameMap[id] = songName;
 
     return id;
 }
 
+Mix_Music *AudioSystem::getMusic(const std::string& songName)
+{
+    const auto& loaded = _musicLoaded.find(songName);
+    if (loaded != _musicLoaded.end()) {
+        return loaded->second;
+    }
+    const auto& file = _musicFiles.find(songName);
+    if (file == _musicFiles.end()) {
+        return nullptr;
+    }
+
+    // Music is streamed, opening it only reads the header.
+    Mix_Music* loadedMusic = Mix_LoadMUSType_RW(vfs_openRWopsRead(file->second.c_str()), MUS_NONE, 1);
+    if (!loadedMusic)
+    {
+		Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load music file", "`", file->second, "`: ", Mix_GetError(), Log::EndOfEntry);
+    }
+
+    // Remember failures as well so they are not tried again.
+    _musicLoaded[songName] = loadedMusic;
+    return loadedMusic;
+}
+
 void AudioSystem::playMusic(const std::string& songName, const uint16_t fadetime)
 { 
     // Dont restart a song we are already playing.
@@ -305,15 +395,18 @@ void AudioSystem::playMusic(const std::string& songName, const uint16_t fadetime
     Mix_VolumeMusic(egoboo_config_t::get().sound_music_volume.getValue());
 
     //Get the actual music data from the name of the song
-    const auto& result = _musicLoaded.find(songName);
-    if(result == _musicLoaded.end()) {
+    if(_musicFiles.find(songName) == _musicFiles.end()) {
         Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to play music ", "`", songName, "`", ": ",
                                          "song name ", "`", songName, "`", " does not exist", Log::EndOfEntry);        
         return;
     }
+    Mix_Music *music = getMusic(songName);
+    if (!music) {
+        return;
+    }
 
     // Mix_FadeOutMusic(fadetime);      // Stops the game too
-    if (Mix_FadeInMusic(result->second, -1, fadetime) == -1) {
+    if (Mix_FadeInMusic(music, -1, fadetime) == -1) {
         Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to play music ", "`", songName, "`", ": ",
                                          Mix_GetError(), Log::EndOfEntry);
     }
@@ -328,14 +421,25 @@ void AudioSystem::playMusic(const int musicID, const uint16_t fadetime)
     }
 }
 
+void AudioSystem::prefetchMusic(const MusicID musicID)
+{
+    if (!egoboo_config_t::get().sound_music_enable.getValue()) {
+        return;
+    }
+    const auto& result = _musicIDToNameMap.find(musicID);
+    if (result != _musicIDToNameMap.end()) {
+        getMusic(result->second);
+    }
+}
+
 void AudioSystem::loadAllMusic()
 {
-    if (!_musicLoaded.empty() || !egoboo_config_t::get().sound_music_enable.getValue()) return;
+    if (!_musicFiles.empty() || !egoboo_config_t::get().sound_music_enable.getValue()) return;
 
     // Open the playlist listing all music files
     ReadContext ctxt("mp_data/music/playlist.txt");
 
-    // Load all music data into memory
+    // Add all music files, they are opened when they are played first
     while (ctxt.skipToColon(true))
     {
         std::string songName = vfs_read_name(ctxt);
@@ -377,7 +481,10 @@ void AudioSystem::updateLoopingSound(const std::shared_ptr<LoopingSound> &sound)
     {
         //No channel allocated to this sound yet? try to allocate a free one
         if (channel == INVALID_SOUND_CHANNEL) {
-            channel = Mix_PlayChannel(-1, _soundsLoaded[sound->getSoundID()], -1);
+            Mix_Chunk *chunk = getSound(sound->getSoundID());
+            if (chunk) {
+                channel = Mix_PlayChannel(-1, chunk, -1);
+            }
         }
 
         //Update sound effects
@@ -454,7 +561,12 @@ int AudioSystem::playSoundFull(SoundID soundID)
     }
 
     // play the sound
-    int channel = Mix_PlayChannel(-1, _soundsLoaded[soundID], 0);
+    Mix_Chunk *chunk = getSound(soundID);
+    if (!chunk)
+    {
+        return INVALID_SOUND_CHANNEL;
+    }
+    int channel = Mix_PlayChannel(-1, chunk, 0);
 
     if (channel != INVALID_SOUND_CHANNEL) {
         //remove any 3D positional mixing effects
@@ -565,7 +677,12 @@ int AudioSystem::playSound(const Vector3f& snd_pos, const SoundID soundID)
     }
 
     // Play the sound once
-    int channel = Mix_PlayChannel(-1, _soundsLoaded[soundID], 0);
+    Mix_Chunk *chunk = getSound(soundID);
+    if (!chunk)
+    {
+        return INVALID_SOUND_CHANNEL;
+    }
+    int channel = Mix_PlayChannel(-1, chunk, 0);
 
     // could fail if no free channels are available.
     if (INVALID_SOUND_CHANNEL != channel)
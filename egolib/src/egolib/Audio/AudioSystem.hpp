@@ -159,10 +159,32 @@ public:
     **/
     void playMusic(const std::string& songName, const uint16_t fadetime = 0);
 
-    SoundID loadSound(const std::string &fileName);
+    /**
+     * @brief
+     *  Open a music track before it is played.
+     * @param musicID
+     *  the music ID
+     * @remark
+     *  Music tracks are opened when they are played first. Prefetching a track, e.g. the track of a passage,
+     *  avoids opening it the moment the track is about to be played.
+     */
+    void prefetchMusic(const MusicID musicID);
+
+    /**
+     * @brief
+     *  Load a sound effect.
+     * @param fileName
+     *  the file name of the sound effect without the extension (".ogg" or ".wav")
+     * @param resident
+     *  if @a true the sound effect is decoded immediately and kept in memory.
+     *  Otherwise it is decoded when it is played first and might be released if it is not played for a while.
+     * @return
+     *  the sound ID, INVALID_SOUND_ID if the sound file does not exist or a resident sound effect can not be decoded
+     */
+    SoundID loadSound(const std::string &fileName, bool resident = false);
 
     /// @author ZF
-    /// @details This function loads all of the music sounds
+    /// @details This function reads the playlist. The music tracks are opened when they are played first.
     void loadAllMusic();
 
     /**
@@ -258,10 +280,41 @@ public:
 
 private:
     /**
-    * @brief Loads one music track. Returns nullptr if it fails
+    * @brief Adds one music track to the playlist. Returns INVALID_SOUND_ID if the music file does not exist
     **/
     MusicID loadMusic(const std::string &fileName);
 
+    /**
+     * @brief
+     *  Get the music data of a song, opening the song if it was not opened before.
+     * @param songName
+     *  the song name
+     * @return
+     *  the music data, a null pointer if the song does not exist or can not be opened
+     */
+    Mix_Music *getMusic(const std::string& songName);
+
+    /**
+     * @brief
+     *  Get the decoded data of a sound effect, decoding the sound effect if required.
+     * @param soundID
+     *  the sound ID
+     * @return
+     *  the decoded data, a null pointer if the sound ID is not valid or the sound effect can not be decoded
+     */
+    Mix_Chunk *getSound(const SoundID soundID);
+
+    /**
+     * @brief
+     *  Release the least recently played sound effects until the decoded sound effects
+     *  fit into the cache size given by egoboo_config_t::sound_effectsCache_max.
+     * @param soundID
+     *  the sound ID of a sound effect which must not be released
+     * @remark
+     *  Resident sound effects and sound effects which are currently playing are not released.
+     */
+    void releaseSounds(const SoundID soundID);
+
     /**
      * @brief applies 3D spatial effect to the specified sound (using volume and panning)
      * @param channel
@@ -292,9 +345,22 @@ private:
     void updateLoopingSound(const std::shared_ptr<LoopingSound>& sound);
 
 private:
-    std::unordered_map<std::string, Mix_Music*> _musicLoaded;    //Maps song names to music data
+    /// A sound effect.
+    struct Sound
+    {
+        std::string fileName;   ///< The file name of the sound effect without the extension.
+        Mix_Chunk *chunk;       ///< The decoded data or a null pointer if the sound effect is not decoded.
+        bool resident;          ///< Is the decoded data never released?
+        bool failed;            ///< Did decoding the sound effect fail?
+        uint64_t lastPlayed;    ///< The value of _soundPlayCounter when the sound effect was played last.
+    };
+
+    std::unordered_map<std::string, std::string> _musicFiles;   //Maps song names to music file names
+    std::unordered_map<std::string, Mix_Music*> _musicLoaded;    //Maps song names to opened music data
     std::unordered_map<MusicID, std::string> _musicIDToNameMap;   //Maps MusicID to song names
-    std::vector<Mix_Chunk*> _soundsLoaded;
+    std::vector<Sound> _soundsLoaded;
+    size_t _soundsDecodedSize;                                          ///< Bytes of decoded non-resident sound effects.
+    uint64_t _soundPlayCounter;
     std::array<SoundID, GSND_COUNT> _globalSounds;
 
     std::forward_list<std::shared_ptr<LoopingSound>> _loopingSounds;
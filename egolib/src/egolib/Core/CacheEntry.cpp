@@ -0,0 +1,173 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/Core/CacheEntry.cpp
+/// @brief Entries of the caches in the user directory.
+
+#include "egolib/Core/CacheEntry.hpp"
+#include "egolib/vfs.h"
+#include "egolib/Log/_Include.hpp"
+
+namespace Ego {
+
+uint64_t CacheEntry::hash(const char *bytes, size_t size)
+{
+    uint64_t value = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i)
+    {
+        value ^= static_cast<uint8_t>(bytes[i]);
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+void CacheEntry::begin(std::vector<char>& entry, const char (&magic)[MagicSize], uint64_t version, uint64_t sourceHash)
+{
+    Writer writer{ entry };
+    entry.insert(entry.end(), std::begin(magic), std::end(magic));
+    writer.writeUint64(version);
+    writer.writeUint64(sourceHash);
+}
+
+void CacheEntry::end(std::vector<char>& entry)
+{
+    // A checksum of the entry detects truncated or otherwise corrupted entries.
+    Writer writer{ entry };
+    writer.writeUint64(hash(entry.data(), entry.size()));
+}
+
+bool CacheEntry::open(const std::vector<char>& entry, const char (&magic)[MagicSize], uint64_t version, uint64_t sourceHash,
+                      size_t& payloadBegin, size_t& payloadEnd)
+{
+    // Verify the checksum, the magic, the version and the source.
+    if (entry.size() < MagicSize + 8 + 8 + 8)
+    {
+        return false;
+    }
+    const size_t size = entry.size() - 8;
+    Reader checksum{ entry, size, false };
+    if (checksum.readUint64() != hash(entry.data(), size) || !std::equal(std::begin(magic), std::end(magic), entry.begin()))
+    {
+        return false;
+    }
+    Reader reader{ entry, MagicSize, false };
+    if (reader.readUint64() != version || reader.readUint64() != sourceHash)
+    {
+        return false;
+    }
+    payloadBegin = reader.position;
+    payloadEnd = size;
+    return true;
+}
+
+std::string CacheEntry::getDirectory(const std::string& cacheDirectory, uint64_t version)
+{
+    std::ostringstream os;
+    os << cacheDirectory << "/" << std::hex << std::setw(16) << std::setfill('0') << version;
+    return os.str();
+}
+
+std::string CacheEntry::getPathname(const std::string& directory, uint64_t sourceHash, const std::string& extension)
+{
+    std::ostringstream os;
+    os << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << sourceHash << "." << extension;
+    return os.str();
+}
+
+void CacheEntry::prune(const std::string& cacheDirectory, uint64_t version, size_t maximumNumberOfEntries)
+{
+    if (!vfs_isDirectory(cacheDirectory))
+    {
+        return;
+    }
+    const std::string directory = getDirectory(cacheDirectory, version);
+
+    // Remove the entries of other versions.
+    std::vector<std::string> stale;
+    SearchContext *ctxt = new SearchContext(Ego::VfsPath(cacheDirectory), VFS_SEARCH_DIR | VFS_SEARCH_FILE | VFS_SEARCH_BARE);
+    while (ctxt->hasData())
+    {
+        const std::string pathname = cacheDirectory + "/" + ctxt->getData().string();
+        if (pathname != directory)
+        {
+            stale.push_back(pathname);
+        }
+        ctxt->nextData();
+    }
+    delete ctxt;
+    ctxt = nullptr;
+    for (const std::string& pathname : stale)
+    {
+        if (vfs_isDirectory(pathname))
+        {
+            vfs_removeDirectoryAndContents(pathname.c_str());
+        }
+        else
+        {
+            vfs_delete_file(pathname);
+        }
+    }
+
+    // Entries of changed sources are never loaded again. Remove all entries if there are too many.
+    if (vfs_isDirectory(directory))
+    {
+        size_t numberOfEntries = 0;
+        ctxt = new SearchContext(Ego::VfsPath(directory), VFS_SEARCH_FILE | VFS_SEARCH_BARE);
+        while (ctxt->hasData())
+        {
+            numberOfEntries++;
+            ctxt->nextData();
+        }
+        delete ctxt;
+        ctxt = nullptr;
+        if (numberOfEntries > maximumNumberOfEntries)
+        {
+            Log::get() << Log::Entry::create(Log::Level::Info, __FILE__, __LINE__, "removing ", numberOfEntries, " cache entries from ", "`", directory, "`", Log::EndOfEntry);
+            vfs_removeDirectoryAndContents(directory.c_str());
+        }
+    }
+}
+
+bool CacheEntry::load(const std::string& pathname, std::vector<char>& entry)
+{
+    entry.clear();
+    if (!vfs_exists(pathname))
+    {
+        return false;
+    }
+    try
+    {
+        vfs_readEntireFile(pathname, [&entry](size_t numberOfBytes, const char *bytes) { entry.insert(entry.end(), bytes, bytes + numberOfBytes); });
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return true;
+}
+
+void CacheEntry::store(const std::string& pathname, const std::vector<char>& entry)
+{
+    if (!vfs_writeEntireFile(pathname, entry.data(), entry.size()))
+    {
+        Log::get() << Log::Entry::create(Log::Level::Debug, __FILE__, __LINE__, "unable to write cache entry ", "`", pathname, "`", Log::EndOfEntry);
+    }
+}
+
+} // namespace Ego
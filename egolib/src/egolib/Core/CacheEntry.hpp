@@ -0,0 +1,190 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/Core/CacheEntry.hpp
+/// @brief Entries of the caches in the user directory.
+
+#pragma once
+
+#include "egolib/platform.h"
+#include <cstring>
+
+namespace Ego {
+
+/// @brief The format shared by the entries of the caches in the user directory.
+/// @details An entry starts with a magic, the version of the cache and the hash of the source of the entry.
+/// It ends with a checksum of all preceding bytes. The payload in between is written and read using
+/// CacheEntry::Writer and CacheEntry::Reader. The entries of a version are stored in a directory of their own.
+class CacheEntry
+{
+public:
+    /// @brief The size of the magic of an entry.
+    static const size_t MagicSize = 4;
+
+    /// @brief Writes little-endian values into an entry.
+    struct Writer
+    {
+        std::vector<char>& bytes;
+
+        void writeUint8(uint8_t value)
+        {
+            bytes.push_back(static_cast<char>(value));
+        }
+
+        void writeUint32(uint32_t value)
+        {
+            for (size_t i = 0; i < 4; ++i) writeUint8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        void writeUint64(uint64_t value)
+        {
+            for (size_t i = 0; i < 8; ++i) writeUint8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        void writeFloat(float value)
+        {
+            uint32_t bits;
+            static_assert(sizeof(bits) == sizeof(value), "unsupported float size");
+            std::memcpy(&bits, &value, sizeof(bits));
+            writeUint32(bits);
+        }
+
+        void writeString(const std::string& value)
+        {
+            writeUint32(static_cast<uint32_t>(value.size()));
+            bytes.insert(bytes.end(), value.begin(), value.end());
+        }
+    };
+
+    /// @brief Reads little-endian values from an entry. Reading beyond the end of the entry raises the error flag.
+    struct Reader
+    {
+        const std::vector<char>& bytes;
+        size_t position;
+        bool error;
+
+        bool canRead(size_t size)
+        {
+            if (error || bytes.size() - position < size)
+            {
+                error = true;
+                return false;
+            }
+            return true;
+        }
+
+        uint8_t readUint8()
+        {
+            return canRead(1) ? static_cast<uint8_t>(bytes[position++]) : 0;
+        }
+
+        uint32_t readUint32()
+        {
+            uint32_t value = 0;
+            for (size_t i = 0; i < 4; ++i) value |= static_cast<uint32_t>(readUint8()) << (8 * i);
+            return value;
+        }
+
+        uint64_t readUint64()
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < 8; ++i) value |= static_cast<uint64_t>(readUint8()) << (8 * i);
+            return value;
+        }
+
+        float readFloat()
+        {
+            const uint32_t bits = readUint32();
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        std::string readString()
+        {
+            uint32_t size = readUint32();
+            if (!canRead(size))
+            {
+                return std::string();
+            }
+            std::string value(bytes.data() + position, size);
+            position += size;
+            return value;
+        }
+    };
+
+    /// @brief Compute the hash of a sequence of bytes.
+    /// @param bytes, size the bytes
+    /// @return the hash (64 bit FNV-1a)
+    static uint64_t hash(const char *bytes, size_t size);
+
+    /// @brief Begin an entry.
+    /// @param entry the entry
+    /// @param magic the magic of the cache
+    /// @param version the version of the cache
+    /// @param sourceHash the hash of the source of the entry
+    static void begin(std::vector<char>& entry, const char (&magic)[MagicSize], uint64_t version, uint64_t sourceHash);
+
+    /// @brief End an entry by appending the checksum.
+    /// @param entry the entry
+    static void end(std::vector<char>& entry);
+
+    /// @brief Open an entry.
+    /// @param entry the entry
+    /// @param magic the magic of the cache
+    /// @param version the version of the cache
+    /// @param sourceHash the hash of the source of the entry
+    /// @param [out] payloadBegin, payloadEnd receive the range of the payload of the entry
+    /// @return @a true on success, @a false if the entry is corrupted, of another cache or version or for another source
+    static bool open(const std::vector<char>& entry, const char (&magic)[MagicSize], uint64_t version, uint64_t sourceHash,
+                     size_t& payloadBegin, size_t& payloadEnd);
+
+    /// @brief Get the pathname of the directory of the entries of a version.
+    /// @param cacheDirectory the pathname of the directory of the cache in vfs-specific notation
+    /// @param version the version
+    /// @return the pathname in vfs-specific notation
+    static std::string getDirectory(const std::string& cacheDirectory, uint64_t version);
+
+    /// @brief Get the pathname of an entry.
+    /// @param directory the pathname of the directory of the entries of the version in vfs-specific notation
+    /// @param sourceHash the hash of the source of the entry
+    /// @param extension the extension of the entry
+    /// @return the pathname in vfs-specific notation
+    static std::string getPathname(const std::string& directory, uint64_t sourceHash, const std::string& extension);
+
+    /// @brief Remove the entries of other versions and bound the number of entries of a version.
+    /// @param cacheDirectory the pathname of the directory of the cache in vfs-specific notation
+    /// @param version the version
+    /// @param maximumNumberOfEntries if the version has more entries, all of its entries are removed
+    static void prune(const std::string& cacheDirectory, uint64_t version, size_t maximumNumberOfEntries);
+
+    /// @brief Read an entry.
+    /// @param pathname the pathname of the entry in vfs-specific notation
+    /// @param [out] entry receives the entry
+    /// @return @a true on success, @a false if the entry does not exist or can not be read
+    static bool load(const std::string& pathname, std::vector<char>& entry);
+
+    /// @brief Write an entry.
+    /// @param pathname the pathname of the entry in vfs-specific notation
+    /// @param entry the entry
+    /// @remark Failures are logged and otherwise ignored.
+    static void store(const std::string& pathname, const std::vector<char>& entry);
+};
+
+} // namespace Ego
@@ -0,0 +1,46 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/CommandBuffer.cpp
+/// @brief  Deferred execution of side effects
+
+#include "egolib/Core/CommandBuffer.hpp"
+
+namespace Ego
+{
+
+thread_local CommandBuffer *CommandBuffer::s_recording = nullptr;
+
+void CommandBuffer::replay()
+{
+    //Commands may submit new commands (which are then executed immediately), so swap the list out first
+    std::vector<Command> commands;
+    commands.swap(_commands);
+    for(const Command &command : commands) {
+        command();
+    }
+
+    //Keep the memory for the next recording
+    commands.clear();
+    if(_commands.empty()) {
+        _commands.swap(commands);
+    }
+}
+
+} //namespace Ego
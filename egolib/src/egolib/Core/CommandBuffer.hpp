@@ -0,0 +1,121 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/CommandBuffer.hpp
+/// @brief  Deferred execution of side effects
+
+#pragma once
+
+#include <idlib/idlib.hpp>
+
+namespace Ego
+{
+
+/**
+* @brief
+*   A list of deferred commands.
+* @details
+*   Code that has side effects on other entities or on non-thread-safe systems (audio, spawning,
+*   ...) submits these side effects via CommandBuffer::submit. If no command buffer is recording
+*   on the calling thread, the command is executed immediately. Otherwise it is appended to the
+*   recording command buffer and executed when that buffer is replayed.
+**/
+class CommandBuffer
+{
+public:
+    using Command = std::function<void()>;
+
+    /**
+    * @brief
+    *   While a Recording exists, commands submitted on the creating thread are recorded into a command buffer
+    **/
+    class Recording : private idlib::non_copyable
+    {
+    public:
+        explicit Recording(CommandBuffer &buffer) :
+            _previous(s_recording)
+        {
+            s_recording = &buffer;
+        }
+
+        ~Recording()
+        {
+            s_recording = _previous;
+        }
+
+    private:
+        CommandBuffer *_previous;
+    };
+
+    CommandBuffer() :
+        _commands()
+    {
+        //ctor
+    }
+
+    /**
+    * @brief
+    *   Execute a command now or record it if a command buffer is recording on this thread
+    **/
+    template<typename F>
+    static void submit(F&& command)
+    {
+        if(s_recording != nullptr) {
+            s_recording->_commands.emplace_back(std::forward<F>(command));
+        }
+        else {
+            command();
+        }
+    }
+
+    /**
+    * @return
+    *   true if a command buffer is recording on the calling thread
+    **/
+    static bool isRecording()
+    {
+        return s_recording != nullptr;
+    }
+
+    /**
+    * @brief
+    *   Execute all recorded commands in the order they were recorded and clear this buffer
+    **/
+    void replay();
+
+    /**
+    * @brief
+    *   Discard all recorded commands
+    **/
+    void clear()
+    {
+        _commands.clear();
+    }
+
+    size_t size() const
+    {
+        return _commands.size();
+    }
+
+private:
+    std::vector<Command> _commands;
+    static thread_local CommandBuffer *s_recording;
+};
+
+} //namespace Ego
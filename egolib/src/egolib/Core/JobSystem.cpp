@@ -0,0 +1,47 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/JobSystem.cpp
+/// @brief  Data-parallel jobs on a shared thread pool
+
+#include "egolib/Core/JobSystem.hpp"
+
+namespace Ego
+{
+
+JobSystem::JobSystem() :
+    _workerCount(0),
+    _threadPool(),
+    _commandBuffers(),
+    _futures()
+{
+    //Keep one core for the calling thread, it takes part in every loop
+    const unsigned int cores = std::thread::hardware_concurrency();
+    _workerCount = cores > 1 ? cores - 1 : 0;
+    if(_workerCount > 0) {
+        _threadPool = std::make_unique<ThreadPool>(_workerCount);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    //ThreadPool joins all workers
+}
+
+} //namespace Ego
@@ -0,0 +1,148 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/JobSystem.hpp
+/// @brief  Data-parallel jobs on a shared thread pool
+
+#pragma once
+
+#include "egolib/Core/ThreadPool.hpp"
+#include "egolib/Core/CommandBuffer.hpp"
+
+namespace Ego
+{
+
+/**
+* @brief
+*   Runs data-parallel loops on a shared ThreadPool.
+* @details
+*   A loop over <tt>[0, count)</tt> is split into chunks of a fixed number of elements. The chunk
+*   boundaries only depend on the element count and the grain size, never on the number of threads
+*   or on scheduling. Each chunk records its deferred side effects (see CommandBuffer) into its own
+*   command buffer. After all chunks finished, the buffers are replayed on the calling thread in chunk
+*   order, i.e. in the same order in which a serial loop would have executed these side effects.
+**/
+class JobSystem : public idlib::singleton<JobSystem>
+{
+public:
+    /**
+    * @return
+    *   the number of worker threads (0 if all loops run serially)
+    **/
+    size_t getWorkerCount() const
+    {
+        return _workerCount;
+    }
+
+    /**
+    * @brief
+    *   Invoke <tt>body(begin, end)</tt> for all chunks of <tt>[0, count)</tt> in parallel and wait for them.
+    * @param count
+    *   the number of elements
+    * @param grainSize
+    *   the number of elements per chunk
+    * @param body
+    *   functor of signature <tt>void(size_t begin, size_t end)</tt>. It must only modify the elements
+    *   of its chunk and submit all other side effects via CommandBuffer::submit.
+    * @remark
+    *   Must be called from the main thread and must not be nested.
+    **/
+    template<typename Body>
+    void parallelFor(const size_t count, const size_t grainSize, Body&& body)
+    {
+        const size_t chunkSize = std::max<size_t>(1, grainSize);
+        const size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+        //Not worth the overhead? Run serially, side effects are executed immediately
+        if(0 == _workerCount || chunkCount <= 1) {
+            if(count > 0) body(size_t(0), count);
+            return;
+        }
+
+        if(_commandBuffers.size() < chunkCount) {
+            _commandBuffers.resize(chunkCount);
+        }
+
+        auto runChunk = [this, count, chunkSize, &body](const size_t chunk)
+        {
+            CommandBuffer::Recording recording(_commandBuffers[chunk]);
+            const size_t begin = chunk * chunkSize;
+            body(begin, std::min(count, begin + chunkSize));
+        };
+
+        //The calling thread runs the first chunk itself
+        std::exception_ptr exception;
+        _futures.clear();
+        try {
+            for(size_t chunk = 1; chunk < chunkCount; ++chunk) {
+                _futures.push_back(_threadPool->submit(runChunk, chunk));
+            }
+            runChunk(0);
+        }
+        catch(...) {
+            exception = std::current_exception();
+        }
+
+        //Wait for all chunks before rethrowing any exception, they refer to body and to the command buffers
+        for(std::future<void> &future : _futures) {
+            future.wait();
+        }
+        for(std::future<void> &future : _futures) {
+            try {
+                future.get();
+            }
+            catch(...) {
+                if(!exception) exception = std::current_exception();
+            }
+        }
+        _futures.clear();
+
+        //Replay the side effects in serial order
+        size_t chunk = 0;
+        try {
+            for(; !exception && chunk < chunkCount; ++chunk) {
+                _commandBuffers[chunk].replay();
+            }
+        }
+        catch(...) {
+            exception = std::current_exception();
+        }
+
+        //Discard the side effects not replayed, the next loop must not replay them
+        if(exception) {
+            for(; chunk < chunkCount; ++chunk) {
+                _commandBuffers[chunk].clear();
+            }
+            std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    friend idlib::default_new_functor<JobSystem>;
+    friend idlib::default_delete_functor<JobSystem>;
+    JobSystem();
+    ~JobSystem();
+
+    size_t _workerCount;
+    std::unique_ptr<ThreadPool> _threadPool;
+    std::vector<CommandBuffer> _commandBuffers;
+    std::vector<std::future<void>> _futures;
+};
+
+} //namespace Ego
@@ -0,0 +1,378 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/Core/SpatialGrid.hpp
+/// @brief  Persistent uniform grid for fast element lookup based on bounding boxes
+
+#pragma once
+
+#include "egolib/Math/_Include.hpp"
+#include "egolib/Math/Standard.hpp"
+#include <unordered_map>
+
+namespace Ego
+{
+
+/**
+* @brief
+*   A persistent, incrementally updated uniform grid.
+* @details
+*   Unlike QuadTree this structure is not rebuilt every frame. Each element is identified by an
+*   integral id (e.g. ObjectRef::get()) and is only relinked when the range of cells covered
+*   by its getAxisAlignedBox2D() changes. Ids are mapped to pooled element slots which are
+*   recycled on removal, so the storage is bounded by the number of contained elements and not
+*   by the largest id. Cell membership is stored in a pooled link array (with a free list), so
+*   steady-state updates do not allocate.
+*
+*   Elements that lie (partially) outside of the grid bounds are clamped to the border cells.
+*   Querying is not thread-safe (queries stamp elements to remove duplicates).
+**/
+template<typename T>
+class SpatialGrid
+{
+public:
+    /**
+    * @brief
+    *   Construct an empty grid consisting of a single cell
+    **/
+    SpatialGrid() :
+        _minX(0.0f),
+        _minY(0.0f),
+        _cellSize(1.0f),
+        _inverseCellSize(1.0f),
+        _cellCountX(1),
+        _cellCountY(1),
+        _cells(1, INVALID),
+        _slots(),
+        _elements(),
+        _freeElement(INVALID),
+        _links(),
+        _freeLink(INVALID),
+        _queryStamp(0)
+    {
+        //ctor
+    }
+
+    /**
+    * @brief
+    *   Removes all elements and changes the bounds and cell size of this grid
+    * @param cellSize
+    *   width and height of a single cell
+    **/
+    void reset(const float minX, const float minY, const float maxX, const float maxY, const float cellSize)
+    {
+        _minX = minX;
+        _minY = minY;
+        _cellSize = std::max(cellSize, 1.0f);
+        _inverseCellSize = 1.0f / _cellSize;
+        _cellCountX = std::max<int>(1, static_cast<int>(std::ceil((maxX - minX) * _inverseCellSize)));
+        _cellCountY = std::max<int>(1, static_cast<int>(std::ceil((maxY - minY) * _inverseCellSize)));
+
+        _cells.assign(static_cast<size_t>(_cellCountX) * _cellCountY, INVALID);
+        _slots.clear();
+        _elements.clear();
+        _freeElement = INVALID;
+        _links.clear();
+        _freeLink = INVALID;
+        _queryStamp = 0;
+    }
+
+    /**
+    * @return
+    *   true if the specified bounds and cell size match the current layout of this grid
+    **/
+    bool hasLayout(const float minX, const float minY, const float maxX, const float maxY, const float cellSize) const
+    {
+        return minX == _minX && minY == _minY && cellSize == _cellSize
+            && _cellCountX == std::max<int>(1, static_cast<int>(std::ceil((maxX - minX) * _inverseCellSize)))
+            && _cellCountY == std::max<int>(1, static_cast<int>(std::ceil((maxY - minY) * _inverseCellSize)));
+    }
+
+    /**
+    * @brief
+    *   Inserts an element or moves it to the cells it currently overlaps.
+    *   Does nothing if the element is already linked into the correct cells.
+    * @param id
+    *   unique integral id of the element
+    **/
+    void update(const size_t id, const std::shared_ptr<T> &element)
+    {
+        const CellRange range = getCellRange(element->getAxisAlignedBox2D());
+
+        uint32_t slot;
+        auto it = _slots.find(id);
+        if(it != _slots.end()) {
+            slot = it->second;
+            Element &entry = _elements[slot];
+            //Still in the same cells?
+            if(entry.range == range && entry.element == element) {
+                return;
+            }
+            unlink(slot);
+        }
+        else {
+            slot = allocateElement();
+            _slots.emplace(id, slot);
+        }
+
+        Element &entry = _elements[slot];
+        entry.element = element;
+        entry.range = range;
+        link(slot);
+    }
+
+    /**
+    * @brief
+    *   Removes an element from this grid
+    * @return
+    *   true if the element was contained in this grid
+    **/
+    bool remove(const size_t id)
+    {
+        auto it = _slots.find(id);
+        if(it == _slots.end()) {
+            return false;
+        }
+        const uint32_t slot = it->second;
+        _slots.erase(it);
+        unlink(slot);
+
+        //Return the slot to the pool
+        Element &entry = _elements[slot];
+        entry.element.reset();
+        entry.nextFree = _freeElement;
+        _freeElement = slot;
+        return true;
+    }
+
+    /**
+    * @return
+    *   true if an element with the specified id is contained in this grid
+    **/
+    bool contains(const size_t id) const
+    {
+        return _slots.find(id) != _slots.end();
+    }
+
+    /**
+    * @return
+    *   number of elements contained in this grid
+    **/
+    size_t size() const
+    {
+        return _slots.size();
+    }
+
+    /**
+    * @brief
+    *   Find all elements whose bounding box intersects the search area.
+    *   Each element is reported at most once.
+    * @param searchArea
+    *   The bounding box which is used for finding elements
+    * @param result
+    *   Vector of all elements that fit within the search area
+    **/
+    void find(const AxisAlignedBox2f &searchArea, std::vector<std::shared_ptr<T>> &result) const
+    {
+        find(searchArea, [&result](const std::shared_ptr<T> &element) { result.push_back(element); });
+    }
+
+    /**
+    * @brief
+    *   Invoke a visitor for all elements whose bounding box intersects the search area.
+    *   Each element is visited at most once.
+    * @param searchArea
+    *   The bounding box which is used for finding elements
+    * @param visitor
+    *   functor of signature <tt>void(const std::shared_ptr<T>&)</tt>
+    **/
+    template<typename Visitor>
+    void find(const AxisAlignedBox2f &searchArea, Visitor&& visitor) const
+    {
+        const CellRange range = getCellRange(searchArea);
+        const uint32_t stamp = nextQueryStamp();
+
+        for(int y = range.minY; y <= range.maxY; ++y) {
+            for(int x = range.minX; x <= range.maxX; ++x) {
+                for(uint32_t i = _cells[y * _cellCountX + x]; i != INVALID; i = _links[i].next) {
+                    const Element &entry = _elements[_links[i].element];
+
+                    //Already visited by this query?
+                    if(entry.stamp == stamp) {
+                        continue;
+                    }
+                    entry.stamp = stamp;
+
+                    //Check if element is within search area
+                    if(idlib::is_intersecting(entry.element->getAxisAlignedBox2D(), searchArea)) {
+                        visitor(entry.element);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+    struct CellRange
+    {
+        int minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange &other) const
+        {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Element
+    {
+        std::shared_ptr<T> element;     //< the element or nullptr if this slot is unused
+        CellRange range;                //< cells this element is currently linked into
+        uint32_t firstLink = INVALID;   //< first link of the chain of links owned by this element
+        uint32_t nextFree = INVALID;    //< next slot in the free list if this slot is unused
+        mutable uint32_t stamp = 0;     //< id of the last query that visited this element
+    };
+
+    struct Link
+    {
+        uint32_t element;               //< slot of the element
+        uint32_t cell;                  //< index of the cell
+        uint32_t prev, next;            //< doubly linked list of links in the same cell
+        uint32_t nextOfElement;         //< singly linked list of links owned by the same element
+    };
+
+    CellRange getCellRange(const AxisAlignedBox2f &box) const
+    {
+        CellRange range;
+        range.minX = toCell(box.get_min()[kX], _minX, _cellCountX);
+        range.minY = toCell(box.get_min()[kY], _minY, _cellCountY);
+        range.maxX = toCell(box.get_max()[kX], _minX, _cellCountX);
+        range.maxY = toCell(box.get_max()[kY], _minY, _cellCountY);
+        return range;
+    }
+
+    int toCell(const float value, const float origin, const int count) const
+    {
+        const float cell = std::floor((value - origin) * _inverseCellSize);
+        if(!(cell > 0.0f)) return 0;    // also catches NaN
+        if(cell >= count - 1) return count - 1;
+        return static_cast<int>(cell);
+    }
+
+    uint32_t nextQueryStamp() const
+    {
+        //Wrap around: reset all stamps so that old stamps can not collide with new queries
+        if(++_queryStamp == 0) {
+            for(const Element &entry : _elements) {
+                entry.stamp = 0;
+            }
+            _queryStamp = 1;
+        }
+        return _queryStamp;
+    }
+
+    uint32_t allocateElement()
+    {
+        if(_freeElement != INVALID) {
+            uint32_t slot = _freeElement;
+            _freeElement = _elements[slot].nextFree;
+            _elements[slot].nextFree = INVALID;
+            return slot;
+        }
+        _elements.emplace_back();
+        return static_cast<uint32_t>(_elements.size() - 1);
+    }
+
+    uint32_t allocateLink()
+    {
+        if(_freeLink != INVALID) {
+            uint32_t index = _freeLink;
+            _freeLink = _links[index].next;
+            return index;
+        }
+        _links.emplace_back();
+        return static_cast<uint32_t>(_links.size() - 1);
+    }
+
+    void link(const uint32_t slot)
+    {
+        Element &entry = _elements[slot];
+        entry.firstLink = INVALID;
+
+        for(int y = entry.range.minY; y <= entry.range.maxY; ++y) {
+            for(int x = entry.range.minX; x <= entry.range.maxX; ++x) {
+                const uint32_t cell = y * _cellCountX + x;
+                const uint32_t index = allocateLink();
+                Link &link = _links[index];
+                link.element = slot;
+                link.cell = cell;
+                link.prev = INVALID;
+                link.next = _cells[cell];
+                link.nextOfElement = entry.firstLink;
+                if(link.next != INVALID) {
+                    _links[link.next].prev = index;
+                }
+                _cells[cell] = index;
+                entry.firstLink = index;
+            }
+        }
+    }
+
+    void unlink(const uint32_t slot)
+    {
+        Element &entry = _elements[slot];
+        uint32_t index = entry.firstLink;
+        while(index != INVALID) {
+            Link &link = _links[index];
+            if(link.prev != INVALID) {
+                _links[link.prev].next = link.next;
+            }
+            else {
+                _cells[link.cell] = link.next;
+            }
+            if(link.next != INVALID) {
+                _links[link.next].prev = link.prev;
+            }
+
+            //Return link to the pool
+            const uint32_t nextOfElement = link.nextOfElement;
+            link.next = _freeLink;
+            _freeLink = index;
+            index = nextOfElement;
+        }
+        entry.firstLink = INVALID;
+    }
+
+private:
+    float _minX, _minY;                         //< lower bounds of the grid
+    float _cellSize, _inverseCellSize;          //< width and height of a cell
+    int _cellCountX, _cellCountY;               //< number of cells along the x- and y-axis
+
+    std::vector<uint32_t> _cells;               //< head of the link list of each cell
+    std::unordered_map<size_t, uint32_t> _slots; //< slots of the elements indexed by id
+    std::vector<Element> _elements;             //< pooled element storage indexed by slot
+    uint32_t _freeElement;                      //< head of the free list of element slots
+    std::vector<Link> _links;                   //< pooled link storage
+    uint32_t _freeLink;                         //< head of the free list of links
+
+    mutable uint32_t _queryStamp;               //< id of the current query
+};
+
+} //namespace Ego
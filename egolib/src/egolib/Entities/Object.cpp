@@ -897,17 +897,17 @@ void Object::update()
 
         //Give Rally bonus to friends within 6 tiles
         if(hasPerk(Ego::Perks::RALLY)) {
-            std::vector<std::shared_ptr<Object>> nearbyObjects = _currentModule->getObjectHandler().findObjects(getPosX(), getPosY(), WIDE, false);
-            for(const std::shared_ptr<Object> &object : nearbyObjects)
+            const AxisAlignedBox2f searchArea(Point2f(getPosX() - WIDE, getPosY() - WIDE), Point2f(getPosX() + WIDE, getPosY() + WIDE));
+            _currentModule->getObjectHandler().visitObjects(searchArea, [this](const std::shared_ptr<Object> &object)
             {
                 //Only valid objects that are on our team
-                if(object->isTerminated() || object->getTeam() != getTeam()) continue;
+                if(object->isTerminated() || object->getTeam() != getTeam()) return;
 
                 //Don't give bonus to ourselves!
-                if(object.get() == this) continue;
+                if(object.get() == this) return;
 
                 object->_reallyDuration = update_wld + GameEngine::GAME_TARGET_UPS*3;    //Apply bonus for 3 seconds
-            }
+            }, false);
         }
     }
 
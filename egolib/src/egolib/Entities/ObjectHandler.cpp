@@ -33,6 +33,8 @@ bool INGAME_PCHR(const Object *pobj)
     return (nullptr != pobj) && !pobj->isTerminated();
 }
 
+const float ObjectHandler::SPATIAL_INDEX_CELL_SIZE = 2.0f * Info<float>::Grid::Size();
+
 ObjectHandler::ObjectHandler() :
 	_internalCharacterList(),
     _iteratorList(),
@@ -42,8 +44,7 @@ ObjectHandler::ObjectHandler() :
     _deletedCharacters(0),
     _totalCharactersSpawned(0),
     _dynamicObjects(),
-    _staticObjects(),
-    _updateStaticTreeClock(0)
+    _staticObjects()
 {
     _iteratorList.reserve(OBJECTS_MAX);
 }
@@ -167,7 +168,8 @@ void ObjectHandler::clear()
 {
 	_internalCharacterList.clear();
 	_iteratorList.clear();
-    _dynamicObjects.clear(0, 0, 0, 0);
+    _dynamicObjects.reset(0, 0, 0, 0, SPATIAL_INDEX_CELL_SIZE);
+    _staticObjects.reset(0, 0, 0, 0, SPATIAL_INDEX_CELL_SIZE);
     _deletedCharacters = 0;
     _totalCharactersSpawned = 0;
 }
@@ -240,6 +242,7 @@ void ObjectHandler::maybeRunDeferred()
                 {
                     //Delete this character
                     _deletedCharacters--;
+                    removeFromSpatialIndex(element->getObjRef());
 
                     // Make sure everyone knows it died
                     for (const std::shared_ptr<Object>& chr : _iteratorList)
@@ -298,34 +301,38 @@ size_t ObjectHandler::getObjectCount() const
     return _iteratorList.size() + _allocateList.size() - _deletedCharacters;
 }
 
-void ObjectHandler::updateQuadTree(float minX, float minY, float maxX, float maxY)
+void ObjectHandler::removeFromSpatialIndex(ObjectRef ref)
 {
-    //Reset quad-tree
-    _dynamicObjects.clear(minX, minY, maxX, maxY);
-
-    //Rebuild the static quad tree only once per second
-    bool updateStaticQuadTree = false;
-    if(_updateStaticTreeClock <= 0) {
-        _updateStaticTreeClock = ONESECOND;
-        updateStaticQuadTree = true;
-        _staticObjects.clear(minX, minY, maxX, maxY);
-    }
-    else {
-        _updateStaticTreeClock--;
+    _dynamicObjects.remove(ref.get());
+    _staticObjects.remove(ref.get());
+}
+
+void ObjectHandler::updateSpatialIndex(float minX, float minY, float maxX, float maxY)
+{
+    //Level bounds changed? Start from scratch
+    if(!_dynamicObjects.hasLayout(minX, minY, maxX, maxY, SPATIAL_INDEX_CELL_SIZE)) {
+        _dynamicObjects.reset(minX, minY, maxX, maxY, SPATIAL_INDEX_CELL_SIZE);
+        _staticObjects.reset(minX, minY, maxX, maxY, SPATIAL_INDEX_CELL_SIZE);
     }
 
-    //Rebuild quad-tree
+    //Relink objects which moved to other cells
     for(const std::shared_ptr<Object> &object : _iteratorList) {
+        const size_t id = object->getObjRef().get();
+
         //Do not add objects that cannot interact with the rest of the world
-        if(object->isTerminated() || object->isHidden()) continue;
+        if(object->isTerminated() || object->isHidden()) {
+            removeFromSpatialIndex(object->getObjRef());
+            continue;
+        }
 
+        //Objects can change from dynamic to static and vice versa (e.g. team change)
         if(object->isScenery()) {
-            if(updateStaticQuadTree) {
-                _staticObjects.insert(object);
-            }
+            _dynamicObjects.remove(id);
+            _staticObjects.update(id, object);
         }
         else {
-            _dynamicObjects.insert(object);
+            _staticObjects.remove(id);
+            _dynamicObjects.update(id, object);
         }
     }
 }
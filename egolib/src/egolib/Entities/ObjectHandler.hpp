@@ -27,7 +27,7 @@
 #endif
 
 #include "egolib/game/egoboo.h"
-#include "egolib/Core/QuadTree.hpp"
+#include "egolib/Core/SpatialGrid.hpp"
 
 //Forward declarations
 class Object;
@@ -153,8 +153,7 @@ public:
 
 	/**
 	* @brief
-	*	Find all elements that are within range of a specified point in this QuadTree's
-	*	bounding box
+	*	Find all elements that are within range of a specified point
 	* @param x
 	*	x position of point to search from
 	* @param y
@@ -182,12 +181,34 @@ public:
 
 	/**
 	* @brief
-	* 	Clear and rebuild the quad tree for this update frame
+	*	Invoke a visitor for all elements that collide with a 2D bounding box area.
+	*	Unlike findObjects() this does not build a result vector. Each object is visited at most once.
+	* @param searchArea
+	*	The bounding box to scan
+	* @param visitor
+	*	functor of signature <tt>void(const std::shared_ptr<Object>&)</tt>.
+	*	It must not query this ObjectHandler or update its spatial index.
+	* @param includeSceneryObjects
+	*	if true, it will also include Scenery objects in the search as defined by Object::isScenery()
+	**/
+	template<typename Visitor>
+	void visitObjects(const AxisAlignedBox2f &searchArea, Visitor&& visitor, bool includeSceneryObjects = true) const
+	{
+		if(includeSceneryObjects) {
+			_staticObjects.find(searchArea, visitor);
+		}
+		_dynamicObjects.find(searchArea, visitor);
+	}
+
+	/**
+	* @brief
+	* 	Update the spatial index for this update frame. Objects are only relinked if they moved
+	*	to other cells, the index is only rebuilt from scratch if the bounds change.
 	*	This function is NOT thread-safe
 	* @param minX, minY, maxX, maxY
-	*	Sets the bounds of this quad tree (size of the entire current level)
+	*	Sets the bounds of the spatial index (size of the entire current level)
 	**/
-	void updateQuadTree(float minX, float minY, float maxX, float maxY);
+	void updateSpatialIndex(float minX, float minY, float maxX, float maxY);
 
 	/**
 	* @return
@@ -214,6 +235,12 @@ private:
 	 */
 	void maybeRunDeferred();
 
+	/**
+	 * @brief
+	 *	Remove an object from the spatial index.
+	 */
+	void removeFromSpatialIndex(ObjectRef ref);
+
 #if defined(_DEBUG)
 	/**
 	 * @brief
@@ -223,9 +250,11 @@ private:
 #endif
 
 private:
-	Ego::QuadTree<Object> _dynamicObjects;			//Objects that can move (Creatures, moving platforms, etc.)
-	Ego::QuadTree<Object> _staticObjects;			//Objects that rarely move - if ever (Trees, pillars, chairs)
-	int _updateStaticTreeClock;
+	/// Width and height of a spatial index cell (in world units).
+	static const float SPATIAL_INDEX_CELL_SIZE;
+
+	Ego::SpatialGrid<Object> _dynamicObjects;		//Objects that can move (Creatures, moving platforms, etc.)
+	Ego::SpatialGrid<Object> _staticObjects;		//Objects that rarely move - if ever (Trees, pillars, chairs)
 
 	std::unordered_map<ObjectRef, std::shared_ptr<Object>> _internalCharacterList; ///< Maps object references to shared pointers to objects
 	std::vector<std::shared_ptr<Object>> _iteratorList;					///< For iterating, contains only valid objects (unsorted)
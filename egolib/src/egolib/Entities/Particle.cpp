@@ -30,6 +30,7 @@
 #include "egolib/game/game.h"
 #include "egolib/game/Physics/PhysicalConstants.hpp"
 #include "egolib/game/CharacterMatrix.h"
+#include "egolib/Core/CommandBuffer.hpp"
 
 namespace Ego
 {
@@ -767,18 +768,30 @@ void Particle::playSound(int8_t sound)
         return;
     }
 
+    SoundID soundID = INVALID_SOUND_ID;
+
     //If we were spawned by an Object, then use that Object's sound pool
     const std::shared_ptr<ObjectProfile> &profile = ProfileSystem::get().getProfile(_spawnerProfile);
     if (profile) {
-        AudioSystem::get().playSound(getPosition(), profile->getSoundID(sound));
+        soundID = profile->getSoundID(sound);
     }
 
     //Else we are a global particle and use global particle sounds
     else if (sound >= 0 && sound < GSND_COUNT)
     {
         GlobalSound globalSound = static_cast<GlobalSound>(sound);
-        AudioSystem::get().playSound(getPosition(), AudioSystem::get().getGlobalSound(globalSound));
+        soundID = AudioSystem::get().getGlobalSound(globalSound);
+    }
+    else {
+        return;
     }
+
+    //The audio system is not thread-safe, defer if we are updated by a physics job
+    const Vector3f position = getPosition();
+    Ego::CommandBuffer::submit([position, soundID]
+    {
+        AudioSystem::get().playSound(position, soundID);
+    });
 }
 
 bool Particle::initialize(const ParticleRef particleID, const Vector3f& spawnPos, const Facing& spawnFacing, ObjectProfileRef spawnProfile,
@@ -1338,7 +1351,7 @@ bool Particle::canCollide() const
     //Has collision size?
     /// @todo this is a stopgap solution, figure out if this is the correct place or
     ///       we need to fix the loop in fill_interaction_list instead
-    if(getProfile()->bump_height <= 0 && getProfile()->bump_size <= 0) {
+    if(!getProfile()->canEverCollide()) {
         return false;
     }
 
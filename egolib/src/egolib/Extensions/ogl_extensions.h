@@ -26,7 +26,6 @@
 #pragma once
 
 #include "egolib/platform.h"
-#define GLEW_STATIC
 #include <GL/glew.h>
 
 //--------------------------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file  egolib/Graphics/ImageDecoder.cpp
+/// @brief Decoding of images from the vfs in background threads.
+
+#include "egolib/Graphics/ImageDecoder.hpp"
+#include "egolib/Image/ImageManager.hpp"
+#include "egolib/Image/ImageLoader.hpp"
+#include "egolib/vfs.h"
+
+namespace Ego {
+
+ImageDecoder::ImageDecoder(size_t threads) :
+    _threads(threads),
+    _pending()
+{}
+
+ImageDecoder::~ImageDecoder() {
+    wait();
+}
+
+std::shared_future<ImageDecoder::DecodedImage> ImageDecoder::submit(const std::string& filename) {
+    // Forget the images decoded already.
+    _pending.erase(std::remove_if(_pending.begin(), _pending.end(),
+                                  [](const std::shared_future<DecodedImage>& image) { return image.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }),
+                   _pending.end());
+    auto image = _threads.submit(&ImageDecoder::decode, filename).share();
+    _pending.push_back(image);
+    return image;
+}
+
+void ImageDecoder::wait() {
+    for (const auto& image : _pending) {
+        image.wait();
+    }
+    _pending.clear();
+}
+
+ImageDecoder::DecodedImage ImageDecoder::decode(const std::string& filename) {
+    // Try all different formats.
+    for (const auto& loader : ImageManager::get()) {
+        for (const auto& extension : loader.getExtensions()) {
+            // Build the full file name.
+            std::string fullFilename = filename + extension;
+            // Open the file.
+            vfs_FILE *file = vfs_openRead(fullFilename);
+            if (!file) {
+                continue;
+            }
+            // Stream the surface.
+            std::shared_ptr<SDL_Surface> surface = nullptr;
+            try {
+                surface = loader.load(file);
+            } catch (...) {
+                vfs_close(file);
+                continue;
+            }
+            vfs_close(file);
+            if (!surface) {
+                continue;
+            }
+            return std::make_pair(fullFilename, surface);
+        }
+    }
+    return std::make_pair(std::string(), nullptr);
+}
+
+} // namespace Ego
@@ -0,0 +1,69 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file  egolib/Graphics/ImageDecoder.hpp
+/// @brief Decoding of images from the vfs in background threads.
+
+#pragma once
+
+#include "egolib/typedef.h"
+#include "egolib/Core/ThreadPool.hpp"
+#include <SDL.h>
+#undef main
+
+namespace Ego {
+
+/// @brief Decodes images from the vfs in background threads.
+/// @remark The decoding threads read from the vfs, which is not safe while its mount points change.
+/// Call wait() before the mount points change. This class itself is not thread-safe.
+class ImageDecoder : private idlib::non_copyable {
+public:
+    /// @brief A decoded image and the name of the file it was decoded from.
+    using DecodedImage = std::pair<std::string, std::shared_ptr<SDL_Surface>>;
+
+    /// @brief Construct this image decoder.
+    /// @param threads the number of decoding threads
+    explicit ImageDecoder(size_t threads);
+
+    /// @brief Destruct this image decoder, waiting for the images being decoded.
+    ~ImageDecoder();
+
+    /// @brief Decode an image in the background.
+    /// @param filename the filename of the image <em>without</em> extension
+    /// @return the future of the decoded image, see decode()
+    std::shared_future<DecodedImage> submit(const std::string& filename);
+
+    /// @brief Wait until all submitted images are decoded.
+    void wait();
+
+    /// @brief Decode an image.
+    /// @param filename the filename of the image <em>without</em> extension
+    /// @return the full filename and the image on success, an empty filename and a null pointer on failure.
+    /// The filenames this function considers are all combinations of the specified filename concatenated
+    /// with supported file extensions until one combination succeeds or all combinations failed.
+    /// @remark This function does not need an OpenGL context, it may be called from any thread.
+    static DecodedImage decode(const std::string& filename);
+
+private:
+    ThreadPool _threads;
+    /// @brief The images submitted since the last call to wait().
+    std::vector<std::shared_future<DecodedImage>> _pending;
+};
+
+} // namespace Ego
@@ -47,6 +47,48 @@ float MD2Model::getMD2Normal(size_t normal, size_t index)
 	return MD2_NORMALS[normal][index];
 }
 
+float MD2Model::getEnviroX(size_t normal)
+{
+    static const std::array<float, normalCount> table = []()
+    {
+        std::array<float, normalCount> result;
+        for (size_t i = 0; i < normalCount; ++i)
+        {
+            result[i] = std::atan2(MD2_NORMALS[i][1], MD2_NORMALS[i][0]) * idlib::inv_two_pi<float>();
+        }
+        return result;
+    }();
+    return table[normal];
+}
+
+void MD2_FrameArrays::assign(const std::vector<MD2_Vertex>& vertices)
+{
+    const size_t size = (vertices.size() + blockSize - 1) / blockSize * blockSize;
+    for (std::vector<float> *array : { &posX, &posY, &posZ, &nrmX, &nrmY, &nrmZ, &envX })
+    {
+        array->assign(size, 0.0f);
+    }
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const MD2_Vertex& vertex = vertices[i];
+        posX[i] = vertex.pos[kX];
+        posY[i] = vertex.pos[kY];
+        posZ[i] = vertex.pos[kZ];
+        nrmX[i] = vertex.nrm[kX];
+        nrmY[i] = vertex.nrm[kY];
+        nrmZ[i] = vertex.nrm[kZ];
+        envX[i] = MD2Model::getEnviroX(vertex.normal);
+    }
+}
+
+void MD2Model::updateFrameArrays()
+{
+    for (MD2_Frame &frame : _frames)
+    {
+        frame.arrays.assign(frame.vertexList);
+    }
+}
+
 void MD2Model::scaleModel(const float scaleX, const float scaleY, const float scaleZ)
 {
     for(MD2_Frame &frame : _frames)
@@ -98,6 +140,8 @@ void MD2Model::scaleModel(const float scaleX, const float scaleY, const float sc
         }
 #endif
     }
+
+    updateFrameArrays();
 }
 
 void MD2Model::makeEquallyLit()
@@ -109,6 +153,8 @@ void MD2Model::makeEquallyLit()
 	        vertex.normal = MD2Model::normalCount -1;
 	    }
 	}
+
+	updateFrameArrays();
 }
 
 std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
@@ -330,5 +376,7 @@ std::shared_ptr<MD2Model> MD2Model::loadFromFile(const std::string &fileName)
     // Close the file, we're done with it
     vfs_close(f);
 
+    model->updateFrameArrays();
+
     return model;
 }
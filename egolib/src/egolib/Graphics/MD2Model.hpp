@@ -71,6 +71,35 @@ public:
     std::vector<id_glcmd_packed_t> 	data;
 };
 
+/**
+* @brief
+*   A structure-of-arrays copy of the vertices of a frame, as read by the keyframe interpolation kernel.
+*   Every array holds the same number of entries, a multiple of blockSize. The padding is zero.
+**/
+class MD2_FrameArrays
+{
+public:
+    /// The number of vertices the interpolation kernel processes at once.
+    static constexpr size_t blockSize = 4;
+
+    MD2_FrameArrays() :
+        posX(), posY(), posZ(),
+        nrmX(), nrmY(), nrmZ(),
+        envX()
+    {
+        //ctor
+    }
+
+    /**
+    * @brief rebuild the arrays from the specified vertices
+    **/
+    void assign(const std::vector<MD2_Vertex>& vertices);
+
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> nrmX, nrmY, nrmZ;
+    std::vector<float> envX;  ///< environment map x-coordinate of the normal
+};
+
 class MD2_Frame
 {
 public:
@@ -79,6 +108,7 @@ public:
 		name(),
 #endif
 		vertexList(),
+		arrays(),
 		bb(),
 		framelip(0),
 		framefx(EMPTY_BIT_FIELD)
@@ -89,6 +119,7 @@ public:
     char name[16];
 
     std::vector<MD2_Vertex> vertexList;
+    MD2_FrameArrays arrays;  ///< copy of vertexList for the interpolation kernel
 
     oct_bb_t bb;        ///< axis-aligned octagonal bounding box limits
     int framelip;       ///< the position in the current animation
@@ -127,7 +158,17 @@ public:
 
 	static float getMD2Normal(size_t normal, size_t index);
 
+	/**
+	* @return the environment map x-coordinate of a normal, atan2(y, x) / 2pi
+	**/
+	static float getEnviroX(size_t normal);
+
 private:
+	/**
+	* @brief rebuild the structure-of-arrays copies of all frames after the vertices were changed
+	**/
+	void updateFrameArrays();
+
 	size_t 					   	     _vertices;
     std::vector<MD2_SkinName>  	     _skins;
     std::vector<MD2_TexCoord>  	     _texCoords;
@@ -2,7 +2,6 @@
 
 #include "egolib/Graphics/SDL/GraphicsWindow.hpp"
 #include "egolib/egoboo_setup.h"
-#define GLEW_STATIC
 #include <GL/glew.h>
 
 namespace Ego {
@@ -23,8 +23,10 @@
 #include "egolib/_math.h"
 #include "egolib/fileutil.h"
 #include "egolib/Graphics/TextureManager.hpp"
+#include "egolib/Graphics/ImageDecoder.hpp"
 #include "egolib/Image/ImageManager.hpp"
 #include "egolib/Image/ImageLoader.hpp"
+#include "egolib/egoboo_setup.h"
 
 /**
  * @brief
@@ -44,44 +46,27 @@
  */
 static bool ego_texture_load_vfs(std::shared_ptr<Ego::Texture> texture, const char *filename);
 
-static bool ego_texture_load_vfs(std::shared_ptr<Ego::Texture> texture, const char *filename) {
+/**
+ * @brief
+ *  Load a decoded image into a texture.
+ * @param [out] texture
+ *  the texture to load the image in
+ * @param filename
+ *  the filename of the image <em>without</em> extension.
+ * @param image
+ *  the full filename and the image as returned by Ego::ImageDecoder::decode()
+ */
+static bool ego_texture_upload(std::shared_ptr<Ego::Texture> texture, const char *filename, const std::pair<std::string, std::shared_ptr<SDL_Surface>>& image);
+
+static bool ego_texture_upload(std::shared_ptr<Ego::Texture> texture, const char *filename, const std::pair<std::string, std::shared_ptr<SDL_Surface>>& image) {
     // Get rid of any old data.
     texture->release();
 
-    // Load the image.
+    // Create the texture from the surface.
     bool retval = false;
-
-    // Try all different formats.
-    for (const auto& loader : Ego::ImageManager::get()) {
-        for (const auto& extension : loader.getExtensions()) {
-            texture->release();
-            // Build the full file name.
-            std::string fullFilename = filename + extension;
-            // Open the file.
-            vfs_FILE *file = vfs_openRead(fullFilename);
-            if (!file) {
-                continue;
-            }
-            // Stream the surface.
-            std::shared_ptr<SDL_Surface> surface = nullptr;
-            try {
-                surface = loader.load(file);
-            } catch (...) {
-                vfs_close(file);
-                continue;
-            }
-            vfs_close(file);
-            if (!surface) {
-                continue;
-            }
-            // Create the texture from the surface.
-            retval = texture->load(fullFilename, surface);
-            if (retval) {
-                goto End;
-            }
-        }
+    if (image.second) {
+        retval = texture->load(image.first, image.second);
     }
-End:
     if (!retval) {
         auto resolved = vfs_resolveReadFilename(filename);
         Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load texture file ", "`", resolved.second, "`", Log::EndOfEntry);
@@ -90,6 +75,10 @@ End:
     return retval;
 }
 
+static bool ego_texture_load_vfs(std::shared_ptr<Ego::Texture> texture, const char *filename) {
+    return ego_texture_upload(texture, filename, Ego::ImageDecoder::decode(filename));
+}
+
 
 //--------------------------------------------------------------------------------------------
 
@@ -97,15 +86,31 @@ namespace Ego {
 TextureManager::TextureManager() :
     _deferredLoadingMutex(),
     _requestedLoadDeferredTextures(),
-    _notifyDeferredLoadingComplete()
+    _notifyDeferredLoadingComplete(),
+    _streamingMutex(),
+    _streamingRequests(),
+    _streamingSequence(0),
+    _decoder()
 {}
 
 TextureManager::~TextureManager() {
+    // Wait for the decoding threads.
+    _decoder = nullptr;
+    _streamingRequests.clear();
     _textureCache.clear();
     _unload.clear();
 }
 
 void TextureManager::release_all() {
+    {
+        // The pending textures are released with the cache.
+        // Wait for the images being decoded first, the mount points of the vfs change next.
+        std::lock_guard<std::mutex> lock(_streamingMutex);
+        if (_decoder) {
+            _decoder->wait();
+        }
+        _streamingRequests.clear();
+    }
     if (SDL_GL_GetCurrentContext() != nullptr) {
         // We are the main OpenGL context thread so we can destroy textures.
         _textureCache.clear();
@@ -143,6 +148,15 @@ void TextureManager::updateDeferredLoading() {
 }
 
 const std::shared_ptr<Texture>& TextureManager::getTexture(const std::string &filePath) {
+    //Requested by requestTexture() but not uploaded yet? Finish it now
+    if (SDL_GL_GetCurrentContext() != nullptr) {
+        std::lock_guard<std::mutex> lock(_streamingMutex);
+        auto request = _streamingRequests.find(filePath);
+        if (request != _streamingRequests.end()) {
+            finishStreaming(request);
+        }
+    }
+
     //Not loaded yet?
     const auto &result = _textureCache.find(filePath);
     if (result == _textureCache.end()) {
@@ -168,4 +182,87 @@ const std::shared_ptr<Texture>& TextureManager::getTexture(const std::string &fi
     }
 }
 
+std::shared_ptr<Texture> TextureManager::requestTexture(const std::string &filePath, bool& pending) {
+    pending = false;
+    if (!egoboo_config_t::get().graphic_textureStreaming_enable.getValue() || SDL_GL_GetCurrentContext() == nullptr) {
+        return getTexture(filePath);
+    }
+
+    std::lock_guard<std::mutex> lock(_streamingMutex);
+
+    //Pending? Raise its priority
+    auto request = _streamingRequests.find(filePath);
+    if (request != _streamingRequests.end()) {
+        request->second.priority++;
+        pending = true;
+        return request->second.texture;
+    }
+
+    //Already loaded?
+    auto result = _textureCache.find(filePath);
+    if (result != _textureCache.end()) {
+        return result->second;
+    }
+
+    if (!_decoder) {
+        _decoder = std::make_unique<ImageDecoder>(2);
+    }
+
+    //Hand out the texture bound to the default texture and decode the image in the background
+    StreamingRequest newRequest;
+    newRequest.texture = Ego::Renderer::get().createTexture();
+    newRequest.priority = 1;
+    newRequest.sequence = _streamingSequence++;
+    newRequest.image = _decoder->submit(filePath);
+    _textureCache[filePath] = newRequest.texture;
+    pending = true;
+    return _streamingRequests.emplace(filePath, std::move(newRequest)).first->second.texture;
+}
+
+void TextureManager::finishStreaming(std::unordered_map<std::string, StreamingRequest>::iterator request) {
+    auto texture = request->second.texture;
+    DecodedImage image = request->second.image.get();
+    const std::string filePath = request->first;
+    _streamingRequests.erase(request);
+    try {
+        ego_texture_upload(texture, filePath.c_str(), image);
+    } catch (...) {
+        Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to upload texture ", "`", filePath, "`", Log::EndOfEntry);
+    }
+}
+
+void TextureManager::updateStreaming() {
+    std::lock_guard<std::mutex> lock(_streamingMutex);
+    if (_streamingRequests.empty()) return;
+
+    size_t budget = size_t(egoboo_config_t::get().graphic_textureStreamingBudget_max.getValue()) * 1024;
+    bool uploaded = false;
+    while (true) {
+        //Find the decoded image with the highest priority
+        auto best = _streamingRequests.end();
+        for (auto it = _streamingRequests.begin(); it != _streamingRequests.end(); ++it) {
+            if (it->second.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+            if (best == _streamingRequests.end() || it->second.priority > best->second.priority ||
+                (it->second.priority == best->second.priority && it->second.sequence < best->second.sequence)) {
+                best = it;
+            }
+        }
+        if (best == _streamingRequests.end()) {
+            break;
+        }
+
+        //Upload it if it fits into the budget, the first image of a frame is always uploaded
+        const DecodedImage& image = best->second.image.get();
+        const size_t size = image.second ? size_t(image.second->pitch) * size_t(image.second->h) : 0;
+        if (uploaded && size > budget) {
+            break;
+        }
+        finishStreaming(best);
+        budget -= std::min(budget, size);
+        uploaded = true;
+    }
+}
+
 } // namespace Ego
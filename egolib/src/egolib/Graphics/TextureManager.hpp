@@ -24,6 +24,7 @@
 
 #include "egolib/typedef.h"
 #include "egolib/Renderer/Renderer.hpp"
+#include "egolib/Graphics/ImageDecoder.hpp"
 
 namespace Ego {
 
@@ -60,6 +61,8 @@ public:
     /**
      * @brief
      *  Release all textures.
+     * @remark
+     *  Waits for the images being decoded, hence the mount points of the vfs may change afterwards.
      */
     void release_all();
 
@@ -80,10 +83,57 @@ public:
 
     void updateDeferredLoading();
 
+    /**
+     * @brief
+     *  Request a texture from the TextureHandler without waiting for it to be loaded. If the texture
+     *  is not loaded yet, its image is decoded by a background thread and uploaded by updateStreaming().
+     *  Until then, the returned texture is bound to the default texture.
+     * @param filePath
+     *  File path of the texture to load
+     * @param [out] pending
+     *  set to @a true if the texture is not uploaded yet, to @a false otherwise
+     * @return
+     *  The texture loaded by this texture manager.
+     * @remark
+     *  Requesting a pending texture again raises its priority. If streaming is disabled or if this is not
+     *  the OpenGL context thread, the texture is loaded like by getTexture().
+     */
+    std::shared_ptr<Texture> requestTexture(const std::string &filePath, bool& pending);
+
+    /**
+     * @brief
+     *  Upload the decoded images of requested textures in the order of their priority until the upload
+     *  budget of this frame is exhausted. At least one texture is uploaded if one is decoded.
+     * @remark
+     *  Must be called from the OpenGL context thread.
+     */
+    void updateStreaming();
+
 private:
+    using DecodedImage = ImageDecoder::DecodedImage;
+
+    /// @brief A texture requested by requestTexture() which is not uploaded yet.
+    struct StreamingRequest {
+        std::shared_ptr<Texture> texture;
+        /// @brief The number of times the texture was requested.
+        size_t priority;
+        /// @brief The order of the request, older requests win ties.
+        size_t sequence;
+        std::shared_future<DecodedImage> image;
+    };
+
+    /// @brief Upload the image of a streaming request into its texture and remove the request.
+    void finishStreaming(std::unordered_map<std::string, StreamingRequest>::iterator request);
+
     std::forward_list<std::shared_ptr<Texture>> _unload;
     std::unordered_map<std::string, std::shared_ptr<Texture>> _textureCache;
 
+    std::mutex _streamingMutex;
+    std::unordered_map<std::string, StreamingRequest> _streamingRequests;
+    size_t _streamingSequence;
+    /// @brief The threads decoding images, created on the first request.
+    std::unique_ptr<ImageDecoder> _decoder;
+
     std::mutex _deferredLoadingMutex;
     std::forward_list<std::string> _requestedLoadDeferredTextures;
     std::condition_variable _notifyDeferredLoadingComplete;
@@ -46,6 +46,8 @@ DefaultTarget::~DefaultTarget() {
 
 void DefaultTarget::writev(Level level, const char *format, va_list args) {
 	char logBuffer[MAX_LOG_MESSAGE] = EMPTY_CSTR;
+	// The colour, the prefix and the message of concurrent log messages must not interleave.
+	std::lock_guard<std::mutex> lock(_mutex);
 
 	// Add prefix
 	const char *prefix;
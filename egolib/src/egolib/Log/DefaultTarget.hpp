@@ -24,6 +24,7 @@
 
 #include "egolib/Log/Target.hpp"
 #include "egolib/vfs.h"
+#include <mutex>
 
 namespace Log {
 
@@ -34,6 +35,11 @@ private:
 	*  The log file.
 	*/
 	vfs_FILE *_file;
+	/**
+	* @brief
+	*  Serializes the messages of threads logging concurrently.
+	*/
+	std::mutex _mutex;
 public:
 	DefaultTarget(const std::string& filename, Level level = Level::Warning);
 	virtual ~DefaultTarget();
@@ -19,6 +19,8 @@
 
 #define EGOLIB_PROFILES_PRIVATE 1
 #include "egolib/Profiles/EnchantProfile.hpp"
+#include "egolib/Profiles/ProfileCache.hpp"
+#include "egolib/egoboo_setup.h"
 #include "egolib/Audio/AudioSystem.hpp"
 #include "egolib/Core/StringUtilities.hpp"
 #include "egolib/fileutil.h"
@@ -87,6 +89,16 @@ std::shared_ptr<EnchantProfile> EnchantProfile::readFromFile(const std::string&
 {
     std::shared_ptr<EnchantProfile> profile = std::make_shared<EnchantProfile>();
 
+    // Use the profile from the profile cache if there is a valid entry for its source.
+    uint64_t sourceHash = 0;
+    const bool useCache = egoboo_config_t::get().game_profileCache_enable.getValue()
+                       && Ego::ProfileCache::hash(pathname, sourceHash);
+    if (useCache && Ego::ProfileCache::load(sourceHash, *profile))
+    {
+        profile->_name = pathname;
+        return profile;
+    }
+
     std::unique_ptr<ReadContext> ctxt = nullptr;
     try {
         ctxt = std::make_unique<ReadContext>(pathname);
@@ -272,5 +284,10 @@ std::shared_ptr<EnchantProfile> EnchantProfile::readFromFile(const std::string&
     // Limit the endsound_index.
     profile->endsound_index = Ego::Math::constrain<int16_t>(profile->endsound_index, INVALID_SOUND_ID, MAX_WAVE);
 
+    if (useCache)
+    {
+        Ego::ProfileCache::store(sourceHash, *profile);
+    }
+
     return profile;
 }
@@ -29,6 +29,8 @@
 #include "egolib/IDSZ.hpp"
 #include "egolib/Logic/MissileTreatment.hpp"
 
+namespace Ego { class ProfileCache; }
+
 /**
 * @brief
 *  An enchantment profile, or "eve"
@@ -37,6 +39,8 @@
 */
 class EnchantProfile : public AbstractProfile
 {
+    friend class Ego::ProfileCache;
+
 public:
 
     /**
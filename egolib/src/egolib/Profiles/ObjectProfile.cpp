@@ -24,6 +24,7 @@
 
 #define EGOLIB_PROFILES_PRIVATE 1
 #include "egolib/Profiles/ObjectProfile.hpp"
+#include "egolib/Profiles/ProfileCache.hpp"
 #include "egolib/game/Core/GameEngine.hpp"
 #include "egolib/Entities/_Include.hpp"
 #include "egolib/Graphics/ModelDescriptor.hpp"
@@ -432,6 +433,15 @@ ObjectProfileRef vfs_get_next_object_profile_ref(ReadContext& ctxt)
 
 bool ObjectProfile::loadDataFile(const std::string &filePath)
 {
+    // Use the data from the profile cache if there is a valid entry for the file.
+    uint64_t sourceHash = 0;
+    const bool useCache = egoboo_config_t::get().game_profileCache_enable.getValue()
+                       && Ego::ProfileCache::hash(filePath, sourceHash);
+    if (useCache && Ego::ProfileCache::load(sourceHash, *this))
+    {
+        return true;
+    }
+
     // Open the file
     ReadContext ctxt(filePath);
 
@@ -922,6 +932,11 @@ bool ObjectProfile::loadDataFile(const std::string &filePath)
             break;
         }
     }
+
+    if (useCache)
+    {
+        Ego::ProfileCache::store(sourceHash, *this);
+    }
     return true;
 }
 
@@ -972,6 +987,19 @@ bool ObjectProfile::hasIDSZ(const IDSZ2& idsz) const
 }
 
 std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string& folderPath, ObjectProfileRef ref, bool lightWeight)
+{
+    std::shared_ptr<ObjectProfile> profile = parseFromFile(folderPath, ref, lightWeight);
+
+    //Don't load enchant, sounds or particle effects for lightweight profiles
+    if (profile && !lightWeight)
+    {
+        profile->loadSharedResources();
+    }
+
+    return profile;
+}
+
+std::shared_ptr<ObjectProfile> ObjectProfile::parseFromFile(const std::string& folderPath, ObjectProfileRef ref, bool lightWeight)
 {
     // Assert the reference is valid.
     if (!ref)
@@ -987,7 +1015,7 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string& fo
     profile->_pathname = folderPath;
     profile->_slotNumber = ref.get();
 
-    //Don't load 3d model, enchant, messages, sounds or particle effects for lightweight profiles
+    //Don't load 3d model or messages for lightweight profiles
     if (!lightWeight)
     {
         // Load the model for this profile
@@ -1001,37 +1029,9 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string& fo
             return nullptr;
         }
 
-        // Load the enchantment for this profile (optional)
-        profile->_ieve = ProfileSystem::get().EnchantProfileSystem.load(folderPath + "/enchant.txt", static_cast<EVE_REF>(ref.get()));
-
         // Load the messages for this profile, do this before loading the AI script
         // to ensure any dynamic loaded messages get loaded last (optional)
         profile->loadAllMessages(folderPath + "/message.txt");
-
-        // Load the particles for this profile (optional)
-        for (LocalParticleProfileRef cnt(0); cnt.get() < 30; ++cnt) //TODO: find better way of listing files
-        {
-            const std::string particleName = folderPath + "/part" + std::to_string(cnt.get()) + ".txt";
-            PIP_REF particleProfile = ProfileSystem::get().ParticleProfileSystem.load(particleName.c_str(), INVALID_PIP_REF);
-
-            // Make sure it's referenced properly
-            if (particleProfile != INVALID_PIP_REF)
-            {
-                profile->_particleProfiles[cnt] = particleProfile;
-            }
-        }
-
-        // Load the waves for this iobj
-        for (size_t cnt = 0; cnt < 30; cnt++) //TODO: make better search than just 30 (list files?)
-        {
-            const std::string soundName = folderPath + "/sound" + std::to_string(cnt);
-            SoundID soundID = AudioSystem::get().loadSound(soundName);
-
-            if (soundID != INVALID_SOUND_ID)
-            {
-                profile->_soundMap[cnt] = soundID;
-            }
-        }
     }
 
     //Load profile graphics (optional)
@@ -1041,7 +1041,6 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string& fo
     profile->_randomName.loadFromFile(folderPath + "/naming.txt");
 
     // Finally load the character profile
-    // Do after loading particle and sound profiles
     try
     {
         if (!profile->loadDataFile(folderPath + "/data.txt"))
@@ -1065,6 +1064,37 @@ std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string& fo
     return profile;
 }
 
+void ObjectProfile::loadSharedResources()
+{
+    // Load the enchantment for this profile (optional)
+    _ieve = ProfileSystem::get().EnchantProfileSystem.load(_pathname + "/enchant.txt", static_cast<EVE_REF>(_slotNumber.get()));
+
+    // Load the particles for this profile (optional)
+    for (LocalParticleProfileRef cnt(0); cnt.get() < 30; ++cnt) //TODO: find better way of listing files
+    {
+        const std::string particleName = _pathname + "/part" + std::to_string(cnt.get()) + ".txt";
+        PIP_REF particleProfile = ProfileSystem::get().ParticleProfileSystem.load(particleName.c_str(), INVALID_PIP_REF);
+
+        // Make sure it's referenced properly
+        if (particleProfile != INVALID_PIP_REF)
+        {
+            _particleProfiles[cnt] = particleProfile;
+        }
+    }
+
+    // Load the waves for this iobj
+    for (size_t cnt = 0; cnt < 30; cnt++) //TODO: make better search than just 30 (list files?)
+    {
+        const std::string soundName = _pathname + "/sound" + std::to_string(cnt);
+        SoundID soundID = AudioSystem::get().loadSound(soundName);
+
+        if (soundID != INVALID_SOUND_ID)
+        {
+            _soundMap[cnt] = soundID;
+        }
+    }
+}
+
 std::shared_ptr<ObjectProfile> ObjectProfile::loadFromFile(const std::string &folderPath, PRO_REF ref, const bool lightWeight)
 {
     return loadFromFile(folderPath, ObjectProfileRef(ref), lightWeight);
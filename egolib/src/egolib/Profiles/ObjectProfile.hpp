@@ -38,7 +38,7 @@
 //Forward declarations
 typedef int SoundID;
 class Object;
-namespace Ego { class ModelDescriptor; }
+namespace Ego { class ModelDescriptor; class ProfileCache; }
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -157,6 +157,8 @@ struct SkinInfo
 /// a wrapper for all the datafiles in the *.obj dir
 class ObjectProfile
 {
+    friend class Ego::ProfileCache;
+
 public:
     static constexpr uint16_t NO_SKIN_OVERRIDE = std::numeric_limits<uint16_t>::max();   ///< Means spawn.txt value is used
 
@@ -582,6 +584,19 @@ public:
     static std::shared_ptr<ObjectProfile> loadFromFile(const std::string& folderPath, PRO_REF ref, bool lightWeight = false);
     /// @}
 
+    /// @brief Read and parse the files of an object profile in a folder.
+    /// @param ref the object profile reference of the profile
+    /// @param lightWeight if @a true, then no 3D model and no messages are loaded (for menu)
+    /// @return the profile or a null pointer on failure
+    /// @remark Reads the model, the messages, the random names and data.txt and looks up the skins and icons.
+    /// Nothing is registered with other systems, hence this may be called from worker threads. The enchant,
+    /// the particle profiles and the sounds are loaded by loadSharedResources().
+    static std::shared_ptr<ObjectProfile> parseFromFile(const std::string& folderPath, ObjectProfileRef ref, bool lightWeight = false);
+
+    /// @brief Load the enchant, the particle profiles and the sounds of a parsed profile.
+    /// @remark These are registered with the profile and audio systems, hence this must not be called from worker threads.
+    void loadSharedResources();
+
     /**
     * @brief Writes the contents of this character instance to a profile data.txt file
     **/
@@ -19,6 +19,8 @@
 
 #define EGOLIB_PROFILES_PRIVATE 1
 #include "egolib/Profiles/ParticleProfile.hpp"
+#include "egolib/Profiles/ProfileCache.hpp"
+#include "egolib/egoboo_setup.h"
 #include "egolib/Audio/AudioSystem.hpp"
 #include "egolib/Core/StringUtilities.hpp"
 #include "egolib/fileutil.h"
@@ -161,6 +163,20 @@ ParticleProfile::~ParticleProfile()
 
 std::shared_ptr<ParticleProfile> ParticleProfile::readFromFile(const std::string& pathname)
 {
+    // Use the profile from the profile cache if there is a valid entry for its source.
+    uint64_t sourceHash = 0;
+    const bool useCache = egoboo_config_t::get().game_profileCache_enable.getValue()
+                       && Ego::ProfileCache::hash(pathname, sourceHash);
+    if (useCache)
+    {
+        std::shared_ptr<ParticleProfile> profile = std::make_shared<ParticleProfile>();
+        if (Ego::ProfileCache::load(sourceHash, *profile))
+        {
+            profile->_name = pathname;
+            return profile;
+        }
+    }
+
     char cTmp;
 
     std::unique_ptr<ReadContext> ctxt = nullptr;
@@ -420,6 +436,11 @@ std::shared_ptr<ParticleProfile> ParticleProfile::readFromFile(const std::string
     // Limit the soundspawn index.
     profile->soundspawn = Ego::Math::constrain<int8_t>(profile->soundspawn, INVALID_SOUND_ID, MAX_WAVE);
 
+    if (useCache)
+    {
+        Ego::ProfileCache::store(sourceHash, *profile);
+    }
+
     return profile;
 }
 
@@ -458,3 +479,14 @@ float ParticleProfile::getGravityPull() const
 {
     return _gravityPull;
 }
+
+bool ParticleProfile::canEverCollide() const
+{
+    //Particle is destroyed on any collision?
+    if(end_bump || end_ground) {
+        return true;
+    }
+
+    //Has collision size?
+    return bump_height > 0 || bump_size > 0;
+}
@@ -117,9 +117,13 @@ struct dynalight_info_t
     void reset();
 };
 
+namespace Ego { class ProfileCache; }
+
 /// The definition of a particle profile
 class ParticleProfile : public AbstractProfile
 {
+    friend class Ego::ProfileCache;
+
 public:
     /**
      * @brief
@@ -163,6 +167,14 @@ public:
     *   if it has a gravity push
     **/
     float getGravityPull() const;
+
+    /**
+    * @brief
+    *   Particles of this profile without a collision size are only bumped if they end on a collision.
+    * @return
+    *   false if particles of this profile can never collide with objects
+    **/
+    bool canEverCollide() const;
     
 public:
 
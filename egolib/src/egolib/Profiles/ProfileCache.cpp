@@ -0,0 +1,676 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/Profiles/ProfileCache.cpp
+/// @brief Cache of parsed profiles.
+
+#define EGOLIB_PROFILES_PRIVATE 1
+#include "egolib/Profiles/ProfileCache.hpp"
+#include "egolib/Profiles/_Include.hpp"
+#include "egolib/Core/CacheEntry.hpp"
+#include "egolib/vfs.h"
+
+namespace Ego {
+
+namespace {
+
+const char ParticleProfileMagic[CacheEntry::MagicSize] = { 'E', 'G', 'P', 'P' };
+const char EnchantProfileMagic[CacheEntry::MagicSize] = { 'E', 'G', 'E', 'P' };
+const char ObjectProfileMagic[CacheEntry::MagicSize] = { 'E', 'G', 'O', 'P' };
+
+const char *const CacheDirectory = "/cache/profiles";
+
+template <typename Visitor, typename Descriptor>
+void visitSpawnDescriptor(Visitor& visitor, Descriptor& descriptor)
+{
+    visitor(descriptor._amount);
+    visitor(descriptor._facingAdd);
+    visitor(descriptor._lpip);
+}
+
+template <typename Visitor, typename Descriptor>
+void visitContinuousSpawnDescriptor(Visitor& visitor, Descriptor& descriptor)
+{
+    visitSpawnDescriptor(visitor, descriptor);
+    visitor(descriptor._delay);
+}
+
+template <typename Visitor, typename Skin>
+void visitSkinInfo(Visitor& visitor, Skin& skin)
+{
+    visitor(skin.name);
+    visitor(skin.cost);
+    visitor(skin.maxAccel);
+    visitor(skin.dressy);
+    visitor(skin.defence);
+    visitor(skin.damageModifier);
+    visitor(skin.damageResistance);
+}
+
+/// Writes the fields of a profile into an entry. The sizes of arrays are written such that they can be verified.
+struct Encoder
+{
+    CacheEntry::Writer writer;
+
+    template <typename Type>
+    std::enable_if_t<std::is_integral<Type>::value || std::is_enum<Type>::value> operator()(const Type& value)
+    {
+        static_assert(sizeof(Type) <= sizeof(uint32_t), "unsupported integer size");
+        writer.writeUint32(static_cast<uint32_t>(value));
+    }
+
+    void operator()(const float& value)
+    {
+        writer.writeFloat(value);
+    }
+
+    void operator()(const std::string& value)
+    {
+        writer.writeString(value);
+    }
+
+    void operator()(const IPair& value)
+    {
+        (*this)(value.base);
+        (*this)(value.rand);
+    }
+
+    void operator()(const idlib::interval<float>& value)
+    {
+        (*this)(value.lower());
+        (*this)(value.upper());
+    }
+
+    void operator()(const IDSZ2& value)
+    {
+        writer.writeUint32(value.toUint32());
+    }
+
+    void operator()(const LocalParticleProfileRef& value)
+    {
+        (*this)(value.get());
+    }
+
+    template <size_t Size>
+    void operator()(const std::bitset<Size>& value)
+    {
+        writer.writeUint32(static_cast<uint32_t>(Size));
+        for (size_t i = 0; i < Size; ++i) writer.writeUint8(value[i] ? 1 : 0);
+    }
+
+    template <typename Type, size_t Size>
+    void operator()(const std::array<Type, Size>& value)
+    {
+        writer.writeUint32(static_cast<uint32_t>(Size));
+        for (const Type& element : value) (*this)(element);
+    }
+
+    template <typename Type, size_t Size>
+    void operator()(const Type (&value)[Size])
+    {
+        writer.writeUint32(static_cast<uint32_t>(Size));
+        for (const Type& element : value) (*this)(element);
+    }
+
+    void operator()(const std::unordered_map<size_t, SkinInfo>& value)
+    {
+        // Write the skins in the order of their indices such that equal profiles have equal entries.
+        std::vector<size_t> keys;
+        for (const auto& element : value) keys.push_back(element.first);
+        std::sort(keys.begin(), keys.end());
+        writer.writeUint32(static_cast<uint32_t>(keys.size()));
+        for (size_t key : keys)
+        {
+            writer.writeUint32(static_cast<uint32_t>(key));
+            visitSkinInfo(*this, value.at(key));
+        }
+    }
+};
+
+/// Reads the fields of a profile from an entry. Reading beyond the end of the entry or an array of another size
+/// raises the error flag of the reader.
+struct Decoder
+{
+    CacheEntry::Reader reader;
+
+    bool readSize(size_t size)
+    {
+        if (reader.readUint32() != size)
+        {
+            reader.error = true;
+        }
+        return !reader.error;
+    }
+
+    template <typename Type>
+    std::enable_if_t<std::is_integral<Type>::value || std::is_enum<Type>::value> operator()(Type& value)
+    {
+        static_assert(sizeof(Type) <= sizeof(uint32_t), "unsupported integer size");
+        value = static_cast<Type>(reader.readUint32());
+    }
+
+    void operator()(float& value)
+    {
+        value = reader.readFloat();
+    }
+
+    void operator()(std::string& value)
+    {
+        value = reader.readString();
+    }
+
+    void operator()(IPair& value)
+    {
+        (*this)(value.base);
+        (*this)(value.rand);
+    }
+
+    void operator()(idlib::interval<float>& value)
+    {
+        const float lower = reader.readFloat();
+        const float upper = reader.readFloat();
+        if (lower > upper)
+        {
+            reader.error = true;
+            return;
+        }
+        value = idlib::interval<float>(lower, upper);
+    }
+
+    void operator()(IDSZ2& value)
+    {
+        value = IDSZ2(reader.readUint32());
+    }
+
+    void operator()(LocalParticleProfileRef& value)
+    {
+        value = LocalParticleProfileRef(static_cast<int>(reader.readUint32()));
+    }
+
+    template <size_t Size>
+    void operator()(std::bitset<Size>& value)
+    {
+        if (!readSize(Size)) return;
+        for (size_t i = 0; i < Size; ++i) value[i] = (0 != reader.readUint8());
+    }
+
+    template <typename Type, size_t Size>
+    void operator()(std::array<Type, Size>& value)
+    {
+        if (!readSize(Size)) return;
+        for (Type& element : value) (*this)(element);
+    }
+
+    template <typename Type, size_t Size>
+    void operator()(Type (&value)[Size])
+    {
+        if (!readSize(Size)) return;
+        for (Type& element : value) (*this)(element);
+    }
+
+    void operator()(std::unordered_map<size_t, SkinInfo>& value)
+    {
+        value.clear();
+        const uint32_t size = reader.readUint32();
+        for (uint32_t i = 0; i < size && !reader.error; ++i)
+        {
+            const size_t key = reader.readUint32();
+            SkinInfo skin = SkinInfo();
+            visitSkinInfo(*this, skin);
+            value[key] = skin;
+        }
+    }
+};
+
+template <typename Profile>
+std::vector<char> encodeEntry(const char (&magic)[CacheEntry::MagicSize], uint64_t sourceHash, const Profile& profile,
+                              void (*visit)(Encoder&, const Profile&))
+{
+    std::vector<char> entry;
+    CacheEntry::begin(entry, magic, ProfileCache::getVersion(), sourceHash);
+    Encoder encoder{ CacheEntry::Writer{ entry } };
+    visit(encoder, profile);
+    CacheEntry::end(entry);
+    return entry;
+}
+
+template <typename Profile>
+bool decodeEntry(const char (&magic)[CacheEntry::MagicSize], const std::vector<char>& entry, uint64_t sourceHash, Profile& profile,
+                 void (*visit)(Decoder&, Profile&))
+{
+    size_t payloadBegin, payloadEnd;
+    if (!CacheEntry::open(entry, magic, ProfileCache::getVersion(), sourceHash, payloadBegin, payloadEnd))
+    {
+        return false;
+    }
+    Decoder decoder{ CacheEntry::Reader{ entry, payloadBegin, false } };
+    visit(decoder, profile);
+    // The entry must have been consumed up to the checksum.
+    return !decoder.reader.error && decoder.reader.position == payloadEnd;
+}
+
+std::string getPathname(uint64_t sourceHash, const char *extension)
+{
+    return CacheEntry::getPathname(ProfileCache::getDirectory(), sourceHash, extension);
+}
+
+template <typename Profile>
+bool loadEntry(const std::string& pathname, uint64_t sourceHash, Profile& profile)
+{
+    std::vector<char> entry;
+    if (!CacheEntry::load(pathname, entry))
+    {
+        return false;
+    }
+    // Decode into a scratch profile first such that the profile is not changed if the entry is invalid.
+    auto scratch = std::make_unique<Profile>();
+    return ProfileCache::decode(entry, sourceHash, *scratch)
+        && ProfileCache::decode(entry, sourceHash, profile);
+}
+
+} // namespace
+
+uint64_t ProfileCache::getVersion()
+{
+    static const uint64_t version = []()
+    {
+        const std::string format = "profiles " + std::to_string(FormatVersion);
+        return CacheEntry::hash(format.data(), format.size());
+    }();
+    return version;
+}
+
+bool ProfileCache::hash(const std::string& pathname, uint64_t& sourceHash)
+{
+    if (!vfs_exists(pathname))
+    {
+        return false;
+    }
+    std::vector<char> source;
+    try
+    {
+        vfs_readEntireFile(pathname, [&source](size_t numberOfBytes, const char *bytes) { source.insert(source.end(), bytes, bytes + numberOfBytes); });
+    }
+    catch (...)
+    {
+        return false;
+    }
+    sourceHash = CacheEntry::hash(source.data(), source.size());
+    return true;
+}
+
+template <typename Visitor, typename Profile>
+void ProfileCache::visitParticleProfile(Visitor& visitor, Profile& profile)
+{
+    visitor(profile._comment);
+    visitor(profile._particleEffectBits);
+    visitor(profile._gravityPull);
+    visitor(profile._spawnFacing);
+    visitor(profile._spawnPositionOffsetXY);
+    visitor(profile._spawnPositionOffsetZ);
+    visitor(profile._spawnVelocityOffsetXY);
+    visitor(profile._spawnVelocityOffsetZ);
+
+    // Spawning.
+    visitor(profile.soundspawn);
+    visitor(profile.force);
+    visitor(profile.newtargetonspawn);
+    visitor(profile.needtarget);
+    visitor(profile.startontarget);
+
+    // Ending conditions.
+    visitor(profile.end_time);
+    visitor(profile.end_water);
+    visitor(profile.end_bump);
+    visitor(profile.end_ground);
+    visitor(profile.end_wall);
+    visitor(profile.end_lastframe);
+    visitor(profile.end_sound);
+    visitor(profile.end_sound_floor);
+    visitor(profile.end_sound_wall);
+
+    visitContinuousSpawnDescriptor(visitor, profile.contspawn);
+    visitSpawnDescriptor(visitor, profile.endspawn);
+    visitSpawnDescriptor(visitor, profile.bumpspawn);
+
+    // Bumping.
+    visitor(profile.bump_money);
+    visitor(profile.bump_size);
+    visitor(profile.bump_height);
+
+    // Hitting.
+    visitor(profile.damage);
+    visitor(profile.damageType);
+    visitor(profile.dazeTime);
+    visitor(profile.grogTime);
+    visitor(profile._intellectDamageBonus);
+    visitor(profile.spawnenchant);
+    visitor(profile.onlydamagefriendly);
+    visitor(profile.friendlyfire);
+    visitor(profile.hateonly);
+    visitor(profile.cause_roll);
+    visitor(profile.cause_pancake);
+    visitor(profile.lifeDrain);
+    visitor(profile.manaDrain);
+
+    // Homing.
+    visitor(profile.homing);
+    visitor(profile.targetangle);
+    visitor(profile.homingaccel);
+    visitor(profile.homingfriction);
+    visitor(profile.zaimspd);
+    visitor(profile.rotatetoface);
+    visitor(profile.targetcaster);
+
+    // Physics.
+    visitor(profile.spdlimit);
+    visitor(profile.dampen);
+    visitor(profile.allowpush);
+    visitor(profile.ignore_gravity);
+
+    // Visual properties.
+    visitor(profile.dynalight.mode);
+    visitor(profile.dynalight.on);
+    visitor(profile.dynalight.level);
+    visitor(profile.dynalight.level_add);
+    visitor(profile.dynalight.falloff);
+    visitor(profile.dynalight.falloff_add);
+    visitor(profile.type);
+    visitor(profile.image_max);
+    visitor(profile.image_stt);
+    visitor(profile.image_add);
+    visitor(profile.rotate_pair);
+    visitor(profile.rotate_add);
+    visitor(profile.size_base);
+    visitor(profile.size_add);
+    visitor(profile.facingadd);
+    visitor(profile.orientation);
+}
+
+template <typename Visitor, typename Profile>
+void ProfileCache::visitEnchantProfile(Visitor& visitor, Profile& profile)
+{
+    // Enchant spawn description.
+    visitor(profile._override);
+    visitor(profile.remove_overridden);
+    visitor(profile.retarget);
+    visitor(profile.required_damagetype);
+    visitor(profile.require_damagetarget_damagetype);
+    visitor(profile.spawn_overlay);
+
+    // Enchant despawn conditions.
+    visitor(profile.lifetime);
+    visitor(profile.endIfCannotPay);
+    visitor(profile.removedByIDSZ);
+
+    // Relations to the owner and to the target.
+    visitor(profile._owner._stay);
+    visitor(profile._owner._manaDrain);
+    visitor(profile._owner._lifeDrain);
+    visitor(profile._target._stay);
+    visitor(profile._target._manaDrain);
+    visitor(profile._target._lifeDrain);
+
+    // Modifiers.
+    for (auto& modifier : profile._set)
+    {
+        visitor(modifier.apply);
+        visitor(modifier.value);
+    }
+    for (auto& modifier : profile._add)
+    {
+        visitor(modifier.apply);
+        visitor(modifier.value);
+    }
+    visitor(profile.seeKurses);
+    visitor(profile.darkvision);
+
+    visitContinuousSpawnDescriptor(visitor, profile.contspawn);
+
+    // What to do when the enchant ends.
+    visitor(profile.endsound_index);
+    visitor(profile.killtargetonend);
+    visitor(profile.poofonend);
+    visitor(profile.endmessage);
+
+    visitor(profile._enchantName);
+}
+
+template <typename Visitor, typename Profile>
+void ProfileCache::visitObjectProfile(Visitor& visitor, Profile& profile)
+{
+    // naming
+    visitor(profile._className);
+
+    // skins
+    visitor(profile._skinInfo);
+
+    // overrides
+    visitor(profile._skinOverride);
+    visitor(profile._levelOverride);
+    visitor(profile._stateOverride);
+    visitor(profile._contentOverride);
+
+    visitor(profile._idsz);
+
+    // inventory
+    visitor(profile._maxAmmo);
+    visitor(profile._ammo);
+    visitor(profile._money);
+
+    // characer stats
+    visitor(profile._gender);
+    visitor(profile._spawnLife);
+    visitor(profile._spawnMana);
+    visitor(profile._baseAttribute);
+    visitor(profile._attributeGain);
+
+    // physics
+    visitor(profile._weight);
+    visitor(profile._bounciness);
+    visitor(profile._bumpDampen);
+    visitor(profile._size);
+    visitor(profile._sizeGainPerLevel);
+    visitor(profile._shadowSize);
+    visitor(profile._bumpSize);
+    visitor(profile._bumpOverrideSize);
+    visitor(profile._bumpSizeBig);
+    visitor(profile._bumpOverrideSizeBig);
+    visitor(profile._bumpHeight);
+    visitor(profile._bumpOverrideHeight);
+    visitor(profile._stoppedBy);
+
+    // movement
+    visitor(profile._jumpPower);
+    visitor(profile._jumpNumber);
+    visitor(profile._animationSpeedSneak);
+    visitor(profile._animationSpeedWalk);
+    visitor(profile._animationSpeedRun);
+    visitor(profile._flyHeight);
+    visitor(profile._waterWalking);
+    visitor(profile._jumpSound);
+    visitor(profile._footFallSound);
+
+    // status graphics
+    visitor(profile._lifeColor);
+    visitor(profile._manaColor);
+    visitor(profile._drawIcon);
+
+    // model graphics
+    visitor(profile._flashAND);
+    visitor(profile._alpha);
+    visitor(profile._light);
+    visitor(profile._transferBlending);
+    visitor(profile._sheen);
+    visitor(profile._phongMapping);
+    visitor(profile._textureMovementRateX);
+    visitor(profile._textureMovementRateY);
+    visitor(profile._uniformLit);
+    visitor(profile._hasReflection);
+    visitor(profile._alwaysDraw);
+    visitor(profile._forceShadow);
+    visitor(profile._causesRipples);
+    visitor(profile._dontCullBackfaces);
+
+    // attack blocking info
+    visitor(profile.iframefacing);
+    visitor(profile.iframeangle);
+    visitor(profile.nframefacing);
+    visitor(profile.nframeangle);
+    visitor(profile._blockRating);
+
+    // defense
+    visitor(profile._resistBumpSpawn);
+
+    // xp
+    visitor(profile._experienceForLevel);
+    visitor(profile._startingExperience);
+    visitor(profile._experienceWorth);
+    visitor(profile._experienceExchange);
+    visitor(profile._experienceRate);
+    visitor(profile._levelUpRandomSeedOverride);
+
+    // flags
+    visitor(profile._isEquipment);
+    visitor(profile._isItem);
+    visitor(profile._isMount);
+    visitor(profile._isStackable);
+    visitor(profile._isInvincible);
+    visitor(profile._isPlatform);
+    visitor(profile._canUsePlatforms);
+    visitor(profile._canGrabMoney);
+    visitor(profile._canOpenStuff);
+    visitor(profile._canBeDazed);
+    visitor(profile._canBeGrogged);
+    visitor(profile._isBigItem);
+    visitor(profile._isRanged);
+    visitor(profile._nameIsKnown);
+    visitor(profile._usageIsKnown);
+    visitor(profile._canCarryToNextModule);
+    visitor(profile._damageTargetDamageType);
+    visitor(profile._slotsValid);
+    visitor(profile._riderCanAttack);
+    visitor(profile._kurseChance);
+    visitor(profile._hideState);
+    visitor(profile._isValuable);
+    visitor(profile._spellEffectType);
+
+    // item usage
+    visitor(profile._needSkillIDToUse);
+    visitor(profile._weaponAction);
+    visitor(profile._attachAttackParticleToWeapon);
+    visitor(profile._attackParticle);
+    visitor(profile._attackFast);
+    visitor(profile._strengthBonus);
+    visitor(profile._intelligenceBonus);
+    visitor(profile._dexterityBonus);
+
+    // special particle effects
+    visitor(profile._attachedParticleAmount);
+    visitor(profile._attachedParticleReaffirmDamageType);
+    visitor(profile._attachedParticle);
+    visitor(profile._goPoofParticleAmount);
+    visitor(profile._goPoofParticleFacingAdd);
+    visitor(profile._goPoofParticle);
+    visitor(profile._bludValid);
+    visitor(profile._bludParticle);
+
+    // skill system
+    visitor(profile._seeInvisibleLevel);
+
+    // random stuff
+    visitor(profile._stickyButt);
+    visitor(profile._useManaCost);
+
+    // perks
+    visitor(profile._startingPerks);
+    visitor(profile._perkPool);
+}
+
+std::vector<char> ProfileCache::encode(uint64_t sourceHash, const ParticleProfile& profile)
+{
+    return encodeEntry(ParticleProfileMagic, sourceHash, profile, &ProfileCache::visitParticleProfile<Encoder, const ParticleProfile>);
+}
+
+std::vector<char> ProfileCache::encode(uint64_t sourceHash, const EnchantProfile& profile)
+{
+    return encodeEntry(EnchantProfileMagic, sourceHash, profile, &ProfileCache::visitEnchantProfile<Encoder, const EnchantProfile>);
+}
+
+std::vector<char> ProfileCache::encode(uint64_t sourceHash, const ObjectProfile& profile)
+{
+    return encodeEntry(ObjectProfileMagic, sourceHash, profile, &ProfileCache::visitObjectProfile<Encoder, const ObjectProfile>);
+}
+
+bool ProfileCache::decode(const std::vector<char>& entry, uint64_t sourceHash, ParticleProfile& profile)
+{
+    return decodeEntry(ParticleProfileMagic, entry, sourceHash, profile, &ProfileCache::visitParticleProfile<Decoder, ParticleProfile>);
+}
+
+bool ProfileCache::decode(const std::vector<char>& entry, uint64_t sourceHash, EnchantProfile& profile)
+{
+    return decodeEntry(EnchantProfileMagic, entry, sourceHash, profile, &ProfileCache::visitEnchantProfile<Decoder, EnchantProfile>);
+}
+
+bool ProfileCache::decode(const std::vector<char>& entry, uint64_t sourceHash, ObjectProfile& profile)
+{
+    return decodeEntry(ObjectProfileMagic, entry, sourceHash, profile, &ProfileCache::visitObjectProfile<Decoder, ObjectProfile>);
+}
+
+std::string ProfileCache::getDirectory()
+{
+    return CacheEntry::getDirectory(CacheDirectory, getVersion());
+}
+
+void ProfileCache::prune()
+{
+    CacheEntry::prune(CacheDirectory, getVersion(), MaximumNumberOfEntries);
+}
+
+bool ProfileCache::load(uint64_t sourceHash, ParticleProfile& profile)
+{
+    return loadEntry(getPathname(sourceHash, "pip"), sourceHash, profile);
+}
+
+bool ProfileCache::load(uint64_t sourceHash, EnchantProfile& profile)
+{
+    return loadEntry(getPathname(sourceHash, "eve"), sourceHash, profile);
+}
+
+bool ProfileCache::load(uint64_t sourceHash, ObjectProfile& profile)
+{
+    return loadEntry(getPathname(sourceHash, "cap"), sourceHash, profile);
+}
+
+void ProfileCache::store(uint64_t sourceHash, const ParticleProfile& profile)
+{
+    CacheEntry::store(getPathname(sourceHash, "pip"), encode(sourceHash, profile));
+}
+
+void ProfileCache::store(uint64_t sourceHash, const EnchantProfile& profile)
+{
+    CacheEntry::store(getPathname(sourceHash, "eve"), encode(sourceHash, profile));
+}
+
+void ProfileCache::store(uint64_t sourceHash, const ObjectProfile& profile)
+{
+    CacheEntry::store(getPathname(sourceHash, "cap"), encode(sourceHash, profile));
+}
+
+} // namespace Ego
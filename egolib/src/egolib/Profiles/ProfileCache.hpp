@@ -0,0 +1,114 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/Profiles/ProfileCache.hpp
+/// @brief Cache of parsed profiles.
+
+#pragma once
+
+#include "egolib/platform.h"
+
+class EnchantProfile;
+class ObjectProfile;
+class ParticleProfile;
+
+namespace Ego {
+
+/// @brief Stores parsed profiles in the user directory.
+/// @details An entry is keyed by the hash of the profile source and contains the fields of the profile parsed from
+/// it, i.e. the fields of a particle profile (<tt>part*.txt</tt>), of an enchant profile (<tt>enchant.txt</tt>) or
+/// the fields of an object profile read from its <tt>data.txt</tt>. The pathname of a profile is not part of an
+/// entry, hence profiles with the same source share an entry. The entries of a version are stored in a directory of
+/// their own, the entries use the format of CacheEntry.
+class ProfileCache
+{
+public:
+    /// @brief The version of the format of the entries.
+    /// @remark Increment if the format of the entries or the parsing of the profiles changes.
+    static const uint32_t FormatVersion = 1;
+
+    /// @brief The maximum number of entries of a version.
+    /// @remark If a version has more entries, all of its entries are removed by prune().
+    static const size_t MaximumNumberOfEntries = 16384;
+
+    /// @brief Get the version of the entries.
+    /// @return the hash of the format version
+    /// @remark Entries of other versions are ignored and removed by prune().
+    static uint64_t getVersion();
+
+    /// @brief Compute the hash of a profile source.
+    /// @param pathname the pathname of the profile source in vfs-specific notation
+    /// @param [out] sourceHash receives the hash
+    /// @return @a true on success, @a false if the profile source does not exist or can not be read
+    static bool hash(const std::string& pathname, uint64_t& sourceHash);
+
+    /// @brief Encode a parsed profile into an entry.
+    /// @param sourceHash the hash of the profile source
+    /// @param profile the profile
+    /// @return the entry
+    static std::vector<char> encode(uint64_t sourceHash, const ParticleProfile& profile);
+    static std::vector<char> encode(uint64_t sourceHash, const EnchantProfile& profile);
+    static std::vector<char> encode(uint64_t sourceHash, const ObjectProfile& profile);
+
+    /// @brief Decode a parsed profile from an entry.
+    /// @param entry the entry
+    /// @param sourceHash the hash of the profile source
+    /// @param profile receives the fields of the profile
+    /// @return @a true on success, @a false if the entry is corrupted, of another version or for another source
+    /// @remark The fields of the profile are unspecified on failure.
+    static bool decode(const std::vector<char>& entry, uint64_t sourceHash, ParticleProfile& profile);
+    static bool decode(const std::vector<char>& entry, uint64_t sourceHash, EnchantProfile& profile);
+    static bool decode(const std::vector<char>& entry, uint64_t sourceHash, ObjectProfile& profile);
+
+    /// @brief Get the pathname of the directory of the entries of this version.
+    /// @return the pathname in vfs-specific notation
+    static std::string getDirectory();
+
+    /// @brief Remove the entries of other versions and bound the number of entries of this version.
+    static void prune();
+
+    /// @brief Load the entry of a profile source.
+    /// @param sourceHash the hash of the profile source
+    /// @param profile receives the fields of the profile
+    /// @return @a true on success, @a false if there is no valid entry
+    /// @remark The profile is not changed on failure.
+    static bool load(uint64_t sourceHash, ParticleProfile& profile);
+    static bool load(uint64_t sourceHash, EnchantProfile& profile);
+    static bool load(uint64_t sourceHash, ObjectProfile& profile);
+
+    /// @brief Store the entry of a profile source.
+    /// @param sourceHash the hash of the profile source
+    /// @param profile the profile
+    /// @remark Failures are logged and otherwise ignored.
+    static void store(uint64_t sourceHash, const ParticleProfile& profile);
+    static void store(uint64_t sourceHash, const EnchantProfile& profile);
+    static void store(uint64_t sourceHash, const ObjectProfile& profile);
+
+private:
+    template <typename Visitor, typename Profile>
+    static void visitParticleProfile(Visitor& visitor, Profile& profile);
+
+    template <typename Visitor, typename Profile>
+    static void visitEnchantProfile(Visitor& visitor, Profile& profile);
+
+    template <typename Visitor, typename Profile>
+    static void visitObjectProfile(Visitor& visitor, Profile& profile);
+};
+
+} // namespace Ego
@@ -46,7 +46,8 @@ ProfileSystem::ProfileSystem() :
     _moduleProfilesLoaded(),
     _loadPlayerList(),
     EnchantProfileSystem("enchant", "/debug/enchant_profile_usage.txt"),
-    ParticleProfileSystem("particle", "/debug/particle_profile_usage.txt")
+    ParticleProfileSystem("particle", "/debug/particle_profile_usage.txt"),
+    _loader()
 {
     // Initialize the script compiler.
     parser_state_t::initialize();
@@ -55,6 +56,9 @@ ProfileSystem::ProfileSystem() :
 
 ProfileSystem::~ProfileSystem()
 {
+    // Wait for the loading threads.
+    _loader = nullptr;
+
     // Uninitialize the script compiler.
     parser_state_t::uninitialize();
 }
@@ -194,15 +198,55 @@ ObjectProfileRef ProfileSystem::loadOneProfile(const std::string &pathName, int
         }
     }
 
-    std::shared_ptr<ObjectProfile> profile = ObjectProfile::loadFromFile(pathName, iobj);
+    return addProfile(pathName, iobj, ObjectProfile::parseFromFile(pathName, iobj));
+}
+
+void ProfileSystem::loadProfiles(const std::vector<std::string> &folderPaths)
+{
+    // Read and parse the profiles which get a free slot on the loading threads
+    std::vector<std::pair<ObjectProfileRef, std::future<std::shared_ptr<ObjectProfile>>>> parsed;
+    parsed.reserve(folderPaths.size());
+    for (const std::string &folderPath : folderPaths)
+    {
+        int islot = getProfileSlotNumber(folderPath);
+        if (islot < 0 || islot >= INVALID_PRO_REF || isLoaded(static_cast<PRO_REF>(islot)))
+        {
+            parsed.emplace_back(ObjectProfileRef::Invalid, std::future<std::shared_ptr<ObjectProfile>>());
+            continue;
+        }
+        ObjectProfileRef iobj = ObjectProfileRef(static_cast<PRO_REF>(islot));
+        parsed.emplace_back(iobj, getLoader().submit([folderPath, iobj]() { return ObjectProfile::parseFromFile(folderPath, iobj); }));
+    }
+
+    // Assign the slots in order, a slot might have been taken by an earlier folder of the list
+    for (size_t i = 0; i < parsed.size(); ++i)
+    {
+        if (!parsed[i].first)
+        {
+            continue;
+        }
+        std::shared_ptr<ObjectProfile> profile = parsed[i].second.get();
+        if (isLoaded(parsed[i].first))
+        {
+            continue;
+        }
+        addProfile(folderPaths[i], parsed[i].first, profile);
+    }
+}
+
+ObjectProfileRef ProfileSystem::addProfile(const std::string &folderPath, ObjectProfileRef iobj, const std::shared_ptr<ObjectProfile> &profile)
+{
     if (!profile)
     {
         Log::Entry e(Log::Level::Warning, __FILE__, __LINE__);
-        e << "failed to load " << pathName << " into slot number " << iobj << Log::EndOfEntry;
+        e << "failed to load " << folderPath << " into slot number " << iobj << Log::EndOfEntry;
         Log::get() << e;
         return ObjectProfileRef::Invalid;
     }
 
+    // Load the enchant, particles and sounds of the profile
+    profile->loadSharedResources();
+
     //Success! Store object into the loaded profile map
     _profilesLoaded[iobj.get()] = profile;
     _profilesLoadedByName[profile->getPathname().substr(profile->getPathname().find_last_of('/') + 1)] = profile;
@@ -210,6 +254,16 @@ ObjectProfileRef ProfileSystem::loadOneProfile(const std::string &pathName, int
     return iobj;
 }
 
+ThreadPool& ProfileSystem::getLoader()
+{
+    if (!_loader)
+    {
+        const unsigned int cores = std::thread::hardware_concurrency();
+        _loader = std::make_unique<ThreadPool>(cores > 1 ? cores : 1);
+    }
+    return *_loader;
+}
+
 const Ego::DeferredTexture& ProfileSystem::getSpellBookIcon(size_t index) const
 {
     return _profilesLoaded.find(SPELLBOOK)->second->getIcon(index);
@@ -224,23 +278,29 @@ void ProfileSystem::loadModuleProfiles()
     SearchContext *ctxt = new SearchContext(Ego::VfsPath("mp_modules"), Ego::Extension("mod"), VFS_SEARCH_DIR);
     if (!ctxt) return;
     
+    //Try to load menu.txt, the modules are loaded on the loading threads
+    std::vector<std::pair<std::string, std::future<std::shared_ptr<ModuleProfile>>>> modules;
     while (ctxt->hasData())
     {
-        auto vfs_ModPath = ctxt->getData();
-        //Try to load menu.txt
-        std::shared_ptr<ModuleProfile> module = ModuleProfile::loadFromFile(vfs_ModPath.string());
+        auto vfs_ModPath = ctxt->getData().string();
+        modules.emplace_back(vfs_ModPath, getLoader().submit([vfs_ModPath]() { return ModuleProfile::loadFromFile(vfs_ModPath); }));
+        ctxt->nextData();
+    }
+    delete ctxt;
+    ctxt = nullptr;
+
+    for (auto &element : modules)
+    {
+        std::shared_ptr<ModuleProfile> module = element.second.get();
         if (module)
         {
             _moduleProfilesLoaded.push_back(module);
         }
         else
         {
-			Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load module ", "`", vfs_ModPath.string(), "`", Log::EndOfEntry);
+			Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to load module ", "`", element.first, "`", Log::EndOfEntry);
         }
-        ctxt->nextData();
     }
-    delete ctxt;
-    ctxt = nullptr;
 }
 
 
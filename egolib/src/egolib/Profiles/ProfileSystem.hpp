@@ -25,6 +25,7 @@
 #endif
 
 #include "egolib/typedef.h"
+#include "egolib/Core/ThreadPool.hpp"
 #include "egolib/Profiles/LocalParticleProfileRef.hpp"
 
 //Forward declarations
@@ -89,6 +90,14 @@ public:
      */
     ObjectProfileRef loadOneProfile(const std::string &folderPath, int slot_override = -1);
 
+    /**
+     * @brief Loads the object profiles of a list of folders.
+     * @details Equivalent to calling loadOneProfile(folderPath) for each folder in order, but the
+     *          files of the profiles are read and parsed on worker threads. The slots are assigned and
+     *          the enchants, particle profiles and sounds are loaded in order afterwards.
+     */
+    void loadProfiles(const std::vector<std::string> &folderPaths);
+
     /**
      * @brief Loads only the slot number from data.txt
      *        If slot_override is valid, then that is used indead
@@ -145,12 +154,25 @@ public:
     void loadGlobalParticleProfiles();
 
 private:
+    /**
+     * @brief Stores a loaded profile in its slot.
+     * @return the slot or ObjectProfileRef::Invalid if the profile failed to load
+     */
+    ObjectProfileRef addProfile(const std::string &folderPath, ObjectProfileRef ref, const std::shared_ptr<ObjectProfile> &profile);
+
+    /**
+     * @brief Get the threads reading and parsing profiles, created on the first use.
+     */
+    ThreadPool& getLoader();
+
     std::unordered_map<PRO_REF, std::shared_ptr<ObjectProfile>> _profilesLoaded; //Maps slot numbers to ObjectProfiles
     std::unordered_map<std::string, std::shared_ptr<ObjectProfile>> _profilesLoadedByName; //Maps names to ObjectProfiles
 
     std::vector<std::shared_ptr<ModuleProfile>> _moduleProfilesLoaded;  // List of all valid game modules loaded
 
     std::vector<std::shared_ptr<LoadPlayerElement>> _loadPlayerList; // List of characters that can be loaded (lightweight)
+
+    std::unique_ptr<ThreadPool> _loader; // The threads reading and parsing profiles
 };
 
 // TODO: Remove this.
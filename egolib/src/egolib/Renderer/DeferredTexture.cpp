@@ -9,6 +9,8 @@ DeferredTexture::DeferredTexture() :
     _textureHD(nullptr),
     _loaded(false),
     _loadedHD(false),
+    _pending(false),
+    _pendingHD(false),
     _filePath() {
     //default ctor invalid texture
 }
@@ -19,17 +21,20 @@ DeferredTexture::DeferredTexture(const std::string &filePath) :
     _textureHD(nullptr),
     _loaded(false),
     _loadedHD(false),
+    _pending(false),
+    _pendingHD(false),
     _filePath(filePath) {
     //Do not load texture until its needed
 }
 
 std::shared_ptr<const Texture> DeferredTexture::get() const {
-    if (!_loaded) {
+    //Request the texture again while it is streamed, this raises its priority
+    if (!_loaded || _pending) {
         if (_filePath.empty()) {
             throw std::logic_error("DeferredTexture::get() on nullptr texture");
         }
 
-        _texture = TextureManager::get().getTexture(_filePath);
+        _texture = TextureManager::get().requestTexture(_filePath, _pending);
         _loaded = true;
     }
 
@@ -38,13 +43,17 @@ std::shared_ptr<const Texture> DeferredTexture::get() const {
 
         if(!_loadedHD) {
             if(ego_texture_exists_vfs(_filePath + "_HD")) {
-                _textureHD = TextureManager::get().getTexture(_filePath + "_HD");
+                _textureHD = TextureManager::get().requestTexture(_filePath + "_HD", _pendingHD);
             } 
 
             _loadedHD = true;            
         }
+        else if(_pendingHD) {
+            _textureHD = TextureManager::get().requestTexture(_filePath + "_HD", _pendingHD);
+        }
 
-        if(_textureHD != nullptr) {
+        //Use the normal texture until the HD texture is uploaded
+        if(_textureHD != nullptr && !_pendingHD) {
             return _textureHD; //Oh yeah HD!
         }
     }
@@ -55,6 +64,8 @@ std::shared_ptr<const Texture> DeferredTexture::get() const {
 void DeferredTexture::release() {
     _loaded = false;
     _loadedHD = false;
+    _pending = false;
+    _pendingHD = false;
     _texture.reset();
     _textureHD.reset();
 }
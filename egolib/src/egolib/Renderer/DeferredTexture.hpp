@@ -7,6 +7,8 @@ namespace Ego {
  * @brief
  *  A texture with lazy loading. This means the texture will not
  *  be loaded into memory before it is required for rendering.
+ *  The texture is streamed (see TextureManager::requestTexture), so
+ *  the default texture is displayed until the image is uploaded.
  */
 class DeferredTexture {
 public:
@@ -37,6 +39,10 @@ private:
     mutable std::shared_ptr<Texture> _textureHD;
     mutable bool _loaded;
     mutable bool _loadedHD;
+    /// @brief @a true if the texture is still streamed.
+    mutable bool _pending;
+    /// @brief @a true if the HD texture is still streamed.
+    mutable bool _pendingHD;
     std::string _filePath;
 };
 
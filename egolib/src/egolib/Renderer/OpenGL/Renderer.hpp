@@ -32,7 +32,6 @@
 #include "egolib/Renderer/OpenGL/TextureUnit.hpp"
 #include "egolib/platform.h"
 #include "egolib/Math/_Include.hpp"
-#define GLEW_STATIC
 #include <GL/glew.h>
 
 namespace Ego {
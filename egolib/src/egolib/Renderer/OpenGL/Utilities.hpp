@@ -2,7 +2,6 @@
 
 #include "egolib/integrations/idlib.hpp"
 #include "egolib/Graphics/PixelFormat.hpp"
-#define GLEW_STATIC
 #include <GL/glew.h>
 
 namespace Ego {
@@ -38,6 +38,15 @@ const Constant& ConstantPool::getConstant(ConstantPool::Index index)
     return m_constants[index];
 }
 
+const Constant& ConstantPool::getConstant(ConstantPool::Index index) const
+{
+    if (index >= m_constants.size())
+    {
+        throw idlib::runtime_error(__FILE__, __LINE__, "index out of bounds");
+    }
+    return m_constants[index];
+}
+
 ConstantPool::Size ConstantPool::getNumberOfConstants() const
 {
     return (uint32_t)m_constants.size();
@@ -0,0 +1,214 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/Script/ScriptCache.cpp
+/// @brief Cache of compiled AI scripts.
+
+#include "egolib/Script/ScriptCache.hpp"
+#include "egolib/Script/script.h"
+#include "egolib/Core/CacheEntry.hpp"
+
+namespace Ego {
+namespace Script {
+
+namespace {
+
+const char Magic[CacheEntry::MagicSize] = { 'E', 'G', 'S', 'C' };
+
+const char *const CacheDirectory = "/cache/scripts";
+
+} // namespace
+
+uint64_t ScriptCache::getVersion()
+{
+    static const uint64_t version = []()
+    {
+        std::ostringstream os;
+        os << "format " << FormatVersion << '\n';
+    #define Define(name) os << "function " << #name << ' ' << ScriptFunctions::name << '\n';
+    #define DefineAlias(alias, name) os << "function " << #alias << ' ' << ScriptFunctions::alias << '\n';
+    #include "egolib/Script/Functions.in"
+    #undef DefineAlias
+    #undef Define
+    #define Define(value, name) os << "constant " << name << ' ' << value << '\n';
+    #include "egolib/Script/Constants.in"
+    #undef Define
+    #define Define(cName, eName) os << "variable " << eName << ' ' << ScriptVariables::cName << '\n';
+    #define DefineAlias(cName, eName) os << "variable " << eName << ' ' << ScriptVariables::cName << '\n';
+    #include "egolib/Script/Variables.in"
+    #undef DefineAlias
+    #undef Define
+    #define Define(cName, eName) os << "operator " << eName << ' ' << ScriptOperators::cName << '\n';
+    #define DefineAlias(cAlias, cName) os << "operator " << #cAlias << ' ' << ScriptOperators::cAlias << '\n';
+    #include "egolib/Script/Operators.in"
+    #undef DefineAlias
+    #undef Define
+        const std::string tables = os.str();
+        return hash(tables.data(), tables.size());
+    }();
+    return version;
+}
+
+uint64_t ScriptCache::hash(const char *bytes, size_t size)
+{
+    return CacheEntry::hash(bytes, size);
+}
+
+std::vector<char> ScriptCache::encode(uint64_t sourceHash, const InstructionList& instructions, const std::vector<CachedLiteral>& literals)
+{
+    std::vector<char> entry;
+    CacheEntry::begin(entry, Magic, getVersion(), sourceHash);
+    CacheEntry::Writer writer{ entry };
+
+    const ConstantPool& constantPool = instructions.getConstantPool();
+    writer.writeUint32(constantPool.getNumberOfConstants());
+    for (ConstantPool::Index i = 0; i < constantPool.getNumberOfConstants(); ++i)
+    {
+        const Constant& constant = constantPool.getConstant(i);
+        writer.writeUint8(static_cast<uint8_t>(constant.getKind()));
+        switch (constant.getKind())
+        {
+            case Constant::Kind::Integer:
+                writer.writeUint32(static_cast<uint32_t>(constant.getAsInteger()));
+                break;
+            case Constant::Kind::String:
+                writer.writeString(constant.getAsString());
+                break;
+            default:
+                throw idlib::runtime_error(__FILE__, __LINE__, "unsupported constant");
+        };
+    }
+
+    writer.writeUint32(instructions.getNumberOfInstructions());
+    for (InstructionList::Index i = 0; i < instructions.getNumberOfInstructions(); ++i)
+    {
+        writer.writeUint32(instructions[i].getBits());
+    }
+
+    writer.writeUint32(static_cast<uint32_t>(literals.size()));
+    for (const CachedLiteral& literal : literals)
+    {
+        writer.writeUint8(static_cast<uint8_t>(literal.kind));
+        writer.writeUint32(static_cast<uint32_t>(literal.value));
+        writer.writeString(literal.lexeme);
+    }
+
+    CacheEntry::end(entry);
+    return entry;
+}
+
+bool ScriptCache::decode(const std::vector<char>& entry, uint64_t sourceHash, InstructionList& instructions, std::vector<CachedLiteral>& literals)
+{
+    instructions.clear();
+    literals.clear();
+
+    size_t payloadBegin, payloadEnd;
+    if (!CacheEntry::open(entry, Magic, getVersion(), sourceHash, payloadBegin, payloadEnd))
+    {
+        return false;
+    }
+    CacheEntry::Reader reader{ entry, payloadBegin, false };
+
+    try
+    {
+        // The constants are unique, hence adding them in order must reproduce their indices.
+        ConstantPool& constantPool = instructions.getConstantPool();
+        const uint32_t numberOfConstants = reader.readUint32();
+        for (uint32_t i = 0; i < numberOfConstants && !reader.error; ++i)
+        {
+            ConstantPool::Index index;
+            switch (static_cast<Constant::Kind>(reader.readUint8()))
+            {
+                case Constant::Kind::Integer:
+                    index = constantPool.getOrCreateConstant(static_cast<int>(reader.readUint32()));
+                    break;
+                case Constant::Kind::String:
+                    index = constantPool.getOrCreateConstant(reader.readString());
+                    break;
+                default:
+                    return false;
+            };
+            if (index != i)
+            {
+                return false;
+            }
+        }
+
+        const uint32_t numberOfInstructions = reader.readUint32();
+        if (numberOfInstructions > MAXAICOMPILESIZE)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < numberOfInstructions && !reader.error; ++i)
+        {
+            instructions.append(Instruction(reader.readUint32()));
+        }
+
+        const uint32_t numberOfLiterals = reader.readUint32();
+        for (uint32_t i = 0; i < numberOfLiterals && !reader.error; ++i)
+        {
+            CachedLiteral literal;
+            literal.kind = static_cast<CachedLiteral::Kind>(reader.readUint8());
+            literal.value = static_cast<int>(reader.readUint32());
+            literal.lexeme = reader.readString();
+            if (literal.kind != CachedLiteral::Kind::Message && literal.kind != CachedLiteral::Kind::Reference)
+            {
+                return false;
+            }
+            literals.push_back(literal);
+        }
+    }
+    catch (const idlib::runtime_error&)
+    {
+        return false;
+    }
+
+    // The entry must have been consumed up to the checksum.
+    return !reader.error && reader.position == payloadEnd;
+}
+
+std::string ScriptCache::getDirectory()
+{
+    return CacheEntry::getDirectory(CacheDirectory, getVersion());
+}
+
+std::string ScriptCache::getPathname(uint64_t sourceHash)
+{
+    return CacheEntry::getPathname(getDirectory(), sourceHash, "bin");
+}
+
+void ScriptCache::prune()
+{
+    CacheEntry::prune(CacheDirectory, getVersion(), MaximumNumberOfEntries);
+}
+
+bool ScriptCache::load(uint64_t sourceHash, InstructionList& instructions, std::vector<CachedLiteral>& literals)
+{
+    std::vector<char> entry;
+    return CacheEntry::load(getPathname(sourceHash), entry) && decode(entry, sourceHash, instructions, literals);
+}
+
+void ScriptCache::store(uint64_t sourceHash, const InstructionList& instructions, const std::vector<CachedLiteral>& literals)
+{
+    CacheEntry::store(getPathname(sourceHash), encode(sourceHash, instructions, literals));
+}
+
+} // namespace Script
+} // namespace Ego
@@ -0,0 +1,120 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+/// @file egolib/Script/ScriptCache.hpp
+/// @brief Cache of compiled AI scripts.
+
+#pragma once
+
+#include "egolib/platform.h"
+
+struct InstructionList;
+
+namespace Ego {
+namespace Script {
+
+/// @brief A message or object reference literal of a compiled script.
+/// @remark The values of these literals depend on the messages of the object profile and on the object profiles
+/// loaded when the script is compiled. Hence they are stored with a compiled script and resolved again when the
+/// script is loaded from the cache.
+struct CachedLiteral
+{
+    enum class Kind : uint8_t
+    {
+        /// @brief A string literal, its value is the index of the message.
+        Message,
+        /// @brief An object reference literal, its value is the slot of the object profile.
+        Reference,
+    };
+
+    Kind kind;
+    std::string lexeme;
+    int value;
+
+    bool operator==(const CachedLiteral& other) const
+    {
+        return kind == other.kind && lexeme == other.lexeme && value == other.value;
+    }
+};
+
+/// @brief Stores compiled scripts in the user directory.
+/// @details An entry is keyed by the hash of the script source and contains the instructions (with resolved jumps),
+/// the constant pool and the literals of the script in the order in which the compiler resolved them.
+/// The entries of a version are stored in a directory of their own.
+class ScriptCache
+{
+public:
+    /// @brief The version of the format of the entries.
+    /// @remark Increment if the format or the code generation of the compiler changes.
+    static const uint32_t FormatVersion = 2;
+
+    /// @brief The maximum number of entries of a version.
+    /// @remark If a version has more entries, all of its entries are removed by prune().
+    static const size_t MaximumNumberOfEntries = 4096;
+
+    /// @brief Get the version of the entries.
+    /// @return the hash of the format version and of the names and the values of the functions,
+    /// constants, variables and operators the compiler emits into the instructions
+    /// @remark Entries of other versions are ignored and removed by prune().
+    static uint64_t getVersion();
+
+    /// @brief Compute the hash of a script source.
+    /// @param bytes, size the script source
+    /// @return the hash (64 bit FNV-1a)
+    static uint64_t hash(const char *bytes, size_t size);
+
+    /// @brief Encode a compiled script into an entry.
+    /// @param sourceHash the hash of the script source
+    /// @param instructions the instructions and the constant pool
+    /// @param literals the literals
+    /// @return the entry
+    static std::vector<char> encode(uint64_t sourceHash, const InstructionList& instructions, const std::vector<CachedLiteral>& literals);
+
+    /// @brief Decode a compiled script from an entry.
+    /// @param entry the entry
+    /// @param sourceHash the hash of the script source
+    /// @param instructions receives the instructions and the constant pool
+    /// @param literals receives the literals
+    /// @return @a true on success, @a false if the entry is corrupted, of another version or for another source
+    static bool decode(const std::vector<char>& entry, uint64_t sourceHash, InstructionList& instructions, std::vector<CachedLiteral>& literals);
+
+    /// @brief Get the pathname of the directory of the entries of this version.
+    /// @return the pathname in vfs-specific notation
+    static std::string getDirectory();
+
+    /// @brief Get the pathname of the entry of a script source.
+    /// @param sourceHash the hash of the script source
+    /// @return the pathname in vfs-specific notation
+    static std::string getPathname(uint64_t sourceHash);
+
+    /// @brief Remove the entries of other versions and bound the number of entries of this version.
+    static void prune();
+
+    /// @brief Load the entry of a script source.
+    /// @return @a true on success, @a false if there is no valid entry
+    static bool load(uint64_t sourceHash, InstructionList& instructions, std::vector<CachedLiteral>& literals);
+
+    /// @brief Store the entry of a script source.
+    /// @remark Failures are logged and otherwise ignored.
+    static void store(uint64_t sourceHash, const InstructionList& instructions, const std::vector<CachedLiteral>& literals);
+};
+
+} // namespace Script
+} // namespace Ego
@@ -24,6 +24,7 @@
 
 #include "egolib/Script/TextFile.hpp"
 #include "egolib/vfs.h"
+#include <vector>
 
 namespace Ego
 {
@@ -33,6 +34,9 @@ namespace Script
 /**
  * @brief
  *  A text input file supports reading single characters from a file.
+ * @remark
+ *  The contents of the file are read with a single read when the file is opened,
+ *  advancing the input cursor does not access the file.
  * @author
  *  Michael Heilmann
  */
@@ -44,9 +48,27 @@ private:
 
     /**
      * @brief
-     *  The backing VFS file.
+     *  @a true if the file was opened.
      */
-    vfs_FILE *_file;
+    bool _open;
+
+    /**
+     * @brief
+     *  @a true if an error was encountered while reading the file.
+     */
+    bool _readError;
+
+    /**
+     * @brief
+     *  The contents of the file.
+     */
+    std::vector<uint8_t> _contents;
+
+    /**
+     * @brief
+     *  The index of the next Byte in the contents.
+     */
+    size_t _position;
     
     using Traits = typename TextFile<_Traits>::Traits;
 
@@ -71,10 +93,33 @@ public:
      */
     TextInputFile(const std::string& fileName) :
         TextFile<_Traits>(fileName, TextFile<_Traits>::Mode::Read),
-        _file(nullptr),
+        _open(false),
+        _readError(false),
+        _contents(),
+        _position(0),
         _current(Traits::startOfInput())
     {
-        _file = vfs_openRead(fileName);
+        vfs_FILE *file = vfs_openRead(fileName);
+        if (!file)
+        {
+            return;
+        }
+        _open = true;
+        // Read the file with a single read if its length is known, the rest (if any) in chunks.
+        long length = vfs_fileLength(file);
+        if (length > 0)
+        {
+            _contents.resize(length);
+            _contents.resize(vfs_read(_contents.data(), 1, _contents.size(), file));
+        }
+        uint8_t buffer[2048];
+        while (!vfs_error(file) && !vfs_eof(file))
+        {
+            size_t size = vfs_read(buffer, 1, sizeof(buffer), file);
+            _contents.insert(_contents.end(), buffer, buffer + size);
+        }
+        _readError = (0 != vfs_error(file));
+        vfs_close(file);
     }
 
     /**
@@ -82,13 +127,7 @@ public:
      *  Destruct this text input file.
      */
     virtual ~TextInputFile()
-    {
-        if (_file)
-        {
-            vfs_close(_file);
-            _file = nullptr;
-        }
-    }
+    {}
 
     /**
      * @brief
@@ -98,7 +137,7 @@ public:
      */
     bool isOpen() const
     {
-        return nullptr != _file;
+        return _open;
     }
 
     /**
@@ -117,36 +156,20 @@ public:
             // ... do nothing.
             return;
         }
-        // (2) If the backing VFS file is not opened ...
-        if (!_file)
+        // (2) If the file was not opened ...
+        if (!_open)
         {
             // ... raise an error.
             _current = Traits::error();
             return;
         }
-        // (3) Otherwise: Read a single Byte.
-        uint8_t byte;
-        size_t size = vfs_read(&byte, 1, 1, _file);
-        if (1 != size)
+        // (3) Otherwise: Take a single Byte.
+        if (_position == _contents.size())
         {
-            if (vfs_error(_file))
-            {
-                _current = Traits::error();
-                return;
-            }
-            else if (vfs_eof(_file))
-            {
-                _current = Traits::endOfInput();
-                return;
-            }
-            else
-            {
-                std::ostringstream message;
-                message << __FILE__ << ":" << __LINE__ << ": "
-                        << "inconsistent state of file object  of file `" << this->getFileName() << "`";
-                throw std::runtime_error(message.str());
-            }
+            _current = _readError ? Traits::error() : Traits::endOfInput();
+            return;
         }
+        uint8_t byte = _contents[_position++];
         // (4) Verify that it is a Byte the represents the starting Byte of a UTF-8 character sequence of length 1.
         if (byte > 0x7F)
         {
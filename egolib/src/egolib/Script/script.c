@@ -25,6 +25,7 @@
 
 #include "egolib/AI/AStar.hpp"
 #include "egolib/Script/IRuntimeStatistics.hpp"
+#include "egolib/egoboo_setup.h"
 
 #include "egolib/game/script_compile.h"
 #include "egolib/game/script_implementation.h"
@@ -35,6 +36,7 @@
 #include "egolib/game/Core/GameEngine.hpp"
 #include "egolib/game/Graphics/CameraSystem.hpp"
 #include "egolib/game/Module/Module.hpp"
+#include <optional>
 
 
 namespace Ego {
@@ -78,14 +80,8 @@ std::array<std::string, ScriptFunctions::SCRIPT_FUNCTIONS_COUNT> _scriptFunction
 };
 
 Runtime::Runtime() :
-    _functionValueCodeToFunctionPointer
-    {
-        #define Define(name) { name, &scr_##name },
-        #define DefineAlias(alias, name) { alias, &scr_##name },     
-        #include "egolib/Script/Functions.in"
-        #undef DefineAlias
-        #undef Define
-    },
+    _functionValueCodeToFunctionPointer(),
+    _functionValueCodeToThreadSafety(),
     m_opcodeInfos
     {
     #define Define(cname, name) { cname, { cname, #cname }},
@@ -94,10 +90,21 @@ Runtime::Runtime() :
     #undef DefineAlias
     #undef Define
     },
+    _profilingEnabled(false),
     _statistics(std::make_unique<RuntimeStatistics>()),
     _clock(std::make_unique<Ego::Time::Clock<Ego::Time::ClockPolicy::NonRecursive>>("runtime clock", 1))
 {
-    /* Intentionally empty. */
+    _functionValueCodeToFunctionPointer.fill(nullptr);
+    #define Define(name) _functionValueCodeToFunctionPointer[name] = &scr_##name;
+    #define DefineAlias(alias, name) _functionValueCodeToFunctionPointer[alias] = &scr_##name;
+    #include "egolib/Script/Functions.in"
+    #undef DefineAlias
+    #undef Define
+
+    _functionValueCodeToThreadSafety.fill(false);
+    #define Define(name) _functionValueCodeToThreadSafety[name] = true;
+    #include "egolib/Script/ThreadSafeFunctions.in"
+    #undef Define
 }
 
 Runtime::~Runtime()
@@ -105,14 +112,68 @@ Runtime::~Runtime()
     /* Intentionally empty. */
 }
 
+void Runtime::setProfilingEnabled(bool profilingEnabled)
+{
+    if (_profilingEnabled && !profilingEnabled)
+    {
+        // Drop the measurements taken while profiling was enabled.
+        _clock->reinit();
+        if (_currentModule)
+        {
+            for (const std::shared_ptr<Object>& object : _currentModule->getObjectHandler().iterator())
+            {
+                object->ai._clock->reinit();
+            }
+        }
+    }
+    _profilingEnabled = profilingEnabled;
+}
+
 } // namespace Script
 } // namespace Ego
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
-static ObjectProfileRef script_error_model = ObjectProfileRef::Invalid;
-static const char * script_error_classname = "UNKNOWN";
+static thread_local ObjectProfileRef script_error_model = ObjectProfileRef::Invalid;
+static thread_local const char * script_error_classname = "UNKNOWN";
+
+/// @brief The environment of scripts of objects in the current module.
+struct ModuleEnvironment
+{
+    uint8_t invoke(uint32_t functionIndex, Ego::Script::NativeInterface::Function *function, script_state_t& state, ai_state_t& aiState)
+    {
+        auto& runtime = Ego::Script::Runtime::get();
+        if (!runtime.isProfilingEnabled())
+        {
+            return function(state, aiState);
+        }
+
+        uint8_t returnCode;
+        {
+            Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive> scope(runtime.getClock());
+            returnCode = function(state, aiState);
+        }
+        runtime.getStatistics().onFunctionInvoked(functionIndex, runtime.getClock().lst());
+        return returnCode;
+    }
+
+    bool resolve(ai_state_t& aiState, script_state_t::Objects& objects)
+    {
+        auto& objectHandler = _currentModule->getObjectHandler();
+        if (!objectHandler.exists(aiState.getSelf())) return false;
+        objects.self = objectHandler.get(aiState.getSelf());
+        objects.target = objectHandler.exists(aiState.getTarget()) ? objectHandler.get(aiState.getTarget()) : nullptr;
+        objects.owner = objectHandler.exists(aiState.owner) ? objectHandler.get(aiState.owner) : nullptr;
+        return true;
+    }
+
+    int32_t load(uint8_t variableIndex, script_state_t& state, ai_state_t& aiState, const script_state_t::Objects& objects)
+    {
+        auto leader = _currentModule->getTeamList()[objects.self->team].getLeader();
+        return state.loadVariable(variableIndex, aiState, objects.self, objects.target, objects.owner, leader.get());
+    }
+};
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -121,6 +182,7 @@ void scripting_system_begin()
     if (!Ego::Script::Runtime::is_initialized())
     {
         Ego::Script::Runtime::initialize();
+        Ego::Script::Runtime::get().setProfilingEnabled(egoboo_config_t::get().debug_scriptProfiling_enable.getValue());
     }
 }
 
@@ -128,7 +190,10 @@ void scripting_system_end()
 {
     if (Ego::Script::Runtime::is_initialized())
     {
-        Ego::Script::Runtime::get().getStatistics().append("/debug/script_function_timing.txt");
+        if (Ego::Script::Runtime::get().isProfilingEnabled())
+        {
+            Ego::Script::Runtime::get().getStatistics().append("/debug/script_function_timing.txt");
+        }
         Ego::Script::Runtime::uninitialize();
     }
 }
@@ -162,7 +227,12 @@ void scr_run_chr_script(Object *pchr)
         aiState.changed = false;
     }
 
-    Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive> scope(*aiState._clock);
+    // Only measure the time spent in this script if profiling is enabled.
+    std::optional<Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive>> scope;
+    if (Ego::Script::Runtime::get().isProfilingEnabled())
+    {
+        scope.emplace(*aiState._clock);
+    }
 
     // debug a certain script
     // debug_scripts = ( 385 == pself->index && 76 == pchr->profile_ref );
@@ -241,29 +311,12 @@ void scr_run_chr_script(Object *pchr)
 
     // Run the AI Script.
     script.set_pos(0);
-    while (!aiState.terminate && script.get_pos() < script._instructions.getNumberOfInstructions())
+    ModuleEnvironment environment;
+    if (!script._program.isEmpty() && !script_state_t::is_tracing())
     {
-        // This is used by the Else function
-        // it only keeps track of functions.
-        script.indent_last = script.indent;
-        script.indent = script._instructions[script.get_pos()].getDataBits();
-
-        // Was it a function.
-        if (script._instructions[script.get_pos()].isInv())
-        {
-            if (!my_state.run_function_call(aiState, script))
-            {
-                break;
-            }
-        }
-        else
-        {
-            if (!my_state.run_operation(aiState, script))
-            {
-                break;
-            }
-        }
+        my_state.run_program(aiState, script, environment);
     }
+    my_state.run_instructions(aiState, script, environment);
 
     // Set movement latches
     if (!pchr->isPlayer())
@@ -304,118 +357,6 @@ void scr_run_chr_script(const ObjectRef character)
     return scr_run_chr_script(pchr);
 }
 
-//--------------------------------------------------------------------------------------------
-bool script_state_t::run_function_call(ai_state_t& aiState, script_info_t& script)
-{
-    uint8_t  functionreturn;
-
-    // check for valid execution pointer
-    if (script.get_pos() >= script._instructions.getNumberOfInstructions()) return false;
-
-    // Run the function
-    functionreturn = run_function(aiState, script);
-
-    // move the execution pointer to the jump code
-    script.increment_pos();
-    if (functionreturn)
-    {
-        // move the execution pointer to the next opcode
-        script.increment_pos();
-    }
-    else
-    {
-        // use the jump code to jump to the right location
-        size_t new_index = script._instructions[script.get_pos()].getBits();
-
-        // make sure the value is valid
-        EGOBOO_ASSERT(new_index <= script._instructions.getNumberOfInstructions());
-
-        // actually do the jump
-        script.set_pos(new_index);
-    }
-
-    return true;
-}
-
-//--------------------------------------------------------------------------------------------
-/// @todo Merge with caller.
-bool script_state_t::run_operation(ai_state_t& aiState, script_info_t& script)
-{
-    // check for valid execution pointer
-    if (script.get_pos() >= script._instructions.getNumberOfInstructions()) return false;
-
-    auto constantIndex = script._instructions[script.get_pos()].getValueBits();
-    const auto& constant = script._instructions.getConstantPool().getConstant(constantIndex);
-    uint32_t variableIndex = constant.getAsInteger();
-
-    // debug stuff
-    std::string variable = "UNKNOWN";
-    if (debug_scripts && debug_script_file)
-    {
-
-        for (auto i = 0; i < script.indent; i++) { vfs_printf(debug_script_file, "  "); }
-
-        for (auto i = 0; i < Opcodes.size(); i++)
-        {
-            if (Ego::Script::PDLTokenKind::Variable == Opcodes[i]._kind && variableIndex == Opcodes[i].iValue)
-            {
-                variable = Opcodes[i].cName;
-                break;
-            }
-        }
-
-        vfs_printf(debug_script_file, "%s = ", variable.c_str());
-    }
-
-    // Get the number of operands
-    script.increment_pos();
-    auto operand_count = script._instructions[script.get_pos()].getBits();
-
-    // Now run the operation
-    operationsum = 0;
-    for (auto i = 0; i < operand_count && script.get_pos() < script._instructions.getNumberOfInstructions(); ++i)
-    {
-        script.increment_pos();
-        run_operand(aiState, script);
-    }
-    if (debug_scripts && debug_script_file)
-    {
-        vfs_printf(debug_script_file, " == %d \n", (int)operationsum);
-    }
-
-    // Save the results in the register that called the arithmetic
-    storeVariable(variableIndex);
-
-    // go to the next opcode
-    script.increment_pos();
-
-    return true;
-}
-
-//--------------------------------------------------------------------------------------------
-uint8_t script_state_t::run_function(ai_state_t& aiState, script_info_t& script)
-{
-    auto constantIndex = script._instructions[script.get_pos()].getValueBits();
-    const auto& constant = script._instructions.getConstantPool().getConstant(constantIndex);
-    uint32_t functionIndex = constant.getAsInteger();
-
-    // Assume that the function will pass, as most do
-    uint8_t returnCode = true;
-    auto& runtime = Ego::Script::Runtime::get();
-    {
-
-        Ego::Time::ClockScope<Ego::Time::ClockPolicy::NonRecursive> scope(runtime.getClock());
-        const auto& result = runtime._functionValueCodeToFunctionPointer.find(functionIndex);
-        if (runtime._functionValueCodeToFunctionPointer.cend() == result)
-        {
-            throw idlib::runtime_error(__FILE__, __LINE__, "function not found");
-        }
-        returnCode = result->second(*this, aiState);
-    }
-    runtime.getStatistics().onFunctionInvoked(functionIndex, runtime.getClock().lst());
-    return returnCode;
-}
-
 //--------------------------------------------------------------------------------------------
 std::string getVariableName(int variableIndex)
 {
@@ -525,7 +466,6 @@ int32_t script_state_t::loadVariable(uint8_t variableIndex, ai_state_t& aiState,
 
 void script_state_t::storeVariable(uint8_t variableIndex)
 {
-    auto variableName = getVariableName(variableIndex);
     switch (variableIndex)
     {
         case Ego::Script::VARTMPX:
@@ -565,93 +505,38 @@ void script_state_t::onVariableNotDefinedError(uint8_t variableIndex)
     throw idlib::runtime_error(__FILE__, __LINE__, e.getText());
 }
 
-void script_state_t::run_operand(ai_state_t& aiState, script_info_t& script)
+const char *script_state_t::apply_operator(TaggedValue& value, uint8_t operation, int32_t operand)
 {
-    /// @author ZZ
-    /// @details This function does the scripted arithmetic in OPERATOR, OPERAND pscriptrs
-
-    if (!_currentModule->getObjectHandler().exists(aiState.getSelf())) return;
-    Object *pobject = _currentModule->getObjectHandler().get(aiState.getSelf());
-
-    Object *ptarget = nullptr;
-    if (_currentModule->getObjectHandler().exists(aiState.getTarget()))
-    {
-        ptarget = _currentModule->getObjectHandler().get(aiState.getTarget());
-    }
-
-    Object *powner = nullptr;
-    if (_currentModule->getObjectHandler().exists(aiState.owner))
-    {
-        powner = _currentModule->getObjectHandler().get(aiState.owner);
-    }
-
-    std::string varname;
-
-    // get the operator
-    int32_t iTmp = 0;
-
-    auto constantIndex = script._instructions[script.get_pos()].getValueBits();
-    const auto& constant = script._instructions.getConstantPool().getConstant(constantIndex);
-    uint8_t operation = script._instructions[script.get_pos()].getDataBits();
-    if (script._instructions[script.get_pos()].isLdc())
-    {
-        // Load the constant.
-        iTmp = constant.getAsInteger();
-        if (debug_scripts)
-        {
-            std::stringstream stringStream;
-            stringStream << iTmp;
-            varname = stringStream.str();
-        }
-    }
-    else
-    {
-        // Load the variable. 
-        auto variableIndex = constant.getAsInteger();
-        varname = getVariableName(variableIndex);
-        auto pleader = _currentModule->getTeamList()[pobject->team].getLeader();
-        iTmp = loadVariable(variableIndex, aiState, pobject, ptarget, powner, pleader.get());
-    }
-
-    // Now do the math
-    std::string op = "UNKNOWN";
     switch (operation)
     {
         case Ego::Script::OPADD:
-            op = "ADD";
-            operationsum = int(operationsum) + iTmp;
-            break;
+            value = int(value) + operand;
+            return "ADD";
 
         case Ego::Script::OPSUB:
-            op = "SUB";
-            operationsum = int(operationsum) - iTmp;
-            break;
+            value = int(value) - operand;
+            return "SUB";
 
         case Ego::Script::OPAND:
-            op = "AND";
-            operationsum = int(operationsum) & iTmp;
-            break;
+            value = int(value) & operand;
+            return "AND";
 
         case Ego::Script::OPSHR:
-            op = "SHR";
-            operationsum = int(operationsum) >> iTmp;
-            break;
+            value = int(value) >> operand;
+            return "SHR";
 
         case Ego::Script::OPSHL:
-            op = "SHL";
-            operationsum = int(operationsum) << iTmp;
-            break;
+            value = int(value) << operand;
+            return "SHL";
 
         case Ego::Script::OPMUL:
-            op = "MUL";
-            operationsum = int(operationsum) * iTmp;
-            break;
+            value = int(value) * operand;
+            return "MUL";
 
         case Ego::Script::OPDIV:
-            op = "DIV";
-            if (iTmp != 0)
+            if (operand != 0)
             {
-                operationsum = static_cast<float>(operationsum) / iTmp;
+                value = static_cast<float>(value) / operand;
             }
             else
             {
@@ -659,13 +544,12 @@ void script_state_t::run_operand(ai_state_t& aiState, script_info_t& script)
                                                  script_error_model, " class name == `", script_error_classname,
                                                  "`: divide by zero", Log::EndOfEntry);
             }
-            break;
+            return "DIV";
 
         case Ego::Script::OPMOD:
-            op = "MOD";
-            if (iTmp != 0)
+            if (operand != 0)
             {
-                operationsum = int(operationsum) % iTmp;
+                value = int(value) % operand;
             }
             else
             {
@@ -673,23 +557,221 @@ void script_state_t::run_operand(ai_state_t& aiState, script_info_t& script)
                                                  script_error_model, " class name == `", script_error_classname,
                                                  "`: modulo by zero", Log::EndOfEntry);
             }
-            break;
+            return "MOD";
 
         default:
             Log::get() << Log::Entry::create(Log::Level::Message, __FILE__, __LINE__, "script error - model = ",
                                              script_error_model, " class name == `", script_error_classname,
                                              "`: unknown opcode", Log::EndOfEntry);
-            break;
+            return "UNKNOWN";
     }
+}
 
-    if (debug_scripts && debug_script_file)
+bool script_state_t::is_tracing()
+{
+    return debug_scripts && debug_script_file;
+}
+
+void script_state_t::trace_operation_begin(uint32_t indent, uint32_t variableIndex)
+{
+    std::string variable = "UNKNOWN";
+
+    for (auto i = 0; i < indent; i++) { vfs_printf(debug_script_file, "  "); }
+
+    for (auto i = 0; i < Opcodes.size(); i++)
     {
-        vfs_printf(debug_script_file, "%s %s(%d) ", op.c_str(), varname.c_str(), iTmp);
+        if (Ego::Script::PDLTokenKind::Variable == Opcodes[i]._kind && variableIndex == Opcodes[i].iValue)
+        {
+            variable = Opcodes[i].cName;
+            break;
+        }
     }
+
+    vfs_printf(debug_script_file, "%s = ", variable.c_str());
+}
+
+void script_state_t::trace_operation_end() const
+{
+    vfs_printf(debug_script_file, " == %d \n", (int)operationsum);
+}
+
+void script_state_t::trace_operand(const char *operation, const std::string& operand, int32_t value)
+{
+    vfs_printf(debug_script_file, "%s %s(%d) ", operation, operand.c_str(), value);
 }
 
 //--------------------------------------------------------------------------------------------
 
+void DecodedProgram::decode(InstructionList& instructionList)
+{
+    clear();
+
+    static const uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+    const auto numberOfInstructions = instructionList.getNumberOfInstructions();
+    const auto& functions = Ego::Script::Runtime::get()._functionValueCodeToFunctionPointer;
+    auto& constantPool = instructionList.getConstantPool();
+
+    // Get the integer constant referenced by an instruction.
+    auto getInteger = [&constantPool](const Instruction& instruction, int& value)
+    {
+        if (instruction.getValueBits() >= constantPool.getNumberOfConstants()) return false;
+        const auto& constant = constantPool.getConstant(instruction.getValueBits());
+        if (Ego::Script::Constant::Kind::Integer != constant.getKind()) return false;
+        value = constant.getAsInteger();
+        return true;
+    };
+    auto isVariable = [](int value)
+    {
+        return 0 <= value && value < Ego::Script::SCRIPT_VARIABLES_COUNT;
+    };
+    // Folding must not skip the log messages of the division and the modulus.
+    auto isFoldable = [](uint8_t operation)
+    {
+        return Ego::Script::OPADD == operation || Ego::Script::OPSUB == operation || Ego::Script::OPAND == operation
+            || Ego::Script::OPSHR == operation || Ego::Script::OPSHL == operation || Ego::Script::OPMUL == operation;
+    };
+
+    // Map from instruction list indices to decoded instruction indices.
+    std::vector<uint32_t> decodedIndices(numberOfInstructions, INVALID);
+    // The decoded functions and their jump targets in the instruction list.
+    std::vector<std::pair<uint32_t, uint32_t>> jumps;
+    std::vector<DecodedOperand> decodedOperands;
+
+    uint32_t position = 0;
+    while (position < numberOfInstructions)
+    {
+        const auto& instruction = instructionList[position];
+        DecodedInstruction decoded;
+        decoded.position = position;
+        decoded.indent = instruction.getDataBits();
+        int value;
+        if (!getInteger(instruction, value) || position + 1 >= numberOfInstructions)
+        {
+            break;
+        }
+        uint32_t next;
+        if (instruction.isInv())
+        {
+            // A function is followed by its jump code.
+            if (value < 0 || value >= Ego::Script::SCRIPT_FUNCTIONS_COUNT || nullptr == functions[value])
+            {
+                break;
+            }
+            decoded.kind = DecodedInstruction::Kind::Function;
+            decoded.functionIndex = value;
+            decoded.function = functions[value];
+            jumps.emplace_back(static_cast<uint32_t>(instructions.size()), instructionList[position + 1].getBits());
+            next = position + 2;
+        }
+        else
+        {
+            // An operation is followed by the number of operands and the operands.
+            uint32_t numberOfOperands = instructionList[position + 1].getBits();
+            if (!isVariable(value) || numberOfOperands >= numberOfInstructions - (position + 1))
+            {
+                break;
+            }
+            decodedOperands.clear();
+            for (uint32_t i = 0; i < numberOfOperands; ++i)
+            {
+                const auto& operandInstruction = instructionList[position + 2 + i];
+                DecodedOperand operand;
+                int operandValue;
+                if (!getInteger(operandInstruction, operandValue))
+                {
+                    break;
+                }
+                operand.operation = operandInstruction.getDataBits();
+                operand.isConstant = operandInstruction.isLdc();
+                if (operand.isConstant)
+                {
+                    operand.variable = 0;
+                    operand.value = operandValue;
+                }
+                else
+                {
+                    if (!isVariable(operandValue))
+                    {
+                        break;
+                    }
+                    operand.variable = operandValue;
+                    operand.value = 0;
+                }
+                decodedOperands.push_back(operand);
+            }
+            if (decodedOperands.size() != numberOfOperands)
+            {
+                break;
+            }
+
+            // Fold the leading constant operands.
+            script_state_t::TaggedValue initialValue = 0;
+            size_t first = 0;
+            while (first < decodedOperands.size() && decodedOperands[first].isConstant && isFoldable(decodedOperands[first].operation))
+            {
+                script_state_t::apply_operator(initialValue, decodedOperands[first].operation, decodedOperands[first].value);
+                first++;
+            }
+
+            decoded.kind = DecodedInstruction::Kind::Operation;
+            decoded.variable = value;
+            decoded.initialValue = int(initialValue);
+            decoded.firstOperand = static_cast<uint32_t>(operands.size());
+            decoded.numberOfOperands = static_cast<uint32_t>(decodedOperands.size() - first);
+            operands.insert(operands.end(), decodedOperands.begin() + first, decodedOperands.end());
+            next = position + 2 + numberOfOperands;
+        }
+        decodedIndices[position] = static_cast<uint32_t>(instructions.size());
+        instructions.push_back(decoded);
+        position = next;
+    }
+
+    // Leave the program where decoding stopped (or at the end of the instruction list).
+    DecodedInstruction leave;
+    leave.position = position;
+    instructions.push_back(leave);
+
+    // Resolve the jumps.
+    for (const auto& jump : jumps)
+    {
+        uint32_t target = jump.second;
+        if (target < numberOfInstructions && INVALID != decodedIndices[target])
+        {
+            instructions[jump.first].jump = decodedIndices[target];
+        }
+        else
+        {
+            // The instruction interpreter stays at the jump code if the jump target is out of bounds.
+            leave.position = target < numberOfInstructions ? target : instructions[jump.first].position + 1;
+            instructions[jump.first].jump = static_cast<uint32_t>(instructions.size());
+            instructions.push_back(leave);
+        }
+    }
+
+    // The program may run on worker threads if it never falls back to the instruction interpreter,
+    // only invokes thread-safe functions and does not use the (shared) random number generator.
+    // The jump of "End" is never taken as it terminates the script.
+    const auto& runtime = Ego::Script::Runtime::get();
+    auto leavesEarly = [this, numberOfInstructions](uint32_t index)
+    {
+        return DecodedInstruction::Kind::Leave == instructions[index].kind && instructions[index].position != numberOfInstructions;
+    };
+    threadSafe = position == numberOfInstructions;
+    for (const auto& instruction : instructions)
+    {
+        if (DecodedInstruction::Kind::Function == instruction.kind)
+        {
+            threadSafe = threadSafe && runtime.isThreadSafe(instruction.functionIndex)
+                      && (Ego::Script::ScriptFunctions::End == instruction.functionIndex || !leavesEarly(instruction.jump));
+        }
+    }
+    for (const auto& operand : operands)
+    {
+        threadSafe = threadSafe && (operand.isConstant || Ego::Script::VARRAND != operand.variable);
+    }
+}
+//--------------------------------------------------------------------------------------------
+
 bool script_info_t::increment_pos()
 {
     if (_position >= _instructions.getNumberOfInstructions())
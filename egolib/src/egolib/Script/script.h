@@ -35,6 +35,8 @@
 //--------------------------------------------------------------------------------------------
 
 class Object;
+struct script_state_t;
+struct ai_state_t;
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -374,6 +376,105 @@ public:
     }
 };
 
+/// @brief An operand of a pre-decoded operation.
+struct DecodedOperand
+{
+    /// @brief The operator applied to the current result and the value of this operand.
+    uint8_t operation;
+    /// @brief If this operand is a constant. Otherwise it is a variable.
+    bool isConstant;
+    /// @brief The index of the variable. Only valid if @a isConstant is @a false.
+    uint8_t variable;
+    /// @brief The value of the constant. Only valid if @a isConstant is @a true.
+    int32_t value;
+};
+
+/// @brief A pre-decoded instruction.
+struct DecodedInstruction
+{
+    /// @brief The kinds of pre-decoded instructions.
+    enum class Kind : uint8_t
+    {
+        /// @brief Invoke a function. Continue with the next decoded instruction if it succeeds,
+        /// otherwise continue with the decoded instruction @a jump.
+        Function,
+        /// @brief Evaluate the operands and store the result in a variable.
+        /// Continue with the next decoded instruction.
+        Operation,
+        /// @brief Leave the decoded program and continue with the instruction interpreter at @a position.
+        Leave,
+    };
+
+    /// @brief The kind of this decoded instruction.
+    Kind kind;
+    /// @brief The indention of the instruction.
+    uint8_t indent;
+    /// @brief The index of the variable the result is stored in. Only valid for Kind::Operation.
+    uint8_t variable;
+    /// @brief The index of the instruction in the instruction list.
+    uint32_t position;
+    /// @brief The function value code. Only valid for Kind::Function.
+    uint32_t functionIndex;
+    /// @brief The function. Only valid for Kind::Function.
+    uint8_t (*function)(script_state_t&, ai_state_t&);
+    /// @brief The index of the decoded instruction to continue with if the function fails. Only valid for Kind::Function.
+    uint32_t jump;
+    /// @brief The value of the folded leading constant operands. Only valid for Kind::Operation.
+    int32_t initialValue;
+    /// @brief The index of the first operand which was not folded. Only valid for Kind::Operation.
+    uint32_t firstOperand;
+    /// @brief The number of operands which were not folded. Only valid for Kind::Operation.
+    uint32_t numberOfOperands;
+
+    DecodedInstruction()
+        : kind(Kind::Leave), indent(0), variable(0), position(0), functionIndex(0), function(nullptr),
+          jump(0), initialValue(0), firstOperand(0), numberOfOperands(0)
+    {}
+};
+
+/// @brief An instruction list lowered into a compact, pre-decoded program.
+/// @details Function pointers, operand kinds and variable indices are resolved, jump targets refer to
+/// decoded instructions and leading constant operands of operations are folded. Decoding stops at the
+/// first instruction which can not be decoded, the rest of the script is left to the instruction interpreter.
+struct DecodedProgram
+{
+public:
+    /// @brief The decoded instructions.
+    /// @remark The last decoded instruction of the linear instruction stream is of kind DecodedInstruction::Kind::Leave.
+    std::vector<DecodedInstruction> instructions;
+
+    /// @brief The operands of the decoded operations.
+    std::vector<DecodedOperand> operands;
+
+    /// @brief If this program may run on worker threads.
+    /// @remark @a true if the whole instruction list was decoded, all functions invoked are thread-safe
+    /// (see Ego::Script::Runtime::isThreadSafe) and the random number generator is not used.
+    bool threadSafe;
+
+    DecodedProgram()
+        : instructions(), operands(), threadSafe(false)
+    {}
+
+    /// @brief Decode an instruction list.
+    /// @param instructionList the instruction list
+    /// @remark The script runtime must be initialized.
+    void decode(InstructionList& instructionList);
+
+    /// @brief Get if this program is empty i.e. was not decoded.
+    /// @return @a true if this program is empty, @a false otherwise
+    bool isEmpty() const
+    {
+        return instructions.empty();
+    }
+
+    void clear()
+    {
+        instructions.clear();
+        operands.clear();
+        threadSafe = false;
+    }
+};
+
 struct script_info_t
 {
 public:
@@ -382,7 +483,8 @@ public:
         indent(0),
         indent_last(0),
         _position(0),
-        _instructions()
+        _instructions(),
+        _program()
     {
         //ctor
     }
@@ -420,6 +522,12 @@ public:
 	 */
 	InstructionList _instructions;
 
+	/**
+	 * @brief
+	 *	The pre-decoded program or an empty program if the instruction list was not decoded.
+	 */
+	DecodedProgram _program;
+
 	bool increment_pos();
 	size_t get_pos() const;
 	bool set_pos(size_t position);
@@ -509,18 +617,64 @@ struct script_state_t : private idlib::non_copyable
 	// public
 	script_state_t();
 
+    /// @brief The objects the operands of an operation refer to.
+    struct Objects
+    {
+        Object *self;
+        Object *target;
+        Object *owner;
+    };
+
     /// @brief Error handler for the error "variable not defined".
     /// Writes a warning log messages and raises an idlib::runtime_error.
     /// @param variableIndex the variable index
     /// @throw idlib::runtime_error
     void onVariableNotDefinedError(uint8_t variableIndex);
+
+    /// @brief Apply an operator to a value and an operand.
+    /// @param value the value, receives the result
+    /// @param operation the operator
+    /// @param operand the operand
+    /// @return the name of the operator
+    static const char *apply_operator(TaggedValue& value, uint8_t operation, int32_t operand);
+
+    /// @brief Get if the script execution is traced to the script debug file.
+    static bool is_tracing();
+    static void trace_operation_begin(uint32_t indent, uint32_t variableIndex);
+    void trace_operation_end() const;
+    static void trace_operand(const char *operation, const std::string& operand, int32_t value);
+
+    // The environment of a script is a type providing
+    // - uint8_t invoke(uint32_t functionIndex, NativeInterface::Function *function, script_state_t& state, ai_state_t& aiState)
+    //   to invoke a function,
+    // - bool resolve(ai_state_t& aiState, Objects& objects)
+    //   to resolve the objects of an operation (returns false if the object itself does not exist) and
+    // - int32_t load(uint8_t variableIndex, script_state_t& state, ai_state_t& aiState, const Objects& objects)
+    //   to load a variable.
+
 	// protected
-	uint8_t run_function(ai_state_t& aiState, script_info_t& script);
+    template <typename Environment>
+	uint8_t run_function(ai_state_t& aiState, script_info_t& script, Environment& environment);
     int32_t loadVariable(uint8_t variableIndex, ai_state_t& aiState, Object *pobject, Object *ptarget, Object *powner, Object *pleader);
 	void storeVariable(uint8_t variableIndex);
-	void run_operand(ai_state_t& aiState, script_info_t& script);
-	bool run_operation(ai_state_t& aiState, script_info_t& script);
-	bool run_function_call(ai_state_t& aiState, script_info_t& script);
+    template <typename Environment>
+	void run_operand(ai_state_t& aiState, script_info_t& script, Environment& environment);
+    template <typename Environment>
+	bool run_operation(ai_state_t& aiState, script_info_t& script, Environment& environment);
+    template <typename Environment>
+	bool run_function_call(ai_state_t& aiState, script_info_t& script, Environment& environment);
+
+    /// @brief Run the instructions of a script, starting at its current position, until
+    /// the script terminates or the end of the instruction list is reached.
+    template <typename Environment>
+    void run_instructions(ai_state_t& aiState, script_info_t& script, Environment& environment);
+
+    /// @brief Run the pre-decoded program of a script from its beginning until the script terminates
+    /// or the program is left. The position of the script is updated to where the program was left.
+    /// @pre The program of the script is not empty.
+    /// @remark The results are identical to run_instructions with the script position set to @a 0.
+    template <typename Environment>
+    void run_program(ai_state_t& aiState, script_info_t& script, Environment& environment);
 };
 
 //--------------------------------------------------------------------------------------------
@@ -530,6 +684,8 @@ struct script_state_t : private idlib::non_copyable
 void scr_run_chr_script(Object *pchr);
 void scr_run_chr_script(const ObjectRef character);
 
+std::string getVariableName(int variableIndex);
+
 void issue_order( const ObjectRef character, uint32_t order );
 void issue_special_order( uint32_t order, const IDSZ2& idsz );
 void set_alerts( const ObjectRef character );
@@ -608,10 +764,18 @@ protected:
 	~Runtime();
 
 public:
-	/// @brief A map from function value codes to function pointers.
-	std::unordered_map<uint32_t, NativeInterface::Function*> _functionValueCodeToFunctionPointer;
+	/// @brief A table from function value codes to function pointers.
+	/// @remark Aliases share the entry of the function they alias.
+	std::array<NativeInterface::Function*, SCRIPT_FUNCTIONS_COUNT> _functionValueCodeToFunctionPointer;
+	/// @brief A table from function value codes to @a true if the function may run on worker threads.
+	/// @remark See ThreadSafeFunctions.in.
+	std::array<bool, SCRIPT_FUNCTIONS_COUNT> _functionValueCodeToThreadSafety;
     std::unordered_map<uint32_t, OpcodeInfo> m_opcodeInfos;
 private:
+    /// @brief If the time spent in script functions is measured.
+    /// @remark If @a false, neither the clock nor the statistics are touched when a function is invoked.
+    bool _profilingEnabled;
+
     /// @brief A clock to measure the time from the beginning to the end of an action performed by the runtime.
     /// @remark Its window size is 1 as the duration spend in the invocation is added to an histogram.
     std::unique_ptr<Ego::Time::Clock<Ego::Time::ClockPolicy::NonRecursive>> _clock;
@@ -628,6 +792,36 @@ public:
     /// @brief Get the statistics.
     /// @return the statistics
     IRuntimeStatistics<uint32_t>& getStatistics() { return *_statistics; }
+
+    /// @brief Get if the time spent in script functions is measured.
+    /// @return @a true if the time spent in script functions is measured, @a false otherwise
+    bool isProfilingEnabled() const { return _profilingEnabled; }
+
+    /// @brief Set if the time spent in script functions is measured.
+    /// @param profilingEnabled @a true if the time spent in script functions is measured, @a false otherwise
+    /// @remark Disabling profiling resets the clock and the script clocks of the objects in the current module.
+    void setProfilingEnabled(bool profilingEnabled);
+
+    /// @brief Get the function for a function value code.
+    /// @param functionValueCode the function value code
+    /// @return the function
+    /// @throw idlib::runtime_error @a functionValueCode is not a valid function value code
+    NativeInterface::Function *getFunction(uint32_t functionValueCode) const
+    {
+        if (functionValueCode >= _functionValueCodeToFunctionPointer.size() || nullptr == _functionValueCodeToFunctionPointer[functionValueCode])
+        {
+            throw idlib::runtime_error(__FILE__, __LINE__, "function not found");
+        }
+        return _functionValueCodeToFunctionPointer[functionValueCode];
+    }
+
+    /// @brief Get if the function for a function value code may run on worker threads.
+    /// @param functionValueCode the function value code
+    /// @return @a true if the function may run on worker threads, @a false otherwise
+    bool isThreadSafe(uint32_t functionValueCode) const
+    {
+        return functionValueCode < _functionValueCodeToThreadSafety.size() && _functionValueCodeToThreadSafety[functionValueCode];
+    }
 };
 
 } // namespace Script
@@ -635,3 +829,212 @@ public:
 
 void scripting_system_begin();
 void scripting_system_end();
+
+//--------------------------------------------------------------------------------------------
+// script_state_t interpreter
+//--------------------------------------------------------------------------------------------
+
+template <typename Environment>
+void script_state_t::run_instructions(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    while (!aiState.terminate && script.get_pos() < script._instructions.getNumberOfInstructions())
+    {
+        // This is used by the Else function
+        // it only keeps track of functions.
+        script.indent_last = script.indent;
+        script.indent = script._instructions[script.get_pos()].getDataBits();
+
+        // Was it a function.
+        if (script._instructions[script.get_pos()].isInv())
+        {
+            if (!run_function_call(aiState, script, environment))
+            {
+                break;
+            }
+        }
+        else
+        {
+            if (!run_operation(aiState, script, environment))
+            {
+                break;
+            }
+        }
+    }
+}
+
+template <typename Environment>
+void script_state_t::run_program(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    const auto& instructions = script._program.instructions;
+    const auto& operands = script._program.operands;
+
+    uint32_t index = 0;
+    while (!aiState.terminate)
+    {
+        const DecodedInstruction& instruction = instructions[index];
+        if (DecodedInstruction::Kind::Leave == instruction.kind)
+        {
+            break;
+        }
+
+        // This is used by the Else function
+        // it only keeps track of functions.
+        script.indent_last = script.indent;
+        script.indent = instruction.indent;
+
+        if (DecodedInstruction::Kind::Function == instruction.kind)
+        {
+            if (environment.invoke(instruction.functionIndex, instruction.function, *this, aiState))
+            {
+                index++;
+            }
+            else
+            {
+                index = instruction.jump;
+            }
+        }
+        else
+        {
+            Objects objects;
+            if (environment.resolve(aiState, objects))
+            {
+                operationsum = instruction.initialValue;
+                for (uint32_t i = instruction.firstOperand, n = instruction.firstOperand + instruction.numberOfOperands; i < n; ++i)
+                {
+                    const DecodedOperand& operand = operands[i];
+                    int32_t value = operand.isConstant ? operand.value : environment.load(operand.variable, *this, aiState, objects);
+                    apply_operator(operationsum, operand.operation, value);
+                }
+            }
+            else
+            {
+                // All operands are skipped if the object itself does not exist.
+                operationsum = 0;
+            }
+            storeVariable(instruction.variable);
+            index++;
+        }
+    }
+    script._position = instructions[index].position;
+}
+
+template <typename Environment>
+bool script_state_t::run_function_call(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    uint8_t  functionreturn;
+
+    // check for valid execution pointer
+    if (script.get_pos() >= script._instructions.getNumberOfInstructions()) return false;
+
+    // Run the function
+    functionreturn = run_function(aiState, script, environment);
+
+    // move the execution pointer to the jump code
+    script.increment_pos();
+    if (functionreturn)
+    {
+        // move the execution pointer to the next opcode
+        script.increment_pos();
+    }
+    else
+    {
+        // use the jump code to jump to the right location
+        size_t new_index = script._instructions[script.get_pos()].getBits();
+
+        // make sure the value is valid
+        EGOBOO_ASSERT(new_index <= script._instructions.getNumberOfInstructions());
+
+        // actually do the jump
+        script.set_pos(new_index);
+    }
+
+    return true;
+}
+
+/// @todo Merge with caller.
+template <typename Environment>
+bool script_state_t::run_operation(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    // check for valid execution pointer
+    if (script.get_pos() >= script._instructions.getNumberOfInstructions()) return false;
+
+    auto constantIndex = script._instructions[script.get_pos()].getValueBits();
+    const auto& constant = script._instructions.getConstantPool().getConstant(constantIndex);
+    uint32_t variableIndex = constant.getAsInteger();
+
+    // debug stuff
+    if (is_tracing())
+    {
+        trace_operation_begin(script.indent, variableIndex);
+    }
+
+    // Get the number of operands
+    script.increment_pos();
+    auto operand_count = script._instructions[script.get_pos()].getBits();
+
+    // Now run the operation
+    operationsum = 0;
+    for (auto i = 0; i < operand_count && script.get_pos() < script._instructions.getNumberOfInstructions(); ++i)
+    {
+        script.increment_pos();
+        run_operand(aiState, script, environment);
+    }
+    if (is_tracing())
+    {
+        trace_operation_end();
+    }
+
+    // Save the results in the register that called the arithmetic
+    storeVariable(variableIndex);
+
+    // go to the next opcode
+    script.increment_pos();
+
+    return true;
+}
+
+template <typename Environment>
+uint8_t script_state_t::run_function(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    auto constantIndex = script._instructions[script.get_pos()].getValueBits();
+    const auto& constant = script._instructions.getConstantPool().getConstant(constantIndex);
+    uint32_t functionIndex = constant.getAsInteger();
+
+    auto function = Ego::Script::Runtime::get().getFunction(functionIndex);
+    return environment.invoke(functionIndex, function, *this, aiState);
+}
+
+template <typename Environment>
+void script_state_t::run_operand(ai_state_t& aiState, script_info_t& script, Environment& environment)
+{
+    /// @author ZZ
+    /// @details This function does the scripted arithmetic in OPERATOR, OPERAND pscriptrs
+
+    Objects objects;
+    if (!environment.resolve(aiState, objects)) return;
+
+    // get the operator
+    int32_t iTmp = 0;
+
+    const auto& instruction = script._instructions[script.get_pos()];
+    const auto& constant = script._instructions.getConstantPool().getConstant(instruction.getValueBits());
+    uint8_t operation = instruction.getDataBits();
+    if (instruction.isLdc())
+    {
+        // Load the constant.
+        iTmp = constant.getAsInteger();
+    }
+    else
+    {
+        // Load the variable.
+        iTmp = environment.load(constant.getAsInteger(), *this, aiState, objects);
+    }
+
+    // Now do the math
+    const char *op = apply_operator(operationsum, operation, iTmp);
+
+    if (is_tracing())
+    {
+        trace_operand(op, instruction.isLdc() ? std::to_string(iTmp) : getVariableName(constant.getAsInteger()), iTmp);
+    }
+}
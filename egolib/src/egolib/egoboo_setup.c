@@ -84,6 +84,11 @@ egoboo_config_t::egoboo_config_t() :
     graphic_framesPerSecond_max(30, "graphic.framesPerSecond.max", "inclusive upper bound of frames per second"),
     graphic_simultaneousParticles_max(768, "graphic.simultaneousParticles.max", "inclusive upper bound of simultaneous particles"),
     graphic_hd_textures_enable(true, "graphic.graphic_hd_textures_enable", "enable/disable HD textures"),
+    graphic_keyframeBlending_enable(false, "graphic.keyframeBlending.enable", "enable/disable blending MD2 keyframes on the GPU"),
+    graphic_instancing_enable(true, "graphic.instancing.enable", "enable/disable drawing repeated objects with one draw call"),
+    graphic_parallelLighting_enable(true, "graphic.parallelLighting.enable", "enable/disable multi-threaded tile lighting"),
+    graphic_textureStreaming_enable(true, "graphic.textureStreaming.enable", "enable/disable decoding textures in the background"),
+    graphic_textureStreamingBudget_max(2048, "graphic.textureStreamingBudget.max", "inclusive upper bound of KiB of streamed textures uploaded per frame"),
     //
     graphic_window_borderless(false, "graphic.window.bordless",
                               "if the window is borderless. A bordless window neither has a caption nor an edge frame"),
@@ -107,6 +112,7 @@ egoboo_config_t::egoboo_config_t() :
     "Smaller values yield faster response time, but can lead to underflow if the audio buffer is not filled in time"),
     sound_highQuality_enable(false,"sound.highQuality.enable","enable/disable high quality sound"),
     sound_footfallEffects_enable(true,"sound.footfallEffects.enable","enable/disable footfall effects"),
+    sound_effectsCache_max(16384, "sound.effectsCache.max", "inclusive upper bound of KiB of decoded sound effects kept in memory"),
     // Network configuration section.
     network_enable(false,"network.enable","enable/disable networking"),
     network_lagTolerance(10,"network.lagTolerance","tolerance of lag in seconds"),
@@ -119,6 +125,11 @@ egoboo_config_t::egoboo_config_t() :
         { "Normal", Ego::GameDifficulty::Normal },
         { "Hard", Ego::GameDifficulty::Hard },
     }),
+    game_parallelPhysics_enable(true, "game.parallelPhysics.enable", "enable/disable multi-threaded physics updates"),
+    game_decodedScripts_enable(true, "game.decodedScripts.enable", "enable/disable running AI scripts from pre-decoded programs"),
+    game_parallelThink_enable(true, "game.parallelThink.enable", "enable/disable multi-threaded AI scripts"),
+    game_scriptCache_enable(true, "game.scriptCache.enable", "enable/disable caching compiled AI scripts"),
+    game_profileCache_enable(true, "game.profileCache.enable", "enable/disable caching parsed profiles"),
     // Camera configuration section.
     camera_control(CameraTurnMode::Auto, "camera.control", "type of camera control",
     {
@@ -147,7 +158,8 @@ egoboo_config_t::egoboo_config_t() :
     debug_hideMouse(true,"debug.hideMouse","show/hide mouse"),
     debug_grabMouse(true,"debug.grabMouse","grab/don't grab mouse"),
     debug_developerMode_enable(false,"debug.developerMode.enable","enable/disable developer mode"),
-    debug_sdlImage_enable(true,"debug.SDL_Image.enable","enable/disable advanced SDL_image function")
+    debug_sdlImage_enable(true,"debug.SDL_Image.enable","enable/disable advanced SDL_image function"),
+    debug_scriptProfiling_enable(false,"debug.scriptProfiling.enable","enable/disable measuring the time spent in script functions")
 {}
 
 egoboo_config_t::~egoboo_config_t()
@@ -85,6 +85,11 @@ protected:
                 config.graphic_framesPerSecond_max,
                 config.graphic_simultaneousParticles_max,
                 config.graphic_hd_textures_enable,
+                config.graphic_keyframeBlending_enable,
+                config.graphic_instancing_enable,
+                config.graphic_parallelLighting_enable,
+                config.graphic_textureStreaming_enable,
+                config.graphic_textureStreamingBudget_max,
                 //
                 config.graphic_window_borderless,
                 config.graphic_window_resizable,
@@ -99,6 +104,7 @@ protected:
                 config.sound_outputBuffer_size,
                 config.sound_highQuality_enable,
                 config.sound_footfallEffects_enable,
+                config.sound_effectsCache_max,
                 //
                 config.network_enable,
                 config.network_lagTolerance,
@@ -106,6 +112,11 @@ protected:
                 config.network_playerName,
                 //
                 config.game_difficulty,
+                config.game_parallelPhysics_enable,
+                config.game_decodedScripts_enable,
+                config.game_parallelThink_enable,
+                config.game_scriptCache_enable,
+                config.game_profileCache_enable,
                 //
                 config.camera_control,
                 //
@@ -124,7 +135,8 @@ protected:
                 config.debug_hideMouse,
                 config.debug_grabMouse,
                 config.debug_developerMode_enable,
-                config.debug_sdlImage_enable
+                config.debug_sdlImage_enable,
+                config.debug_scriptProfiling_enable
             );
         return variables;
     }
@@ -282,6 +294,33 @@ public:
     /// @remark Default value is @a true.
     Ego::Configuration::Variable<bool> graphic_hd_textures_enable;
 
+    /// @brief Enable/disable blending the keyframes of MD2 models on the GPU.
+    /// If enabled, the keyframes of a model are uploaded once and the
+    /// vertices of animated objects are no longer interpolated on the CPU.
+    /// Falls back to the CPU if the OpenGL implementation has no GLSL 1.20.
+    /// @remark Default value is @a false.
+    Ego::Configuration::Variable<bool> graphic_keyframeBlending_enable;
+
+    /// @brief Enable/disable drawing solid objects with the same model, keyframes and skin with one draw call.
+    /// Requires graphic_keyframeBlending_enable, as the keyframes of such objects are blended on the GPU.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> graphic_instancing_enable;
+
+    /// @brief Enable/disable lighting the corners and the vertices of the visible tiles on multiple threads.
+    /// The result is identical to the serial update.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> graphic_parallelLighting_enable;
+
+    /// @brief Enable/disable decoding the textures of models and icons in the background.
+    /// Until a texture is uploaded, the default texture is displayed.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> graphic_textureStreaming_enable;
+
+    /// @brief Inclusive upper bound of KiB of streamed textures uploaded per frame.
+    /// At least one texture is uploaded per frame.
+    /// @remark Default value is @a 2048.
+    Ego::Configuration::Variable<uint16_t> graphic_textureStreamingBudget_max;
+
     /// @brief If @a true, the window is borderless, otherwise it is not.
     /// @remark A borderless window displays neither a caption nor an edge frame.
     /// @default Default is @a false.
@@ -347,6 +386,11 @@ public:
     /// @brief Enable/disable footfall effects.
     Ego::Configuration::Variable<bool> sound_footfallEffects_enable;
 
+    /// @brief Inclusive upper bound of KiB of decoded sound effects kept in memory.
+    /// Sound effects are decoded when they are played first, the least recently played are released first.
+    /// @remark Default value is @a 16384.
+    Ego::Configuration::Variable<uint16_t> sound_effectsCache_max;
+
     // Network configuration section.
 
     /// @brief Enable/disable network?
@@ -378,6 +422,32 @@ public:
     /// @remark Default value is Ego::GameDifficulty::Normal.
     Ego::Configuration::Variable<Ego::GameDifficulty> game_difficulty;
 
+    /// @brief Enable/disable updating the physics of independent entities on multiple threads.
+    /// The result is identical to the serial update.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> game_parallelPhysics_enable;
+
+    /// @brief Enable/disable running AI scripts from pre-decoded programs.
+    /// The result is identical to interpreting the instructions.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> game_decodedScripts_enable;
+
+    /// @brief Enable/disable running the AI scripts of independent objects on multiple threads.
+    /// Only scripts with pre-decoded programs are run in parallel. The result is identical to the serial update.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> game_parallelThink_enable;
+
+    /// @brief Enable/disable caching compiled AI scripts in the user directory.
+    /// A cached script is only used if its source, the script functions, constants, variables and operators
+    /// and the values of its message and object literals did not change.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> game_scriptCache_enable;
+
+    /// @brief Enable/disable caching parsed particle, enchant and object profiles in the user directory.
+    /// A cached profile is only used if its source did not change.
+    /// @remark Default value is @a true.
+    Ego::Configuration::Variable<bool> game_profileCache_enable;
+
     // HUD configuration section.
 
     /// @brief Inclusive upper bound of simultaneous messages.
@@ -447,6 +517,11 @@ public:
     /// @remark Default value is @a true.
     Ego::Configuration::Variable<bool> debug_sdlImage_enable;
 
+    /// @brief Enable/disable measuring the time spent in script functions.
+    /// The timings are written to "/debug/script_function_timing.txt".
+    /// @remark Default value is @a false.
+    Ego::Configuration::Variable<bool> debug_scriptProfiling_enable;
+
 public:
 
     /// @brief Construct this Egoboo configuration with default settings.
@@ -31,6 +31,8 @@
 #include "egolib/Core/StringUtilities.hpp"
 #include "egolib/Core/System.hpp"
 #include "egolib/Core/QuadTree.hpp"
+#include "egolib/Core/SpatialGrid.hpp"
+#include "egolib/Core/JobSystem.hpp"
 
 //--------------------------------------------------------------------------------------------
 
@@ -77,6 +79,7 @@
 //--------------------------------------------------------------------------------------------
 
 #include "egolib/AI/AStar.hpp"
+#include "egolib/AI/PathCache.hpp"
 #include "egolib/AI/LineOfSight.hpp"
 
 //--------------------------------------------------------------------------------------------
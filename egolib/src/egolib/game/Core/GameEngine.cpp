@@ -217,6 +217,9 @@ void GameEngine::updateOneFrame()
     //Deferred loading for any textures requested by other threads
     Ego::TextureManager::get().updateDeferredLoading();
 
+    //Upload the textures decoded in the background
+    Ego::TextureManager::get().updateStreaming();
+
     //Update current game state
     _currentGameState->update();
 
@@ -373,6 +376,9 @@ bool GameEngine::initialize()
     // Initialize the profile system.
     ProfileSystem::initialize();
 
+    // Initialize the job system.
+    Ego::JobSystem::initialize();
+
     // Initialize the collision system.
     Ego::Physics::CollisionSystem::initialize();
 
@@ -455,6 +461,9 @@ void GameEngine::uninitialize()
     // Uninitialize the collision system.
     Ego::Physics::CollisionSystem::uninitialize();
 
+    // Uninitialize the job system.
+    Ego::JobSystem::uninitialize();
+
     // Uninitialize the scripting system.
     scripting_system_end();
 
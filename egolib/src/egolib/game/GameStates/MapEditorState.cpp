@@ -87,8 +87,8 @@ void MapEditorState::update()
     // Get immediate mode state for the rest of the game
     Ego::Input::InputSystem::get().update();
 
-    //Rebuild the quadtree for fast object lookup
-    _currentModule->getObjectHandler().updateQuadTree(0.0f, 0.0f, _currentModule->getMeshPointer()->_info.getTileCountX()*Info<float>::Grid::Size(),
+    //Update the spatial index for fast object lookup
+    _currentModule->getObjectHandler().updateSpatialIndex(0.0f, 0.0f, _currentModule->getMeshPointer()->_info.getTileCountX()*Info<float>::Grid::Size(),
 		                                                          _currentModule->getMeshPointer()->_info.getTileCountY()*Info<float>::Grid::Size());
 
     //Always reveal all invisible monsters and objects in Map Editor mode
@@ -0,0 +1,124 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/game/Graphics/AnimatedVertexCache.cpp
+/// @brief Interpolated MD2 vertices shared by object instances in the same animation state
+
+#include "egolib/game/Graphics/AnimatedVertexCache.hpp"
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+
+namespace Ego {
+namespace Graphics {
+
+AnimatedVertices::AnimatedVertices(const std::shared_ptr<MD2Model>& model, uint16_t sourceFrameIndex, uint16_t targetFrameIndex, uint8_t flip) :
+    _model(model),
+    _sourceFrameIndex(sourceFrameIndex),
+    _targetFrameIndex(targetFrameIndex),
+    _flip(flip),
+    _vertices(model->getFrames()[sourceFrameIndex].vertexList.size()),
+    _vmin(-1),
+    _vmax(-1)
+{
+    //ctor
+}
+
+void AnimatedVertices::interpolate(int vmin, int vmax)
+{
+    const auto& frames = _model->getFrames();
+    interpolateMD2Vertices(frames[_sourceFrameIndex].arrays, frames[_targetFrameIndex].arrays, vmin, vmax,
+                           float(_flip) / float(AnimatedVertexCache::FLIP_STEPS), _vertices.data());
+}
+
+void AnimatedVertices::update(int vmin, int vmax)
+{
+    if (_vmin < 0 || _vmax < 0)
+    {
+        interpolate(vmin, vmax);
+        _vmin = vmin;
+        _vmax = vmax;
+        return;
+    }
+    // extend the interpolated range, this includes any gap between the old and the new range
+    if (vmin < _vmin)
+    {
+        interpolate(vmin, _vmin - 1);
+        _vmin = vmin;
+    }
+    if (vmax > _vmax)
+    {
+        interpolate(_vmax + 1, vmax);
+        _vmax = vmax;
+    }
+}
+
+AnimatedVertexCache::AnimatedVertexCache() :
+    _entries(),
+    _statistics(),
+    _frameStatistics()
+{
+    //ctor
+}
+
+uint8_t AnimatedVertexCache::quantize(float flip)
+{
+    return static_cast<uint8_t>(Math::constrain<int>(std::lround(flip * FLIP_STEPS), 0, FLIP_STEPS));
+}
+
+std::shared_ptr<AnimatedVertices> AnimatedVertexCache::acquire(const std::shared_ptr<MD2Model>& model, uint16_t sourceFrameIndex, uint16_t targetFrameIndex, float flip)
+{
+    const Key key{model.get(), sourceFrameIndex, targetFrameIndex, quantize(flip)};
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        _frameStatistics.hits++;
+        return it->second;
+    }
+    _frameStatistics.misses++;
+    auto entry = std::make_shared<AnimatedVertices>(model, sourceFrameIndex, targetFrameIndex, key.flip);
+    _entries.emplace(key, entry);
+    return entry;
+}
+
+void AnimatedVertexCache::evict()
+{
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        if (it->second.use_count() == 1)
+        {
+            it = _entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    _frameStatistics.entries = _entries.size();
+    _statistics = _frameStatistics;
+    _frameStatistics = Statistics();
+}
+
+void AnimatedVertexCache::clear()
+{
+    _entries.clear();
+    _statistics = Statistics();
+    _frameStatistics = Statistics();
+}
+
+} // namespace Graphics
+} // namespace Ego
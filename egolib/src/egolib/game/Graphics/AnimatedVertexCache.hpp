@@ -0,0 +1,160 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/game/Graphics/AnimatedVertexCache.hpp
+/// @brief Interpolated MD2 vertices shared by object instances in the same animation state
+
+#pragma once
+
+#include "egolib/game/Graphics/Vertex.hpp"
+#include "egolib/Graphics/MD2Model.hpp"
+
+namespace Ego {
+namespace Graphics {
+
+/**
+ * @brief
+ *  The vertices of a model interpolated between two of its keyframes.
+ *  Shared by all object instances in the same animation state.
+ */
+class AnimatedVertices : private idlib::non_copyable
+{
+public:
+    /**
+     * @brief
+     *  Construct the (not yet interpolated) vertices of an animation state.
+     * @param flip
+     *  the quantized interpolation parameter, see AnimatedVertexCache::quantize()
+     */
+    AnimatedVertices(const std::shared_ptr<MD2Model>& model, uint16_t sourceFrameIndex, uint16_t targetFrameIndex, uint8_t flip);
+
+    /**
+     * @brief
+     *  Ensure the vertices with the indices @a vmin to @a vmax (inclusive) are interpolated.
+     *  Vertices interpolated before are not interpolated again.
+     */
+    void update(int vmin, int vmax);
+
+    /// @return @a true if these are the vertices of the specified animation state
+    bool matches(const MD2Model *model, uint16_t sourceFrameIndex, uint16_t targetFrameIndex, uint8_t flip) const
+    {
+        return _model.get() == model && _sourceFrameIndex == sourceFrameIndex && _targetFrameIndex == targetFrameIndex && _flip == flip;
+    }
+
+    const GLvertex& getVertex(size_t index) const
+    {
+        return _vertices[index];
+    }
+
+    size_t getVertexCount() const
+    {
+        return _vertices.size();
+    }
+
+private:
+    void interpolate(int vmin, int vmax);
+
+    std::shared_ptr<MD2Model> _model;
+    uint16_t _sourceFrameIndex;
+    uint16_t _targetFrameIndex;
+    uint8_t _flip;
+    std::vector<GLvertex> _vertices;
+    int _vmin;   ///< the minimum interpolated vertex, @a -1 if no vertex was interpolated yet
+    int _vmax;   ///< the maximum interpolated vertex, @a -1 if no vertex was interpolated yet
+};
+
+/**
+ * @brief
+ *  An engine-wide cache of animated vertices keyed by (model, source frame, target frame, quantized flip).
+ *  Object instances hold a reference to the vertices of their current animation state, entries no
+ *  instance refers to are evicted once per frame. This cache is not thread-safe.
+ */
+class AnimatedVertexCache : private idlib::non_copyable
+{
+public:
+    /// The number of steps the interpolation parameter [0,1] is quantized to.
+    /// This is the tolerance at which an instance refreshes its vertices.
+    static constexpr int FLIP_STEPS = 16;
+
+    struct Statistics
+    {
+        size_t entries = 0;  ///< number of cached animation states
+        size_t hits = 0;     ///< number of requests for cached animation states
+        size_t misses = 0;   ///< number of requests which created an animation state
+    };
+
+    AnimatedVertexCache();
+
+    /// @return the interpolation parameter @a flip quantized to the steps 0 to FLIP_STEPS
+    static uint8_t quantize(float flip);
+
+    /**
+     * @brief
+     *  Get the vertices of an animation state, create them if they are not cached.
+     *  The returned vertices may not be interpolated yet, see AnimatedVertices::update().
+     */
+    std::shared_ptr<AnimatedVertices> acquire(const std::shared_ptr<MD2Model>& model, uint16_t sourceFrameIndex, uint16_t targetFrameIndex, float flip);
+
+    /**
+     * @brief
+     *  Remove all animation states no instance refers to and start counting the requests of the next frame.
+     *  Called once per frame.
+     */
+    void evict();
+
+    /// Remove all animation states.
+    void clear();
+
+    /// @return the statistics of the last frame
+    const Statistics& getStatistics() const
+    {
+        return _statistics;
+    }
+
+private:
+    struct Key
+    {
+        const MD2Model *model;
+        uint16_t sourceFrameIndex;
+        uint16_t targetFrameIndex;
+        uint8_t flip;
+
+        bool operator==(const Key& other) const
+        {
+            return model == other.model && sourceFrameIndex == other.sourceFrameIndex
+                && targetFrameIndex == other.targetFrameIndex && flip == other.flip;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const
+        {
+            const uint64_t state = (uint64_t(key.sourceFrameIndex) << 24) | (uint64_t(key.targetFrameIndex) << 8) | key.flip;
+            return std::hash<const MD2Model *>()(key.model) ^ std::hash<uint64_t>()(state);
+        }
+    };
+
+    std::unordered_map<Key, std::shared_ptr<AnimatedVertices>, KeyHash> _entries;
+    Statistics _statistics;       ///< statistics of the last frame
+    Statistics _frameStatistics;  ///< statistics of the current frame
+};
+
+} // namespace Graphics
+} // namespace Ego
@@ -109,8 +109,10 @@ std::shared_ptr<Billboard> BillboardSystem::makeBillboard(::Time::Seconds lifeti
 
 BillboardSystem::BillboardSystem() :
     _billboardList(),
-    vertexDescriptor(Ego::descriptor_factory<idlib::vertex_format::P3FT2F>()()),
-    vertexBuffer(4, vertexDescriptor.get_size())
+    _visibleList(),
+    _textCache(),
+    vertexDescriptor(Ego::descriptor_factory<idlib::vertex_format::P3FC4FT2F>()()),
+    vertexBuffer()
 {}
 
 BillboardSystem::~BillboardSystem()
@@ -121,17 +123,34 @@ BillboardSystem::~BillboardSystem()
 void BillboardSystem::reset()
 {
     _billboardList.clear();
+    _visibleList.clear();
+    _textCache.clear();
 }
 
-bool BillboardSystem::render_one(Billboard& billboard, const Vector3f& cameraUp, const Vector3f& cameraRight)
+VertexBuffer& BillboardSystem::getVertexBuffer(size_t numberOfBillboards)
 {
-    auto obj_ptr = billboard._object.lock();
-    // Do not display billboards for objects that are being held of are inside an inventory.
-    if (!obj_ptr || obj_ptr->isTerminated() || obj_ptr->isBeingHeld() || obj_ptr->isInsideInventory())
+    if (!vertexBuffer || vertexBuffer->getNumberOfVertices() < numberOfBillboards * 4)
     {
-        return false;
+        // Grow geometrically such that the buffer is not reallocated every frame.
+        size_t numberOfVertices = vertexBuffer ? vertexBuffer->getNumberOfVertices() : 64;
+        while (numberOfVertices < numberOfBillboards * 4)
+        {
+            numberOfVertices *= 2;
+        }
+        vertexBuffer = std::make_unique<VertexBuffer>(numberOfVertices, vertexDescriptor.get_size());
     }
+    return *vertexBuffer;
+}
+
+bool BillboardSystem::isVisible(const Billboard& billboard)
+{
+    auto obj_ptr = billboard._object.lock();
+    // Do not display billboards for objects that are being held of are inside an inventory.
+    return obj_ptr && !obj_ptr->isTerminated() && !obj_ptr->isBeingHeld() && !obj_ptr->isInsideInventory();
+}
 
+void BillboardSystem::makeVertices(const Billboard& billboard, const Vector3f& cameraUp, const Vector3f& cameraRight, Vertex *vertices)
+{
     auto texture = billboard._texture.get();
 
     // Compute the texture coordinates.
@@ -141,58 +160,68 @@ bool BillboardSystem::render_one(Billboard& billboard, const Vector3f& cameraUp,
     Vector3f right = cameraRight * (texture->getSourceWidth()  * billboard._size),
         up = cameraUp    * (texture->getSourceHeight() * billboard._size);
 
+    const Vector3f corners[4] =
     {
-        Vector3f tmp;
-        Ego::VertexBufferScopedLock lock(vertexBuffer);
-        Vertex *vertices = lock.get<Vertex>();
-
         // bottom left
-        tmp = billboard._position + billboard._offset + (-right - up * 0);
-        vertices[0].x = tmp.x();
-        vertices[0].y = tmp.y();
-        vertices[0].z = tmp.z();
-        vertices[0].s = s;
-        vertices[0].t = t;
-
+        billboard._position + billboard._offset + (-right - up * 0),
         // top left
-        tmp = billboard._position + billboard._offset + (-right + up * 2);
-        vertices[1].x = tmp.x();
-        vertices[1].y = tmp.y();
-        vertices[1].z = tmp.z();
-        vertices[1].s = s;
-        vertices[1].t = 0;
-
+        billboard._position + billboard._offset + (-right + up * 2),
         // top right
-        tmp = billboard._position + billboard._offset + (right + up * 2);
-        vertices[2].x = tmp.x();
-        vertices[2].y = tmp.y();
-        vertices[2].z = tmp.z();
-        vertices[2].s = 0;
-        vertices[2].t = 0;
-
+        billboard._position + billboard._offset + (right + up * 2),
         // bottom right
-        tmp = billboard._position + billboard._offset + (right - up * 0);
-        vertices[3].x = tmp.x();
-        vertices[3].y = tmp.y();
-        vertices[3].z = tmp.z();
-        vertices[3].s = 0;
-        vertices[3].t = t;
-    }
+        billboard._position + billboard._offset + (right - up * 0),
+    };
+    const float texCoords[4][2] = { { s, t }, { s, 0 }, { 0, 0 }, { 0, t } };
 
+    for (size_t i = 0; i < 4; ++i)
     {
-        auto& renderer = Renderer::get();
-        renderer.setColour(billboard._tint);
-        renderer.getTextureUnit().setActivated(texture);
-
-        // Go on and draw it
-        renderer.render(vertexBuffer, vertexDescriptor, idlib::primitive_type::quadriliterals, 0, 4);
+        vertices[i].x = corners[i].x();
+        vertices[i].y = corners[i].y();
+        vertices[i].z = corners[i].z();
+        // The tint is a vertex colour such that billboards with different tints can be drawn together.
+        vertices[i].r = billboard._tint.get_r();
+        vertices[i].g = billboard._tint.get_g();
+        vertices[i].b = billboard._tint.get_b();
+        vertices[i].a = billboard._tint.get_a();
+        vertices[i].s = texCoords[i][0];
+        vertices[i].t = texCoords[i][1];
     }
-
-    return true;
 }
 
 void BillboardSystem::render_all(::Camera& camera)
 {
+    _visibleList.clear();
+    for (const auto &billboard : _billboardList)
+    {
+        if (isVisible(*billboard))
+        {
+            _visibleList.push_back(billboard.get());
+        }
+    }
+    if (_visibleList.empty())
+    {
+        return;
+    }
+
+    // Group the billboards by the names of their textures. The sort is stable such that billboards
+    // with the same texture are drawn in the order they were created and the order does not depend
+    // on where the textures were allocated.
+    std::stable_sort(_visibleList.begin(), _visibleList.end(), [](const Billboard *x, const Billboard *y)
+    {
+        return x->_texture->getName() < y->_texture->getName();
+    });
+
+    auto& vb = getVertexBuffer(_visibleList.size());
+    {
+        Vertex *vertices = static_cast<Vertex *>(vb.lock());
+        for (const Billboard *billboard : _visibleList)
+        {
+            makeVertices(*billboard, camera.getUp(), camera.getRight(), vertices);
+            vertices += 4;
+        }
+        vb.unlock();
+    }
+
     Renderer3D::begin3D(camera);
     {
         OpenGL::PushAttrib pa(GL_LIGHTING_BIT | GL_DEPTH_BUFFER_BIT | GL_POLYGON_BIT | GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
@@ -217,21 +246,37 @@ void BillboardSystem::render_all(::Camera& camera)
             renderer.setAlphaTestEnabled(true);
             renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
 
-            for (const auto &billboard : _billboardList)
+            // One draw call per texture.
+            for (size_t first = 0, last; first < _visibleList.size(); first = last)
             {
-                render_one(*billboard, camera.getUp(), camera.getRight());
+                auto texture = _visibleList[first]->_texture.get();
+                for (last = first + 1; last < _visibleList.size() && _visibleList[last]->_texture.get() == texture; ++last)
+                {}
+                renderer.getTextureUnit().setActivated(texture);
+                renderer.render(vb, vertexDescriptor, idlib::primitive_type::quadriliterals, first * 4, (last - first) * 4);
             }
         }
     }
     Renderer3D::end3D();
 }
 
-std::shared_ptr<Billboard> BillboardSystem::makeBillboard(ObjectRef obj_ref, const std::string& text, const Ego::Math::Colour4f& textColor, const Ego::Math::Colour4f& tint, int lifetime_secs, const BIT_FIELD opt_bits, const float size)
+std::shared_ptr<Ego::Texture> BillboardSystem::getTextTexture(const std::string& text, const Ego::Math::Colour3f& textColor)
 {
-    auto obj_ptr = _currentModule->getObjectHandler()[obj_ref];
-    if (!obj_ptr)
+    auto key = std::make_tuple(text, textColor.get_r(), textColor.get_g(), textColor.get_b());
+    auto it = _textCache.find(key);
+    if (it != _textCache.end())
     {
-        return nullptr;
+        if (auto tex = it->second.lock())
+        {
+            return tex;
+        }
+    }
+
+    // Remove the texts no billboard refers to anymore.
+    for (auto jt = _textCache.begin(); jt != _textCache.end();)
+    {
+        if (jt->second.expired()) jt = _textCache.erase(jt);
+        else ++jt;
     }
 
     // Pre-render the text.
@@ -244,8 +289,27 @@ std::shared_ptr<Billboard> BillboardSystem::makeBillboard(ObjectRef obj_ref, con
     {
         return nullptr;
     }
-    _gameEngine->getUIManager()->getFloatingTextFont()->drawTextToTexture(tex.get(), text, Ego::Math::Colour3f(textColor.get_r(), textColor.get_g(), textColor.get_b()));
-    tex->setName("billboard text");
+    _gameEngine->getUIManager()->getFloatingTextFont()->drawTextToTexture(tex.get(), text, textColor);
+    tex->setName("billboard text '" + text + "'");
+
+    _textCache[key] = tex;
+    return tex;
+}
+
+std::shared_ptr<Billboard> BillboardSystem::makeBillboard(ObjectRef obj_ref, const std::string& text, const Ego::Math::Colour4f& textColor, const Ego::Math::Colour4f& tint, int lifetime_secs, const BIT_FIELD opt_bits, const float size)
+{
+    auto obj_ptr = _currentModule->getObjectHandler()[obj_ref];
+    if (!obj_ptr)
+    {
+        return nullptr;
+    }
+
+    // Get the pre-rendered text.
+    auto tex = getTextTexture(text, Ego::Math::Colour3f(textColor.get_r(), textColor.get_g(), textColor.get_b()));
+    if (!tex)
+    {
+        return nullptr;
+    }
 
     // Create a new billboard.
     auto billboard = makeBillboard(lifetime_secs, tex, tint, opt_bits, size);
@@ -41,7 +41,6 @@ public:
     BillboardSystem();
     virtual ~BillboardSystem();
 public:
-    bool render_one(Billboard& billboard, const Vector3f& cam_up, const Vector3f& cam_rgt);
     /// @brief Update all billboards in this billboard system with the time of "now".
     void update();
     void reset();
@@ -50,15 +49,32 @@ public:
 private:
     // List of used billboards.
     std::list<std::shared_ptr<Billboard>> _billboardList;
+    // The billboards to be rendered in the current frame.
+    std::vector<Billboard *> _visibleList;
+    // Pre-rendered texts indexed by their text and their colour.
+    // Billboards with the same text and colour share their texture.
+    std::map<std::tuple<std::string, float, float, float>, std::weak_ptr<Ego::Texture>> _textCache;
     // A vertex type used by the billboard system.
     struct Vertex
     {
         float x, y, z;
+        float r, g, b, a;
         float s, t;
     };
     // A vertex desscriptor & a vertex buffer used by the billboard system.
+    // The vertex buffer grows as required.
     VertexDescriptor vertexDescriptor;
-    VertexBuffer vertexBuffer;
+    std::unique_ptr<VertexBuffer> vertexBuffer;
+
+    /// @brief Get if a billboard is to be rendered.
+    static bool isVisible(const Billboard& billboard);
+    /// @brief Write the four vertices of a billboard.
+    static void makeVertices(const Billboard& billboard, const Vector3f& cam_up, const Vector3f& cam_rgt, Vertex *vertices);
+    /// @brief Get the vertex buffer, growing it if it can not hold the given number of billboards.
+    VertexBuffer& getVertexBuffer(size_t numberOfBillboards);
+    /// @brief Get the pre-rendered text, rendering it if it is not cached.
+    /// @return the texture, or a null pointer if it could not be created
+    std::shared_ptr<Ego::Texture> getTextTexture(const std::string& text, const Ego::Math::Colour3f& textColor);
 
 private:
 
@@ -75,6 +91,8 @@ private:
     std::shared_ptr<Billboard> makeBillboard(::Time::Seconds lifetime_secs, std::shared_ptr<Ego::Texture> texture, const Ego::Math::Colour4f& tint, const BIT_FIELD options, const float size);
 
 public:
+    /// @brief Render all billboards.
+    /// @remark Billboards with the same texture are rendered with a single draw call.
     void render_all(::Camera& camera);
 
     std::shared_ptr<Billboard> makeBillboard(ObjectRef obj_ref, const std::string& text, const Ego::Math::Colour4f& textColor, const Ego::Math::Colour4f& tint, int lifetime_secs, const BIT_FIELD opt_bits, const float size = 0.75f);
@@ -0,0 +1,608 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/game/Graphics/KeyframeMd2ModelRenderer.cpp
+/// @brief  Renderer for MD2 models blending keyframes on the GPU
+
+#include "egolib/game/Graphics/KeyframeMd2ModelRenderer.hpp"
+#include "egolib/Graphics/MD2Model.hpp"
+#include "egolib/game/lighting.h"
+#include "egolib/Extensions/ogl_extensions.h"
+
+namespace Ego {
+namespace Graphics {
+
+namespace {
+
+/// @brief The generic vertex attributes of the shader programs.
+enum Attribute : GLuint
+{
+    SourcePosition = 0,
+    SourceNormal = 1,
+    TargetPosition = 2,
+    TargetNormal = 3,
+    TextureCoordinate = 4,
+    // The per-instance attributes of the instanced program.
+    WorldMatrix = 5, // occupies 4 attributes
+    InstanceTint = 9,
+    LowPositiveLight = 10,
+    LowNegativeLight = 11,
+    HighPositiveLight = 12,
+    HighNegativeLight = 13,
+    InstanceState = 14,
+    InstanceFlash = 15,
+};
+
+/// @brief The number of floats of the state of an instance in the instance buffer.
+constexpr size_t InstanceSize = 41;
+
+/// @brief The declarations and functions shared by the vertex shaders.
+/// @remark The lighting reproduces ObjectGraphics::updateLighting(), lighting_cache_t::lighting_evaluate_cache()
+/// and ObjectGraphicsRenderer::render_tex(): The light is interpolated between the low and the high lighting
+/// by the height of the vertex, the directional light is truncated to an integer, ambient light is added
+/// and the result is clamped to [0,1] and tinted. A non-negative flash replaces the directional light of
+/// all vertices like ObjectGraphics::flash().
+const char *vertexShaderCommonSource =
+    "#version 120\n"
+    "attribute vec3 sourcePosition;\n"
+    "attribute vec3 sourceNormal;\n"
+    "attribute vec3 targetPosition;\n"
+    "attribute vec3 targetNormal;\n"
+    "attribute vec2 textureCoordinate;\n"
+    "uniform vec2 heightRange;\n"
+    "float evaluate(vec3 positive, vec3 negative, float ambient, vec3 normal) {\n"
+    "    return dot(max(normal, 0.0), positive) + dot(max(-normal, 0.0), negative) + ambient;\n"
+    "}\n"
+    "float evaluateVertex(vec3 positive, vec3 negative, float ambient, vec3 normal) {\n"
+    "    if (normal == vec3(0.0)) {\n"
+    "        // the \"ambient only\" normal sums up the light of all directions\n"
+    "        return (evaluate(positive, negative, ambient, vec3(1.0)) + evaluate(positive, negative, ambient, vec3(-1.0))) / 6.0;\n"
+    "    }\n"
+    "    return evaluate(positive, negative, ambient, normal);\n"
+    "}\n"
+    "vec4 shade(vec3 position, vec3 normal, bool lit, vec4 tint, float ambient, float flash, float heightScale,\n"
+    "           vec3 lowPositive, vec3 lowNegative, float lowAmbient, vec3 highPositive, vec3 highNegative, float highAmbient) {\n"
+    "    if (!lit) {\n"
+    "        return tint;\n"
+    "    }\n"
+    "    if (flash >= 0.0) {\n"
+    "        return vec4(clamp(vec3(flash / 255.0 + ambient), 0.0, 1.0) * tint.rgb, 1.0);\n"
+    "    }\n"
+    "    float height = position.z * heightScale + heightScale;\n"
+    "    float weight = clamp((height - heightRange.x) / (heightRange.y - heightRange.x), 0.0, 1.0);\n"
+    "    float light = mix(evaluateVertex(lowPositive, lowNegative, lowAmbient, normal),\n"
+    "                      evaluateVertex(highPositive, highNegative, highAmbient, normal), weight);\n"
+    "    light = sign(light) * floor(abs(light));\n"
+    "    return vec4(clamp(vec3(light / 255.0 + ambient), 0.0, 1.0) * tint.rgb, 1.0);\n"
+    "}\n";
+
+/// @brief The vertex shader taking the state of an instance from uniforms.
+const char *vertexShaderSource =
+    "uniform float flip;\n"
+    "uniform vec4 tint;\n"
+    "uniform vec2 textureOffset;\n"
+    "uniform bool lit;\n"
+    "uniform float ambient;\n"
+    "uniform float flash;\n"
+    "uniform vec3 positiveLight[2];\n" // light from +x, +y, +z of the low and the high lighting
+    "uniform vec3 negativeLight[2];\n" // light from -x, -y, -z of the low and the high lighting
+    "uniform float ambientLight[2];\n"
+    "uniform float heightScale;\n"
+    "void main() {\n"
+    "    vec3 position = sourcePosition + (targetPosition - sourcePosition) * flip;\n"
+    "    vec3 normal = sourceNormal + (targetNormal - sourceNormal) * flip;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 1.0);\n"
+    "    gl_TexCoord[0] = vec4(textureCoordinate + textureOffset, 0.0, 1.0);\n"
+    "    gl_FrontColor = shade(position, normal, lit, tint, ambient, flash, heightScale,\n"
+    "                          positiveLight[0], negativeLight[0], ambientLight[0],\n"
+    "                          positiveLight[1], negativeLight[1], ambientLight[1]);\n"
+    "}\n";
+
+/// @brief The vertex shader taking the state of an instance from instanced attributes.
+const char *instancedVertexShaderSource =
+    "attribute mat4 worldMatrix;\n"
+    "attribute vec4 instanceTint;\n"
+    "attribute vec4 lowPositiveLight;\n"  // w: low ambient light
+    "attribute vec4 lowNegativeLight;\n"  // w: ambient light added to the vertex light
+    "attribute vec4 highPositiveLight;\n" // w: high ambient light
+    "attribute vec4 highNegativeLight;\n" // w: height scale
+    "attribute vec4 instanceState;\n"     // texture offset, flip, lit
+    "attribute float instanceFlash;\n"
+    "void main() {\n"
+    "    float flip = instanceState.z;\n"
+    "    vec3 position = sourcePosition + (targetPosition - sourcePosition) * flip;\n"
+    "    vec3 normal = sourceNormal + (targetNormal - sourceNormal) * flip;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * (worldMatrix * vec4(position, 1.0));\n"
+    "    gl_TexCoord[0] = vec4(textureCoordinate + instanceState.xy, 0.0, 1.0);\n"
+    "    gl_FrontColor = shade(position, normal, instanceState.w > 0.5, instanceTint, lowNegativeLight.w, instanceFlash, highNegativeLight.w,\n"
+    "                          lowPositiveLight.xyz, lowNegativeLight.xyz, lowPositiveLight.w,\n"
+    "                          highPositiveLight.xyz, highNegativeLight.xyz, highPositiveLight.w);\n"
+    "}\n";
+
+/// @brief The fragment shader.
+const char *fragmentShaderSource =
+    "#version 120\n"
+    "uniform bool textured;\n"
+    "uniform sampler2D skin;\n"
+    "void main() {\n"
+    "    gl_FragColor = textured ? gl_Color * texture2D(skin, gl_TexCoord[0].st) : gl_Color;\n"
+    "}\n";
+
+GLuint compileShader(GLenum type, const std::vector<const char *>& sources)
+{
+    GLuint shader = glCreateShader(type);
+    if (0 == shader)
+    {
+        return 0;
+    }
+    glShaderSource(shader, static_cast<GLsizei>(sources.size()), sources.data(), nullptr);
+    glCompileShader(shader);
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (GL_TRUE != status)
+    {
+        GLchar infoLog[1024] = {};
+        glGetShaderInfoLog(shader, sizeof(infoLog), nullptr, infoLog);
+        Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to compile keyframe blending shader: ", infoLog, Log::EndOfEntry);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+/// @brief Convert the lighting of an instance into the light from the positive and the
+/// negative axes and the ambient light of the low and the high lighting.
+void packLighting(const Md2ModelRenderer::KeyframeBlend& blend, GLfloat positiveLight[6], GLfloat negativeLight[6], GLfloat ambientLight[2])
+{
+    std::fill(positiveLight, positiveLight + 6, 0.0f);
+    std::fill(negativeLight, negativeLight + 6, 0.0f);
+    std::fill(ambientLight, ambientLight + 2, 0.0f);
+    if (!blend.lighting)
+    {
+        return;
+    }
+    const lighting_cache_base_t *levels[] = { &blend.lighting->low, &blend.lighting->hgh };
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const LightingVector& lighting = levels[i]->_lighting;
+        // Without directional light only the ambient light is evaluated.
+        if (0.0f != levels[i]->_max_light)
+        {
+            positiveLight[3 * i + 0] = lighting[LVEC_PX];
+            positiveLight[3 * i + 1] = lighting[LVEC_PY];
+            positiveLight[3 * i + 2] = lighting[LVEC_PZ];
+            negativeLight[3 * i + 0] = lighting[LVEC_MX];
+            negativeLight[3 * i + 1] = lighting[LVEC_MY];
+            negativeLight[3 * i + 2] = lighting[LVEC_MZ];
+        }
+        ambientLight[i] = lighting[LVEC_AMB];
+    }
+}
+
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+    if (GLEW_VERSION_3_3)
+    {
+        glVertexAttribDivisor(index, divisor);
+    }
+    else
+    {
+        glVertexAttribDivisorARB(index, divisor);
+    }
+}
+
+void drawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+{
+    if (GLEW_VERSION_3_1)
+    {
+        glDrawArraysInstanced(mode, first, count, instanceCount);
+    }
+    else
+    {
+        glDrawArraysInstancedARB(mode, first, count, instanceCount);
+    }
+}
+
+} // namespace
+
+KeyframeMd2ModelRenderer::Stream KeyframeMd2ModelRenderer::Stream::build(MD2Model& model)
+{
+    Stream stream;
+    stream.vertexCount = 0;
+    stream.frameCount = model.getFrames().size();
+
+    // Unroll the commands.
+    std::vector<uint16_t> indices;
+    for (const MD2_GLCommand& glcommand : model.getGLCommands())
+    {
+        Command command;
+        command.mode = glcommand.glMode;
+        command.first = static_cast<GLint>(indices.size());
+        for (const id_glcmd_packed_t& cmd : glcommand.data)
+        {
+            if (cmd.index >= model.getVertexCount())
+            {
+                continue;
+            }
+            indices.push_back(cmd.index);
+            stream.textureCoordinates.push_back(cmd.s);
+            stream.textureCoordinates.push_back(cmd.t);
+        }
+        command.count = static_cast<GLsizei>(indices.size()) - command.first;
+        if (command.count > 0)
+        {
+            stream.commands.push_back(command);
+        }
+    }
+    stream.vertexCount = indices.size();
+
+    // Unroll the keyframes.
+    stream.keyframes.reserve(stream.frameCount * stream.vertexCount * 6);
+    for (const MD2_Frame& frame : model.getFrames())
+    {
+        const MD2_FrameArrays& arrays = frame.arrays;
+        for (uint16_t index : indices)
+        {
+            stream.keyframes.push_back(arrays.posX[index]);
+            stream.keyframes.push_back(arrays.posY[index]);
+            stream.keyframes.push_back(arrays.posZ[index]);
+            stream.keyframes.push_back(arrays.nrmX[index]);
+            stream.keyframes.push_back(arrays.nrmY[index]);
+            stream.keyframes.push_back(arrays.nrmZ[index]);
+        }
+    }
+    return stream;
+}
+
+KeyframeMd2ModelRenderer::KeyframeMd2ModelRenderer()
+    : DefaultMd2ModelRenderer(), m_buffers(), m_programChecked(false), m_program(), m_instancedProgram(),
+      m_instanceBuffer(0), m_instanceData()
+{}
+
+KeyframeMd2ModelRenderer::~KeyframeMd2ModelRenderer()
+{
+    release();
+}
+
+void KeyframeMd2ModelRenderer::release()
+{
+    for (auto& entry : m_buffers)
+    {
+        deleteBuffers(entry.second);
+    }
+    m_buffers.clear();
+    for (Program *program : { &m_program, &m_instancedProgram })
+    {
+        if (0 != program->id)
+        {
+            glDeleteProgram(program->id);
+            program->id = 0;
+        }
+    }
+    if (0 != m_instanceBuffer)
+    {
+        glDeleteBuffers(1, &m_instanceBuffer);
+        m_instanceBuffer = 0;
+    }
+    m_programChecked = false;
+}
+
+void KeyframeMd2ModelRenderer::deleteBuffers(Buffers& buffers)
+{
+    GLuint names[] = { buffers.textureCoordinates, buffers.keyframes };
+    glDeleteBuffers(2, names);
+    buffers.textureCoordinates = 0;
+    buffers.keyframes = 0;
+}
+
+bool KeyframeMd2ModelRenderer::isInstancingSupported()
+{
+    return (GLEW_VERSION_3_3 || GLEW_ARB_instanced_arrays) && (GLEW_VERSION_3_1 || GLEW_ARB_draw_instanced);
+}
+
+KeyframeMd2ModelRenderer::Program KeyframeMd2ModelRenderer::createProgram(bool instanced)
+{
+    Program program = {};
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, { vertexShaderCommonSource, instanced ? instancedVertexShaderSource : vertexShaderSource });
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, { fragmentShaderSource });
+    if (0 != vertexShader && 0 != fragmentShader)
+    {
+        program.id = glCreateProgram();
+        glAttachShader(program.id, vertexShader);
+        glAttachShader(program.id, fragmentShader);
+        glBindAttribLocation(program.id, SourcePosition, "sourcePosition");
+        glBindAttribLocation(program.id, SourceNormal, "sourceNormal");
+        glBindAttribLocation(program.id, TargetPosition, "targetPosition");
+        glBindAttribLocation(program.id, TargetNormal, "targetNormal");
+        glBindAttribLocation(program.id, TextureCoordinate, "textureCoordinate");
+        if (instanced)
+        {
+            glBindAttribLocation(program.id, WorldMatrix, "worldMatrix");
+            glBindAttribLocation(program.id, InstanceTint, "instanceTint");
+            glBindAttribLocation(program.id, LowPositiveLight, "lowPositiveLight");
+            glBindAttribLocation(program.id, LowNegativeLight, "lowNegativeLight");
+            glBindAttribLocation(program.id, HighPositiveLight, "highPositiveLight");
+            glBindAttribLocation(program.id, HighNegativeLight, "highNegativeLight");
+            glBindAttribLocation(program.id, InstanceState, "instanceState");
+            glBindAttribLocation(program.id, InstanceFlash, "instanceFlash");
+        }
+        glLinkProgram(program.id);
+        GLint status = GL_FALSE;
+        glGetProgramiv(program.id, GL_LINK_STATUS, &status);
+        if (GL_TRUE != status)
+        {
+            GLchar infoLog[1024] = {};
+            glGetProgramInfoLog(program.id, sizeof(infoLog), nullptr, infoLog);
+            Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "unable to link keyframe blending shader: ", infoLog, Log::EndOfEntry);
+            glDeleteProgram(program.id);
+            program.id = 0;
+        }
+    }
+    // The shaders are deleted as soon as the program is deleted.
+    if (0 != vertexShader) glDeleteShader(vertexShader);
+    if (0 != fragmentShader) glDeleteShader(fragmentShader);
+    if (0 != program.id)
+    {
+        program.flip = glGetUniformLocation(program.id, "flip");
+        program.tint = glGetUniformLocation(program.id, "tint");
+        program.textureOffset = glGetUniformLocation(program.id, "textureOffset");
+        program.lit = glGetUniformLocation(program.id, "lit");
+        program.ambient = glGetUniformLocation(program.id, "ambient");
+        program.flash = glGetUniformLocation(program.id, "flash");
+        program.positiveLight = glGetUniformLocation(program.id, "positiveLight");
+        program.negativeLight = glGetUniformLocation(program.id, "negativeLight");
+        program.ambientLight = glGetUniformLocation(program.id, "ambientLight");
+        program.heightScale = glGetUniformLocation(program.id, "heightScale");
+        program.heightRange = glGetUniformLocation(program.id, "heightRange");
+        program.textured = glGetUniformLocation(program.id, "textured");
+        program.skin = glGetUniformLocation(program.id, "skin");
+    }
+    return program;
+}
+
+bool KeyframeMd2ModelRenderer::canBlendKeyframes()
+{
+    if (!m_programChecked)
+    {
+        m_programChecked = true;
+        // The shaders require OpenGL 2.0.
+        if (!GLEW_VERSION_2_0)
+        {
+            Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "OpenGL 2.0 is not available, keyframes are blended on the CPU", Log::EndOfEntry);
+            return false;
+        }
+        m_program = createProgram(false);
+        if (0 != m_program.id && isInstancingSupported())
+        {
+            m_instancedProgram = createProgram(true);
+        }
+    }
+    return 0 != m_program.id;
+}
+
+const KeyframeMd2ModelRenderer::Buffers& KeyframeMd2ModelRenderer::getBuffers(const std::shared_ptr<MD2Model>& model)
+{
+    auto it = m_buffers.find(model.get());
+    if (it != m_buffers.end() && it->second.model.lock() == model)
+    {
+        return it->second;
+    }
+
+    // Remove the buffers of deleted models (including a previous model at the same address).
+    for (auto jt = m_buffers.begin(); jt != m_buffers.end();)
+    {
+        if (jt->second.model.expired() || jt->first == model.get())
+        {
+            deleteBuffers(jt->second);
+            jt = m_buffers.erase(jt);
+        }
+        else
+        {
+            ++jt;
+        }
+    }
+
+    Stream stream = Stream::build(*model);
+
+    Buffers buffers;
+    buffers.model = model;
+    buffers.vertexCount = stream.vertexCount;
+    buffers.frameCount = stream.frameCount;
+    buffers.commands = std::move(stream.commands);
+    GLuint names[2];
+    glGenBuffers(2, names);
+    buffers.textureCoordinates = names[0];
+    buffers.keyframes = names[1];
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.textureCoordinates);
+    glBufferData(GL_ARRAY_BUFFER, stream.textureCoordinates.size() * sizeof(float), stream.textureCoordinates.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.keyframes);
+    glBufferData(GL_ARRAY_BUFFER, stream.keyframes.size() * sizeof(float), stream.keyframes.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    Ego::OpenGL::Utilities::isError();
+
+    return m_buffers.emplace(model.get(), std::move(buffers)).first->second;
+}
+
+void KeyframeMd2ModelRenderer::bindVertexAttributes(const Buffers& buffers, uint16_t sourceFrameIndex, uint16_t targetFrameIndex)
+{
+    // The keyframes are selected by the attribute offsets.
+    const GLsizei stride = 6 * sizeof(float);
+    auto offset = [&buffers](uint16_t frameIndex, size_t component)
+    {
+        return reinterpret_cast<const GLvoid *>((frameIndex * buffers.vertexCount * 6 + component) * sizeof(float));
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.textureCoordinates);
+    glVertexAttribPointer(TextureCoordinate, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.keyframes);
+    glVertexAttribPointer(SourcePosition, 3, GL_FLOAT, GL_FALSE, stride, offset(sourceFrameIndex, 0));
+    glVertexAttribPointer(SourceNormal, 3, GL_FLOAT, GL_FALSE, stride, offset(sourceFrameIndex, 3));
+    glVertexAttribPointer(TargetPosition, 3, GL_FLOAT, GL_FALSE, stride, offset(targetFrameIndex, 0));
+    glVertexAttribPointer(TargetNormal, 3, GL_FLOAT, GL_FALSE, stride, offset(targetFrameIndex, 3));
+    for (GLuint attribute = SourcePosition; attribute <= TextureCoordinate; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+    }
+}
+
+void KeyframeMd2ModelRenderer::unbindVertexAttributes()
+{
+    for (GLuint attribute = SourcePosition; attribute <= TextureCoordinate; ++attribute)
+    {
+        glDisableVertexAttribArray(attribute);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool KeyframeMd2ModelRenderer::renderBlended(const std::shared_ptr<MD2Model>& model, const KeyframeBlend& blend)
+{
+    if (!model || !canBlendKeyframes())
+    {
+        return false;
+    }
+    const Buffers& buffers = getBuffers(model);
+    if (blend.sourceFrameIndex >= buffers.frameCount || blend.targetFrameIndex >= buffers.frameCount)
+    {
+        return false;
+    }
+
+    glUseProgram(m_program.id);
+
+    // Per-instance state.
+    glUniform1f(m_program.flip, blend.flip);
+    glUniform4fv(m_program.tint, 1, blend.tint);
+    glUniform2f(m_program.textureOffset, blend.uoffset, blend.voffset);
+    glUniform1i(m_program.lit, blend.lit ? 1 : 0);
+    glUniform1f(m_program.ambient, blend.ambient);
+    glUniform1f(m_program.flash, blend.flash);
+    GLfloat positiveLight[6], negativeLight[6], ambientLight[2];
+    packLighting(blend, positiveLight, negativeLight, ambientLight);
+    glUniform3fv(m_program.positiveLight, 2, positiveLight);
+    glUniform3fv(m_program.negativeLight, 2, negativeLight);
+    glUniform1fv(m_program.ambientLight, 2, ambientLight);
+    glUniform1f(m_program.heightScale, blend.heightScale);
+    glUniform2f(m_program.heightRange, blend.minZ, blend.maxZ);
+    glUniform1i(m_program.textured, glIsEnabled(GL_TEXTURE_2D) ? 1 : 0);
+    glUniform1i(m_program.skin, 0);
+
+    bindVertexAttributes(buffers, blend.sourceFrameIndex, blend.targetFrameIndex);
+    for (const Command& command : buffers.commands)
+    {
+        glDrawArrays(command.mode, command.first, command.count);
+    }
+    unbindVertexAttributes();
+
+    glUseProgram(0);
+    return !Ego::OpenGL::Utilities::isError();
+}
+
+bool KeyframeMd2ModelRenderer::renderInstanced(const std::shared_ptr<MD2Model>& model, const std::vector<KeyframeInstance>& instances)
+{
+    if (!model || !canBlendKeyframes() || 0 == m_instancedProgram.id)
+    {
+        return false;
+    }
+    if (instances.empty())
+    {
+        return true;
+    }
+    const Buffers& buffers = getBuffers(model);
+    const KeyframeBlend& first = instances.front().blend;
+    if (first.sourceFrameIndex >= buffers.frameCount || first.targetFrameIndex >= buffers.frameCount)
+    {
+        return false;
+    }
+
+    // Pack the states of the instances.
+    m_instanceData.resize(instances.size() * InstanceSize);
+    float *target = m_instanceData.data();
+    for (const KeyframeInstance& instance : instances)
+    {
+        const KeyframeBlend& blend = instance.blend;
+        GLfloat positiveLight[6], negativeLight[6], ambientLight[2];
+        packLighting(blend, positiveLight, negativeLight, ambientLight);
+        // The world matrix column by column.
+        for (size_t column = 0; column < 4; ++column)
+        {
+            for (size_t row = 0; row < 4; ++row)
+            {
+                *target++ = instance.worldMatrix(row, column);
+            }
+        }
+        for (size_t i = 0; i < 4; ++i)
+        {
+            *target++ = blend.tint[i];
+        }
+        const float w[] = { ambientLight[0], blend.ambient, ambientLight[1], blend.heightScale };
+        const GLfloat *lights[] = { positiveLight, negativeLight, positiveLight + 3, negativeLight + 3 };
+        for (size_t i = 0; i < 4; ++i)
+        {
+            *target++ = lights[i][0];
+            *target++ = lights[i][1];
+            *target++ = lights[i][2];
+            *target++ = w[i];
+        }
+        *target++ = blend.uoffset;
+        *target++ = blend.voffset;
+        *target++ = blend.flip;
+        *target++ = blend.lit ? 1.0f : 0.0f;
+        *target++ = blend.flash;
+    }
+    if (0 == m_instanceBuffer)
+    {
+        glGenBuffers(1, &m_instanceBuffer);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, m_instanceData.size() * sizeof(float), m_instanceData.data(), GL_STREAM_DRAW);
+
+    glUseProgram(m_instancedProgram.id);
+    glUniform2f(m_instancedProgram.heightRange, first.minZ, first.maxZ);
+    glUniform1i(m_instancedProgram.textured, glIsEnabled(GL_TEXTURE_2D) ? 1 : 0);
+    glUniform1i(m_instancedProgram.skin, 0);
+
+    // The instance attributes advance once per instance.
+    // All but the flash are vectors of 4 floats.
+    const GLsizei stride = InstanceSize * sizeof(float);
+    for (GLuint attribute = WorldMatrix; attribute <= InstanceFlash; ++attribute)
+    {
+        const size_t offset = (attribute - WorldMatrix) * 4 * sizeof(float);
+        const GLint size = InstanceFlash == attribute ? 1 : 4;
+        glVertexAttribPointer(attribute, size, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const GLvoid *>(offset));
+        vertexAttribDivisor(attribute, 1);
+        glEnableVertexAttribArray(attribute);
+    }
+
+    bindVertexAttributes(buffers, first.sourceFrameIndex, first.targetFrameIndex);
+    for (const Command& command : buffers.commands)
+    {
+        drawArraysInstanced(command.mode, command.first, command.count, static_cast<GLsizei>(instances.size()));
+    }
+    unbindVertexAttributes();
+
+    for (GLuint attribute = WorldMatrix; attribute <= InstanceFlash; ++attribute)
+    {
+        vertexAttribDivisor(attribute, 0);
+        glDisableVertexAttribArray(attribute);
+    }
+
+    glUseProgram(0);
+    return !Ego::OpenGL::Utilities::isError();
+}
+
+} // namespace Graphics
+} // namespace Ego
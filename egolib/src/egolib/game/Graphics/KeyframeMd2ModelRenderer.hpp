@@ -0,0 +1,155 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file   egolib/game/Graphics/KeyframeMd2ModelRenderer.hpp
+/// @brief  Renderer for MD2 models blending keyframes on the GPU
+
+#pragma once
+
+#include "egolib/game/Graphics/DefaultMd2ModelRenderer.hpp"
+#include <GL/glew.h>
+
+namespace Ego {
+namespace Graphics {
+
+/// @brief Renderer for MD2 models which blends keyframes on the GPU.
+/// @details The keyframes of a model are uploaded once into a vertex buffer and the source
+/// and the target keyframe of an instance are blended by a vertex shader, which also computes
+/// the same per-vertex lighting as ObjectGraphics::updateLighting(). Only GLSL 1.20 (OpenGL 2.0)
+/// is used so the renderer runs on software implementations like Mesa's llvmpipe. If the shader
+/// is not available, canBlendKeyframes() returns @a false and the renderer behaves like the
+/// DefaultMd2ModelRenderer. Instances sharing their keyframes can be drawn with a single draw
+/// call if the implementation supports instanced arrays (OpenGL 3.3 or ARB_instanced_arrays).
+class KeyframeMd2ModelRenderer : public DefaultMd2ModelRenderer
+{
+public:
+    /// @brief A range of vertices of the unrolled vertex stream drawn by a single draw call.
+    struct Command
+    {
+        GLenum mode;
+        GLint first;
+        GLsizei count;
+    };
+
+    /// @brief The vertex stream of a model.
+    /// @details The indexed GL commands of a model are unrolled into a flat list of vertices.
+    /// The keyframes are stored one after another, every vertex of a keyframe consists of
+    /// a position and a normal (6 floats).
+    struct Stream
+    {
+        /// @brief The number of vertices of a keyframe.
+        size_t vertexCount;
+        /// @brief The number of keyframes.
+        size_t frameCount;
+        /// @brief The texture coordinates of the vertices (2 floats per vertex).
+        std::vector<float> textureCoordinates;
+        /// @brief The positions and the normals of the vertices of all keyframes.
+        std::vector<float> keyframes;
+        std::vector<Command> commands;
+
+        /// @brief Build the vertex stream of a model.
+        /// @param model the model
+        /// @remark References to vertices outside of the vertex list of the model are skipped.
+        static Stream build(MD2Model& model);
+    };
+
+private:
+    /// @brief The vertex buffers of a model.
+    struct Buffers
+    {
+        std::weak_ptr<MD2Model> model;
+        GLuint textureCoordinates;
+        GLuint keyframes;
+        size_t vertexCount;
+        size_t frameCount;
+        std::vector<Command> commands;
+    };
+
+    /// @brief The vertex buffers of the models indexed by their address.
+    /// Entries of deleted models are removed when new buffers are uploaded.
+    std::unordered_map<const MD2Model *, Buffers> m_buffers;
+
+    /// @brief A shader program and the locations of its uniforms.
+    /// The locations of uniforms a program does not have are @a -1.
+    struct Program
+    {
+        GLuint id;
+        GLint flip, tint, textureOffset, lit, ambient, flash;
+        GLint positiveLight, negativeLight, ambientLight;
+        GLint heightScale, heightRange;
+        GLint textured, skin;
+    };
+
+    /// @brief @a true if compiling the shaders was attempted.
+    bool m_programChecked;
+    /// @brief The program taking the state of an instance from uniforms.
+    /// Its id is @a 0 if it could not be created.
+    Program m_program;
+    /// @brief The program taking the states of the instances from an instance buffer.
+    /// Its id is @a 0 if it could not be created or instancing is not supported.
+    Program m_instancedProgram;
+
+    /// @brief The buffer the states of the instances are streamed into.
+    GLuint m_instanceBuffer;
+    /// @brief The states of the instances of the current instanced draw.
+    std::vector<float> m_instanceData;
+
+public:
+    /// @brief Construct this MD2 model renderer.
+    KeyframeMd2ModelRenderer();
+
+    /// @brief Destruct this MD2 model renderer.
+    virtual ~KeyframeMd2ModelRenderer();
+
+    /// @copydoc Md2ModelRenderer::canBlendKeyframes
+    bool canBlendKeyframes() override;
+
+    /// @copydoc Md2ModelRenderer::renderBlended
+    bool renderBlended(const std::shared_ptr<MD2Model>& model, const KeyframeBlend& blend) override;
+
+    /// @copydoc Md2ModelRenderer::renderInstanced
+    bool renderInstanced(const std::shared_ptr<MD2Model>& model, const std::vector<KeyframeInstance>& instances) override;
+
+    /// @copydoc Md2ModelRenderer::release
+    void release() override;
+
+private:
+    /// @brief Compile and link a shader program.
+    /// @param instanced if @a true the program takes the states of the instances from instanced attributes
+    /// @return the shader program, its id is @a 0 on failure
+    static Program createProgram(bool instanced);
+
+    /// @brief Get if this OpenGL implementation supports instanced arrays.
+    static bool isInstancingSupported();
+
+    /// @brief Bind the texture coordinates and the source and target keyframe of a model.
+    static void bindVertexAttributes(const Buffers& buffers, uint16_t sourceFrameIndex, uint16_t targetFrameIndex);
+
+    /// @brief Disable all vertex attributes and unbind the vertex buffers.
+    static void unbindVertexAttributes();
+
+    /// @brief Get the vertex buffers of a model, uploading them if required.
+    const Buffers& getBuffers(const std::shared_ptr<MD2Model>& model);
+
+    static void deleteBuffers(Buffers& buffers);
+
+}; // class KeyframeMd2ModelRenderer
+
+} // namespace Graphics
+} // namespace Ego
@@ -0,0 +1,192 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/game/Graphics/MD2Interpolation.cpp
+/// @brief Interpolation of MD2 vertices between two keyframes
+
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define EGO_MD2_INTERPOLATION_SSE 1
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define EGO_MD2_INTERPOLATION_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// Do not fuse multiplications and additions (e.g. if FMA instructions are enabled) such that
+// the scalar and the vector kernels round the same and produce bit-identical vertices.
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+    #pragma fp_contract(off)
+#endif
+
+namespace Ego {
+namespace Graphics {
+
+namespace {
+
+static constexpr size_t blockSize = MD2_FrameArrays::blockSize;
+
+/// A block of interpolated vertices in structure-of-arrays layout.
+struct Block
+{
+    float posX[blockSize], posY[blockSize], posZ[blockSize];
+    float nrmX[blockSize], nrmY[blockSize], nrmZ[blockSize];
+    float envX[blockSize];
+};
+
+/// Store the lanes <tt>begin</tt> to <tt>end</tt> (exclusive) of a block in the vertices starting at <tt>target</tt>.
+inline void store(const float *posX, const float *posY, const float *posZ,
+                  const float *nrmX, const float *nrmY, const float *nrmZ,
+                  const float *envX, size_t begin, size_t end, GLvertex *target)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        GLvertex& dst = target[i];
+
+        dst.pos[XX] = posX[i];
+        dst.pos[YY] = posY[i];
+        dst.pos[ZZ] = posZ[i];
+        dst.pos[WW] = 1.0f;
+
+        dst.nrm[XX] = nrmX[i];
+        dst.nrm[YY] = nrmY[i];
+        dst.nrm[ZZ] = nrmZ[i];
+
+        dst.env[XX] = envX[i];
+        dst.env[YY] = 0.5f * (1.0f + nrmZ[i]);
+    }
+}
+
+inline void store(const Block& block, size_t begin, size_t end, GLvertex *target)
+{
+    store(block.posX, block.posY, block.posZ, block.nrmX, block.nrmY, block.nrmZ, block.envX, begin, end, target);
+}
+
+/// Copy the vertices of a single keyframe, this is exact for flip = 0 and flip = 1.
+void copy(const MD2_FrameArrays& source, size_t first, size_t last, GLvertex *target)
+{
+    store(source.posX.data(), source.posY.data(), source.posZ.data(),
+          source.nrmX.data(), source.nrmY.data(), source.nrmZ.data(),
+          source.envX.data(), first, last + 1, target);
+}
+
+/// Invoke <tt>lerp(source, destination, target)</tt> for each array of each block touching the vertices
+/// <tt>first</tt> to <tt>last</tt> and store the results. Blocks start at multiples of the block size,
+/// the padding of the arrays ensures that the last block is readable.
+template <typename Lerp>
+void interpolateBlocks(const MD2_FrameArrays& source, const MD2_FrameArrays& destination,
+                       size_t first, size_t last, GLvertex *target, Lerp&& lerp)
+{
+    const size_t end = last + 1;
+    for (size_t i = first - first % blockSize; i < end; i += blockSize)
+    {
+        Block block;
+        lerp(source.posX.data() + i, destination.posX.data() + i, block.posX);
+        lerp(source.posY.data() + i, destination.posY.data() + i, block.posY);
+        lerp(source.posZ.data() + i, destination.posZ.data() + i, block.posZ);
+        lerp(source.nrmX.data() + i, destination.nrmX.data() + i, block.nrmX);
+        lerp(source.nrmY.data() + i, destination.nrmY.data() + i, block.nrmY);
+        lerp(source.nrmZ.data() + i, destination.nrmZ.data() + i, block.nrmZ);
+        lerp(source.envX.data() + i, destination.envX.data() + i, block.envX);
+        store(block, std::max(first, i) - i, std::min(end - i, blockSize), target + i);
+    }
+}
+
+} // namespace
+
+void interpolateMD2VerticesScalar(const MD2_FrameArrays& source, const MD2_FrameArrays& destination,
+                                  size_t first, size_t last, float flip, GLvertex *target)
+{
+    if (0.0f == flip)
+    {
+        copy(source, first, last, target);
+    }
+    else if (1.0f == flip)
+    {
+        copy(destination, first, last, target);
+    }
+    else
+    {
+        interpolateBlocks(source, destination, first, last, target,
+                          [flip](const float *a, const float *b, float *c)
+                          {
+                              for (size_t i = 0; i < blockSize; ++i)
+                              {
+                                  c[i] = a[i] + (b[i] - a[i]) * flip;
+                              }
+                          });
+    }
+}
+
+void interpolateMD2Vertices(const MD2_FrameArrays& source, const MD2_FrameArrays& destination,
+                            size_t first, size_t last, float flip, GLvertex *target)
+{
+#if defined(EGO_MD2_INTERPOLATION_SSE)
+    static_assert(blockSize == 4, "the block size must match the SSE vector width");
+    if (0.0f == flip)
+    {
+        copy(source, first, last, target);
+    }
+    else if (1.0f == flip)
+    {
+        copy(destination, first, last, target);
+    }
+    else
+    {
+        const __m128 f = _mm_set1_ps(flip);
+        interpolateBlocks(source, destination, first, last, target,
+                          [f](const float *a, const float *b, float *c)
+                          {
+                              const __m128 x = _mm_loadu_ps(a), y = _mm_loadu_ps(b);
+                              _mm_storeu_ps(c, _mm_add_ps(x, _mm_mul_ps(_mm_sub_ps(y, x), f)));
+                          });
+    }
+#elif defined(EGO_MD2_INTERPOLATION_NEON)
+    static_assert(blockSize == 4, "the block size must match the NEON vector width");
+    if (0.0f == flip)
+    {
+        copy(source, first, last, target);
+    }
+    else if (1.0f == flip)
+    {
+        copy(destination, first, last, target);
+    }
+    else
+    {
+        // Multiply and add separately, a fused multiply-add would round differently than the scalar version.
+        const float32x4_t f = vdupq_n_f32(flip);
+        interpolateBlocks(source, destination, first, last, target,
+                          [f](const float *a, const float *b, float *c)
+                          {
+                              const float32x4_t x = vld1q_f32(a), y = vld1q_f32(b);
+                              vst1q_f32(c, vaddq_f32(x, vmulq_f32(vsubq_f32(y, x), f)));
+                          });
+    }
+#else
+    interpolateMD2VerticesScalar(source, destination, first, last, flip, target);
+#endif
+}
+
+} // namespace Graphics
+} // namespace Ego
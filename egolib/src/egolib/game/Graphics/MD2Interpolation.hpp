@@ -0,0 +1,54 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/game/Graphics/MD2Interpolation.hpp
+/// @brief Interpolation of MD2 vertices between two keyframes
+
+#pragma once
+
+#include "egolib/game/Graphics/Vertex.hpp"
+#include "egolib/Graphics/MD2Model.hpp"
+
+namespace Ego {
+namespace Graphics {
+
+/**
+ * @brief
+ *  Interpolate the position, normal and environment map coordinates of the vertices with the indices
+ *  <tt>first</tt> to <tt>last</tt> (inclusive) between two keyframes and store them in the same
+ *  vertices of <tt>target</tt>. Uses SSE or NEON where available, the results are identical to
+ *  interpolateMD2VerticesScalar().
+ * @param flip
+ *  the interpolation parameter. @a 0 yields the vertices of <tt>source</tt>,
+ *  @a 1 the vertices of <tt>destination</tt>
+ * @remark
+ *  raw indicates no bounds checking, so be careful
+ */
+void interpolateMD2Vertices(const MD2_FrameArrays& source, const MD2_FrameArrays& destination,
+                            size_t first, size_t last, float flip, GLvertex *target);
+
+/**
+ * @brief
+ *  The scalar version of interpolateMD2Vertices().
+ */
+void interpolateMD2VerticesScalar(const MD2_FrameArrays& source, const MD2_FrameArrays& destination,
+                                  size_t first, size_t last, float flip, GLvertex *target);
+
+} // namespace Graphics
+} // namespace Ego
@@ -9,6 +9,24 @@ Md2ModelRenderer::Md2ModelRenderer()
 Md2ModelRenderer::~Md2ModelRenderer()
 {}
 
+bool Md2ModelRenderer::canBlendKeyframes()
+{
+    return false;
+}
+
+bool Md2ModelRenderer::renderBlended(const std::shared_ptr<MD2Model>& model, const KeyframeBlend& blend)
+{
+    return false;
+}
+
+bool Md2ModelRenderer::renderInstanced(const std::shared_ptr<MD2Model>& model, const std::vector<KeyframeInstance>& instances)
+{
+    return false;
+}
+
+void Md2ModelRenderer::release()
+{}
+
 } // namespace Graphics
 } // namespace Ego
 
@@ -4,6 +4,7 @@
 
 // Forward declaration.
 class MD2Model;
+struct lighting_cache_t;
 
 namespace Ego {
 namespace Graphics {
@@ -31,6 +32,68 @@ public:
 
     virtual void *lock() = 0;
 
+    /// @brief The state of an instance of a model blended between two of its keyframes.
+    struct KeyframeBlend
+    {
+        /// @brief The indices of the source and the target keyframe.
+        uint16_t sourceFrameIndex, targetFrameIndex;
+        /// @brief The interpolation between the source (0) and the target (1) keyframe.
+        float flip;
+        /// @brief The offset of the texture coordinates.
+        float uoffset, voffset;
+        /// @brief The tint of the model.
+        float tint[4];
+        /// @brief If @a true the model is lit, otherwise its colour is its tint.
+        bool lit;
+        /// @brief The ambient light (in [0,1]) added to the directional light of the vertices.
+        float ambient;
+        /// @brief The lighting in model coordinates.
+        const lighting_cache_t *lighting;
+        /// @brief The directional light (in [0,255]) of all vertices replacing the lighting, see ObjectGraphics::flash().
+        /// Negative if the vertices are lit by the lighting.
+        float flash;
+        /// @brief The scale of vertex heights and the vertical extent of the mesh.
+        /// The light of a vertex is interpolated between the low and the high lighting by its height.
+        float heightScale, minZ, maxZ;
+    };
+
+    /// @brief Get if this renderer can blend the keyframes of models on the GPU.
+    /// @return @a true if renderBlended() can be used, @a false otherwise
+    /// @remark The default implementation returns @a false.
+    virtual bool canBlendKeyframes();
+
+    /// @brief Render a model blending two of its keyframes on the GPU.
+    /// The world matrix and the texture must be set by the caller.
+    /// @param model the model
+    /// @param blend the state of the instance
+    /// @return @a true on success, @a false otherwise
+    /// @pre canBlendKeyframes() returned @a true
+    /// @remark The default implementation returns @a false.
+    virtual bool renderBlended(const std::shared_ptr<MD2Model>& model, const KeyframeBlend& blend);
+
+    /// @brief An instance of a model in an instanced draw.
+    struct KeyframeInstance
+    {
+        /// @brief The world matrix of the instance.
+        Matrix4f4f worldMatrix;
+        /// @brief The state of the instance.
+        KeyframeBlend blend;
+    };
+
+    /// @brief Render instances of a model with a single draw call.
+    /// The world matrix must be the identity and the texture must be set by the caller.
+    /// @param model the model
+    /// @param instances the instances, they must have the same source and target keyframe
+    /// @return @a true on success, @a false if instanced rendering is not supported or failed
+    /// @pre canBlendKeyframes() returned @a true
+    /// @remark The default implementation returns @a false.
+    virtual bool renderInstanced(const std::shared_ptr<MD2Model>& model, const std::vector<KeyframeInstance>& instances);
+
+    /// @brief Release all graphics resources held by this renderer.
+    /// They are re-created on demand.
+    /// @remark The default implementation does nothing.
+    virtual void release();
+
 }; // class M2dModelRenderer
 
 } // namespace Graphics
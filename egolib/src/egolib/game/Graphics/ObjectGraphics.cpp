@@ -8,8 +8,8 @@ namespace Ego
 namespace Graphics
 {
 
-// the flip tolerance is the default flip increment / 2
-static constexpr float FLIP_TOLERANCE = 0.25f * 0.5f;
+// the flip tolerance is the step the shared vertices are quantized to
+static constexpr float FLIP_TOLERANCE = 1.0f / AnimatedVertexCache::FLIP_STEPS;
 
 ObjectGraphics::ObjectGraphics(Object &object) :
     matrix_cache(),
@@ -24,7 +24,8 @@ ObjectGraphics::ObjectGraphics(Object &object) :
     voffset(0),
 
     _object(object),
-    _vertexList(),
+    _animatedVertices(nullptr),
+    _vertexLighting(),
     _matrix(Matrix4f4f::identity()),
     _reflectionMatrix(Matrix4f4f::identity()),
 
@@ -32,7 +33,9 @@ ObjectGraphics::ObjectGraphics(Object &object) :
     _vertexCache(),
 
     // lighting info
+    _lighting(),
     _ambientColour(0),
+    _flashLight(-1),
     _maxLight(-0xFF),
     _lastLightingUpdateFrame(-1),
 
@@ -58,7 +61,7 @@ ObjectGraphics::~ObjectGraphics()
     //dtor
 }
 
-void ObjectGraphics::updateLighting()
+void ObjectGraphics::updateLighting(bool perVertex)
 {
     static constexpr uint32_t FRAME_SKIP = 1 << 2;
     static constexpr uint32_t FRAME_MASK = FRAME_SKIP - 1;
@@ -80,41 +83,66 @@ void ObjectGraphics::updateLighting()
     GridIllumination::grid_lighting_interpolate(*_currentModule->getMeshPointer(), global_light, Vector2f(_object.getPosX(), _object.getPosY()));
 
     // rotate the lighting data to body_centered coordinates
-	lighting_cache_t loc_light;
-	lighting_cache_t::lighting_project_cache(loc_light, global_light, getMatrix());
+	lighting_cache_t::lighting_project_cache(_lighting, global_light, getMatrix());
+    const lighting_cache_t& loc_light = _lighting;
 
     //Low-pass filter to smooth lighting transitions?
     //_ambientColour = 0.9f * _ambientColour + 0.1f * (loc_light.hgh._lighting[LVEC_AMB] + loc_light.low._lighting[LVEC_AMB]) * 0.5f;
     //_ambientColour = (loc_light.hgh._lighting[LVEC_AMB] + loc_light.low._lighting[LVEC_AMB]) * 0.5f;
     _ambientColour = get_ambient_level();
+    _flashLight = -1;
 
     _maxLight = -0xFF;
-    for (size_t cnt = 0; cnt < _vertexList.size(); cnt++ )
+    if (!perVertex)
     {
-        float lite = 0.0f;
+        // the vertices are lit on the GPU, estimate the brightest vertex
+        // from the axis-aligned normals at the bottom and the top of the model
+        static const Vector3f normals[] =
+        {
+            Vector3f(+1.0f, 0.0f, 0.0f), Vector3f(-1.0f, 0.0f, 0.0f),
+            Vector3f(0.0f, +1.0f, 0.0f), Vector3f(0.0f, -1.0f, 0.0f),
+            Vector3f(0.0f, 0.0f, +1.0f), Vector3f(0.0f, 0.0f, -1.0f),
+        };
+        const oct_bb_t bb = getBoundingBox();
+        for (float z : { bb._mins[OCT_Z], bb._maxs[OCT_Z] })
+        {
+            float hgt = z * _matrix(3, 3) + _matrix(3, 3);
+            for (const Vector3f& normal : normals)
+            {
+                int lite = lighting_cache_t::lighting_evaluate_cache(loc_light, normal, hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
+                _maxLight = std::max(_maxLight, lite);
+            }
+        }
+    }
+    else
+    {
+        for (size_t cnt = 0; cnt < getVertexCount(); cnt++ )
+        {
+            float lite = 0.0f;
 
-        GLvertex *pvert = &_vertexList[cnt];
+            const GLvertex *pvert = &getVertex(cnt);
 
-        // a simple "height" measurement
-        float hgt = pvert->pos[ZZ] * _matrix(3, 3) + _matrix(3, 3);
+            // a simple "height" measurement
+            float hgt = pvert->pos[ZZ] * _matrix(3, 3) + _matrix(3, 3);
 
-        if (pvert->nrm[0] == 0.0f && pvert->nrm[1] == 0.0f && pvert->nrm[2] == 0.0f)
-        {
-            // this is the "ambient only" index, but it really means to sum up all the light
-            lite  = lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(+1.0f,+1.0f,+1.0f), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
-            lite += lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(-1.0f,-1.0f,-1.0f), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
+            if (pvert->nrm[0] == 0.0f && pvert->nrm[1] == 0.0f && pvert->nrm[2] == 0.0f)
+            {
+                // this is the "ambient only" index, but it really means to sum up all the light
+                lite  = lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(+1.0f,+1.0f,+1.0f), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
+                lite += lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(-1.0f,-1.0f,-1.0f), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
 
-            // average all the directions
-            lite /= 6.0f;
-        }
-        else
-        {
-            lite = lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(pvert->nrm[0],pvert->nrm[1],pvert->nrm[2]), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
-        }
+                // average all the directions
+                lite /= 6.0f;
+            }
+            else
+            {
+                lite = lighting_cache_t::lighting_evaluate_cache(loc_light, Vector3f(pvert->nrm[0],pvert->nrm[1],pvert->nrm[2]), hgt, _currentModule->getMeshPointer()->_tmem._bbox, nullptr, nullptr);
+            }
 
-        pvert->color_dir = lite;
+            _vertexLighting[cnt].color_dir = lite;
 
-        _maxLight = std::max(_maxLight, pvert->color_dir);
+            _maxLight = std::max(_maxLight, _vertexLighting[cnt].color_dir);
+        }
     }
 
     // ??coerce this to reasonable values in the presence of negative light??
@@ -126,6 +154,11 @@ int ObjectGraphics::getAmbientColour() const
     return _ambientColour;
 }
 
+const lighting_cache_t& ObjectGraphics::getLighting() const
+{
+    return _lighting;
+}
+
 gfx_rv ObjectGraphics::needs_update(int vmin, int vmax, bool *verts_match, bool *frames_match)
 {
 	bool local_verts_match, local_frames_match;
@@ -145,7 +178,7 @@ gfx_rv ObjectGraphics::needs_update(int vmin, int vmax, bool *verts_match, bool
 	}
 
     // get the last valid vertex from the chr_instance
-    int maxvert = static_cast<int>(_vertexList.size()) - 1;
+    int maxvert = static_cast<int>(_vertexLighting.size()) - 1;
 
     // check to make sure the lower bound of the saved data is valid.
     // it is initialized to an invalid value (_vertexCache.vmin = _vertexCache.vmax = -1)
@@ -171,98 +204,23 @@ gfx_rv ObjectGraphics::needs_update(int vmin, int vmax, bool *verts_match, bool
     return (!(*verts_match) || !( *frames_match )) ? gfx_success : gfx_fail;
 }
 
-void ObjectGraphics::interpolateVerticesRaw(const std::vector<MD2_Vertex> &lst_ary, const std::vector<MD2_Vertex> &nxt_ary, int vmin, int vmax, float flip )
-{
-    /// raw indicates no bounds checking, so be careful
-
-    if ( 0.0f == flip )
-    {
-        for (size_t i = vmin; i <= vmax; i++)
-        {
-            GLvertex* dst = &_vertexList[i];
-            const MD2_Vertex &srcLast = lst_ary[i];
-
-			dst->pos[XX] = srcLast.pos[kX];
-			dst->pos[YY] = srcLast.pos[kY];
-			dst->pos[ZZ] = srcLast.pos[kZ];
-            dst->pos[WW] = 1.0f;
-
-			dst->nrm[XX] = srcLast.nrm[kX];
-			dst->nrm[YY] = srcLast.nrm[kY];
-			dst->nrm[ZZ] = srcLast.nrm[kZ];
-
-            dst->env[XX] = indextoenvirox[srcLast.normal];
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
-    else if ( 1.0f == flip )
-    {
-        for (size_t i = vmin; i <= vmax; i++ )
-        {
-            GLvertex* dst = &_vertexList[i];
-            const MD2_Vertex &srcNext = nxt_ary[i];
-
-			dst->pos[XX] = srcNext.pos[kX];
-			dst->pos[YY] = srcNext.pos[kY];
-			dst->pos[ZZ] = srcNext.pos[kZ];
-            dst->pos[WW] = 1.0f;
-
-            dst->nrm[XX] = srcNext.nrm[kX];
-            dst->nrm[YY] = srcNext.nrm[kY];
-            dst->nrm[ZZ] = srcNext.nrm[kZ];
-
-            dst->env[XX] = indextoenvirox[srcNext.normal];
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
-    else
-    {
-        uint16_t vrta_lst, vrta_nxt;
-
-        for (size_t i = vmin; i <= vmax; i++)
-        {
-            GLvertex* dst = &_vertexList[i];
-            const MD2_Vertex &srcLast = lst_ary[i];
-            const MD2_Vertex &srcNext = nxt_ary[i];
-
-            dst->pos[XX] = srcLast.pos[kX] + ( srcNext.pos[kX] - srcLast.pos[kX] ) * flip;
-            dst->pos[YY] = srcLast.pos[kY] + ( srcNext.pos[kY] - srcLast.pos[kY] ) * flip;
-            dst->pos[ZZ] = srcLast.pos[kZ] + ( srcNext.pos[kZ] - srcLast.pos[kZ] ) * flip;
-            dst->pos[WW] = 1.0f;
-
-            dst->nrm[XX] = srcLast.nrm[kX] + ( srcNext.nrm[kX] - srcLast.nrm[kX] ) * flip;
-            dst->nrm[YY] = srcLast.nrm[kY] + ( srcNext.nrm[kY] - srcLast.nrm[kY] ) * flip;
-            dst->nrm[ZZ] = srcLast.nrm[kZ] + ( srcNext.nrm[kZ] - srcLast.nrm[kZ] ) * flip;
-
-            vrta_lst = srcLast.normal;
-            vrta_nxt = srcNext.normal;
-
-            dst->env[XX] = indextoenvirox[vrta_lst] + ( indextoenvirox[vrta_nxt] - indextoenvirox[vrta_lst] ) * flip;
-            dst->env[YY] = 0.5f * ( 1.0f + dst->nrm[ZZ] );
-        }
-    }
-}
-
 gfx_rv ObjectGraphics::updateVertices(int vmin, int vmax, bool force)
 {
     bool vertices_match, frames_match;
     float  loc_flip;
 
-    int vdirty1_min = -1, vdirty1_max = -1;
-    int vdirty2_min = -1, vdirty2_max = -1;
-
     // get the model
     const std::shared_ptr<MD2Model> &pmd2 = getModelDescriptor()->getMD2();
 
     // make sure we have valid data
-    if (_vertexList.size() != pmd2->getVertexCount())
+    if (_vertexLighting.size() != pmd2->getVertexCount())
     {
         Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "character instance vertex data does not match its md2", Log::EndOfEntry);
         return gfx_error;
     }
 
     // get the vertex list size from the chr_instance
-    int maxvert = static_cast<int>(_vertexList.size()) - 1;
+    int maxvert = static_cast<int>(_vertexLighting.size()) - 1;
 
     // handle the default parameters
     if ( vmin < 0 ) vmin = 0;
@@ -278,15 +236,6 @@ gfx_rv ObjectGraphics::updateVertices(int vmin, int vmax, bool force)
     if (force)
     {
         // force an update of vertices
-
-        // select a range that encompases the requested vertices and the saved vertices
-        // if this is the 1st update, the saved vertices may be set to invalid values, as well
-
-        // grab the dirty vertices
-        vdirty1_min = vmin;
-        vdirty1_max = vmax;
-
-        // force the routine to update
         vertices_match = false;
         frames_match   = false;
     }
@@ -296,28 +245,6 @@ gfx_rv ObjectGraphics::updateVertices(int vmin, int vmax, bool force)
         gfx_rv retval = needs_update(vmin, vmax, &vertices_match, &frames_match );
         if ( gfx_error == retval ) return gfx_error;            // gfx_error == retval means some pointer or reference is messed up
         if ( gfx_fail  == retval ) return gfx_success;          // gfx_fail  == retval means we do not need to update this round
-
-        if ( !frames_match )
-        {
-            // the entire frame is dirty
-            vdirty1_min = vmin;
-            vdirty1_max = vmax;
-        }
-        else
-        {
-            // grab the dirty vertices
-            if ( vmin < _vertexCache.vmin )
-            {
-                vdirty1_min = vmin;
-                vdirty1_max = _vertexCache.vmin - 1;
-            }
-
-            if ( vmax > _vertexCache.vmax )
-            {
-                vdirty2_min = _vertexCache.vmax + 1;
-                vdirty2_max = vmax;
-            }
-        }
     }
 
     // make sure the frames are in the valid range
@@ -329,27 +256,19 @@ gfx_rv ObjectGraphics::updateVertices(int vmin, int vmax, bool force)
         return gfx_error;
     }
 
-    // grab the frame data from the correct model
-    const auto& nextFrame = frameList[_targetFrameIndex];
-    const auto& lastFrame = frameList[_sourceFrameIndex];
-
     // fix the flip for objects that are not animating
     loc_flip = _animationProgress;
     if ( _targetFrameIndex == _sourceFrameIndex ) {
         loc_flip = 0.0f;
     }
 
-    // interpolate the 1st dirty region
-    if ( vdirty1_min >= 0 && vdirty1_max >= 0 )
-    {
-		interpolateVerticesRaw(lastFrame.vertexList, nextFrame.vertexList, vdirty1_min, vdirty1_max, loc_flip);
-    }
-
-    // interpolate the 2nd dirty region
-    if ( vdirty2_min >= 0 && vdirty2_max >= 0 )
+    // share the interpolated vertices with all instances in the same animation state,
+    // the cached vertices only interpolate the dirty vertices which no instance requested before
+    if (!_animatedVertices || !_animatedVertices->matches(pmd2.get(), _sourceFrameIndex, _targetFrameIndex, AnimatedVertexCache::quantize(loc_flip)))
     {
-		interpolateVerticesRaw(lastFrame.vertexList, nextFrame.vertexList, vdirty2_min, vdirty2_max, loc_flip);
+        _animatedVertices = GFX::get().getAnimatedVertexCache().acquire(pmd2, _sourceFrameIndex, _targetFrameIndex, loc_flip);
     }
+    _animatedVertices->update(vmin, vmax);
 
     // update the saved parameters
     return updateVertexCache(vmax, vmin, force, vertices_match, frames_match);
@@ -361,7 +280,7 @@ gfx_rv ObjectGraphics::updateVertexCache(int vmax, int vmin, bool force, bool ve
     // we need to do this calculation as little as possible, so it is important that the
     // _vertexCache.* values be tested and stored properly
 
-	int maxvert = static_cast<int>(_vertexList.size()) - 1;
+	int maxvert = static_cast<int>(_vertexLighting.size()) - 1;
 
     // the save_vmin and save_vmax is the most complex
     bool verts_updated = false;
@@ -509,7 +428,20 @@ int ObjectGraphics::getMaxLight() const
 
 const GLvertex& ObjectGraphics::getVertex(const size_t index) const
 {
-    return _vertexList[index];
+    // the vertices may be requested before the first call to updateVertices(),
+    // e.g. by a particle attached to an object spawned in the same frame
+    if (!_animatedVertices)
+    {
+        const float loc_flip = (_targetFrameIndex == _sourceFrameIndex) ? 0.0f : _animationProgress;
+        _animatedVertices = GFX::get().getAnimatedVertexCache().acquire(getModelDescriptor()->getMD2(), _sourceFrameIndex, _targetFrameIndex, loc_flip);
+    }
+    _animatedVertices->update(static_cast<int>(index), static_cast<int>(index));
+    return _animatedVertices->getVertex(index);
+}
+
+const VertexLighting& ObjectGraphics::getVertexLighting(const size_t index) const
+{
+    return _vertexLighting[index];
 }
 
 bool ObjectGraphics::setModel(const std::shared_ptr<Ego::ModelDescriptor> &model)
@@ -523,9 +455,9 @@ bool ObjectGraphics::setModel(const std::shared_ptr<Ego::ModelDescriptor> &model
 
     // set the vertex size
     size_t vlst_size = getModelDescriptor()->getMD2()->getVertexCount();
-    if (_vertexList.size() != vlst_size) {
+    if (_vertexLighting.size() != vlst_size) {
         updated = true;
-        _vertexList.resize(vlst_size);
+        _vertexLighting.resize(vlst_size);
     }
 
     // set the frames to frame 0 of this object's data
@@ -574,8 +506,10 @@ void ObjectGraphics::setObjectProfile(const std::shared_ptr<ObjectProfile> &prof
     voffset = 0;
 
     _ambientColour = 0;
+    _flashLight = -1;
     _maxLight = -0xFF;
-    _vertexList.clear();
+    _animatedVertices = nullptr;
+    _vertexLighting.clear();
     clearCache();
 
     //Animation and 3D model
@@ -731,52 +665,60 @@ void ObjectGraphics::flash(uint8_t value)
 	_ambientColour = flash_val;
 
 	// flash the directional lighting
-	for (size_t i = 0; i < _vertexList.size(); ++i) {
-		_vertexList[i].color_dir = flash_val;
+	for (size_t i = 0; i < _vertexLighting.size(); ++i) {
+		_vertexLighting[i].color_dir = flash_val;
 	}
+
+	// remember it for the vertices lit on the GPU
+	_flashLight = flash_val;
+}
+
+int ObjectGraphics::getFlashLight() const
+{
+    return _flashLight;
 }
 
 
 size_t ObjectGraphics::getVertexCount() const
 {
-    return _vertexList.size();
+    return _vertexLighting.size();
 }
 
 void ObjectGraphics::flashVariableHeight(const uint8_t valuelow, const int16_t low, const uint8_t valuehigh, const int16_t high)
 {
-    for (size_t cnt = 0; cnt < _vertexList.size(); cnt++)
+    for (size_t cnt = 0; cnt < getVertexCount(); cnt++)
     {
-        int16_t z = _vertexList[cnt].pos[ZZ];
+        int16_t z = getVertex(cnt).pos[ZZ];
 
         if ( z < low )
         {
-            _vertexList[cnt].col[RR] =
-                _vertexList[cnt].col[GG] =
-                    _vertexList[cnt].col[BB] = valuelow;
+            _vertexLighting[cnt].col[RR] =
+                _vertexLighting[cnt].col[GG] =
+                    _vertexLighting[cnt].col[BB] = valuelow;
         }
         else if ( z > high )
         {
-            _vertexList[cnt].col[RR] =
-                _vertexList[cnt].col[GG] =
-                    _vertexList[cnt].col[BB] = valuehigh;
+            _vertexLighting[cnt].col[RR] =
+                _vertexLighting[cnt].col[GG] =
+                    _vertexLighting[cnt].col[BB] = valuehigh;
         }
         else if ( high != low )
         {
             uint8_t valuemid = ( valuehigh * ( z - low ) / ( high - low ) ) +
                              ( valuelow * ( high - z ) / ( high - low ) );
 
-            _vertexList[cnt].col[RR] =
-                _vertexList[cnt].col[GG] =
-                    _vertexList[cnt].col[BB] =  valuemid;
+            _vertexLighting[cnt].col[RR] =
+                _vertexLighting[cnt].col[GG] =
+                    _vertexLighting[cnt].col[BB] =  valuemid;
         }
         else
         {
             // z == high == low
             uint8_t valuemid = ( valuehigh + valuelow ) * 0.5f;
 
-            _vertexList[cnt].col[RR] =
-                _vertexList[cnt].col[GG] =
-                    _vertexList[cnt].col[BB] =  valuemid;
+            _vertexLighting[cnt].col[RR] =
+                _vertexLighting[cnt].col[GG] =
+                    _vertexLighting[cnt].col[BB] =  valuemid;
         }
     }
 }
@@ -1323,6 +1265,22 @@ void ObjectGraphics::removeInterpolation()
     }
 }
 
+uint16_t ObjectGraphics::getSourceFrameIndex() const
+{
+    return _sourceFrameIndex;
+}
+
+uint16_t ObjectGraphics::getTargetFrameIndex() const
+{
+    return _targetFrameIndex;
+}
+
+float ObjectGraphics::getFlip() const
+{
+    // objects that are not animating are not interpolated
+    return (_targetFrameIndex == _sourceFrameIndex) ? 0.0f : _animationProgress;
+}
+
 oct_bb_t ObjectGraphics::getBoundingBox() const
 {
     //Beginning of a frame animation
@@ -3,6 +3,8 @@
 #include "idlib/idlib.hpp"
 #include "egolib/game/CharacterMatrix.h"
 #include "egolib/game/Graphics/Vertex.hpp"
+#include "egolib/game/Graphics/AnimatedVertexCache.hpp"
+#include "egolib/game/lighting.h"
 
 #include "egolib/Graphics/ModelDescriptor.hpp"
 #include "egolib/Graphics/MD2Model.hpp"
@@ -95,6 +97,20 @@ struct VertexListCache
     uint32_t vert_wld;          ///< the update_wld the last time the vertices were updated
 };
 
+/// the lighting of a vertex of a single instance, the animated vertices are shared (see Ego::Graphics::AnimatedVertexCache)
+struct VertexLighting
+{
+    VertexLighting() :
+        col{0.0f, 0.0f, 0.0f, 0.0f},
+        color_dir(0)
+    {
+        //ctor
+    }
+
+    GLfloat col[4];      ///< generic per-vertex lighting
+    GLint   color_dir;   ///< "optimized" per-vertex directional lighting
+};
+
 namespace Ego
 {
 
@@ -125,7 +141,12 @@ public:
     ~ObjectGraphics();
 
     /// @details determine the basic per-vertex lighting
-	void updateLighting();
+    /// @param perVertex if @a false, the vertices are lit on the GPU and only the lighting of the
+    ///        object and its maximum light (estimated from the axis-aligned normals) are updated
+	void updateLighting(bool perVertex = true);
+
+    /// @brief Get the lighting of the object in body-centered coordinates.
+    const lighting_cache_t& getLighting() const;
 
     bool isVertexCacheValid() const;
 
@@ -139,8 +160,12 @@ public:
         
     void getTint(GLXvector4f tint, const bool reflection, const int type);
 
+    /// @remark the vertex is shared with all instances in the same animation state, its lighting is not used.
+    /// The vertices of the current animation state are acquired and the vertex is interpolated if required.
     const GLvertex& getVertex(const size_t index) const;
 
+    const VertexLighting& getVertexLighting(const size_t index) const;
+
     size_t getVertexCount() const;
 
     /**
@@ -162,6 +187,10 @@ public:
     /// This function sets a object's lighting.
     void flash(uint8_t value);
 
+    /// Get the directional light of all vertices set by flash().
+    /// @return the directional light, @a -1 if the vertices are lit by the lighting
+    int getFlashLight() const;
+
     void setObjectProfile(const std::shared_ptr<ObjectProfile> &profile);
 
     /**
@@ -243,6 +272,15 @@ public:
     
     void removeInterpolation();
 
+    /// @brief Get the source frame index of the current animation state.
+    uint16_t getSourceFrameIndex() const;
+
+    /// @brief Get the target frame index of the current animation state.
+    uint16_t getTargetFrameIndex() const;
+
+    /// @brief Get the interpolation between the source and the target frame of the current animation state.
+    float getFlip() const;
+
     /**
     * @brief
     *   Get the interpolated bounding box for the current animation frame. The current animation frame
@@ -287,8 +325,6 @@ private:
     **/
 	void clearCache();
 
-	void interpolateVerticesRaw(const std::vector<MD2_Vertex> &lst_ary, const std::vector<MD2_Vertex> &nxt_ary, int vmin, int vmax, float flip);
-
     /**
     * @brief
     *   try to set the model used by the character instance.
@@ -316,7 +352,8 @@ private:
 
 private:
     Object& _object;
-    std::vector<GLvertex> _vertexList;
+    mutable std::shared_ptr<AnimatedVertices> _animatedVertices;   ///< the vertices of the current animation state, acquired on first use
+    std::vector<VertexLighting> _vertexLighting;
     Matrix4f4f _matrix;                     ///< Character's matrix
     Matrix4f4f _reflectionMatrix;           ///< Character's matrix reflecter (on the floor)
 
@@ -324,7 +361,9 @@ private:
     VertexListCache _vertexCache;              ///< Do we need to re-calculate all or part of the vertex list
 
     // lighting info
+    lighting_cache_t _lighting;                         ///< lighting in body-centered coordinates
     int32_t        _ambientColour;
+    int            _flashLight;                         ///< directional light set by flash(), -1 if none
     int            _maxLight;
     int            _lastLightingUpdateFrame;            ///< update some lighting info no more than once an update
 
@@ -46,55 +46,70 @@ namespace Graphics {
 namespace Internal {
 
 ElementV2::ElementV2()
-    : ElementV2(std::numeric_limits<float>::infinity(), 
-                Index1D::Invalid, 
-                std::numeric_limits<uint32_t>::max()) {
+    : ElementV2(std::numeric_limits<uint32_t>::max(),
+                std::numeric_limits<uint32_t>::max(),
+                0, 0, Index1D::Invalid,
+                std::numeric_limits<float>::infinity()) {
 }
 
-ElementV2::ElementV2(float distance, const Index1D& tileIndex, uint32_t textureIndex)
-	: distance(distance), tileIndex(tileIndex), textureIndex(textureIndex) {
+ElementV2::ElementV2(uint32_t textureIndex, uint32_t chunkIndex, uint32_t first, uint32_t count, const Index1D& tileIndex, float distance)
+	: textureIndex(textureIndex), chunkIndex(chunkIndex), first(first), count(count), tileIndex(tileIndex), distance(distance) {
 }
 
-ElementV2::ElementV2(const ElementV2& other)
-	: ElementV2(other.getDistance(), other.getTileIndex(), other.getTextureIndex()) {
+uint32_t ElementV2::getTextureIndex() const {
+    return textureIndex;
 }
 
-const ElementV2& ElementV2::operator=(const ElementV2& other) {
-	distance = other.getDistance();
-	tileIndex = other.getTileIndex();
-	textureIndex = other.getTextureIndex();
-	return *this;
+uint32_t ElementV2::getChunkIndex() const {
+    return chunkIndex;
 }
 
-float ElementV2::getDistance() const {
-    return distance;
+uint32_t ElementV2::getFirst() const {
+    return first;
+}
+
+uint32_t ElementV2::getCount() const {
+    return count;
 }
 
 const Index1D& ElementV2::getTileIndex() const {
     return tileIndex;
 }
 
-uint32_t ElementV2::getTextureIndex() const {
-    return textureIndex;
+float ElementV2::getDistance() const {
+    return distance;
+}
+
+bool ElementV2::isContinuedBy(const ElementV2& other) const {
+    return textureIndex == other.textureIndex
+        && chunkIndex == other.chunkIndex
+        && first + count == other.first;
+}
+
+void ElementV2::append(const ElementV2& other) {
+    count += other.count;
 }
 
 bool ElementV2::compare(const ElementV2& x, const ElementV2& y) {
-	int result = (int)x.getTextureIndex() - (int)y.getTextureIndex();
-	if (result < 0) {
-		return true;
-	} else if (result > 0) {
-		return false;
-	} else {
-        float result = x.getDistance() - y.getDistance();
-		if (result < 0.0f) {
-			return true;
-		} else {
-			return false;
-		}
-	}
+    if (x.getTextureIndex() != y.getTextureIndex()) {
+        return x.getTextureIndex() < y.getTextureIndex();
+    }
+    if (x.getChunkIndex() != y.getChunkIndex()) {
+        return x.getChunkIndex() < y.getChunkIndex();
+    }
+    return x.getFirst() < y.getFirst();
+}
+
+bool ElementV2::compareByDistance(const ElementV2& x, const ElementV2& y) {
+    if (x.getTextureIndex() != y.getTextureIndex()) {
+        return x.getTextureIndex() < y.getTextureIndex();
+    }
+    return x.getDistance() < y.getDistance();
 }
 
-void TileListV2::render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles)
+TileListV2::Statistics TileListV2::statistics;
+
+void TileListV2::render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles, bool sortByDistance)
 {
 	size_t tcnt = mesh._tmem.getInfo().getTileCount();
 
@@ -102,43 +117,95 @@ void TileListV2::render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tile
 		return;
 	}
 
-	// insert the rlst values into lst_vals
-	std::vector<ElementV2> lst_vals(tiles.size());
+	// rebuild the index lists of chunks with changed textures
+	tile_chunks_t& chunks = mesh._chunks;
+	chunks.update(mesh._tmem, tile_dict);
+
+	// get the index ranges of the visible tiles
+	std::vector<ElementV2> lst_vals;
+	lst_vals.reserve(tiles.size());
 	for (size_t i = 0; i < tiles.size(); ++i)
 	{
-        uint32_t textureIndex;
-		if (tiles[i].getIndex() >= tcnt)
-		{
-			textureIndex = std::numeric_limits<uint32_t>::max();
-		}
-		else
-		{
-			const ego_tile_info_t& tile = mesh._tmem.get(tiles[i].getIndex());
+		const Index1D& tileIndex = tiles[i].getIndex();
+		if (tileIndex >= tcnt) continue;
 
-			int img = TILE_GET_LOWER_BITS(tile._img);
-			if (tile._type >= tile_dict.offset)
+		const ego_tile_info_t& tile = mesh._tmem.get(tileIndex);
+		const tile_chunks_t::range_t& range = chunks.getRange(tileIndex);
+		if (0 == range.count)
+		{
+			// fan off tiles are not rendered, other tiles without indices have an invalid tile type
+			if (egoboo_config_t::get().debug_developerMode_enable.getValue() && !tile.isFanOff() && nullptr == tile_dict.get(tile._type))
 			{
-				img += Graphics::MESH_IMG_COUNT;
+				Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "error rendering tile ", tileIndex.i(), Log::EndOfEntry);
 			}
-
-			textureIndex = img;
+			continue;
 		}
-        lst_vals[i] = ElementV2(tiles[i].getDistance(), tiles[i].getIndex(), textureIndex);
+
+		lst_vals.emplace_back(tile_chunks_t::getTextureIndex(tile, tile_dict), (uint32_t)chunks.getChunkIndex(tileIndex),
+		                      range.first, range.count, tileIndex, tiles[i].getDistance());
 	}
 
-	std::sort(lst_vals.begin(), lst_vals.end(), ElementV2::compare);
+	std::sort(lst_vals.begin(), lst_vals.end(), sortByDistance ? ElementV2::compareByDistance : ElementV2::compare);
+
+	// merge adjacent ranges into runs
+	size_t runCount = 0;
+	for (size_t i = 0; i < lst_vals.size(); ++i)
+	{
+		if (runCount > 0 && lst_vals[runCount - 1].isContinuedBy(lst_vals[i])) {
+			lst_vals[runCount - 1].append(lst_vals[i]);
+		} else {
+			lst_vals[runCount++] = lst_vals[i];
+		}
+	}
+	statistics.tiles += lst_vals.size();
 
 	// restart the mesh texture code
 	TileRenderer::invalidate();
 
-	for (size_t i = 0; i < tiles.size(); ++i)
 	{
-		Index1D tmp_itile = lst_vals[i].getTileIndex();
+		const tile_mem_t& ptmem = mesh._tmem;
+
+		OpenGL::PushClientAttrib pca(GL_CLIENT_VERTEX_ARRAY_BIT);
+		{
+			// Per-vertex coloring.
+			Renderer::get().setGouraudShadingEnabled(gfx.gouraudShading_enable); // GL_LIGHTING_BIT
+
+			// The mesh-wide vertex lists are shared by all chunks.
+			// The colour list is read directly, hence changes to the lighting need no re-upload.
+			GL_DEBUG(glEnableClientState)(GL_VERTEX_ARRAY);
+			GL_DEBUG(glVertexPointer)(3, GL_FLOAT, 0, ptmem._plst.get());
+
+			GL_DEBUG(glEnableClientState)(GL_TEXTURE_COORD_ARRAY);
+			GL_DEBUG(glTexCoordPointer)(2, GL_FLOAT, 0, ptmem._tlst.get());
+
+			if (gfx.gouraudShading_enable) {
+				GL_DEBUG(glEnableClientState)(GL_COLOR_ARRAY);
+				GL_DEBUG(glColorPointer)(3, GL_FLOAT, 0, ptmem._clst.get());
+			} else {
+				GL_DEBUG(glDisableClientState)(GL_COLOR_ARRAY);
+			}
+
+			for (size_t i = 0; i < runCount; ++i)
+			{
+				const ElementV2& run = lst_vals[i];
+
+				// bind the correct texture
+				TileRenderer::bind(ptmem.get(run.getTileIndex()));
 
-		gfx_rv render_rv = render_fan(mesh, tmp_itile);
-		if (egoboo_config_t::get().debug_developerMode_enable.getValue() && gfx_error == render_rv)
+				const tile_chunks_t::chunk_t& chunk = chunks.getChunk(run.getChunkIndex());
+				GL_DEBUG(glDrawElements)(GL_TRIANGLES, run.getCount(), GL_UNSIGNED_INT, &(chunk.indices[run.getFirst()]));
+
+				statistics.drawCalls++;
+				statistics.indexBytes += run.getCount() * sizeof(uint32_t);
+			}
+		}
+	}
+
+	if (egoboo_config_t::get().debug_mesh_renderNormals.getValue()) {
+		for (size_t i = 0; i < tiles.size(); ++i)
 		{
-			Log::get() << Log::Entry::create(Log::Level::Warning, __FILE__, __LINE__, "error rendering tile ", tmp_itile.i(), Log::EndOfEntry);
+			if (tiles[i].getIndex() >= tcnt) continue;
+			render_normals(mesh, tiles[i].getIndex());
 		}
 	}
 
@@ -146,75 +213,33 @@ void TileListV2::render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tile
 	TileRenderer::invalidate();
 }
 
-gfx_rv TileListV2::render_fan(ego_mesh_t& mesh, const Index1D& i) {
+void TileListV2::render_normals(ego_mesh_t& mesh, const Index1D& i) {
     // grab a pointer to the tile
     const ego_tile_info_t& ptile = mesh.getTileInfo(i);
 
     const tile_mem_t& ptmem = mesh._tmem;
 
     // do not render the itile if the image image is invalid
-    if (ptile.isFanOff())  return gfx_success;
-
-    tile_definition_t *pdef = tile_dict.get(ptile._type);
-    if (NULL == pdef) return gfx_fail;
-
-    // bind the correct texture
-    TileRenderer::bind(ptile);
+    if (ptile.isFanOff()) return;
 
-    {
-        OpenGL::PushClientAttrib pca(GL_CLIENT_VERTEX_ARRAY_BIT);
+    TileRenderer::invalidate();
+    auto& renderer = Renderer::get();
+    renderer.getTextureUnit().setActivated(nullptr);
+    renderer.setColour(Math::Colour4f::white());
+    for (size_t i = ptile._vrtstart, j = 0; j < 4; ++i, ++j) {
+        glBegin(GL_LINES);
         {
-            // Per-vertex coloring.
-            Renderer::get().setGouraudShadingEnabled(gfx.gouraudShading_enable); // GL_LIGHTING_BIT
-
-                                                                                      /// @note claforte@> Put this in an initialization function.
-            GL_DEBUG(glEnableClientState)(GL_VERTEX_ARRAY);
-            GL_DEBUG(glVertexPointer)(3, GL_FLOAT, 0, &(ptmem._plst[ptile._vrtstart]));
-
-            GL_DEBUG(glEnableClientState)(GL_TEXTURE_COORD_ARRAY);
-            GL_DEBUG(glTexCoordPointer)(2, GL_FLOAT, 0, &(ptmem._tlst[ptile._vrtstart]));
-
-            if (gfx.gouraudShading_enable) {
-                GL_DEBUG(glEnableClientState)(GL_COLOR_ARRAY);
-                GL_DEBUG(glColorPointer)(3, GL_FLOAT, 0, &(ptmem._clst[ptile._vrtstart]));
-            } else {
-                GL_DEBUG(glDisableClientState)(GL_COLOR_ARRAY);
-            }
-            // grab some model info
-            uint16_t commands = pdef->command_count;
-
-            // Render each command
-            for (size_t cnt = 0, entry = 0; cnt < commands; cnt++) {
-                uint8_t numEntries = pdef->command_entries[cnt];
-
-                GL_DEBUG(glDrawElements)(GL_TRIANGLE_FAN, numEntries, GL_UNSIGNED_SHORT, &(pdef->command_verts[entry]));
-                entry += numEntries;
-            }
-        }
-    }
+            glVertex3fv(ptmem._plst[i]);
+            glVertex3f
+                (
+                    ptmem._plst[i][XX] + Info<float>::Grid::Size()*(ptile._ncache[j][XX]),
+                    ptmem._plst[i][YY] + Info<float>::Grid::Size()*(ptile._ncache[j][YY]),
+                    ptmem._plst[i][ZZ] + Info<float>::Grid::Size()*(ptile._ncache[j][ZZ])
+                    );
 
-    if (egoboo_config_t::get().debug_mesh_renderNormals.getValue()) {
-        TileRenderer::invalidate();
-        auto& renderer = Renderer::get();
-        renderer.getTextureUnit().setActivated(nullptr);
-        renderer.setColour(Math::Colour4f::white());
-        for (size_t i = ptile._vrtstart, j = 0; j < 4; ++i, ++j) {
-            glBegin(GL_LINES);
-            {
-                glVertex3fv(ptmem._plst[i]);
-                glVertex3f
-                    (
-                        ptmem._plst[i][XX] + Info<float>::Grid::Size()*(ptile._ncache[j][XX]),
-                        ptmem._plst[i][YY] + Info<float>::Grid::Size()*(ptile._ncache[j][YY]),
-                        ptmem._plst[i][ZZ] + Info<float>::Grid::Size()*(ptile._ncache[j][ZZ])
-                        );
-
-            }
-            glEnd();
         }
+        glEnd();
     }
-
-    return gfx_success;
 }
 
 void TileListV2::render_heightmap(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles)
@@ -31,41 +31,74 @@ namespace Graphics {
 
 namespace Internal {
 
+/// @brief A run of indices in the index list of a mesh chunk.
 struct ElementV2 {
 private:
-    float distance;
-    Index1D tileIndex;
     uint32_t textureIndex;
+    uint32_t chunkIndex;
+    uint32_t first;
+    uint32_t count;
+    Index1D tileIndex;
+    float distance;
 public:
     ElementV2();
-    ElementV2(float distance, const Index1D& tileIndex, uint32_t textureIndex);
-    ElementV2(const ElementV2& other);
-    const ElementV2& operator=(const ElementV2& other);
+    ElementV2(uint32_t textureIndex, uint32_t chunkIndex, uint32_t first, uint32_t count, const Index1D& tileIndex, float distance);
 public:
-    float getDistance() const;
-    const Index1D& getTileIndex() const;
     uint32_t getTextureIndex() const;
+    uint32_t getChunkIndex() const;
+    uint32_t getFirst() const;
+    uint32_t getCount() const;
+    /// @brief Get the index of the (first) tile of this run.
+    const Index1D& getTileIndex() const;
+    /// @brief Get the distance of the (first) tile of this run to the camera.
+    float getDistance() const;
+    /// @brief Get if an element directly follows this element in the same chunk and with the same texture.
+    bool isContinuedBy(const ElementV2& other) const;
+    /// @brief Append an element which directly follows this element.
+    void append(const ElementV2& other);
 public:
+    /// @brief Order by texture, then by chunk, then by position in the chunk.
     static bool compare(const ElementV2& x, const ElementV2& y);
+    /// @brief Order by texture, then by distance to the camera.
+    static bool compareByDistance(const ElementV2& x, const ElementV2& y);
 };
 
 struct TileListV2 {
 public:
+    /// @brief Counters of the tile render passes of the current frame.
+    struct Statistics {
+        size_t tiles = 0;       ///< number of tiles drawn
+        size_t drawCalls = 0;   ///< number of draw calls issued
+        size_t indexBytes = 0;  ///< number of bytes of indices submitted
+    };
+
     /// @brief Draw fans.
+    /// @remark Visible tiles are merged into runs of the persistent index lists of the mesh chunks,
+    /// one draw call is issued per run.
     /// @param mesh the mesh
     /// @param tiles the list of tiles
-    static void render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles);
+    /// @param sortByDistance if @a true the tiles of a texture are drawn in the order of their distance
+    /// to the camera, as required by blended tiles. Only tiles adjacent in that order are merged.
+    static void render(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles, bool sortByDistance);
 
     /// @brief Draw heightmap fans.
     /// @param mesh the mesh
     /// @param tiles the list of tiles
     static void render_heightmap(ego_mesh_t& mesh, const std::vector<ClippingEntry>& tiles);
 
+    /// @brief Get the counters of the current frame.
+    static const Statistics& getStatistics() { return statistics; }
+
+    /// @brief Reset the counters at the beginning of a frame.
+    static void resetStatistics() { statistics = Statistics(); }
+
 private:
-    /// @brief Draw a fan.
+    static Statistics statistics;
+
+    /// @brief Draw the normals of a fan.
     /// @param mesh the mesh
     /// @param tileIndex the tile index
-    static gfx_rv render_fan(ego_mesh_t& mesh, const Index1D& tileIndex);
+    static void render_normals(ego_mesh_t& mesh, const Index1D& tileIndex);
 
     /// @brief Draw a heightmap fan.
     /// @param mesh the mesh
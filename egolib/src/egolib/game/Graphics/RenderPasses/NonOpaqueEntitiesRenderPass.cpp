@@ -33,20 +33,26 @@ void NonOpaqueEntitiesRenderPass::doRun(::Camera& camera, const TileList& tl, co
         renderer.setDepthFunction(idlib::compare_function::less_or_equal);
 
         // Now render all transparent and light objects
+        _particles.clear();
         for (size_t i = el.getSize(); i > 0; --i)
         {
             size_t j = i - 1;
             // A character.
             if (ParticleRef::Invalid == el.get(j).iprt && ObjectRef::Invalid != el.get(j).iobj)
             {
+                // Draw the particles behind the character first.
+                ParticleGraphicsRenderer::render_prt_trans(_particles);
+                _particles.clear();
+
                 ObjectGraphicsRenderer::render_trans(camera, _currentModule->getObjectHandler()[el.get(j).iobj]);
             }
             // A particle.
             else if (ObjectRef::Invalid == el.get(j).iobj && ParticleRef::Invalid != el.get(j).iprt)
             {
-                ParticleGraphicsRenderer::render_one_prt_trans(el.get(j).iprt);
+                _particles.push_back(el.get(j).iprt);
             }
         }
+        ParticleGraphicsRenderer::render_prt_trans(_particles);
     }
 }
 
@@ -12,6 +12,9 @@ public:
     NonOpaqueEntitiesRenderPass();
 protected:
 	void doRun(::Camera& cam, const TileList& tl, const EntityList& el) override;
+private:
+	/// @brief The particles between two objects, drawn in batches
+	std::vector<ParticleRef> _particles;
 };
 	
 } // namespace Graphics
@@ -32,7 +32,7 @@ void NonReflectiveTilesRenderPass::doRun(::Camera& camera, const TileList& tl, c
         renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
 
         // reduce texture hashing by loading up each texture only once
-        Internal::TileListV2::render(*tl.getMesh(), tl._nonReflective);
+        Internal::TileListV2::render(*tl.getMesh(), tl._nonReflective, false);
     }
     OpenGL::Utilities::isError();
 }
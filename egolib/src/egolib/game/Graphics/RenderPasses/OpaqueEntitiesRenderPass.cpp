@@ -13,6 +13,8 @@ OpaqueEntitiesRenderPass::OpaqueEntitiesRenderPass() :
 
 void OpaqueEntitiesRenderPass::doRun(::Camera& camera, const TileList& tl, const EntityList& el)
 {
+    _particles.clear();
+    _objects.clear();
     OpenGL::PushAttrib pa(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
     {
         // scan for solid objects
@@ -31,16 +33,27 @@ void OpaqueEntitiesRenderPass::doRun(::Camera& camera, const TileList& tl, const
 
             if (ParticleRef::Invalid == el.get(i).iprt && ObjectRef::Invalid != el.get(i).iobj)
             {
-                ObjectGraphicsRenderer::render_solid(camera, _currentModule->getObjectHandler()[el.get(i).iobj]);
+                const auto& object = _currentModule->getObjectHandler()[el.get(i).iobj];
+                if (ObjectGraphicsRenderer::canRenderInstanced(object))
+                {
+                    _objects.push_back(object);
+                }
+                else
+                {
+                    ObjectGraphicsRenderer::render_solid(camera, object);
+                }
             }
             else if (ObjectRef::Invalid == el.get(i).iobj && ParticleHandler::get()[el.get(i).iprt] != nullptr)
             {
-                // draw draw front and back faces of polygons
-                renderer.setCullingMode(idlib::culling_mode::none);
-
-                ParticleGraphicsRenderer::render_one_prt_solid(el.get(i).iprt);
+                _particles.push_back(el.get(i).iprt);
             }
         }
+
+        // objects sharing a model, keyframes and skin are drawn with one draw call
+        ObjectGraphicsRenderer::render_solid_instanced(camera, _objects, _instances);
+
+        // the solid particles write into the depth buffer, hence their order does not matter
+        ParticleGraphicsRenderer::render_prt_solid(_particles);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "egolib/game/Graphics/RenderPass.hpp"
+#include "egolib/game/Graphics/Md2ModelRenderer.hpp"
 
 namespace Ego {
 namespace Graphics {
@@ -12,6 +13,13 @@ public:
 	OpaqueEntitiesRenderPass();
 protected:
 	void doRun(::Camera& cam, const TileList& tl, const EntityList& el) override;
+private:
+	/// @brief The solid particles, drawn in one batch after the objects
+	std::vector<ParticleRef> _particles;
+	/// @brief The solid objects blending their keyframes on the GPU, drawn instanced after the objects
+	std::vector<std::shared_ptr<Object>> _objects;
+	/// @brief The instances of a group of _objects
+	std::vector<Md2ModelRenderer::KeyframeInstance> _instances;
 };
 	
 } // namespace Graphics
@@ -38,7 +38,7 @@ void ReflectiveTilesFirstRenderPass::doRun(::Camera& camera, const TileList& tl,
         // speed-up drawing of surfaces with alpha == 0.0f sections
         renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
         // reduce texture hashing by loading up each texture only once
-        Internal::TileListV2::render(*tl.getMesh(), tl._reflective);
+        Internal::TileListV2::render(*tl.getMesh(), tl._reflective, true);
     }
 }
 
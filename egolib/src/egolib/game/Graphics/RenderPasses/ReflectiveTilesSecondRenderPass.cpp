@@ -46,7 +46,7 @@ void ReflectiveTilesSecondRenderPass::doReflectionsEnabled(::Camera& camera, con
         renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one);
 
         // reduce texture hashing by loading up each texture only once
-        Internal::TileListV2::render(*tl.getMesh(), tl._reflective);
+        Internal::TileListV2::render(*tl.getMesh(), tl._reflective, true);
     }
 }
 
@@ -64,7 +64,7 @@ void ReflectiveTilesSecondRenderPass::doReflectionsDisabled(::Camera& camera, co
         renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
 
         // reduce texture hashing by loading up each texture only once
-        Internal::TileListV2::render(*tl.getMesh(), tl._reflective);
+        Internal::TileListV2::render(*tl.getMesh(), tl._reflective, false);
     }
 }
 
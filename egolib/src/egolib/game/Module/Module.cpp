@@ -37,6 +37,7 @@
 
 #include "egolib/game/Physics/CollisionSystem.hpp"
 #include "egolib/game/Graphics/CameraSystem.hpp"
+#include "egolib/Profiles/ProfileCache.hpp"
 
 /// @todo Remove this global.
 std::unique_ptr<GameModule> _currentModule = nullptr;
@@ -92,6 +93,12 @@ GameModule::GameModule(const std::shared_ptr<ModuleProfile> &profile, const uint
     _waterTextures[0] = Ego::DeferredTexture("mp_data/waterlow");
     _waterTextures[1] = Ego::DeferredTexture("mp_data/watertop");
 
+    // remove outdated parsed profiles
+    if (egoboo_config_t::get().game_profileCache_enable.getValue())
+    {
+        Ego::ProfileCache::prune();
+    }
+
     // load a bunch of assets that are used in the module
     AudioSystem::get().loadGlobalSounds();
     ProfileSystem::get().loadGlobalParticleProfiles();
@@ -1180,8 +1187,8 @@ void GameModule::update()
     // of the mpdfx values was changed during the last update
     _mesh->_fxlists.synch(_mesh->_tmem, false);
 
-    //Rebuild the quadtree for fast object lookup
-    _gameObjects.updateQuadTree(0.0f, 0.0f, _mesh->_info.getTileCountX()*Info<float>::Grid::Size(),
+    //Update the spatial index for fast object lookup
+    _gameObjects.updateSpatialIndex(0.0f, 0.0f, _mesh->_info.getTileCountX()*Info<float>::Grid::Size(),
                                             _mesh->_info.getTileCountY()*Info<float>::Grid::Size());
 
     //---- begin the code for updating misc. game stuff
@@ -226,6 +226,11 @@ bool Passage::checkPassageMusic(const std::shared_ptr<Object> &pchr) const
 void Passage::setMusic(const int32_t musicID)
 {
     _music = musicID;
+
+    // open the track now rather than when a character enters the passage
+    if (_music != NO_MUSIC) {
+        AudioSystem::get().prefetchMusic(_music);
+    }
 }
 
 bool Passage::isShop() const
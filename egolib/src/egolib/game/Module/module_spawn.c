@@ -96,6 +96,12 @@ void game_load_profile_ai()
     // ensure that the script parser exists
     parser_state_t& ps = parser_state_t::get();
 
+    // remove outdated compiled scripts
+    if (egoboo_config_t::get().game_scriptCache_enable.getValue())
+    {
+        Ego::Script::ScriptCache::prune();
+    }
+
     for (const auto &element : ProfileSystem::get().getLoadedProfiles())
     {
         const std::shared_ptr<ObjectProfile> &profile = element.second;
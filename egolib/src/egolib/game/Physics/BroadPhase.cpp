@@ -0,0 +1,356 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+#include "BroadPhase.hpp"
+#include "egolib/Entities/_Include.hpp"
+#include "egolib/game/physics.h"
+
+namespace Ego
+{
+namespace Physics
+{
+
+ObjectBroadPhase::ObjectBroadPhase() :
+    _entries(),
+    _entryOfRef(),
+    _pairs(),
+    _frame(0),
+    _order(0)
+{
+    //ctor
+}
+
+void ObjectBroadPhase::begin()
+{
+    _frame++;
+    _order = 0;
+    _pairs.clear();
+}
+
+void ObjectBroadPhase::add(const std::shared_ptr<Object> &object)
+{
+    const ObjectRef ref = object->getObjRef();
+    const size_t id = ref.get();
+
+    //Refresh the entry of the last update (keeps the sorted order) or append a new one
+    auto it = _entryOfRef.find(id);
+    uint32_t index = it != _entryOfRef.end() ? it->second : INVALID;
+    if(index >= _entries.size() || _entries[index].ref != ref || _entries[index].frame == _frame) {
+        index = static_cast<uint32_t>(_entries.size());
+        _entries.emplace_back();
+        _entryOfRef[id] = index;
+    }
+
+    const AxisAlignedBox2f &aabb = object->getAxisAlignedBox2D();
+    Entry &entry = _entries[index];
+    entry.object = object;
+    entry.ref = ref;
+    entry.minX = aabb.get_min()[kX];
+    entry.maxX = aabb.get_max()[kX];
+    entry.minY = aabb.get_min()[kY];
+    entry.maxY = aabb.get_max()[kY];
+    entry.order = _order++;
+    entry.frame = _frame;
+    entry.scenery = object->isScenery();
+    entry.canUsePlatforms = object->canuseplatforms;
+}
+
+void ObjectBroadPhase::end()
+{
+    //Remove all objects that were not added during this update, and their references
+    size_t count = 0;
+    for(size_t i = 0; i < _entries.size(); ++i) {
+        if(_entries[i].frame != _frame) {
+            auto it = _entryOfRef.find(_entries[i].ref.get());
+            if(it != _entryOfRef.end() && it->second == i) {
+                _entryOfRef.erase(it);
+            }
+            continue;
+        }
+        if(count != i) {
+            _entries[count] = std::move(_entries[i]);
+        }
+        count++;
+    }
+    _entries.resize(count);
+
+    //Insertion sort along the x-axis, almost linear for the nearly sorted array of the last update
+    for(size_t i = 1; i < _entries.size(); ++i) {
+        if(_entries[i - 1].minX <= _entries[i].minX) {
+            continue;
+        }
+        Entry entry = std::move(_entries[i]);
+        size_t j = i;
+        while(j > 0 && _entries[j - 1].minX > entry.minX) {
+            _entries[j] = std::move(_entries[j - 1]);
+            j--;
+        }
+        _entries[j] = std::move(entry);
+    }
+
+    for(size_t i = 0; i < _entries.size(); ++i) {
+        _entryOfRef[_entries[i].ref.get()] = static_cast<uint32_t>(i);
+    }
+
+    //Sweep along the x-axis
+    for(size_t i = 0; i < _entries.size(); ++i) {
+        const Entry &a = _entries[i];
+        for(size_t j = i + 1; j < _entries.size() && _entries[j].minX <= a.maxX; ++j) {
+            const Entry &b = _entries[j];
+
+            //Overlap along the y-axis?
+            if(b.maxY < a.minY || b.minY > a.maxY) {
+                continue;
+            }
+
+            //Do not collide scenery with other scenery objects - unless they can use platforms,
+            //for example boxes stacked on top of other boxes
+            if(a.scenery && b.scenery && !a.canUsePlatforms && !b.canUsePlatforms) {
+                continue;
+            }
+
+            if(a.order < b.order) {
+                _pairs.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(j)});
+            }
+            else {
+                _pairs.push_back({static_cast<uint32_t>(j), static_cast<uint32_t>(i)});
+            }
+        }
+    }
+
+    //Handle the pairs in the order the objects were added
+    std::sort(_pairs.begin(), _pairs.end(), [this](const Pair &x, const Pair &y)
+    {
+        const uint32_t xFirst = _entries[x.first].order, yFirst = _entries[y.first].order;
+        return xFirst < yFirst || (xFirst == yFirst && _entries[x.second].order < _entries[y.second].order);
+    });
+}
+
+void ObjectBroadPhase::release()
+{
+    for(Entry &entry : _entries) {
+        entry.object.reset();
+    }
+}
+
+ParticleBroadPhase::ParticleBroadPhase() :
+    _particles(),
+    _objects(),
+    _cellStart(),
+    _cellCursor(),
+    _cellParticles(),
+    _pairs(),
+    _minX(0.0f),
+    _minY(0.0f),
+    _inverseCellSize(1.0f),
+    _cellCountX(1),
+    _cellCountY(1),
+    _stamp(0),
+    _statistics()
+{
+    //ctor
+}
+
+void ParticleBroadPhase::begin()
+{
+    _particles.clear();
+    _objects.clear();
+    _pairs.clear();
+    _statistics = Statistics();
+}
+
+bool ParticleBroadPhase::addParticle(const std::shared_ptr<Ego::Particle> &particle)
+{
+    _statistics.particles++;
+
+    //Cull particle kinds that can never collide before anything else
+    if(!particle->getProfile()->canEverCollide()) {
+        _statistics.culledByProfile++;
+        return false;
+    }
+
+    if(!particle->canCollide()) {
+        return false;
+    }
+
+    // use the particle velocity to figure out where the volume that the particle will occupy during this update
+    oct_bb_t tmp_oct;
+    phys_expand_prt_bb(particle.get(), 0.0f, 1.0f, tmp_oct);
+
+    _particles.emplace_back();
+    ParticleEntry &entry = _particles.back();
+    entry.particle = particle;
+    entry.minX = tmp_oct._mins[OCT_X];
+    entry.maxX = tmp_oct._maxs[OCT_X];
+    entry.minY = tmp_oct._mins[OCT_Y];
+    entry.maxY = tmp_oct._maxs[OCT_Y];
+    entry.minZ = tmp_oct._mins[OCT_Z];
+    entry.maxZ = tmp_oct._maxs[OCT_Z];
+    entry.stamp = 0;
+    return true;
+}
+
+void ParticleBroadPhase::getCellRange(const float minX, const float minY, const float maxX, const float maxY, int& cellMinX, int& cellMinY, int& cellMaxX, int& cellMaxY) const
+{
+    auto toCell = [this](const float value, const float origin, const int count)
+    {
+        const float cell = std::floor((value - origin) * _inverseCellSize);
+        if(!(cell > 0.0f)) return 0;
+        if(cell >= count - 1) return count - 1;
+        return static_cast<int>(cell);
+    };
+    cellMinX = toCell(minX, _minX, _cellCountX);
+    cellMinY = toCell(minY, _minY, _cellCountY);
+    cellMaxX = toCell(maxX, _minX, _cellCountX);
+    cellMaxY = toCell(maxY, _minY, _cellCountY);
+}
+
+void ParticleBroadPhase::bin()
+{
+    _statistics.binnedParticles = _particles.size();
+    _stamp = 0;
+
+    //Fit the grid to the particles of this update
+    float maxX, maxY;
+    if(_particles.empty()) {
+        _minX = _minY = maxX = maxY = 0.0f;
+    }
+    else {
+        _minX = maxX = _particles[0].minX;
+        _minY = maxY = _particles[0].minY;
+        for(const ParticleEntry &entry : _particles) {
+            _minX = std::min(_minX, entry.minX);
+            _minY = std::min(_minY, entry.minY);
+            maxX = std::max(maxX, entry.maxX);
+            maxY = std::max(maxY, entry.maxY);
+        }
+    }
+
+    //Same cell size as the spatial index of the ObjectHandler, unless the area is too large
+    const float cellSize = std::max(2.0f * Info<float>::Grid::Size(), std::max(maxX - _minX, maxY - _minY) / MAX_CELLS);
+    _inverseCellSize = 1.0f / cellSize;
+    _cellCountX = Ego::Math::constrain(static_cast<int>(std::ceil((maxX - _minX) * _inverseCellSize)), 1, MAX_CELLS);
+    _cellCountY = Ego::Math::constrain(static_cast<int>(std::ceil((maxY - _minY) * _inverseCellSize)), 1, MAX_CELLS);
+
+    //Counting sort of the particles into the cells: count ...
+    _cellStart.assign(static_cast<size_t>(_cellCountX) * _cellCountY + 1, 0);
+    for(const ParticleEntry &entry : _particles) {
+        int cellMinX, cellMinY, cellMaxX, cellMaxY;
+        getCellRange(entry.minX, entry.minY, entry.maxX, entry.maxY, cellMinX, cellMinY, cellMaxX, cellMaxY);
+        for(int y = cellMinY; y <= cellMaxY; ++y) {
+            for(int x = cellMinX; x <= cellMaxX; ++x) {
+                _cellStart[y * _cellCountX + x + 1]++;
+            }
+        }
+    }
+
+    // ... compute the prefix sums ...
+    for(size_t i = 1; i < _cellStart.size(); ++i) {
+        _cellStart[i] += _cellStart[i - 1];
+    }
+
+    // ... and fill the cells (keeping the particles of a cell in the order they were added)
+    _cellParticles.resize(_cellStart.back());
+    _cellCursor.assign(_cellStart.begin(), _cellStart.end() - 1);
+    for(uint32_t i = 0; i < _particles.size(); ++i) {
+        const ParticleEntry &entry = _particles[i];
+        int cellMinX, cellMinY, cellMaxX, cellMaxY;
+        getCellRange(entry.minX, entry.minY, entry.maxX, entry.maxY, cellMinX, cellMinY, cellMaxX, cellMaxY);
+        for(int y = cellMinY; y <= cellMaxY; ++y) {
+            for(int x = cellMinX; x <= cellMaxX; ++x) {
+                _cellParticles[_cellCursor[y * _cellCountX + x]++] = i;
+            }
+        }
+    }
+}
+
+void ParticleBroadPhase::addObject(const std::shared_ptr<Object> &object)
+{
+    if(_particles.empty()) {
+        return;
+    }
+
+    const uint32_t objectIndex = static_cast<uint32_t>(_objects.size());
+    _objects.push_back(object);
+
+    //The volume the object will occupy during this update
+    oct_bb_t tmp_oct;
+    phys_expand_chr_bb(object.get(), 0.0f, 1.0f, tmp_oct);
+    const float objectMinZ = tmp_oct._mins[OCT_Z];
+    const float objectMaxZ = tmp_oct._maxs[OCT_Z];
+
+    const AxisAlignedBox2f &aabb = object->getAxisAlignedBox2D();
+    const float minX = aabb.get_min()[kX], maxX = aabb.get_max()[kX];
+    const float minY = aabb.get_min()[kY], maxY = aabb.get_max()[kY];
+
+    int cellMinX, cellMinY, cellMaxX, cellMaxY;
+    getCellRange(minX, minY, maxX, maxY, cellMinX, cellMinY, cellMaxX, cellMaxY);
+
+    //Particles spanning several cells must only be tested once
+    if(++_stamp == 0) {
+        for(ParticleEntry &entry : _particles) {
+            entry.stamp = 0;
+        }
+        _stamp = 1;
+    }
+
+    for(int y = cellMinY; y <= cellMaxY; ++y) {
+        for(int x = cellMinX; x <= cellMaxX; ++x) {
+            const int cell = y * _cellCountX + x;
+            for(uint32_t i = _cellStart[cell]; i < _cellStart[cell + 1]; ++i) {
+                const uint32_t particleIndex = _cellParticles[i];
+                ParticleEntry &entry = _particles[particleIndex];
+                if(entry.stamp == _stamp) {
+                    continue;
+                }
+                entry.stamp = _stamp;
+
+                //Overlap in the xy-plane?
+                if(entry.maxX < minX || entry.minX > maxX || entry.maxY < minY || entry.minY > maxY) {
+                    continue;
+                }
+                _statistics.candidates++;
+
+                //Overlap along the z-axis? phys_intersect_oct_bb() adds the platform tolerance at most.
+                if(entry.maxZ + PLATTOLERANCE < objectMinZ || objectMaxZ + PLATTOLERANCE < entry.minZ) {
+                    _statistics.culledByHeight++;
+                    continue;
+                }
+
+                _pairs.push_back({particleIndex, objectIndex});
+            }
+        }
+    }
+}
+
+void ParticleBroadPhase::end()
+{
+    std::sort(_pairs.begin(), _pairs.end(), [](const Pair &x, const Pair &y)
+    {
+        return x.particle < y.particle || (x.particle == y.particle && x.object < y.object);
+    });
+}
+
+void ParticleBroadPhase::release()
+{
+    _particles.clear();
+    _objects.clear();
+}
+
+} //namespace Physics
+} //namespace Ego
@@ -0,0 +1,236 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+/// @file egolib/game/Physics/BroadPhase.hpp
+/// @brief Broad phase collision detection (sort and sweep)
+
+#pragma once
+
+#include "idlib/idlib.hpp"
+#include "egolib/egolib.h"
+#include <unordered_map>
+
+//Forward declarations
+class Object;
+namespace Ego { class Particle; }
+
+namespace Ego
+{
+namespace Physics
+{
+
+/**
+* @brief
+*   Sort and sweep broad phase for Object to Object collisions.
+* @details
+*   Keeps a persistent array of object references and their 2D bounding boxes sorted along the
+*   x-axis. As objects move only a little between two updates, the array is re-sorted with an
+*   insertion sort in almost linear time. The sweep emits a flat list of potentially colliding
+*   pairs, sorted by the order in which the objects were added, so that the narrow phase handles
+*   collisions in a deterministic order.
+*
+*   Usage per update: begin(), add() every collidable object, end(), iterate getPairs(), release().
+**/
+class ObjectBroadPhase
+{
+public:
+    /// A pair of potentially colliding objects, the first one was added before the second one.
+    struct Pair
+    {
+        uint32_t first;
+        uint32_t second;
+    };
+
+    ObjectBroadPhase();
+
+    /**
+    * @brief
+    *   Start a new update. All objects not added again before end() are removed.
+    **/
+    void begin();
+
+    /**
+    * @brief
+    *   Add or refresh an object for this update
+    **/
+    void add(const std::shared_ptr<Object> &object);
+
+    /**
+    * @brief
+    *   Sort the objects along the x-axis and compute the pairs of potentially colliding objects
+    **/
+    void end();
+
+    /**
+    * @return
+    *   the pairs of potentially colliding objects computed by the last call to end()
+    **/
+    const std::vector<Pair>& getPairs() const { return _pairs; }
+
+    /**
+    * @return
+    *   the object at the specified index of a Pair
+    **/
+    const std::shared_ptr<Object>& getObject(const uint32_t index) const { return _entries[index].object; }
+
+    /**
+    * @brief
+    *   Release the references to the objects once the narrow phase is done.
+    *   The sorted order is kept for the next update.
+    **/
+    void release();
+
+private:
+    static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+    struct Entry
+    {
+        std::shared_ptr<Object> object;     ///< the object, only valid between begin() and release()
+        ObjectRef ref;                      ///< reference of the object
+        float minX, maxX, minY, maxY;       ///< 2D bounding box of the object
+        uint32_t order;                     ///< order in which the object was added during the current update
+        uint32_t frame;                     ///< last update in which this object was added
+        bool scenery;                       ///< Object::isScenery()
+        bool canUsePlatforms;               ///< Object::canuseplatforms
+    };
+
+    std::vector<Entry> _entries;            ///< entries sorted by minX
+    std::unordered_map<size_t, uint32_t> _entryOfRef; ///< maps ObjectRef::get() to the index of its entry, only for contained objects
+    std::vector<Pair> _pairs;               ///< pairs of potentially colliding objects
+    uint32_t _frame;                        ///< current update
+    uint32_t _order;                        ///< number of objects added during the current update
+};
+
+/**
+* @brief
+*   Broad phase for Particle to Object collisions.
+* @details
+*   Instead of one spatial query per particle, the swept bounding boxes of all particles are
+*   binned into a uniform grid once per update (using a counting sort into flat arrays). Every
+*   collidable object then tests the bins it overlaps. Particles whose ParticleProfile can never
+*   collide are culled before binning and candidates are additionally culled along the z-axis.
+*
+*   Usage per update: begin(), addParticle() every particle, bin(), addObject() every collidable
+*   object, end(), iterate getPairs(), release().
+**/
+class ParticleBroadPhase
+{
+public:
+    /// A pair of a potentially colliding particle and object (indices in the order they were added).
+    struct Pair
+    {
+        uint32_t particle;
+        uint32_t object;
+    };
+
+    /// Counters of the last update.
+    struct Statistics
+    {
+        size_t particles = 0;           ///< number of particles added
+        size_t culledByProfile = 0;     ///< particles culled because their profile can never collide
+        size_t binnedParticles = 0;     ///< particles binned into the grid
+        size_t candidates = 0;          ///< particle/object pairs overlapping in the xy-plane
+        size_t culledByHeight = 0;      ///< candidates culled along the z-axis, i.e. saved phys_intersect_oct_bb() calls
+    };
+
+    ParticleBroadPhase();
+
+    /**
+    * @brief
+    *   Start a new update
+    **/
+    void begin();
+
+    /**
+    * @brief
+    *   Add a particle for this update.
+    * @return
+    *   false if the particle can not collide and was culled
+    **/
+    bool addParticle(const std::shared_ptr<Ego::Particle> &particle);
+
+    /**
+    * @brief
+    *   Bin all particles added during this update into the grid
+    **/
+    void bin();
+
+    /**
+    * @brief
+    *   Find all particles which potentially collide with an object
+    **/
+    void addObject(const std::shared_ptr<Object> &object);
+
+    /**
+    * @brief
+    *   Sort the pairs by particle (in the order the particles were added), then by object
+    **/
+    void end();
+
+    /**
+    * @return
+    *   the pairs of potentially colliding particles and objects computed by the last call to end()
+    **/
+    const std::vector<Pair>& getPairs() const { return _pairs; }
+
+    const std::shared_ptr<Ego::Particle>& getParticle(const uint32_t index) const { return _particles[index].particle; }
+    const std::shared_ptr<Object>& getObject(const uint32_t index) const { return _objects[index]; }
+
+    /**
+    * @brief
+    *   Release the references to the particles and objects once the narrow phase is done
+    **/
+    void release();
+
+    /**
+    * @return
+    *   the counters of the last update
+    **/
+    const Statistics& getStatistics() const { return _statistics; }
+
+private:
+    /// The maximum number of cells along one axis (the cell size grows for larger areas).
+    static constexpr int MAX_CELLS = 256;
+
+    struct ParticleEntry
+    {
+        std::shared_ptr<Ego::Particle> particle;    ///< the particle, only valid between begin() and release()
+        float minX, maxX, minY, maxY, minZ, maxZ;   ///< bounding box of the particle swept over this update
+        uint32_t stamp;                             ///< last object query which visited this particle
+    };
+
+    void getCellRange(const float minX, const float minY, const float maxX, const float maxY, int& cellMinX, int& cellMinY, int& cellMaxX, int& cellMaxY) const;
+
+    std::vector<ParticleEntry> _particles;          ///< particles in the order they were added
+    std::vector<std::shared_ptr<Object>> _objects;  ///< objects in the order they were added
+    std::vector<uint32_t> _cellStart;               ///< index of the first particle of each cell in _cellParticles
+    std::vector<uint32_t> _cellCursor;              ///< write position of each cell while binning
+    std::vector<uint32_t> _cellParticles;           ///< particle indices, grouped by cell
+    std::vector<Pair> _pairs;                       ///< pairs of potentially colliding particles and objects
+
+    float _minX, _minY;                             ///< lower bounds of the grid
+    float _inverseCellSize;                         ///< 1 / width and height of a cell
+    int _cellCountX, _cellCountY;                   ///< number of cells along the x- and y-axis
+
+    uint32_t _stamp;                                ///< id of the current object query
+    Statistics _statistics;
+};
+
+} //namespace Physics
+} //namespace Ego
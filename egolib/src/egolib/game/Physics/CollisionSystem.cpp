@@ -57,220 +57,275 @@ void CollisionSystem::update()
     updateParticleCollisions();
 
     // accumulate the accumulators
-    for(const std::shared_ptr<Object> &pchr : _currentModule->getObjectHandler().iterator())
+    const bool parallel = egoboo_config_t::get().game_parallelPhysics_enable.getValue();
     {
-        if(pchr->isTerminated()) {
-            continue;
+        ObjectHandler::ObjectIterator objects = _currentModule->getObjectHandler().iterator();
+        const auto first = objects.cbegin();
+        auto integrateObjects = [this, first](size_t begin, size_t end)
+        {
+            for(size_t i = begin; i < end; ++i) {
+                integrate(**(first + i));
+            }
+        };
+        const size_t count = objects.cend() - first;
+        if(parallel) {
+            Ego::JobSystem::get().parallelFor(count, INTEGRATION_GRAIN_SIZE, integrateObjects);
+        }
+        else {
+            integrateObjects(0, count);
+        }
+    }
+    {
+        ParticleHandler::ParticleIterator particles = ParticleHandler::get().iterator();
+        const auto first = particles.cbegin();
+        auto integrateParticles = [this, first](size_t begin, size_t end)
+        {
+            for(size_t i = begin; i < end; ++i) {
+                integrate(**(first + i));
+            }
+        };
+        const size_t count = particles.cend() - first;
+        if(parallel) {
+            Ego::JobSystem::get().parallelFor(count, INTEGRATION_GRAIN_SIZE, integrateParticles);
+        }
+        else {
+            integrateParticles(0, count);
         }
-        
-        float tmpx, tmpy;
-        bool position_updated = false;
-        Vector3f max_apos;
+    }
+}
 
-		Vector3f tmp_pos = pchr->getPosition();
+void CollisionSystem::integrate(Object &object) const
+{
+    if(object.isTerminated()) {
+        return;
+    }
 
-        // do the "integration" of the accumulated accelerations
-        pchr->setVelocity(pchr->getVelocity() + pchr->phys.avel);
+    float tmpx, tmpy;
+    bool position_updated = false;
+    Vector3f max_apos;
 
-        // get a net displacement vector from aplat and acoll
-        {
-            // create a temporary apos_t
-            apos_t  apos_tmp;
+    Vector3f tmp_pos = object.getPosition();
+
+    // do the "integration" of the accumulated accelerations
+    object.setVelocity(object.getVelocity() + object.phys.avel);
 
-            // copy 1/2 of the data over
-            apos_tmp = pchr->phys.aplat;
+    // get a net displacement vector from aplat and acoll
+    {
+        // create a temporary apos_t
+        apos_t  apos_tmp;
 
-            // get the resultant apos_t
-            apos_tmp.join(pchr->phys.acoll);
+        // copy 1/2 of the data over
+        apos_tmp = object.phys.aplat;
 
-            // turn this into a vector
-            apos_t::evaluate(apos_tmp, max_apos);
-        }
+        // get the resultant apos_t
+        apos_tmp.join(object.phys.acoll);
+
+        // turn this into a vector
+        apos_t::evaluate(apos_tmp, max_apos);
+    }
 
-        // limit the size of the displacement
-        max_apos[kX] = Ego::Math::constrain( max_apos[kX], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
-        max_apos[kY] = Ego::Math::constrain( max_apos[kY], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
-        max_apos[kZ] = Ego::Math::constrain( max_apos[kZ], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+    // limit the size of the displacement
+    max_apos[kX] = Ego::Math::constrain( max_apos[kX], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+    max_apos[kY] = Ego::Math::constrain( max_apos[kY], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+    max_apos[kZ] = Ego::Math::constrain( max_apos[kZ], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
 
-        // do the "integration" on the position
-        if (std::abs(max_apos[kX]) > 0.0f)
+    // do the "integration" on the position
+    if (std::abs(max_apos[kX]) > 0.0f)
+    {
+        tmpx = tmp_pos[kX];
+        tmp_pos[kX] += max_apos[kX];
+        if ( EMPTY_BIT_FIELD != object.test_wall( tmp_pos ) )
         {
-            tmpx = tmp_pos[kX];
-            tmp_pos[kX] += max_apos[kX];
-            if ( EMPTY_BIT_FIELD != pchr->test_wall( tmp_pos ) )
-            {
-                // restore the old values
-                tmp_pos[kX] = tmpx;
-            }
-            else
-            {
-                //pchr->vel[kX] += pchr->phys.apos_coll[kX] * bump_str;
-                position_updated = true;
-            }
+            // restore the old values
+            tmp_pos[kX] = tmpx;
+        }
+        else
+        {
+            //object.vel[kX] += object.phys.apos_coll[kX] * bump_str;
+            position_updated = true;
         }
+    }
 
-        if (std::abs(max_apos[kY]) > 0.0f)
+    if (std::abs(max_apos[kY]) > 0.0f)
+    {
+        tmpy = tmp_pos[kY];
+        tmp_pos[kY] += max_apos[kY];
+        if ( EMPTY_BIT_FIELD != object.test_wall( tmp_pos ) )
         {
-            tmpy = tmp_pos[kY];
-            tmp_pos[kY] += max_apos[kY];
-            if ( EMPTY_BIT_FIELD != pchr->test_wall( tmp_pos ) )
-            {
-                // restore the old values
-                tmp_pos[kY] = tmpy;
-            }
-            else
-            {
-                //pchr->vel[kY] += pchr->phys.apos_coll[kY] * bump_str;
-                position_updated = true;
-            }
+            // restore the old values
+            tmp_pos[kY] = tmpy;
         }
+        else
+        {
+            //object.vel[kY] += object.phys.apos_coll[kY] * bump_str;
+            position_updated = true;
+        }
+    }
 
-        if (std::abs(max_apos[kZ]) > 0.0f)
+    if (std::abs(max_apos[kZ]) > 0.0f)
+    {
+        tmp_pos[kZ] += max_apos[kZ];
+        if ( tmp_pos[kZ] < object.getObjectPhysics().getGroundElevation() )
         {
-            tmp_pos[kZ] += max_apos[kZ];
-            if ( tmp_pos[kZ] < pchr->getObjectPhysics().getGroundElevation() )
-            {
-                // restore the old values
-                tmp_pos[kZ] = pchr->getObjectPhysics().getGroundElevation();
-                if ( pchr->getVelocity().z() < 0 )
-                {
-                    pchr->setVelocity(pchr->getVelocity() +
-                                      Vector3f(0.0f, 0.0f,
-                                               -(1.0f + pchr->getProfile()->getBounciness()) * pchr->getVelocity().z()));
-                }
-                position_updated = true;
-            }
-            else
+            // restore the old values
+            tmp_pos[kZ] = object.getObjectPhysics().getGroundElevation();
+            if ( object.getVelocity().z() < 0 )
             {
-                //pchr->vel[kZ] += pchr->phys.apos_coll[kZ] * bump_str;
-                position_updated = true;
+                object.setVelocity(object.getVelocity() +
+                                   Vector3f(0.0f, 0.0f,
+                                            -(1.0f + object.getProfile()->getBounciness()) * object.getVelocity().z()));
             }
+            position_updated = true;
         }
-
-        if ( position_updated )
+        else
         {
-            pchr->setPosition(tmp_pos);
+            //object.vel[kZ] += object.phys.apos_coll[kZ] * bump_str;
+            position_updated = true;
         }
     }
 
-    // accumulate the accumulators
-    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
+    if ( position_updated )
     {
-        float tmpx, tmpy;
-        bool position_updated = false;
-        Vector3f max_apos;
+        object.setPosition(tmp_pos);
+    }
+}
 
-        if(particle->isTerminated()) {
-            continue;
-        }
+void CollisionSystem::integrate(Ego::Particle &particle) const
+{
+    float tmpx, tmpy;
+    bool position_updated = false;
+    Vector3f max_apos;
 
-        Vector3f tmp_pos = particle->getPosition();
+    if(particle.isTerminated()) {
+        return;
+    }
 
-        // do the "integration" of the accumulated accelerations
-        particle->setVelocity(particle->getVelocity() + particle->phys.avel);
+    Vector3f tmp_pos = particle.getPosition();
 
-        position_updated = false;
+    // do the "integration" of the accumulated accelerations
+    particle.setVelocity(particle.getVelocity() + particle.phys.avel);
 
-        // get a net displacement vector from aplat and acoll
-        {
-            // create a temporary apos_t
-            apos_t  apos_tmp;
+    position_updated = false;
 
-            // copy 1/2 of the data over
-            apos_tmp = particle->phys.aplat;
+    // get a net displacement vector from aplat and acoll
+    {
+        // create a temporary apos_t
+        apos_t  apos_tmp;
 
-            // get the resultant apos_t
-            apos_tmp.join(particle->phys.acoll);
+        // copy 1/2 of the data over
+        apos_tmp = particle.phys.aplat;
 
-            // turn this into a vector
-            apos_t::evaluate(apos_tmp, max_apos);
-        }
+        // get the resultant apos_t
+        apos_tmp.join(particle.phys.acoll);
 
-        max_apos[kX] = Ego::Math::constrain( max_apos[kX], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
-        max_apos[kY] = Ego::Math::constrain( max_apos[kY], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
-        max_apos[kZ] = Ego::Math::constrain( max_apos[kZ], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+        // turn this into a vector
+        apos_t::evaluate(apos_tmp, max_apos);
+    }
 
-        // do the "integration" on the position
-        if (std::abs(max_apos[kX]) > 0.0f)
+    max_apos[kX] = Ego::Math::constrain( max_apos[kX], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+    max_apos[kY] = Ego::Math::constrain( max_apos[kY], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+    max_apos[kZ] = Ego::Math::constrain( max_apos[kZ], -Info<float>::Grid::Size(), Info<float>::Grid::Size());
+
+    // do the "integration" on the position
+    if (std::abs(max_apos[kX]) > 0.0f)
+    {
+        tmpx = tmp_pos[kX];
+        tmp_pos[kX] += max_apos[kX];
+        if ( EMPTY_BIT_FIELD != particle.test_wall( tmp_pos ) )
         {
-            tmpx = tmp_pos[kX];
-            tmp_pos[kX] += max_apos[kX];
-            if ( EMPTY_BIT_FIELD != particle->test_wall( tmp_pos ) )
-            {
-                // restore the old values
-                tmp_pos[kX] = tmpx;
-            }
-            else
-            {
-                //bdl.prt_ptr->vel[kX] += bdl.prt_ptr->phys.apos_coll[kX] * bump_str;
-                position_updated = true;
-            }
+            // restore the old values
+            tmp_pos[kX] = tmpx;
         }
+        else
+        {
+            //bdl.prt_ptr->vel[kX] += bdl.prt_ptr->phys.apos_coll[kX] * bump_str;
+            position_updated = true;
+        }
+    }
 
-        if (std::abs(max_apos[kY]) > 0.0f)
+    if (std::abs(max_apos[kY]) > 0.0f)
+    {
+        tmpy = tmp_pos[kY];
+        tmp_pos[kY] += max_apos[kY];
+        if ( EMPTY_BIT_FIELD != particle.test_wall( tmp_pos ) )
         {
-            tmpy = tmp_pos[kY];
-            tmp_pos[kY] += max_apos[kY];
-            if ( EMPTY_BIT_FIELD != particle->test_wall( tmp_pos ) )
-            {
-                // restore the old values
-                tmp_pos[kY] = tmpy;
-            }
-            else
-            {
-                //bdl.prt_ptr->vel[kY] += bdl.prt_ptr->phys.apos_coll[kY] * bump_str;
-                position_updated = true;
-            }
+            // restore the old values
+            tmp_pos[kY] = tmpy;
+        }
+        else
+        {
+            //bdl.prt_ptr->vel[kY] += bdl.prt_ptr->phys.apos_coll[kY] * bump_str;
+            position_updated = true;
         }
+    }
 
-        if (std::abs(max_apos[kZ]) > 0.0f)
+    if (std::abs(max_apos[kZ]) > 0.0f)
+    {
+        tmp_pos[kZ] += max_apos[kZ];
+        if ( tmp_pos[kZ] < particle.enviro.floor_level )
         {
-            tmp_pos[kZ] += max_apos[kZ];
-            if ( tmp_pos[kZ] < particle->enviro.floor_level )
-            {
-                // restore the old values
-                tmp_pos[kZ] = particle->enviro.floor_level;
-                if ( particle->getVelocity().z() < 0 )
-                {
-                    particle->setVelocity(particle->getVelocity() +
-                                          Vector3f(0.0f, 0.0f,
-                                                   -(1.0f + particle->getProfile()->dampen) * particle->getVelocity().z()));;
-                }
-                position_updated = true;
-            }
-            else
+            // restore the old values
+            tmp_pos[kZ] = particle.enviro.floor_level;
+            if ( particle.getVelocity().z() < 0 )
             {
-                //bdl.prt_ptr->vel[kZ] += bdl.prt_ptr->phys.apos_coll[kZ] * bump_str;
-                position_updated = true;
+                particle.setVelocity(particle.getVelocity() +
+                                     Vector3f(0.0f, 0.0f,
+                                              -(1.0f + particle.getProfile()->dampen) * particle.getVelocity().z()));;
             }
+            position_updated = true;
         }
-
-        // Change the direction of the particle
-        if ( particle->getProfile()->rotatetoface )
+        else
         {
-            // Turn to face new direction
-            particle->facing = Facing(vec_to_facing( particle->getVelocity().x() , particle->getVelocity().y() ));
+            //bdl.prt_ptr->vel[kZ] += bdl.prt_ptr->phys.apos_coll[kZ] * bump_str;
+            position_updated = true;
         }
+    }
 
-        if ( position_updated )
-        {
-            particle->setPosition(tmp_pos);
-        }
+    // Change the direction of the particle
+    if ( particle.getProfile()->rotatetoface )
+    {
+        // Turn to face new direction
+        particle.facing = Facing(vec_to_facing( particle.getVelocity().x() , particle.getVelocity().y() ));
+    }
+
+    if ( position_updated )
+    {
+        particle.setPosition(tmp_pos);
     }
 }
 
 void CollisionSystem::updateObjectCollisions()
 {
-    std::unordered_set<std::shared_ptr<Object>> handledObjects;
-
-    //Detect character -> character collisions
+    //Broad phase: gather all objects which can collide
+    _objectBroadPhase.begin();
     for(const std::shared_ptr<Object> &object : _currentModule->getObjectHandler().iterator()) {
 
         //Can we collide?
         if (!object->canCollide()) {
             continue;
         }
-        handledObjects.insert(object);
+
+        _objectBroadPhase.add(object);
+        _collidingObjects.push_back(object);
+    }
+    _objectBroadPhase.end();
+
+    //Narrow phase: detect character -> character collisions
+    //The pairs are sorted by the order the objects were added, so we can handle the objects one after
+    //another (as the object loop did before the broad phase existed): the platform check of an object
+    //is done right before its collisions, after the collisions of all objects handled before it
+    const std::vector<ObjectBroadPhase::Pair> &pairs = _objectBroadPhase.getPairs();
+    auto pair = pairs.cbegin();
+    for(const std::shared_ptr<Object> &object : _collidingObjects) {
+        auto firstPair = pair;
+        while(pair != pairs.cend() && _objectBroadPhase.getObject(pair->first) == object) {
+            ++pair;
+        }
+
+        //Can we still collide? (e.g. we mounted another object)
+        if (!object->canCollide()) {
+            continue;
+        }
 
         //First check if this object is still attached to it's Platform
         const std::shared_ptr<Object> &platform = _currentModule->getObjectHandler()[object->onwhichplatform_ref];
@@ -283,28 +338,10 @@ void CollisionSystem::updateObjectCollisions()
             }
         }
 
-        //TODO: Remove this messy block and replace it with something better
-        // use the object velocity to figure out where the volume that the object will occupy during this update
-        // convert the oct_bb_t to a correct BSP_aabb_t
-        oct_bb_t tmp_oct;
-        phys_expand_chr_bb(object.get(), 0.0f, 1.0f, tmp_oct);
-        const AxisAlignedBox2f aabb2d = AxisAlignedBox2f(Point2f(tmp_oct._mins[OCT_X], tmp_oct._mins[OCT_Y]), Point2f(tmp_oct._maxs[OCT_X], tmp_oct._maxs[OCT_Y]));
-
-        //Do not collide scenery with other scenery objects - unless they can use platforms,
-        //for example boxes stacked on top of other boxes
-        bool canCollideWithScenery = !object->isScenery() || object->canuseplatforms;
-
-        // Check collisions to nearby Objects
-        std::vector<std::shared_ptr<Object>> possibleCollisions;
-        _currentModule->getObjectHandler().findObjects(object->getAxisAlignedBox2D(), possibleCollisions, canCollideWithScenery);
-        for (const std::shared_ptr<Object> &other : possibleCollisions)
-        {
-            //Skip possible interactions that have already been handled earlier this iteration
-            if(handledObjects.find(other) != handledObjects.end()) {
-                continue;
-            }
+        for(; firstPair != pair; ++firstPair) {
+            const std::shared_ptr<Object> &other = _objectBroadPhase.getObject(firstPair->second);
 
-            //Can it collide?
+            //Can they still collide?
             if(!other->canCollide()) {
                 continue;
             }
@@ -316,14 +353,18 @@ void CollisionSystem::updateObjectCollisions()
             }
         }
     }
+    _collidingObjects.clear();
+    _objectBroadPhase.release();
 }
 
 void CollisionSystem::updateParticleCollisions()
 {
-    //Check collisions with particles
+    //Broad phase: bin all particles once ...
+    _particleBroadPhase.begin();
     for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
     {
-        if(!particle->canCollide()) {
+        //Culls particles which can not collide
+        if(!_particleBroadPhase.addParticle(particle)) {
             continue;
         }
 
@@ -331,31 +372,37 @@ void CollisionSystem::updateParticleCollisions()
         if (particle->onwhichplatform_update < update_wld && _currentModule->getObjectHandler().exists(particle->onwhichplatform_ref)) {
             particle->getParticlePhysics().detachFromPlatform();
         }
+    }
+    _particleBroadPhase.bin();
 
-        // use the object velocity to figure out where the volume that the object will occupy during this update
-        // convert the oct_bb_t to a correct AABB2f
-        oct_bb_t   tmp_oct;
-        phys_expand_prt_bb(particle.get(), 0.0f, 1.0f, tmp_oct);
-        const AxisAlignedBox2f aabb2d = AxisAlignedBox2f(Point2f(tmp_oct._mins[OCT_X], tmp_oct._mins[OCT_Y]), Point2f(tmp_oct._maxs[OCT_X], tmp_oct._maxs[OCT_Y]));
+    // ... and test the bins against all Objects
+    for(const std::shared_ptr<Object> &object : _currentModule->getObjectHandler().iterator())
+    {
+        if(object->canCollide()) {
+            _particleBroadPhase.addObject(object);
+        }
+    }
+    _particleBroadPhase.end();
 
-        //Detect collisions with nearby Objects
-        std::vector<std::shared_ptr<Object>> possibleCollisions;
-         _currentModule->getObjectHandler().findObjects(aabb2d, possibleCollisions, true);
-        for (const std::shared_ptr<Object> &object : possibleCollisions)
-        {
-            //Is it a valid collision?
-            if(!object->canCollide()) {
-                continue;
-            }
+    //Narrow phase: check collisions with particles
+    for(const ParticleBroadPhase::Pair &pair : _particleBroadPhase.getPairs())
+    {
+        const std::shared_ptr<Ego::Particle> &particle = _particleBroadPhase.getParticle(pair.particle);
+        const std::shared_ptr<Object> &object = _particleBroadPhase.getObject(pair.object);
 
-            //Detect any collisions and handle it if needed
-            float tmin, tmax;
-            if(detectCollision(particle, object, &tmin, &tmax)) {
-                do_prt_platform_detection(object->getObjRef(), particle->getParticleID());
-                do_chr_prt_collision(object, particle, tmin, tmax);
-            }
+        //Is it still a valid collision?
+        if(!object->canCollide()) {
+            continue;
         }
-    }    
+
+        //Detect any collisions and handle it if needed
+        float tmin, tmax;
+        if(detectCollision(particle, object, &tmin, &tmax)) {
+            do_prt_platform_detection(object->getObjRef(), particle->getParticleID());
+            do_chr_prt_collision(object, particle, tmin, tmax);
+        }
+    }
+    _particleBroadPhase.release();
 }
 
 bool CollisionSystem::detectCollision(const std::shared_ptr<Ego::Particle> &particle, const std::shared_ptr<Object> &object, float *tmin, float *tmax) const
@@ -20,6 +20,7 @@
 
 #include "idlib/idlib.hpp"
 #include "egolib/egolib.h"
+#include "egolib/game/Physics/BroadPhase.hpp"
 
 //Forward declarations
 namespace Ego { class Particle; }
@@ -46,7 +47,27 @@ public:
 
     void update();
 
+    /**
+    * @return
+    *   the counters of the Particle to Object broad phase of the last update
+    **/
+    const ParticleBroadPhase::Statistics& getParticleStatistics() const { return _particleBroadPhase.getStatistics(); }
+
 private:
+    /**
+    * @brief
+    *   Integrate the accumulated collision accelerations and displacements of an Object.
+    *   Only modifies the specified Object, so it may run concurrently for different Objects.
+    **/
+    void integrate(Object &object) const;
+
+    /**
+    * @brief
+    *   Integrate the accumulated collision accelerations and displacements of a Particle.
+    *   Only modifies the specified Particle, so it may run concurrently for different Particles.
+    **/
+    void integrate(Ego::Particle &particle) const;
+
     /**
     * @brief
     *   Detects if a collision occurs between two Objects
@@ -99,6 +120,14 @@ private:
     **/
     bool handleMountingCollision(const std::shared_ptr<Object> &character, const std::shared_ptr<Object> &mount);
 
+private:
+    /// Number of entities integrated by a single job.
+    static constexpr size_t INTEGRATION_GRAIN_SIZE = 64;
+
+    ObjectBroadPhase _objectBroadPhase;     ///< Broad phase for Object to Object collisions
+    ParticleBroadPhase _particleBroadPhase; ///< Broad phase for Particle to Object collisions
+    std::vector<std::shared_ptr<Object>> _collidingObjects; ///< collidable objects in the order they were added to the broad phase
+
 private:
     friend idlib::default_new_functor<CollisionSystem>;
     friend idlib::default_delete_functor<CollisionSystem>;
@@ -53,6 +53,26 @@ void ParticlePhysics::updatePhysics()
     }
 }
 
+bool ParticlePhysics::requiresSerialUpdate() const
+{
+    //Gravity fields pull other objects and particles
+    if(_particle.getProfile()->getGravityPull() != 0.0f) {
+        return true;
+    }
+
+    //Homing dither is drawn from the global random number generator
+    if(_particle.getProfile()->homing) {
+        return true;
+    }
+
+    //Platform matrices are updated on demand
+    if(ObjectRef::Invalid != _particle.onwhichplatform_ref) {
+        return true;
+    }
+
+    return false;
+}
+
 void ParticlePhysics::updateMovement()
 {
     Ego::prt_environment_t *penviro = &(_particle.enviro);
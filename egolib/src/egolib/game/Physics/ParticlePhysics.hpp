@@ -17,6 +17,15 @@ public:
 
     void detachFromPlatform();
 
+    /**
+    * @brief
+    *	Check if updatePhysics() of this Particle must not run concurrently with other particles.
+    * @return
+    *	true if updating this Particle has side effects on other entities or on shared state
+    *	(gravity fields, random homing dither, lazily updated platform matrices)
+    **/
+    bool requiresSerialUpdate() const;
+
 private:
     void updateEnviroment();
 
@@ -67,14 +67,19 @@ import_list_t g_importList;
 uint32_t clock_chr_stat   = 0;
 uint32_t update_wld       = 0;
 
-int chr_stoppedby_tests = 0;
-int chr_pressure_tests = 0;
+std::atomic<int> chr_stoppedby_tests(0);
+std::atomic<int> chr_pressure_tests(0);
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
 // looping - stuff called every loop - not accessible by scripts
 static void game_reset_players();
+static void move_all_particles_parallel();
+static bool chr_can_think(const Object& object);
+static void chr_think(Object& object);
+static bool chr_requires_serial_think(const Object& object);
+static void let_all_characters_think_parallel();
 
 // implementing wawalite data
 
@@ -265,12 +270,19 @@ void MainLoop::move_all_objects()
     chr_stoppedby_tests = 0;
 
     // move every particle
-    for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
+    if(egoboo_config_t::get().game_parallelPhysics_enable.getValue())
     {
-        if(particle->isTerminated()) {
-            continue;
+        move_all_particles_parallel();
+    }
+    else
+    {
+        for(const std::shared_ptr<Ego::Particle> &particle : ParticleHandler::get().iterator())
+        {
+            if(particle->isTerminated()) {
+                continue;
+            }
+            particle->getParticlePhysics().updatePhysics();
         }
-        particle->getParticlePhysics().updatePhysics();
     }
 
     // Move every character
@@ -284,6 +296,56 @@ void MainLoop::move_all_objects()
     }
 }
 
+//--------------------------------------------------------------------------------------------
+void move_all_particles_parallel()
+{
+    /// @details Particles which do not affect other entities are updated by parallel jobs. Particles which
+    ///          do (see ParticlePhysics::requiresSerialUpdate) act as barriers and are updated on this
+    ///          thread, once all particles before them are done. Together with the ordered replay of
+    ///          deferred side effects this yields exactly the same result as the serial update.
+
+    static const size_t GRAIN_SIZE = 64;
+    static std::vector<Ego::Particle*> particles;
+
+    // keep the particle list locked until all jobs are done
+    ParticleHandler::ParticleIterator iterator = ParticleHandler::get().iterator();
+
+    particles.clear();
+    for(const std::shared_ptr<Ego::Particle> &particle : iterator)
+    {
+        if(particle->isTerminated()) {
+            continue;
+        }
+        particles.push_back(particle.get());
+    }
+
+    size_t begin = 0;
+    while(begin < particles.size())
+    {
+        // find the next barrier
+        size_t end = begin;
+        while(end < particles.size() && !particles[end]->getParticlePhysics().requiresSerialUpdate()) {
+            end++;
+        }
+
+        // update the independent particles before the barrier in parallel
+        Ego::JobSystem::get().parallelFor(end - begin, GRAIN_SIZE, [begin](size_t first, size_t last)
+        {
+            for(size_t i = first; i < last; ++i) {
+                particles[begin + i]->getParticlePhysics().updatePhysics();
+            }
+        });
+
+        // update the barrier itself
+        if(end < particles.size()) {
+            particles[end]->getParticlePhysics().updatePhysics();
+            end++;
+        }
+
+        begin = end;
+    }
+}
+
 void MainLoop::updateLocalStats()
 {
     // Check for all local players being dead
@@ -870,13 +932,17 @@ void game_load_module_profiles( const std::string& modname )
     SearchContext* ctxt = new SearchContext(Ego::VfsPath(folderPath), Ego::Extension("obj"), VFS_SEARCH_DIR);
     if (!ctxt) return;
 
+    std::vector<std::string> objectPaths;
     while (ctxt->hasData()) {
         auto searchResult = ctxt->getData();
-        ProfileSystem::get().loadOneProfile(searchResult.string());
+        objectPaths.push_back(searchResult.string());
         ctxt->nextData();
     }
     delete ctxt;
     ctxt = nullptr;
+
+    // the profiles are parsed in parallel and loaded in search order
+    ProfileSystem::get().loadProfiles(objectPaths);
 }
 
 //--------------------------------------------------------------------------------------------
@@ -1005,42 +1071,150 @@ void MainLoop::let_all_characters_think()
 {
     /// @author ZZ
     /// @details This function funst the ai scripts for all eligible objects
+    if(egoboo_config_t::get().game_parallelThink_enable.getValue())
+    {
+        let_all_characters_think_parallel();
+        return;
+    }
+
     for(const std::shared_ptr<Object> &object : _currentModule->getObjectHandler().iterator())
     {
-        if(object->isTerminated()) {
-            continue;
+        if(chr_can_think(*object)) {
+            chr_think(*object);
         }
+    }
+}
 
-        //Only inventory items marked as equipment has active AI scripts
-        if(object->isInsideInventory() && !object->getProfile()->isEquipment()) {
-            continue;
+//--------------------------------------------------------------------------------------------
+bool chr_can_think(const Object& object)
+{
+    if(object.isTerminated()) {
+        return false;
+    }
+
+    //Only inventory items marked as equipment has active AI scripts
+    if(object.isInsideInventory() && !object.getProfile()->isEquipment()) {
+        return false;
+    }
+
+    // only let dead/destroyed things think if they have beem crushed/cleanedup
+    return object.isAlive() || HAS_SOME_BITS( object.ai.alert, ALERTIF_CRUSHED ) || HAS_SOME_BITS( object.ai.alert, ALERTIF_CLEANEDUP );
+}
+
+//--------------------------------------------------------------------------------------------
+void chr_think(Object& object)
+{
+    // check for actions that must always be handled
+    bool is_cleanedup = HAS_SOME_BITS( object.ai.alert, ALERTIF_CLEANEDUP );
+    bool is_crushed   = HAS_SOME_BITS( object.ai.alert, ALERTIF_CRUSHED );
+
+    // Figure out alerts that weren't already set
+    set_alerts(object.getObjRef());
+
+    // Cleaned up characters shouldn't be alert to anything else
+    if (is_cleanedup) { 
+        object.ai.alert = ALERTIF_CLEANEDUP; 
+        /*object.ai.timer = update_wld + 1;*/ 
+    }
+
+    // Crushed characters shouldn't be alert to anything else
+    if (is_crushed)  { 
+        object.ai.alert = ALERTIF_CRUSHED; 
+        object.ai.timer = update_wld + 1;  //Prevents IfTimeOut from triggering
+    }
+
+    scr_run_chr_script(&object);
+}
+
+//--------------------------------------------------------------------------------------------
+bool chr_requires_serial_think(const Object& object)
+{
+    // Only pre-decoded programs which invoke thread-safe functions only can run on worker threads
+    if(!object.getProfile()->getAIScript()._program.threadSafe) {
+        return true;
+    }
+
+    // Mounts copy the movement latches of their rider
+    return object.isMount() && object.getLeftHandItem();
+}
+
+//--------------------------------------------------------------------------------------------
+void let_all_characters_think_parallel()
+{
+    /// @details Objects with thread-safe scripts only modify their own state, they think in parallel jobs.
+    ///          All other objects act as barriers and think on this thread, once all objects before them are done.
+    ///          Objects sharing a profile share the position in its script, they think one after another on the
+    ///          same job. The deferred side effects of each object are replayed in iteration order, so the result
+    ///          is identical to the serial update.
+
+    static const size_t GRAIN_SIZE = 1;
+    static std::vector<Object*> objects;
+    static std::vector<size_t> order;
+    static std::vector<size_t> groups;
+    static std::vector<Ego::CommandBuffer> commandBuffers;
+
+    scripting_system_begin();
+    const bool serial = script_state_t::is_tracing() || Ego::Script::Runtime::get().isProfilingEnabled();
+
+    // think in parallel, in groups of objects sharing a script
+    auto thinkInParallel = []()
+    {
+        if(objects.empty()) {
+            return;
         }
-        
-        // check for actions that must always be handled
-        bool is_cleanedup = HAS_SOME_BITS( object->ai.alert, ALERTIF_CLEANEDUP );
-        bool is_crushed   = HAS_SOME_BITS( object->ai.alert, ALERTIF_CRUSHED );
 
-        // only let dead/destroyed things think if they have beem crushed/cleanedup
-        if (object->isAlive() || is_crushed || is_cleanedup )
+        order.clear();
+        for(size_t i = 0; i < objects.size(); ++i) {
+            order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [](size_t x, size_t y)
         {
-            // Figure out alerts that weren't already set
-            set_alerts(object->getObjRef());
-
-            // Cleaned up characters shouldn't be alert to anything else
-            if (is_cleanedup) { 
-                object->ai.alert = ALERTIF_CLEANEDUP; 
-                /*object->ai.timer = update_wld + 1;*/ 
+            return std::less<const script_info_t*>()(&objects[x]->getProfile()->getAIScript(), &objects[y]->getProfile()->getAIScript());
+        });
+        groups.clear();
+        for(size_t i = 0; i < order.size(); ++i) {
+            if(0 == i || &objects[order[i - 1]]->getProfile()->getAIScript() != &objects[order[i]]->getProfile()->getAIScript()) {
+                groups.push_back(i);
             }
+        }
+        groups.push_back(order.size());
 
-            // Crushed characters shouldn't be alert to anything else
-            if (is_crushed)  { 
-                object->ai.alert = ALERTIF_CRUSHED; 
-                object->ai.timer = update_wld + 1;  //Prevents IfTimeOut from triggering
+        if(commandBuffers.size() < objects.size()) {
+            commandBuffers.resize(objects.size());
+        }
+        Ego::JobSystem::get().parallelFor(groups.size() - 1, GRAIN_SIZE, [](size_t first, size_t last)
+        {
+            for(size_t i = groups[first]; i < groups[last]; ++i) {
+                Ego::CommandBuffer::Recording recording(commandBuffers[order[i]]);
+                chr_think(*objects[order[i]]);
             }
+        });
+
+        for(size_t i = 0; i < objects.size(); ++i) {
+            commandBuffers[i].replay();
+        }
+        objects.clear();
+    };
+
+    // keep the object list locked until all jobs are done
+    ObjectHandler::ObjectIterator iterator = _currentModule->getObjectHandler().iterator();
 
-            scr_run_chr_script(object.get());
+    objects.clear();
+    for(const std::shared_ptr<Object> &object : iterator)
+    {
+        // barriers may change whether or how the objects after them think
+        if(!chr_can_think(*object)) {
+            continue;
+        }
+        if(serial || chr_requires_serial_think(*object)) {
+            thinkInParallel();
+            chr_think(*object);
+        }
+        else {
+            objects.push_back(object.get());
         }
     }
+    thinkInParallel();
 }
 
 //--------------------------------------------------------------------------------------------
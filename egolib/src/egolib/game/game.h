@@ -182,8 +182,8 @@ extern uint32_t        clock_chr_stat;        ///< For enchant stat regeneration
 extern uint32_t        update_wld;            ///< The number of times the game has been updated
 
 // counters for debugging wall collisions
-extern int chr_stoppedby_tests;
-extern int chr_pressure_tests;
+extern std::atomic<int> chr_stoppedby_tests;
+extern std::atomic<int> chr_pressure_tests;
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
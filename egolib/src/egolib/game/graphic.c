@@ -46,12 +46,14 @@
 #include "egolib/game/Graphics/RenderPasses/ReflectiveTilesSecondRenderPass.hpp"
 #include "egolib/game/Graphics/RenderPasses/HeightmapRenderPass.hpp"
 #include "egolib/game/mesh.h"
-#include "egolib/game/Graphics/DefaultMd2ModelRenderer.hpp"
+#include "egolib/game/Graphics/KeyframeMd2ModelRenderer.hpp"
 #include "egolib/game/Graphics/BillboardSystem.hpp"
+#include "egolib/game/Graphics/AnimatedVertexCache.hpp"
 #include "egolib/game/Graphics/CameraSystem.hpp"
 #include "egolib/Entities/_Include.hpp"
 #include "egolib/game/Graphics/TextureAtlasManager.hpp"
 #include "egolib/game/Module/Passage.hpp"
+#include "egolib/game/Physics/CollisionSystem.hpp"
 #include "egolib/game/GUI/Material.hpp"
 
 //--------------------------------------------------------------------------------------------
@@ -232,6 +234,8 @@ void gfx_system_init_all_graphics()
 void gfx_system_release_all_graphics()
 {
     GFX::get().getBillboardSystem().reset();
+    GFX::get().getAnimatedVertexCache().clear();
+    GFX::get().getMd2ModelRenderer().release();
     Ego::TextureManager::get().release_all();
 }
 
@@ -244,9 +248,7 @@ void gfx_system_make_enviro()
     // Find the environment map positions
     for (size_t i = 0; i < MD2Model::normalCount; ++i)
     {
-        float x = MD2Model::getMD2Normal(i, 0);
-        float y = MD2Model::getMD2Normal(i, 1);
-        indextoenvirox[i] = std::atan2(y, x) * idlib::inv_two_pi<float>();
+        indextoenvirox[i] = MD2Model::getEnviroX(i);
     }
 }
 
@@ -512,6 +514,25 @@ float draw_debug(float y)
 
         os.str(std::string()); os << "~~PASS:    " << _currentModule->getPassageCount();
         y = _gameEngine->getUIManager()->drawBitmapFontString(Vector2f(0, y), os.str(), 0, 1.0f);
+
+        const auto& prtColl = Ego::Physics::CollisionSystem::get().getParticleStatistics();
+        os.str(std::string()); os << "~~PRTCOLL: " << prtColl.binnedParticles << "/" << prtColl.particles << " PRT, "
+                                  << prtColl.culledByProfile << " CULLED";
+        y = _gameEngine->getUIManager()->drawBitmapFontString(Vector2f(0, y), os.str(), 0, 1.0f);
+
+        os.str(std::string()); os << "~~PRTTEST: " << (prtColl.candidates - prtColl.culledByHeight) << "/" << prtColl.candidates << " ("
+                                  << prtColl.culledByHeight << " SAVED)";
+        y = _gameEngine->getUIManager()->drawBitmapFontString(Vector2f(0, y), os.str(), 0, 1.0f);
+
+        const auto& tileStats = Ego::Graphics::Internal::TileListV2::getStatistics();
+        os.str(std::string()); os << "~~TILES:   " << tileStats.tiles << " TILES, " << tileStats.drawCalls << " CALLS, "
+                                  << (tileStats.indexBytes / 1024) << " KB";
+        y = _gameEngine->getUIManager()->drawBitmapFontString(Vector2f(0, y), os.str(), 0, 1.0f);
+
+        const auto& vertexStats = GFX::get().getAnimatedVertexCache().getStatistics();
+        os.str(std::string()); os << "~~ANIMVRT: " << vertexStats.entries << " STATES, " << vertexStats.hits << " SHARED, "
+                                  << vertexStats.misses << " NEW";
+        y = _gameEngine->getUIManager()->drawBitmapFontString(Vector2f(0, y), os.str(), 0, 1.0f);
     }
 
     if (Ego::Input::InputSystem::get().isKeyDown(SDLK_F7))
@@ -633,6 +654,9 @@ void draw_hud()
         y = draw_game_status(y);
     }
     _gameEngine->getUIManager()->endRenderUI();
+
+    // The HUD is drawn after all cameras, start counting the tiles of the next frame.
+    Ego::Graphics::Internal::TileListV2::resetStatistics();
 }
 
 //--------------------------------------------------------------------------------------------
@@ -900,37 +924,8 @@ void gfx_config_t::init(gfx_config_t& self)
 //--------------------------------------------------------------------------------------------
 // grid_lighting FUNCTIONS
 //--------------------------------------------------------------------------------------------
-float GridIllumination::grid_lighting_test(const ego_mesh_t& mesh, GLXvector3f pos, float& low_diff, float& hgh_diff)
-{
-    const lighting_cache_t *cache_list[4];
-
-    int ix = std::floor(pos[XX] / Info<float>::Grid::Size());
-    int iy = std::floor(pos[YY] / Info<float>::Grid::Size());
-
-    Index1D fan[4];
-    fan[0] = mesh.getTileIndex(Index2D(ix, iy));
-    fan[1] = mesh.getTileIndex(Index2D(ix + 1, iy));
-    fan[2] = mesh.getTileIndex(Index2D(ix, iy + 1));
-    fan[3] = mesh.getTileIndex(Index2D(ix + 1, iy + 1));
-
-    for (size_t cnt = 0; cnt < 4; cnt++)
-    {
-        cache_list[cnt] = nullptr;
-		if (fan[cnt] == Index1D::Invalid) {
-			cache_list[cnt] = nullptr;
-		} else {
-			cache_list[cnt] = &(mesh.getTileInfo(fan[cnt])._cache);
-		}
-    }
-
-    float u = pos[XX] / Info<float>::Grid::Size() - ix;
-    float v = pos[YY] / Info<float>::Grid::Size() - iy;
-
-    return lighting_cache_test(cache_list, u, v, low_diff, hgh_diff);
-}
-
 //--------------------------------------------------------------------------------------------
-float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, bool reflective, float mesh_lighting_keep)
+float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, bool reflective, float mesh_lighting_keep, uint32_t frame)
 {
 	// if no update is requested, return an "error value"
 	if (!tile._lightingCache.getNeedUpdate())
@@ -939,7 +934,7 @@ float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, b
 	}
 
 	// has the lighting already been calculated this frame?
-	if (tile._lightingCache.isValid(_gameEngine->getNumberOfFramesRendered()))
+	if (tile._lightingCache.isValid(frame))
 	{
 		return -1.0f;
 	}
@@ -952,6 +947,7 @@ float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, b
 	light_cache_t& d2_cache = tile._vertexLightingCache._d2_cache;
 
 	float max_delta = 0.0f;
+	bool converged = true;
 	for (size_t corner = 0; corner < 4; corner++)
 	{
 		GLXvector3f& pnrm = ncache[corner];
@@ -970,7 +966,16 @@ float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, b
 		if (plight != light_new)
 		{
 			light_old = plight;
-			plight = light_old * mesh_lighting_keep + light_new * (1.0f - mesh_lighting_keep);
+			if (std::abs(light_new - light_old) < 1.0f)
+			{
+				// less than one intensity step, snap to the new lighting
+				plight = light_new;
+			}
+			else
+			{
+				plight = light_old * mesh_lighting_keep + light_new * (1.0f - mesh_lighting_keep);
+				converged = false;
+			}
 
 			// measure the actual delta
 			delta = std::abs(light_old - plight);
@@ -997,9 +1002,9 @@ float GridIllumination::light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, b
 		max_delta = std::max(max_delta, pdelta1);
 	}
 
-	// un-mark the lcache
-	tile._lightingCache.setNeedUpdate(false);
-	tile._lightingCache.setLastFrame(_gameEngine->getNumberOfFramesRendered());
+	// un-mark the lcache if the corners have reached the grid lighting
+	tile._lightingCache.setNeedUpdate(!converged);
+	tile._lightingCache.setLastFrame(frame);
 
 	return max_delta;
 }
@@ -1034,60 +1039,6 @@ bool GridIllumination::grid_lighting_interpolate(const ego_mesh_t& mesh, lightin
     return lighting_cache_t::lighting_cache_interpolate(dst, cache_list, u, v);
 }
 
-void GridIllumination::test_one_corner(const ego_mesh_t& mesh, GLXvector3f pos, float& pdelta)
-{
-	// interpolate the lighting for the given corner of the mesh
-	float low_delta, hgh_delta;
-	pdelta = grid_lighting_test(mesh, pos, low_delta, hgh_delta);
-
-	// determine the weighting
-	float hgh_wt, low_wt;
-	hgh_wt = (pos[ZZ] - mesh._tmem._bbox.get_min()[kZ]) / (mesh._tmem._bbox.get_max()[kZ] - mesh._tmem._bbox.get_min()[kZ]);
-	hgh_wt = Ego::Math::constrain(hgh_wt, 0.0f, 1.0f);
-	low_wt = 1.0f - hgh_wt;
-
-	pdelta = low_wt * low_delta + hgh_wt * hgh_delta;
-}
-
-bool GridIllumination::test_corners(const ego_mesh_t& mesh, ego_tile_info_t& tile, float threshold)
-{
-	if (threshold < 0.0f) threshold = 0.0f;
-
-	// get the lighting and per-vertex lighting cache for this tile
-	light_cache_t& lcache = tile._lightingCache._contents;
-	light_cache_t& d1_cache = tile._vertexLightingCache._d1_cache;
-
-	bool retval = false;
-	for (size_t corner = 0; corner < 4; corner++)
-	{
-		float& pdelta = d1_cache[corner];
-		float& plight = lcache[corner];
-		GLXvector3f& ppos = mesh._tmem._plst[tile._vrtstart + corner];
-
-		float delta;
-		test_one_corner(mesh, ppos, delta);
-
-		if (0.0f == plight)
-		{
-			delta = 10.0f;
-		}
-		else
-		{
-			delta /= plight;
-			delta = Ego::Math::constrain(delta, 0.0f, 10.0f);
-		}
-
-		pdelta += delta;
-
-		if (pdelta > threshold)
-		{
-			retval = true;
-		}
-	}
-
-	return retval;
-}
-
 void GridIllumination::light_one_corner(ego_mesh_t& mesh, ego_tile_info_t& tile, const bool reflective, const Vector3f& pos, const Vector3f& nrm, float& plight)
 {
 	// interpolate the lighting for the given corner of the mesh
@@ -1158,41 +1109,26 @@ void gfx_do_flip_pages()
 //--------------------------------------------------------------------------------------------
 // LIGHTING FUNCTIONS
 //--------------------------------------------------------------------------------------------
-gfx_rv GridIllumination::light_fans_throttle_update(ego_mesh_t * mesh, ego_tile_info_t& tile, const Index1D& tileIndex, float threshold)
+//--------------------------------------------------------------------------------------------
+/// @brief Invoke <tt>body(begin, end)</tt> for ranges of the visible tiles.
+/// @remark The ranges are processed by parallel jobs if graphic.parallelLighting.enable is set.
+template <typename Body>
+static void for_each_tile_range(size_t count, Body&& body)
 {
-    bool       retval = false;
+    static const size_t GRAIN_SIZE = 128;
 
-    if (!mesh)
+    if (egoboo_config_t::get().graphic_parallelLighting_enable.getValue())
     {
-		throw idlib::null_error(__FILE__, __LINE__, "mesh");
+        Ego::JobSystem::get().parallelFor(count, GRAIN_SIZE, body);
     }
-	tile_mem_t& tmem = mesh->_tmem;
-
-#if defined(CLIP_LIGHT_FANS) && !defined(CLIP_ALL_LIGHT_FANS)
-
-    // visible fans based on the update "need"
-    retval = test_corners(*mesh, tile, threshold);
-
-    // update every 4 fans even if there is no need
-    if (!retval)
+    else if (count > 0)
     {
-        // use a kind of checkerboard pattern
-        auto i2 = Grid::map<int>(tileIndex, (int)tmem.getInfo().getTileCountX());
-        if (0 != (((i2.x() ^ i2.y()) + _gameEngine->getNumberOfFramesRendered()) & 0x03))
-        {
-            retval = true;
-        }
+        body(size_t(0), count);
     }
-
-#else
-    retval = true;
-#endif
-
-    return retval ? gfx_success : gfx_fail;
 }
 
 //--------------------------------------------------------------------------------------------
-void GridIllumination::light_fans_update_lcache(Ego::Graphics::TileList& tl)
+void GridIllumination::light_fans_update_lcache(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame)
 {
 	const int frame_skip = 1 << 2; // 1 << 2 ~ 2^2 ~ 4. 
 #if defined(CLIP_ALL_LIGHT_FANS)
@@ -1206,18 +1142,10 @@ void GridIllumination::light_fans_update_lcache(Ego::Graphics::TileList& tl)
 	/// @note it is normally assumed that 64 colors of gray can make a smoothly colored black and white picture
 	/// which means that the threshold could be set as low as 1/64 = 0.015625.
 	const float delta_threshold = 0.05f;
-	
-	bool is_valid;
-
-	auto mesh = tl.getMesh();
-	if (!mesh)
-	{
-		throw idlib::runtime_error(__FILE__, __LINE__, "tile list not attached to a mesh");
-	}
 
 #if defined(CLIP_ALL_LIGHT_FANS)
 	// Update all visible fans once every 4 frames.
-	if (0 != (_gameEngine->getNumberOfFramesRendered() & frame_mask)) {
+	if (0 != (frame & frame_mask)) {
 		return;
 }
 #endif
@@ -1230,58 +1158,55 @@ void GridIllumination::light_fans_update_lcache(Ego::Graphics::TileList& tl)
 	float local_mesh_lighting_keep = std::pow(0.9f, frame_skip);
 #endif
 
-    // cache the grid lighting
-    for (size_t entry = 0; entry < tl._all.size(); entry++)
+    // cache the grid lighting, the tiles are independent
+    for_each_tile_range(tiles.size(), [&tiles, &mesh, frame, frame_skip, delta_threshold, local_mesh_lighting_keep](size_t first, size_t last)
     {
-        // which tile?
-        Index1D fan = tl._all[entry].getIndex();
+        for (size_t entry = first; entry < last; entry++)
+        {
+            // which tile?
+            Index1D fan = tiles[entry].getIndex();
 
-        // grab a pointer to the tile
-		ego_tile_info_t& ptile = mesh->getTileInfo(fan);
+            // grab a pointer to the tile
+			ego_tile_info_t& ptile = mesh.getTileInfo(fan);
 
-        // Test to see whether the lcache was already updated
-        // - ptile->_lcache_frame < 0 means that the cache value is invalid.
-        // - ptile->_lcache_frame is updated inside ego_mesh_light_corners()
+            // Test to see whether the lcache was already updated
+            // - ptile->_lcache_frame < 0 means that the cache value is invalid.
+            // - ptile->_lcache_frame is updated inside ego_mesh_light_corners()
 #if defined(CLIP_LIGHT_FANS)
-        // clip the updated on each individual tile
-        is_valid = ptile._lightingCache.isValid(_gameEngine->getNumberOfFramesRendered(), frame_skip);
+            // clip the updated on each individual tile
+            bool is_valid = ptile._lightingCache.isValid(frame, frame_skip);
 #else
-        // let the function clip all tile updates
-        is_valid = ptile._lightingCache.isValid(_gameEngine->getNumberOfFramesRendered());
+            // let the function clip all tile updates
+            bool is_valid = ptile._lightingCache.isValid(frame);
 #endif
-	if (is_valid)
-        {
-            continue;
-        }
-
-        // If no update was requested ...
-        if (!ptile._lightingCache.getNeedUpdate())
-        {
-			// ... do we need one?
-            gfx_rv light_fans_rv = light_fans_throttle_update(mesh.get(), ptile, fan, delta_threshold);
-            ptile._lightingCache.setNeedUpdate(gfx_success == light_fans_rv);
-        }
+		if (is_valid)
+            {
+                continue;
+            }
 
-		// If there is still no need for an update, go to the next tile.
-		if (!ptile._lightingCache.getNeedUpdate()) {
-			continue;
-		}
+			// An update is only requested if the grid lighting around the tile has changed (see do_grid_lighting())
+			// and it is kept requested until the corners of the tile have reached the grid lighting (see light_corners()).
+			if (!ptile._lightingCache.getNeedUpdate()) {
+				continue;
+			}
 
-        // is the tile reflective?
-        bool reflective = (0 != ptile.testFX(MAPFX_REFLECTIVE));
+            // is the tile reflective?
+            bool reflective = (0 != ptile.testFX(MAPFX_REFLECTIVE));
 
-        // light the corners of this tile
-        float delta = GridIllumination::light_corners(*mesh, ptile, reflective, local_mesh_lighting_keep);
+            // light the corners of this tile
+            float delta = GridIllumination::light_corners(mesh, ptile, reflective, local_mesh_lighting_keep, frame);
 
 #if defined(CLIP_LIGHT_FANS)
-        // Use the actual maximum change in the intensity at a tile corner to
-        // signal whether we need to calculate the next stage.
-        ptile._vertexLightingCache.setNeedUpdate(delta > delta_threshold);
+            // Use the actual maximum change in the intensity at a tile corner to
+            // signal whether we need to calculate the next stage.
+            // Once the corners have reached the grid lighting, push any remaining change.
+            ptile._vertexLightingCache.setNeedUpdate(delta > delta_threshold || (delta > 0.0f && !ptile._lightingCache.getNeedUpdate()));
 #else
-        // make sure that ego_mesh_light_corners() did not return an "error value"
-        ptile._vertexLightingCache.setNeedUpdate(delta > 0.0f);
+            // make sure that ego_mesh_light_corners() did not return an "error value"
+            ptile._vertexLightingCache.setNeedUpdate(delta > 0.0f);
 #endif
-    }
+        }
+    });
 }
 
 //--------------------------------------------------------------------------------------------
@@ -1353,80 +1278,88 @@ float GridIllumination::ego_mesh_interpolate_vertex(const ego_tile_info_t& info,
     return light;
 }
 
-void GridIllumination::light_fans_update_clst(Ego::Graphics::TileList& tl)
+void GridIllumination::light_fans_update_clst(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame)
 {
     /// @author BB
     /// @details update the tile's color list, if needed
-    auto mesh = tl.getMesh();
-    if (!mesh)
-    {
-		throw idlib::runtime_error(__FILE__, __LINE__, "tile list is not attached to a mesh");
-    }
 
     // alias the tile memory
-	tile_mem_t& ptmem = mesh->_tmem;
+	tile_mem_t& ptmem = mesh._tmem;
 
-    // use the grid to light the tiles
-    for (size_t entry = 0; entry < tl._all.size(); entry++)
+    // use the grid to light the tiles, the tiles write disjoint ranges of the colour list
+    for_each_tile_range(tiles.size(), [&tiles, &mesh, &ptmem, frame](size_t first, size_t last)
     {
-        Index1D fan = tl._all[entry].getIndex();
-        if (Index1D::Invalid == fan) continue;
+        for (size_t entry = first; entry < last; entry++)
+        {
+            Index1D fan = tiles[entry].getIndex();
+            if (Index1D::Invalid == fan) continue;
 
-        // valid tile?
-		ego_tile_info_t& ptile = mesh->getTileInfo(fan);
+            // valid tile?
+			ego_tile_info_t& ptile = mesh.getTileInfo(fan);
 
-        // Do nothing if this tile does not need an update.
-        if (!ptile._vertexLightingCache.getNeedUpdate()) {
-            continue;
-        }
+            // Do nothing if this tile does not need an update.
+            if (!ptile._vertexLightingCache.getNeedUpdate()) {
+                continue;
+            }
 
-        // Do nothing if the update was performed in this frame.
-        if (ptile._vertexLightingCache.isValid(_gameEngine->getNumberOfFramesRendered())) {
-            continue;
-        }
+            // Do nothing if the update was performed in this frame.
+            if (ptile._vertexLightingCache.isValid(frame)) {
+                continue;
+            }
 
-		size_t numberOfVertices;
-		tile_definition_t *pdef = tile_dict.get(ptile._type);
-        if (nullptr != pdef) {
-			numberOfVertices = pdef->numvertices;
-        } else {
-			numberOfVertices = 4;
-        }
+			size_t numberOfVertices;
+			tile_definition_t *pdef = tile_dict.get(ptile._type);
+            if (nullptr != pdef) {
+				numberOfVertices = pdef->numvertices;
+            } else {
+				numberOfVertices = 4;
+            }
 
-		size_t index, vertex;
-        // copy the 1st 4 vertices
-        for (index = 0, vertex = ptile._vrtstart; index < 4; index++, vertex++)
-        {
-            GLXvector3f& color = ptmem._clst[vertex];
-            float light = ptile._lightingCache._contents[index];
-			color[RR] = color[GG] = color[BB] 
-				= idlib::fraction<float, 1, 255>() * Ego::Math::constrain(light, 0.0f, 255.0f);
-        }
+			size_t index, vertex;
+            // copy the 1st 4 vertices
+            for (index = 0, vertex = ptile._vrtstart; index < 4; index++, vertex++)
+            {
+                GLXvector3f& color = ptmem._clst[vertex];
+                float light = ptile._lightingCache._contents[index];
+				color[RR] = color[GG] = color[BB] 
+					= idlib::fraction<float, 1, 255>() * Ego::Math::constrain(light, 0.0f, 255.0f);
+            }
 
-        for ( /* Intentionall left empty. */; index < numberOfVertices; index++, vertex++)
-        {
-			GLXvector3f& color = ptmem._clst[vertex];
-			const GLXvector3f& position = ptmem._plst[vertex];
-			float light = ego_mesh_interpolate_vertex(ptile, position);
-			color[RR] = color[GG] = color[BB] 
-				= idlib::fraction<float, 1, 255>() * Ego::Math::constrain(light, 0.0f, 255.0f);
-        }
+            for ( /* Intentionall left empty. */; index < numberOfVertices; index++, vertex++)
+            {
+				GLXvector3f& color = ptmem._clst[vertex];
+				const GLXvector3f& position = ptmem._plst[vertex];
+				float light = ego_mesh_interpolate_vertex(ptile, position);
+				color[RR] = color[GG] = color[BB] 
+					= idlib::fraction<float, 1, 255>() * Ego::Math::constrain(light, 0.0f, 255.0f);
+            }
 
-        // clear out the deltas
-        ptile._vertexLightingCache._d1_cache.fill(0.0f);
-        ptile._vertexLightingCache._d2_cache.fill(0.0f);
+            // clear out the deltas
+            ptile._vertexLightingCache._d1_cache.fill(0.0f);
+            ptile._vertexLightingCache._d2_cache.fill(0.0f);
 
-        // This tile was updated this frame and does not require an update (for some time).
-		ptile._vertexLightingCache.setNeedUpdate(false);
-		ptile._vertexLightingCache._lastFrame = _gameEngine->getNumberOfFramesRendered();
-    }
+            // This tile was updated this frame and does not require an update (for some time).
+			ptile._vertexLightingCache.setNeedUpdate(false);
+			ptile._vertexLightingCache._lastFrame = frame;
+        }
+    });
 }
 
 //--------------------------------------------------------------------------------------------
 void GridIllumination::light_fans(Ego::Graphics::TileList& tl)
 {
-	light_fans_update_lcache(tl);
-	light_fans_update_clst(tl);
+	auto mesh = tl.getMesh();
+	if (!mesh)
+	{
+		throw idlib::runtime_error(__FILE__, __LINE__, "tile list not attached to a mesh");
+	}
+	light_fans(*mesh, tl._all, _gameEngine->getNumberOfFramesRendered());
+}
+
+void GridIllumination::light_fans(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame)
+{
+	light_fans_update_lcache(mesh, tiles, frame);
+	light_fans_update_clst(mesh, tiles, frame);
 }
 
 //--------------------------------------------------------------------------------------------
@@ -1496,7 +1429,7 @@ bool sum_global_lighting(std::array<float, LIGHTING_VEC_SIZE> &lighting)
 //--------------------------------------------------------------------------------------------
 
 dynalist_t::dynalist_t()
-    : frame(-1), size(0), lst{}
+    : frame(-1), size(0), lst{}, applied_size(0), applied_lst{}, applied_global{}
 {}
 
 void dynalist_t::init(dynalist_t& self) {
@@ -1602,25 +1535,78 @@ gfx_rv gfx_make_dynalist(dynalist_t& dyl, Camera& cam)
 }
 
 //--------------------------------------------------------------------------------------------
+/// @brief Get if two dynamic lights light the grid alike.
+static bool dynalight_similar(const dynalight_data_t& x, const dynalight_data_t& y)
+{
+    // a light must move by more than a quarter of a tile to relight the grid
+    static const float distance_threshold = Info<float>::Grid::Size() * 0.25f;
+    // the level and the falloff must change by more than 1/64 to relight the grid
+    static const float relative_threshold = 1.0f / 64.0f;
+
+    auto similar = [](float a, float b)
+    {
+        return std::abs(a - b) <= relative_threshold * std::max(std::abs(a), std::abs(b));
+    };
+    return similar(x.level, y.level) && similar(x.falloff, y.falloff)
+        && idlib::squared_euclidean_norm(x.pos - y.pos) <= distance_threshold * distance_threshold;
+}
+
+/// @brief Get the bounding rectangle of a dynamic light.
+static ego_frect_t dynalight_bound(const dynalight_data_t& light)
+{
+    float radius = std::sqrt(light.falloff * 765.0f * 0.5f);
+
+    ego_frect_t bound;
+    bound.xmin = light.pos[kX] - radius;
+    bound.xmax = light.pos[kX] + radius;
+    bound.ymin = light.pos[kY] - radius;
+    bound.ymax = light.pos[kY] + radius;
+    return bound;
+}
+
+/// @brief Mark the grid lighting of the tiles within a bounding rectangle as invalid.
+static void invalidate_grid_lighting(ego_mesh_t& mesh, const ego_frect_t& bound)
+{
+    // the grid lighting of a tile is computed for a square of the size of a tile around its grid vertex
+    const float size = Info<float>::Grid::Size();
+    const float tileCountX = mesh._info.getTileCountX(),
+                tileCountY = mesh._info.getTileCountY();
+
+    float xmin = std::ceil(bound.xmin / size - 0.5f), xmax = std::floor(bound.xmax / size + 0.5f),
+          ymin = std::ceil(bound.ymin / size - 0.5f), ymax = std::floor(bound.ymax / size + 0.5f);
+
+    // does the rectangle intersect the mesh?
+    if (xmax < 0.0f || xmin > tileCountX - 1.0f || ymax < 0.0f || ymin > tileCountY - 1.0f) return;
+    if (xmin > xmax || ymin > ymax) return;
+
+    const int x0 = std::max(0.0f, xmin), x1 = std::min(tileCountX - 1.0f, xmax),
+              y0 = std::max(0.0f, ymin), y1 = std::min(tileCountY - 1.0f, ymax);
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            mesh._tmem.get(Index2D(x, y))._cache_frame = -1;
+        }
+    }
+}
+
 gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_t& dyl, Camera& cam)
 {
     /// @author ZZ
-    /// @details Do all tile lighting, dynamic and global
+    /// @details Do all tile lighting, dynamic and global.
+    /// The grid lighting of a tile is only recomputed if a light touching it was added, removed,
+    /// moved or changed since it was computed, or if the global lighting has changed.
 
     size_t cnt;
 
     int    tnc;
 
     float x0, y0, local_keep;
-    bool needs_dynalight;
 
     std::array<float, LIGHTING_VEC_SIZE> global_lighting = {0};
 
-    size_t               reg_count = 0;
-    dynalight_registry_t reg[TOTAL_MAX_DYNA];
-
-    ego_frect_t mesh_bound, light_bound;
-    dynalight_data_t fake_dynalight;
+    size_t           light_count = 0;
+    dynalight_data_t lights[TOTAL_MAX_DYNA];
 
 	auto mesh = tl.getMesh();
     if (!mesh)
@@ -1631,84 +1617,23 @@ gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_
 	Ego::MeshInfo& pinfo = mesh->_info;
 	tile_mem_t& tmem = mesh->_tmem;
 
-    // find a bounding box for the "frustum"
-    mesh_bound.xmin = tmem._edge_x;
-    mesh_bound.xmax = 0;
-    mesh_bound.ymin = tmem._edge_y;
-    mesh_bound.ymax = 0;
-    for (size_t entry = 0; entry < tl._all.size(); entry++)
-    {
-        Index1D fan = tl._all[entry].getIndex();
-        if (fan.i() >= pinfo.getTileCount()) continue;
-
-		const oct_bb_t& poct = tmem.get(fan)._oct;
-
-        mesh_bound.xmin = std::min(mesh_bound.xmin, poct._mins[OCT_X]);
-        mesh_bound.xmax = std::max(mesh_bound.xmax, poct._maxs[OCT_X]);
-        mesh_bound.ymin = std::min(mesh_bound.ymin, poct._mins[OCT_Y]);
-        mesh_bound.ymax = std::max(mesh_bound.ymax, poct._maxs[OCT_Y]);
-    }
-
     // is the visible mesh list empty?
-    if (mesh_bound.xmin >= mesh_bound.xmax || mesh_bound.ymin >= mesh_bound.ymax)
+    if (tl._all.empty())
         return gfx_success;
 
-    // clear out the dynalight registry
-    reg_count = 0;
-
     // refresh the dynamic light list
     gfx_make_dynalist(dyl, cam);
 
-    // assume no dynamic lighting
-    needs_dynalight = false;
-
-    // assume no "extra help" for systems with only flat lighting
-    dynalight_data_t::init(fake_dynalight);
-
-    // initialize the light_bound
-    light_bound.xmin = tmem._edge_x;
-    light_bound.xmax = 0;
-    light_bound.ymin = tmem._edge_y;
-    light_bound.ymax = 0;
-
-    // make bounding boxes for each dynamic light
+    // collect the lights illuminating the grid
     if (gfx.gouraudShading_enable)
     {
         for (cnt = 0; cnt < dyl.size; cnt++)
         {
-            float radius;
-            ego_frect_t ftmp;
-
             dynalight_data_t& pdyna = dyl.lst[cnt];
 
             if (pdyna.falloff <= 0.0f || 0.0f == pdyna.level) continue;
 
-            radius = std::sqrt(pdyna.falloff * 765.0f * 0.5f);
-
-            // find the intersection with the frustum boundary
-            ftmp.xmin = std::max(pdyna.pos[kX] - radius, mesh_bound.xmin);
-            ftmp.xmax = std::min(pdyna.pos[kX] + radius, mesh_bound.xmax);
-            ftmp.ymin = std::max(pdyna.pos[kY] - radius, mesh_bound.ymin);
-            ftmp.ymax = std::min(pdyna.pos[kY] + radius, mesh_bound.ymax);
-
-            // check to see if it intersects the "frustum"
-            if (ftmp.xmin >= ftmp.xmax || ftmp.ymin >= ftmp.ymax) continue;
-
-            reg[reg_count].bound = ftmp;
-            reg[reg_count].reference = cnt;
-            reg_count++;
-
-            // determine the maxumum bounding box that encloses all valid lights
-            light_bound.xmin = std::min(light_bound.xmin, ftmp.xmin);
-            light_bound.xmax = std::max(light_bound.xmax, ftmp.xmax);
-            light_bound.ymin = std::min(light_bound.ymin, ftmp.ymin);
-            light_bound.ymax = std::max(light_bound.ymax, ftmp.ymax);
-        }
-
-        // are there any dynalights visible?
-        if (reg_count > 0 && light_bound.xmax >= light_bound.xmin && light_bound.ymax >= light_bound.ymin)
-        {
-            needs_dynalight = true;
+            lights[light_count++] = pdyna;
         }
     }
     else
@@ -1716,6 +1641,10 @@ gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_
         float dyna_weight = 0.0f;
         float dyna_weight_sum = 0.0f;
 
+        // assume no "extra help" for systems with only flat lighting
+        dynalight_data_t fake_dynalight;
+        dynalight_data_t::init(fake_dynalight);
+
         // evaluate all the lights at the camera position
         for (cnt = 0; cnt < dyl.size; cnt++)
         {
@@ -1737,61 +1666,81 @@ gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_
         // use a single dynalight to represent the sum of all dynalights
         if (dyna_weight_sum > 0.0f)
         {
-            float radius;
-            ego_frect_t ftmp;
-
             fake_dynalight.distance /= dyna_weight_sum;
             fake_dynalight.falloff /= dyna_weight_sum;
             fake_dynalight.level /= dyna_weight_sum;
             fake_dynalight.pos = (fake_dynalight.pos * (1.0/dyna_weight_sum)) + cam.getCenter();
 
-            radius = std::sqrt(fake_dynalight.falloff * 765.0f * 0.5f);
-
-            // find the intersection with the frustum boundary
-            ftmp.xmin = std::max(fake_dynalight.pos[kX] - radius, mesh_bound.xmin);
-            ftmp.xmax = std::min(fake_dynalight.pos[kX] + radius, mesh_bound.xmax);
-            ftmp.ymin = std::max(fake_dynalight.pos[kY] - radius, mesh_bound.ymin);
-            ftmp.ymax = std::min(fake_dynalight.pos[kY] + radius, mesh_bound.ymax);
+            lights[light_count++] = fake_dynalight;
+        }
+    }
 
-            // make a fake light bound
-            light_bound = ftmp;
+    // sum up the lighting from global sources
+    sum_global_lighting(global_lighting);
 
-            // register the fake dynalight
-            reg[reg_count].bound = ftmp;
-            reg[reg_count].reference = -1;
-            reg_count++;
+    if (global_lighting != dyl.applied_global)
+    {
+        // the global lighting has changed, relight all tiles
+        for (Index1D fan = 0; fan < pinfo.getTileCount(); ++fan)
+        {
+            mesh->getTileInfo(fan)._cache_frame = -1;
+        }
+        dyl.applied_global = global_lighting;
+        std::copy(lights, lights + light_count, dyl.applied_lst);
+        dyl.applied_size = light_count;
+    }
+    else
+    {
+        // match the lights of this frame against the lights the grid lighting was computed with
+        bool matched[TOTAL_MAX_DYNA] = {false};
+        for (size_t i = 0; i < dyl.applied_size; )
+        {
+            size_t j = 0;
+            while (j < light_count && (matched[j] || !dynalight_similar(dyl.applied_lst[i], lights[j]))) j++;
+            if (j < light_count)
+            {
+                // keep the applied light such that slowly moving lights do not drift
+                matched[j] = true;
+                i++;
+            }
+            else
+            {
+                // the light was removed or has changed, relight the tiles it touched
+                invalidate_grid_lighting(*mesh, dynalight_bound(dyl.applied_lst[i]));
+                dyl.applied_lst[i] = dyl.applied_lst[--dyl.applied_size];
+            }
+        }
+        for (size_t j = 0; j < light_count; ++j)
+        {
+            if (matched[j]) continue;
 
-            // let the downstream calc know we are coming
-            needs_dynalight = true;
+            // the light was added or has changed, relight the tiles it touches
+            invalidate_grid_lighting(*mesh, dynalight_bound(lights[j]));
+            dyl.applied_lst[dyl.applied_size++] = lights[j];
         }
     }
 
-    // sum up the lighting from global sources
-    sum_global_lighting(global_lighting);
+    // no blending with the old lighting, the grid lighting is only computed if it is invalid
+    local_keep = 0.0f;
 
-    // make the grids update their lighting every 4 frames
-    local_keep = 0.0f; //std::pow(DYNALIGHT_KEEP, 4); //const static float DYNALIGHT_KEEP = 0.9f;
+    ego_frect_t applied_bound[TOTAL_MAX_DYNA];
+    for (cnt = 0; cnt < dyl.applied_size; cnt++)
+    {
+        applied_bound[cnt] = dynalight_bound(dyl.applied_lst[cnt]);
+    }
 
-    // Add to base light level in normal mode
     for (size_t entry = 0; entry < tl._all.size(); entry++)
     {
-        bool resist_lighting_calculation = true;
-
         // grab each grid box in the "frustum"
         Index1D fan = tl._all[entry].getIndex();
 
         // a valid tile?
         ego_tile_info_t& ptile = mesh->getTileInfo(fan);
 
-        // do not update this more than once a frame
-        if (ptile._cache_frame >= 0 && (uint32_t)ptile._cache_frame >= _gameEngine->getNumberOfFramesRendered()) continue;
-        auto i2 = Grid::map<int>(fan, pinfo.getTileCountX());
-        // Resist the lighting calculation?
-        // This is a speedup for lighting calculations so that
-        // not every light-tile calculation is done every single frame
-        resist_lighting_calculation = (0 != (((i2.x() + i2.y()) ^ _gameEngine->getNumberOfFramesRendered()) & 0x03));
+        // is the grid lighting of this tile still valid?
+        if (ptile._cache_frame >= 0) continue;
 
-        if (resist_lighting_calculation) continue;
+        auto i2 = Grid::map<int>(fan, pinfo.getTileCountX());
 
         // this is not a "bad" grid box, so grab the lighting info
         lighting_cache_t& pcache_old = ptile._cache;
@@ -1806,62 +1755,36 @@ gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_
             cache_new.hgh._lighting[tnc] = global_lighting[tnc];
         };
 
-        // do we need any dynamic lighting at all?
-        if (needs_dynalight)
+        // calculate the local lighting
+        ego_frect_t fgrid_rect;
+
+        x0 = i2.x() * Info<float>::Grid::Size();
+        y0 = i2.y() * Info<float>::Grid::Size();
+
+        fgrid_rect.xmin = x0 - Info<float>::Grid::Size() * 0.5f;
+        fgrid_rect.xmax = x0 + Info<float>::Grid::Size() * 0.5f;
+        fgrid_rect.ymin = y0 - Info<float>::Grid::Size() * 0.5f;
+        fgrid_rect.ymax = y0 + Info<float>::Grid::Size() * 0.5f;
+
+        // add the dynamic lighting of this grid
+        for (cnt = 0; cnt < dyl.applied_size; cnt++)
         {
-            // calculate the local lighting
+			Vector3f nrm;
 
-            ego_frect_t fgrid_rect;
+            // does this dynamic light intersects this grid?
+            if (fgrid_rect.xmin > applied_bound[cnt].xmax || fgrid_rect.xmax < applied_bound[cnt].xmin) continue;
+            if (fgrid_rect.ymin > applied_bound[cnt].ymax || fgrid_rect.ymax < applied_bound[cnt].ymin) continue;
 
-            x0 = i2.x() * Info<float>::Grid::Size();
-            y0 = i2.y() * Info<float>::Grid::Size();
+            // this should be a valid intersection, so proceed
+            const dynalight_data_t *pdyna = dyl.applied_lst + cnt;
 
-            // check this grid vertex relative to the measured light_bound
-            fgrid_rect.xmin = x0 - Info<float>::Grid::Size() * 0.5f;
-            fgrid_rect.xmax = x0 + Info<float>::Grid::Size() * 0.5f;
-            fgrid_rect.ymin = y0 - Info<float>::Grid::Size() * 0.5f;
-            fgrid_rect.ymax = y0 + Info<float>::Grid::Size() * 0.5f;
+            nrm[kX] = pdyna->pos[kX] - x0;
+            nrm[kY] = pdyna->pos[kY] - y0;
+            nrm[kZ] = pdyna->pos[kZ] - tmem._bbox.get_min()[ZZ];
+            sum_dyna_lighting(pdyna, cache_new.low._lighting, nrm);
 
-            // check the bounding box of this grid vs. the bounding box of the lighting
-            if (fgrid_rect.xmin <= light_bound.xmax && fgrid_rect.xmax >= light_bound.xmin)
-            {
-                if (fgrid_rect.ymin <= light_bound.ymax && fgrid_rect.ymax >= light_bound.ymin)
-                {
-                    // this grid has dynamic lighting. add it.
-                    for (cnt = 0; cnt < reg_count; cnt++)
-                    {
-						Vector3f nrm;
-                        dynalight_data_t *pdyna;
-
-                        // does this dynamic light intersects this grid?
-                        if (fgrid_rect.xmin > reg[cnt].bound.xmax || fgrid_rect.xmax < reg[cnt].bound.xmin) continue;
-                        if (fgrid_rect.ymin > reg[cnt].bound.ymax || fgrid_rect.ymax < reg[cnt].bound.ymin) continue;
-
-                        // this should be a valid intersection, so proceed
-                        tnc = reg[cnt].reference;
-                        if (tnc < 0)
-                        {
-                            pdyna = &fake_dynalight;
-                        }
-                        else
-                        {
-                            pdyna = dyl.lst + tnc;
-                        }
-
-                        nrm[kX] = pdyna->pos[kX] - x0;
-                        nrm[kY] = pdyna->pos[kY] - y0;
-                        nrm[kZ] = pdyna->pos[kZ] - tmem._bbox.get_min()[ZZ];
-                        sum_dyna_lighting(pdyna, cache_new.low._lighting, nrm);
-
-                        nrm[kZ] = pdyna->pos[kZ] - tmem._bbox.get_max()[ZZ];
-                        sum_dyna_lighting(pdyna, cache_new.hgh._lighting, nrm);
-                    }
-                }
-            }
-        }
-        else if (!gfx.gouraudShading_enable)
-        {
-            // evaluate the intensity at the camera
+            nrm[kZ] = pdyna->pos[kZ] - tmem._bbox.get_max()[ZZ];
+            sum_dyna_lighting(pdyna, cache_new.hgh._lighting, nrm);
         }
 
         // blend in the global lighting every single time
@@ -1872,6 +1795,15 @@ gfx_rv GridIllumination::do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_
         pcache_old.max_light();
 
         ptile._cache_frame = _gameEngine->getNumberOfFramesRendered();
+
+        // the corners of the tiles interpolating this grid lighting need to be relit
+        for (int y = std::max(0, i2.y() - 2); y <= std::min((int)pinfo.getTileCountY() - 1, i2.y() + 1); ++y)
+        {
+            for (int x = std::max(0, i2.x() - 2); x <= std::min((int)pinfo.getTileCountX() - 1, i2.x() + 1); ++x)
+            {
+                tmem.get(Index2D(x, y))._lightingCache.setNeedUpdate(true);
+            }
+        }
     }
 
     return gfx_success;
@@ -1882,46 +1814,35 @@ gfx_rv gfx_make_tileList(Ego::Graphics::TileList& tl, Camera& cam)
 	// @a true if clipping is enabled, @a false otherwise.
 	static const bool clippingEnabled = true;
 
-    // Because the main loop of the program will always flip the
-    // page before rendering the 1st frame of the actual game,
-    // _gameEngine->getNumberOfFramesRendered() will always start at 1
-    if (1 != (_gameEngine->getNumberOfFramesRendered() & 3))
-    {
-        return gfx_success;
-    }
-
     // reset the renderlist
     tl.reset();
 
-    // get the tiles in the center of the view (TODO: calculate actual tile view from camera frustrum)
-	int startX, startY, endX, endY;
+    const std::shared_ptr<ego_mesh_t>& mesh = _currentModule->getMeshPointer();
+    gfx_rv retval = gfx_success;
+    auto add = [&tl, &cam, &retval](const Index1D& index)
+    {
+        if (gfx_error == tl.add(index, cam))
+        {
+            retval = gfx_error;
+        }
+    };
+
+    // get the tiles in the view frustum of the camera
 	if (clippingEnabled)
 	{
-		static const float offset = 10;
-		float centerX = cam.getTrackPosition()[kX] / Info<float>::Grid::Size();
-		float centerY = cam.getTrackPosition()[kY] / Info<float>::Grid::Size();
-		startX = Ego::Math::constrain<int>(centerX - offset, 0, _currentModule->getMeshPointer()->_info.getTileCountX());
-		startY = Ego::Math::constrain<int>(centerY - offset, 0, _currentModule->getMeshPointer()->_info.getTileCountY());
-		endX = Ego::Math::constrain<int>(centerX + offset, 0, _currentModule->getMeshPointer()->_info.getTileCountX());
-		endY = Ego::Math::constrain<int>(centerY + offset, 0, _currentModule->getMeshPointer()->_info.getTileCountY());
+		// the water surface may be above the floor of water tiles
+		mesh->_chunks.setWaterLevel(_currentModule->getWater().get_level(), mesh->_tmem);
+		mesh->_chunks.visit(mesh->_tmem, cam.getFrustum(), add);
 	}
 	else
 	{
-		startX = 0;
-		startY = 0;
-		endX = _currentModule->getMeshPointer()->_info.getTileCountX();
-		endY = _currentModule->getMeshPointer()->_info.getTileCountY();
+		for (Index1D index = 0; index < mesh->_info.getTileCount(); ++index)
+		{
+			add(index);
+		}
 	}
-    for(size_t x = startX; x < endX; ++x) {
-        for(size_t y = startY; y < endY; ++y) {
-            if (gfx_error == tl.add(x + y * _currentModule->getMeshPointer()->_info.getTileCountX(), cam))
-            {
-                return gfx_error;
-            }        
-        }
-    }
 
-    return gfx_success;
+    return retval;
 }
 
 //--------------------------------------------------------------------------------------------
@@ -2069,6 +1990,13 @@ gfx_rv GFX::update_object_instances(Camera& cam)
 		auto mesh = _currentModule->getMeshPointer();
         if (!mesh->grid_is_valid(pchr->getTile())) continue;
 
+        // the keyframes of the object are blended and lit on the GPU
+        if (ObjectGraphicsRenderer::blendsKeyframes(pchr)) {
+            pchr->getObjectPhysics().updateCollisionSize(true);
+            pchr->inst.updateLighting(false);
+            continue;
+        }
+
         // make sure that the vertices are interpolated
         if(pchr->inst.updateVertices(-1, -1, true) == gfx_error) {
             retval = gfx_error;
@@ -2083,6 +2011,9 @@ gfx_rv GFX::update_object_instances(Camera& cam)
         pchr->inst.updateLighting();
     }
 
+    // release the animation states no instance uses any more
+    getAnimatedVertexCache().evict();
+
     return retval;
 }
 
@@ -2187,7 +2118,8 @@ gfx_rv GFX::update_particle_instances(Camera& camera)
 GameAppImpl::GameAppImpl() :
     dynalist(),
     billboardSystem(std::make_unique<Ego::Graphics::BillboardSystem>()),
-    md2ModelRenderer(std::make_unique<Ego::Graphics::DefaultMd2ModelRenderer>())
+    md2ModelRenderer(std::make_unique<Ego::Graphics::KeyframeMd2ModelRenderer>()),
+    animatedVertexCache(std::make_unique<Ego::Graphics::AnimatedVertexCache>())
 {
     // Initialize the texture atlas manager.
     try
@@ -2220,3 +2152,8 @@ Ego::Graphics::Md2ModelRenderer& GameAppImpl::getMd2ModelRenderer() const
 {
     return *md2ModelRenderer;
 }
+
+Ego::Graphics::AnimatedVertexCache& GameAppImpl::getAnimatedVertexCache() const
+{
+    return *animatedVertexCache;
+}
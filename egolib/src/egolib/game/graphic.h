@@ -33,8 +33,10 @@ namespace Ego {
 namespace Graphics {
 class BillboardSystem;
 class Md2ModelRenderer;
+class AnimatedVertexCache;
 struct RenderPass;
 struct TileList;
+struct ClippingEntry;
 struct EntityList;
 } }
 
@@ -130,6 +132,11 @@ struct dynalist_t
     int frame; ///< The last frame in shich the list was updated. @a -1 if there was no update yet.
     size_t size; ///< The size of the list.
     dynalight_data_t lst[TOTAL_MAX_DYNA];  ///< The list.
+    /// The lights and the global lighting the grid lighting of the tiles was computed with.
+    /// The grid lighting is only recomputed for the tiles touched by lights which changed.
+    size_t applied_size;
+    dynalight_data_t applied_lst[TOTAL_MAX_DYNA];
+    std::array<float, LIGHTING_VEC_SIZE> applied_global;
     dynalist_t();
     static void init(dynalist_t& self);
 };
@@ -142,12 +149,14 @@ private:
     dynalist_t dynalist;
     std::unique_ptr<Ego::Graphics::BillboardSystem> billboardSystem;
     std::unique_ptr<Ego::Graphics::Md2ModelRenderer> md2ModelRenderer;
+    std::unique_ptr<Ego::Graphics::AnimatedVertexCache> animatedVertexCache;
 public:
     GameAppImpl();
     ~GameAppImpl();
     dynalist_t& getDynalist();
     Ego::Graphics::BillboardSystem& getBillboardSystem() const;
     Ego::Graphics::Md2ModelRenderer& getMd2ModelRenderer() const;
+    Ego::Graphics::AnimatedVertexCache& getAnimatedVertexCache() const;
 };
 
 template <typename T>
@@ -174,6 +183,10 @@ public:
     {
         return impl->getMd2ModelRenderer();
     }
+    Ego::Graphics::AnimatedVertexCache& getAnimatedVertexCache() const
+    {
+        return impl->getAnimatedVertexCache();
+    }
 };
 
 struct GFX : public GameApp<GFX>
@@ -290,28 +303,22 @@ void draw_mouse_cursor();
 void draw_passages(Camera& cam);
 
 
-/// Structure for keeping track of which dynalights are visible
-struct dynalight_registry_t {
-    int reference;
-    ego_frect_t bound;
-};
-
 /// Illuminate the "grid".
 struct GridIllumination {
 private:
     static float grid_get_mix(float u0, float u, float v0, float v);
     static float ego_mesh_interpolate_vertex(const ego_tile_info_t& info, const GLXvector3f& position);
-	static void test_one_corner(const ego_mesh_t& mesh, GLXvector3f pos, float& pdelta);
-	static bool test_corners(const ego_mesh_t& mesh, ego_tile_info_t& tile, float threshold);
 	static void light_one_corner(ego_mesh_t& mesh, ego_tile_info_t& tile, const bool reflective, const Vector3f& pos, const Vector3f& nrm, float& plight);
-	static float grid_lighting_test(const ego_mesh_t& mesh, GLXvector3f pos, float& low_diff, float& hgh_diff);
-	static void light_fans_update_clst(Ego::Graphics::TileList& tl);
-	static gfx_rv light_fans_throttle_update(ego_mesh_t * mesh, ego_tile_info_t& tile, const Index1D& tileIndex, float threshold);
-	static void light_fans_update_lcache(Ego::Graphics::TileList& tl);
+	static void light_fans_update_clst(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame);
+	static void light_fans_update_lcache(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame);
 public:
 	static gfx_rv do_grid_lighting(Ego::Graphics::TileList& tl, dynalist_t& dyl, Camera& cam);
 	static void light_fans(Ego::Graphics::TileList& tl);
-	static float light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, bool reflective, float mesh_lighting_keep);
+	/// @brief Update the lighting of the corners and the vertices of tiles of a mesh.
+	/// @param tiles the tiles
+	/// @param frame the number of frames rendered
+	static void light_fans(ego_mesh_t& mesh, const std::vector<Ego::Graphics::ClippingEntry>& tiles, uint32_t frame);
+	static float light_corners(ego_mesh_t& mesh, ego_tile_info_t& tile, bool reflective, float mesh_lighting_keep, uint32_t frame);
 	static bool grid_lighting_interpolate(const ego_mesh_t& mesh, lighting_cache_t& dst, const Vector2f& pos);
 	static bool light_corner(ego_mesh_t& mesh, const Index1D& fan, float height, float nrm[], float& plight);
 };
@@ -29,6 +29,7 @@
 #include "egolib/game/Graphics/CameraSystem.hpp"
 #include "egolib/Entities/_Include.hpp"
 #include "egolib/game/Graphics/DefaultMd2ModelRenderer.hpp"
+#include "egolib/game/Module/Module.hpp"
 
 struct Md2VertexBuffer {
     static void render(GLenum mode, size_t start, size_t length) {
@@ -47,6 +48,38 @@ struct Md2VertexBuffer {
     }
 };
 
+/// @brief Get the state of an object for blending its keyframes on the GPU.
+static void make_keyframe_blend(const Object& object, const GLXvector4f tint, const BIT_FIELD bits, Ego::Graphics::Md2ModelRenderer::KeyframeBlend& blend)
+{
+    blend.sourceFrameIndex = object.inst.getSourceFrameIndex();
+    blend.targetFrameIndex = object.inst.getTargetFrameIndex();
+    blend.flip = object.inst.getFlip();
+    blend.uoffset = object.inst.uoffset * idlib::fraction<float, 1, 65535>();
+    blend.voffset = object.inst.voffset * idlib::fraction<float, 1, 65535>();
+    for (size_t i = 0; i < 4; ++i)
+    {
+        blend.tint[i] = tint[i];
+    }
+    blend.lit = HAS_NO_BITS(bits, CHR_LIGHT) && HAS_NO_BITS(bits, CHR_ALPHA);
+    blend.ambient = 0.0f;
+    if (HAS_NO_BITS(bits, CHR_PHONG))
+    {
+        // Convert the "light" parameter to self-lighting for
+        // every object that is not being rendered using CHR_LIGHT.
+        if (HAS_NO_BITS(bits, CHR_LIGHT) && 0xFF != object.inst.light)
+        {
+            blend.ambient += object.inst.light * idlib::fraction<float, 1, 255>();
+        }
+        blend.ambient += object.inst.getAmbientColour() * idlib::fraction<float, 1, 255>();
+    }
+    blend.lighting = &object.inst.getLighting();
+    blend.flash = object.inst.getFlashLight();
+    blend.heightScale = object.inst.getMatrix()(3, 3);
+    const auto& bbox = _currentModule->getMeshPointer()->_tmem._bbox;
+    blend.minZ = bbox.get_min()[kZ];
+    blend.maxZ = bbox.get_max()[kZ];
+}
+
 gfx_rv ObjectGraphicsRenderer::render_enviro( Camera& cam, const std::shared_ptr<Object>& pchr, GLXvector4f tint, const BIT_FIELD bits )
 {
     if (!pchr->inst.getModelDescriptor())
@@ -115,9 +148,10 @@ gfx_rv ObjectGraphicsRenderer::render_enviro( Camera& cam, const std::shared_ptr
                     targetVertex->normal.z = pvrt.nrm[ZZ];
 
                     // normalize the color so it can be modulated by the phong/environment map
-                    targetVertex->colour.r = pvrt.color_dir * idlib::fraction<float, 1, 255>();
-                    targetVertex->colour.g = pvrt.color_dir * idlib::fraction<float, 1, 255>();
-                    targetVertex->colour.b = pvrt.color_dir * idlib::fraction<float, 1, 255>();
+                    const VertexLighting& plit = pchr->inst.getVertexLighting(vertexIndex);
+                    targetVertex->colour.r = plit.color_dir * idlib::fraction<float, 1, 255>();
+                    targetVertex->colour.g = plit.color_dir * idlib::fraction<float, 1, 255>();
+                    targetVertex->colour.b = plit.color_dir * idlib::fraction<float, 1, 255>();
                     targetVertex->colour.a = 1.0f;
 
                     float cmax = std::max({targetVertex->colour.r, targetVertex->colour.g, targetVertex->colour.b});
@@ -223,11 +257,6 @@ gfx_rv ObjectGraphicsRenderer::render_tex(Camera& camera, const std::shared_ptr<
         base_amb = (0xFF == pchr->inst.light) ? 0 : (pchr->inst.light * idlib::fraction<float, 1, 255>());
     }
 
-    // Get the maximum number of vertices per command.
-    size_t vertexBufferCapacity = md2ModelRenderer.getRequiredVertexBufferCapacity(*pmd2);
-    // Allocate a vertex buffer.
-    md2ModelRenderer.ensureSize(vertexBufferCapacity);
-
     if (0 != (bits & CHR_REFLECT))
     {
         renderer.setWorldMatrix(pchr->inst.getReflectionMatrix());
@@ -240,6 +269,21 @@ gfx_rv ObjectGraphicsRenderer::render_tex(Camera& camera, const std::shared_ptr<
     // Choose texture.
 	renderer.getTextureUnit().setActivated(ptex.get());
 
+    // Blend the keyframes on the GPU.
+    if (blendsKeyframes(pchr))
+    {
+        Ego::Graphics::Md2ModelRenderer::KeyframeBlend blend;
+        make_keyframe_blend(*pchr, tint, bits, blend);
+
+        Ego::OpenGL::PushAttrib pa(GL_CURRENT_BIT);
+        return md2ModelRenderer.renderBlended(pmd2, blend) ? gfx_success : gfx_error;
+    }
+
+    // Get the maximum number of vertices per command.
+    size_t vertexBufferCapacity = md2ModelRenderer.getRequiredVertexBufferCapacity(*pmd2);
+    // Allocate a vertex buffer.
+    md2ModelRenderer.ensureSize(vertexBufferCapacity);
+
     {
         Ego::OpenGL::PushAttrib pa(GL_CURRENT_BIT);
         {
@@ -268,7 +312,7 @@ gfx_rv ObjectGraphicsRenderer::render_tex(Camera& camera, const std::shared_ptr<
                     // Perform lighting.
                     if (HAS_NO_BITS(bits, CHR_LIGHT) && HAS_NO_BITS(bits, CHR_ALPHA)) {
                         // The directional lighting.
-                        float fcol = pvrt.color_dir * idlib::fraction<float, 1, 255>();
+                        float fcol = pchr->inst.getVertexLighting(vertexIndex).color_dir * idlib::fraction<float, 1, 255>();
 
                         targetVertex->colour.r = fcol;
                         targetVertex->colour.g = fcol;
@@ -389,6 +433,22 @@ gfx_rv ObjectGraphicsRenderer::render(Camera& cam, const std::shared_ptr<Object>
     return retval;
 }
 
+bool ObjectGraphicsRenderer::blendsKeyframes(const std::shared_ptr<Object>& pchr)
+{
+    if (!egoboo_config_t::get().graphic_keyframeBlending_enable.getValue())
+    {
+        return false;
+    }
+
+    // environment mapping (including the shining effect) reads the interpolated vertices
+    if (pchr->getProfile()->isPhongMapped() || (gfx.phongon && pchr->inst.sheen > 0))
+    {
+        return false;
+    }
+
+    return GFX::get().getMd2ModelRenderer().canBlendKeyframes();
+}
+
 gfx_rv ObjectGraphicsRenderer::render_ref( Camera& cam, const std::shared_ptr<Object>& pchr)
 {
     //Does this object have a reflection?
@@ -582,6 +642,100 @@ gfx_rv ObjectGraphicsRenderer::render_solid( Camera& cam, const std::shared_ptr<
     return retval;
 }
 
+bool ObjectGraphicsRenderer::isInstanceable(const std::shared_ptr<Object>& pchr)
+{
+    if (!egoboo_config_t::get().graphic_instancing_enable.getValue()) {
+        return false;
+    }
+    // only fully solid objects which are visible
+    return !pchr->isHidden() && !pchr->isInsideInventory() && 0xFF == pchr->inst.alpha && 0xFF == pchr->inst.light;
+}
+
+bool ObjectGraphicsRenderer::canRenderInstanced(const std::shared_ptr<Object>& pchr)
+{
+    return isInstanceable(pchr) && blendsKeyframes(pchr);
+}
+
+gfx_rv ObjectGraphicsRenderer::render_solid_instanced(Camera& cam, std::vector<std::shared_ptr<Object>>& objects,
+                                                      std::vector<Ego::Graphics::Md2ModelRenderer::KeyframeInstance>& instances)
+{
+    if (objects.empty()) {
+        return gfx_success;
+    }
+
+    // group the objects by model, keyframes, skin and culling
+    auto key = [](const std::shared_ptr<Object>& pchr) {
+        return std::make_tuple(pchr->getProfile()->getModel()->getMD2().get(),
+                               pchr->inst.getSourceFrameIndex(), pchr->inst.getTargetFrameIndex(),
+                               pchr->getSkinTexture().get(), pchr->getProfile()->isDontCullBackfaces());
+    };
+    std::sort(objects.begin(), objects.end(), [&key](const std::shared_ptr<Object>& x, const std::shared_ptr<Object>& y) {
+        return key(x) < key(y);
+    });
+
+    // assume the best
+    gfx_rv retval = gfx_success;
+
+    auto& md2ModelRenderer = GFX::get().getMd2ModelRenderer();
+
+    {
+        Ego::OpenGL::PushAttrib pa(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_POLYGON_BIT | GL_CURRENT_BIT);
+        {
+            auto& renderer = Ego::Renderer::get();
+            // the same state as render_solid()
+            renderer.setAlphaTestEnabled(true);
+            renderer.setAlphaFunction(idlib::compare_function::equal, 1.0f);
+            renderer.setBlendingEnabled(true);
+            renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one_minus_source0_alpha);
+
+            // the world matrices are part of the instances
+            renderer.setWorldMatrix(Matrix4f4f::identity());
+
+            for (size_t first = 0, last; first < objects.size(); first = last) {
+                const auto groupKey = key(objects[first]);
+                for (last = first + 1; last < objects.size() && key(objects[last]) == groupKey; ++last) {}
+
+                const std::shared_ptr<Object>& pchr = objects[first];
+                if (pchr->getProfile()->isDontCullBackfaces()) {
+                    renderer.setCullingMode(idlib::culling_mode::none);
+                } else {
+                    renderer.setCullingMode(idlib::culling_mode::back);
+                    renderer.setWindingMode(MAD_NRM_CULL);
+                }
+                renderer.getTextureUnit().setActivated(pchr->getSkinTexture().get());
+
+                instances.resize(last - first);
+                for (size_t i = first; i < last; ++i) {
+                    GLXvector4f tint;
+                    objects[i]->inst.getTint(tint, false, CHR_SOLID);
+                    instances[i - first].worldMatrix = objects[i]->inst.getMatrix();
+                    make_keyframe_blend(*objects[i], tint, CHR_SOLID, instances[i - first].blend);
+                }
+
+                const std::shared_ptr<MD2Model>& pmd2 = pchr->getProfile()->getModel()->getMD2();
+                if (!md2ModelRenderer.renderInstanced(pmd2, instances)) {
+                    // without instancing, draw the objects one by one
+                    for (const auto& instance : instances) {
+                        renderer.setWorldMatrix(instance.worldMatrix);
+                        if (!md2ModelRenderer.renderBlended(pmd2, instance.blend)) {
+                            retval = gfx_error;
+                        }
+                    }
+                    renderer.setWorldMatrix(Matrix4f4f::identity());
+                }
+            }
+        }
+    }
+
+#if defined(_DEBUG)
+    for (const auto& pchr : objects) {
+        draw_chr_bbox(pchr);
+    }
+#endif
+
+    return retval;
+}
+
 #if _DEBUG
 void ObjectGraphicsRenderer::draw_chr_bbox(const std::shared_ptr<Object>& pchr)
 {
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "egolib/game/egoboo.h"
+#include "egolib/game/Graphics/Md2ModelRenderer.hpp"
 
 class Camera;
 class Object;
@@ -41,7 +42,26 @@ struct ObjectGraphicsRenderer {
 	static gfx_rv render_trans(Camera& cam, const std::shared_ptr<Object>& object);
 	static gfx_rv render_solid(Camera& cam, const std::shared_ptr<Object>& object);
 
+	/// @brief Get if the keyframes of an object are blended on the GPU.
+	/// @remark If so, the vertices of the object are not interpolated on the CPU every frame.
+	/// Environment mapped objects always use the interpolated vertices.
+	static bool blendsKeyframes(const std::shared_ptr<Object>& object);
+
+	/// @brief Get if an object can be drawn by render_solid_instanced().
+	static bool canRenderInstanced(const std::shared_ptr<Object>& object);
+
+	/// @brief Draw solid objects which blend their keyframes on the GPU.
+	/// Objects with the same model, keyframes and skin are drawn with one instanced draw call
+	/// or one by one if the renderer does not support instancing.
+	/// @param objects the objects, see canRenderInstanced(). They are reordered.
+	/// @param instances storage for the instances of a group, kept by the caller to reuse its memory
+	static gfx_rv render_solid_instanced(Camera& cam, std::vector<std::shared_ptr<Object>>& objects,
+	                                     std::vector<Ego::Graphics::Md2ModelRenderer::KeyframeInstance>& instances);
+
 private:
+	/// @brief Get if an object is drawn by render_solid_instanced() if its keyframes can be blended on the GPU.
+	static bool isInstanceable(const std::shared_ptr<Object>& object);
+
 	/// Draw model with environment mapping.
 	static gfx_rv render_enviro(Camera& cam, const std::shared_ptr<Object>& object, GLXvector4f tint, const BIT_FIELD bits);
 	/// Draw model with texturing.
@@ -56,36 +56,91 @@ float ParticleGraphicsRenderer::CALCULATE_PRT_V1(const Ego::Texture& texture, in
     return (((.95f + ((CNT) >> 4)) / 16.0f) * (w / h)*hscale);
 }
 
-gfx_rv ParticleGraphicsRenderer::render_one_prt_solid(const ParticleRef iprt)
+std::unique_ptr<Ego::VertexBuffer> ParticleGraphicsRenderer::billboardBuffer = nullptr;
+
+Ego::VertexBuffer& ParticleGraphicsRenderer::getBillboardBuffer(size_t numberOfBillboards)
 {
-    /// @author BB
-    /// @details Render the solid version of the particle
+    if (!billboardBuffer || billboardBuffer->getNumberOfVertices() < numberOfBillboards * 4)
+    {
+        // Grow geometrically such that the buffer is not reallocated every frame.
+        size_t numberOfVertices = billboardBuffer ? billboardBuffer->getNumberOfVertices() : 256;
+        while (numberOfVertices < numberOfBillboards * 4)
+        {
+            numberOfVertices *= 2;
+        }
+        billboardBuffer = std::make_unique<Ego::VertexBuffer>(numberOfVertices, sizeof(BillboardVertex));
+    }
+    return *billboardBuffer;
+}
 
+/// @brief Get a particle which is to be rendered.
+/// @return the particle, or @a nullptr if it is not to be rendered
+static Ego::Particle *get_renderable_prt(const ParticleRef iprt, gfx_rv& retval)
+{
     const auto& pprt = ParticleHandler::get()[iprt];
     if (pprt == nullptr || pprt->isTerminated())
     {
         Log::Entry e(Log::Level::Error, __FILE__, __LINE__);
         e << "invalid particle `" << iprt << "`" << Log::EndOfEntry;
         Log::get() << e;
-        return gfx_error;
+        retval = gfx_error;
+        return nullptr;
     }
 
     // if the particle is hidden, do not continue
-    if (pprt->isHidden()) return gfx_fail;
+    if (pprt->isHidden()) return nullptr;
 
     // if the particle instance data is not valid, do not continue
-    if (!pprt->inst.valid) return gfx_fail;
-    auto& pinst = pprt->inst;
+    if (!pprt->inst.valid) return nullptr;
+
+    return pprt.get();
+}
+
+gfx_rv ParticleGraphicsRenderer::render_prt_solid(const std::vector<ParticleRef>& particles)
+{
+    /// @author BB
+    /// @details Render the solid version of the particles
+
+    gfx_rv retval = gfx_success;
 
     // only render solid sprites
-    if (SPRITE_SOLID != pprt->type) return gfx_fail;
+    static std::vector<Ego::Particle *> solid;
+    solid.clear();
+    for (const ParticleRef iprt : particles)
+    {
+        Ego::Particle *pprt = get_renderable_prt(iprt, retval);
+        if (pprt && SPRITE_SOLID == pprt->type)
+        {
+            solid.push_back(pprt);
+        }
+    }
+    if (solid.empty()) return retval;
+
+    std::shared_ptr<const Ego::Texture> texture = ParticleHandler::get().getTransparentParticleTexture();
+
+    // billboards for the particles
+    auto& vd = Ego::descriptor_factory<idlib::vertex_format::P3FC4FT2F>()();
+    auto& vb = getBillboardBuffer(solid.size());
+    {
+        BillboardVertex *v = static_cast<BillboardVertex *>(vb.lock());
+        for (const Ego::Particle *pprt : solid)
+        {
+            const auto& pinst = pprt->inst;
+            calc_billboard_verts(*texture, v, pinst, pinst.size, false);
+            for (size_t i = 0; i < 4; ++i, ++v)
+            {
+                v->r = v->g = v->b = pinst.fintens;
+                v->a = 1.0f;
+            }
+        }
+        vb.unlock();
+    }
 
     auto& renderer = Ego::Renderer::get();
     renderer.setWorldMatrix(Matrix4f4f::identity());
     {
         Ego::OpenGL::PushAttrib pa(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
         {
-            std::shared_ptr<const Ego::Texture> texture = nullptr;
             // Use the depth test to eliminate hidden portions of the particle
             renderer.setDepthTestEnabled(true);
             renderer.setDepthFunction(idlib::compare_function::less);                                   // GL_DEPTH_BUFFER_BIT
@@ -105,48 +160,121 @@ gfx_rv ParticleGraphicsRenderer::render_one_prt_solid(const ParticleRef iprt)
             renderer.setAlphaTestEnabled(true);
             renderer.setAlphaFunction(idlib::compare_function::equal, 1.0f);
 
-            texture = ParticleHandler::get().getTransparentParticleTexture();
             renderer.getTextureUnit().setActivated(texture.get());
 
-            renderer.setColour(Ego::Math::Colour4f(pinst.fintens, pinst.fintens, pinst.fintens, 1.0f));
-
-            // billboard for the particle
-            auto vd = Ego::descriptor_factory<idlib::vertex_format::P3FT2F>()();
-            auto vb = std::make_shared<Ego::VertexBuffer>(4, vd.get_size());
-            calc_billboard_verts(*texture, *vb, pinst, pinst.size, false);
-
-            renderer.render(*vb, vd, idlib::primitive_type::triangle_fan, 0, 4);
+            renderer.render(vb, vd, idlib::primitive_type::quadriliterals, 0, solid.size() * 4);
         }
     }
 
-    return gfx_success;
+    return retval;
 }
 
-gfx_rv ParticleGraphicsRenderer::render_one_prt_trans(const ParticleRef iprt)
+gfx_rv ParticleGraphicsRenderer::render_prt_trans(const std::vector<ParticleRef>& particles)
 {
     /// @author BB
     /// @details do all kinds of transparent sprites next
 
-    const auto& pprt = ParticleHandler::get()[iprt];
+    enum Batch
+    {
+        BATCH_SOLID_EDGE = 0, ///< the alpha blended edges of solid sprites
+        BATCH_ALPHA,          ///< transparent sprites
+        BATCH_LIGHT,          ///< light sprites, additive hence drawn last
+        BATCH_COUNT
+    };
 
-    if (pprt == nullptr || pprt->isTerminated())
+    gfx_rv retval = gfx_success;
+
+    // Sort the particles into the batches, keeping the back to front order within a batch.
+    static std::array<std::vector<Ego::Particle *>, BATCH_COUNT> batches;
+    for (auto& batch : batches)
     {
-        Log::Entry e(Log::Level::Error, __FILE__, __LINE__);
-        e << "invalid particle `" << iprt << "`" << Log::EndOfEntry;
-        Log::get() << e;
-        return gfx_error;
+        batch.clear();
     }
+    for (const ParticleRef iprt : particles)
+    {
+        Ego::Particle *pprt = get_renderable_prt(iprt, retval);
+        if (!pprt) continue;
+        const auto& inst = pprt->inst;
+        switch (pprt->type)
+        {
+            // Solid sprites.
+            case SPRITE_SOLID:
+                batches[BATCH_SOLID_EDGE].push_back(pprt);
+                break;
 
-    // if the particle is hidden, do not continue
-    if (pprt->isHidden()) return gfx_fail;
+            // Light sprites.
+            case SPRITE_LIGHT:
+                //Is particle invisible?
+                if (inst.fintens * inst.falpha > 0.0f) {
+                    batches[BATCH_LIGHT].push_back(pprt);
+                }
+                break;
 
-    // if the particle instance data is not valid, do not continue
-    if (!pprt->inst.valid) return gfx_fail;
-    auto& renderer = Ego::Renderer::get();
-    auto& inst = pprt->inst;
+            // Transparent sprites.
+            case SPRITE_ALPHA:
+                //Is particle invisible?
+                if (inst.falpha > 0.0f) {
+                    batches[BATCH_ALPHA].push_back(pprt);
+                }
+                break;
 
+            // unknown type
+            default:
+                retval = gfx_error;
+                break;
+        }
+    }
+
+    size_t numberOfBillboards = 0;
+    for (const auto& batch : batches)
+    {
+        numberOfBillboards += batch.size();
+    }
+    if (0 == numberOfBillboards) return retval;
+
+    std::shared_ptr<const Ego::Texture> transparentTexture = ParticleHandler::get().getTransparentParticleTexture(),
+                                        lightTexture = ParticleHandler::get().getLightParticleTexture();
+
+    // Stream the billboards of all batches into the vertex buffer.
+    auto& vd = Ego::descriptor_factory<idlib::vertex_format::P3FC4FT2F>()();
+    auto& vb = getBillboardBuffer(numberOfBillboards);
+    {
+        BillboardVertex *v = static_cast<BillboardVertex *>(vb.lock());
+        for (size_t i = 0; i < BATCH_COUNT; ++i)
+        {
+            const Ego::Texture& texture = (BATCH_LIGHT == i) ? *lightTexture : *transparentTexture;
+            for (const Ego::Particle *pprt : batches[i])
+            {
+                const auto& inst = pprt->inst;
+                Ego::Math::Colour4f particleColour;
+                switch (i)
+                {
+                    case BATCH_SOLID_EDGE:
+                        particleColour = Ego::Math::Colour4f(inst.fintens, inst.fintens, inst.fintens, 1.0f);
+                        break;
+                    case BATCH_ALPHA:
+                        particleColour = Ego::Math::Colour4f(inst.fintens, inst.fintens, inst.fintens, inst.falpha);
+                        break;
+                    case BATCH_LIGHT:
+                        particleColour = Ego::Math::Colour4f(1.0f, 1.0f, 1.0f, inst.fintens * inst.falpha);
+                        break;
+                }
+                calc_billboard_verts(texture, v, inst, inst.size, false);
+                for (size_t j = 0; j < 4; ++j, ++v)
+                {
+                    v->r = particleColour.get_r();
+                    v->g = particleColour.get_g();
+                    v->b = particleColour.get_b();
+                    v->a = particleColour.get_a();
+                }
+            }
+        }
+        vb.unlock();
+    }
+
+    auto& renderer = Ego::Renderer::get();
+    renderer.setWorldMatrix(Matrix4f4f::identity());
     {
-        renderer.setWorldMatrix(Matrix4f4f::identity());
         Ego::OpenGL::PushAttrib pa(GL_ENABLE_BIT | GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
         {
             // Do not write into the depth buffer.
@@ -159,88 +287,44 @@ gfx_rv ParticleGraphicsRenderer::render_one_prt_trans(const ParticleRef iprt)
             // Draw front-facing and back-facing polygons.
             renderer.setCullingMode(idlib::culling_mode::none);
 
-            Ego::Math::Colour4f particleColour;
-            std::shared_ptr<const Ego::Texture> texture = nullptr;
+            renderer.setBlendingEnabled(true);
 
-            switch(pprt->type)
+            size_t first = 0;
+            for (size_t i = 0; i < BATCH_COUNT; ++i)
             {
-                // Solid sprites.
-                case SPRITE_SOLID:
-                {
-                    // Do the alpha blended edge ("anti-aliasing") of the solid particle.
-                    // Only display the alpha-edge of the particle.
-                    renderer.setAlphaTestEnabled(true);
-                    renderer.setAlphaFunction(idlib::compare_function::less, 1.0f);
-
-                    renderer.setBlendingEnabled(true);
-                    renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one_minus_source0_alpha);
-
-                    particleColour = Ego::Math::Colour4f(inst.fintens, inst.fintens, inst.fintens, 1.0f);
-
-                    texture = ParticleHandler::get().getTransparentParticleTexture();
-                    renderer.getTextureUnit().setActivated(texture.get());
-                }
-                break;
-
-                // Light sprites.
-                case SPRITE_LIGHT:
-                {
-                    //Is particle invisible?
-                    if(inst.fintens * inst.falpha <= 0.0f) {
-                        return gfx_success;
-                    }
-
-                    renderer.setAlphaTestEnabled(false);
-                    renderer.setBlendingEnabled(true);
-                    renderer.setBlendFunction(idlib::color_blend_parameter::one, idlib::color_blend_parameter::one);
-
-                    particleColour = Ego::Math::Colour4f(1.0f, 1.0f, 1.0f, inst.fintens * inst.falpha);
-
-                    texture = ParticleHandler::get().getLightParticleTexture();
-                    renderer.getTextureUnit().setActivated(texture.get());
-                }
-                break;
-
-                // Transparent sprites.
-                case SPRITE_ALPHA:
+                if (batches[i].empty()) continue;
+                switch (i)
                 {
-                    //Is particle invisible?
-                    if(inst.falpha <= 0.0f) {
-                        return gfx_success;
-                    }
-
-                    // do not display the completely transparent portion
-                    renderer.setAlphaTestEnabled(true);
-                    renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
-
-                    renderer.setBlendingEnabled(true);
-                    renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one_minus_source0_alpha);
-
-                    particleColour = Ego::Math::Colour4f(inst.fintens, inst.fintens, inst.fintens, inst.falpha);
-
-                    texture = ParticleHandler::get().getTransparentParticleTexture();
-                    renderer.getTextureUnit().setActivated(texture.get());
+                    case BATCH_SOLID_EDGE:
+                        // Do the alpha blended edge ("anti-aliasing") of the solid particle.
+                        // Only display the alpha-edge of the particle.
+                        renderer.setAlphaTestEnabled(true);
+                        renderer.setAlphaFunction(idlib::compare_function::less, 1.0f);
+                        renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one_minus_source0_alpha);
+                        renderer.getTextureUnit().setActivated(transparentTexture.get());
+                        break;
+                    case BATCH_ALPHA:
+                        // do not display the completely transparent portion
+                        renderer.setAlphaTestEnabled(true);
+                        renderer.setAlphaFunction(idlib::compare_function::greater, 0.0f);
+                        renderer.setBlendFunction(idlib::color_blend_parameter::source0_alpha, idlib::color_blend_parameter::one_minus_source0_alpha);
+                        renderer.getTextureUnit().setActivated(transparentTexture.get());
+                        break;
+                    case BATCH_LIGHT:
+                        renderer.setAlphaTestEnabled(false);
+                        renderer.setBlendFunction(idlib::color_blend_parameter::one, idlib::color_blend_parameter::one);
+                        renderer.getTextureUnit().setActivated(lightTexture.get());
+                        break;
                 }
-                break;
 
-                // unknown type
-                default:
-                    return gfx_error;
-                break;
+                // Go on and draw them
+                renderer.render(vb, vd, idlib::primitive_type::quadriliterals, first * 4, batches[i].size() * 4);
+                first += batches[i].size();
             }
-
-            auto vd = Ego::descriptor_factory<idlib::vertex_format::P3FT2F>()();
-            auto vb = std::make_shared<Ego::VertexBuffer>(4, vd.get_size());
-            calc_billboard_verts(*texture, *vb, inst, inst.size, false);
-
-            renderer.setColour(particleColour);
-
-            // Go on and draw it
-            renderer.render(*vb, vd, idlib::primitive_type::triangle_fan, 0, 4);
         }
     }
 
-    return gfx_success;
+    return retval;
 }
 
 gfx_rv ParticleGraphicsRenderer::render_one_prt_ref(const ParticleRef iprt)
@@ -356,8 +440,6 @@ gfx_rv ParticleGraphicsRenderer::render_one_prt_ref(const ParticleRef iprt)
 
 void ParticleGraphicsRenderer::calc_billboard_verts(const Ego::Texture& texture, Ego::VertexBuffer& vb, Ego::Graphics::ParticleGraphics& inst, float size, bool do_reflect)
 {
-    // Calculate the position and texture coordinates of the four corners of the billboard used to display the particle.
-
     if (vb.getNumberOfVertices() < 4)
     {
         throw std::runtime_error("vertex buffer too small");
@@ -369,6 +451,16 @@ void ParticleGraphicsRenderer::calc_billboard_verts(const Ego::Texture& texture,
         float s, t;
     };
 
+    Vertex *v = static_cast<Vertex *>(vb.lock());
+    calc_billboard_verts(texture, v, inst, size, do_reflect);
+    vb.unlock();
+}
+
+template <typename Vertex>
+void ParticleGraphicsRenderer::calc_billboard_verts(const Ego::Texture& texture, Vertex *v, const Ego::Graphics::ParticleGraphics& inst, float size, bool do_reflect)
+{
+    // Calculate the position and texture coordinates of the four corners of the billboard used to display the particle.
+
     int i;
 	Vector3f prt_pos, prt_up, prt_right;
 
@@ -386,8 +478,6 @@ void ParticleGraphicsRenderer::calc_billboard_verts(const Ego::Texture& texture,
         prt_right = inst.right;
     }
 
-    Vertex *v = static_cast<Vertex *>(vb.lock());
-
     for (i = 0; i < 4; i++)
     {
         v[i].x = prt_pos[kX];
@@ -431,7 +521,6 @@ void ParticleGraphicsRenderer::calc_billboard_verts(const Ego::Texture& texture,
     v[3].s = CALCULATE_PRT_U1(texture, inst.image_ref);
     v[3].t = CALCULATE_PRT_V0(texture, inst.image_ref);
 
-    vb.unlock();
 }
 
 void ParticleGraphicsRenderer::render_all_prt_attachment()
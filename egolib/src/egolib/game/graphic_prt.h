@@ -46,15 +46,37 @@ struct ParticleGraphicsRenderer
     static float CALCULATE_PRT_U1(const Ego::Texture& texture, int CNT);
     static float CALCULATE_PRT_V0(const Ego::Texture& texture, int CNT);
     static float CALCULATE_PRT_V1(const Ego::Texture& texture, int CNT);
-    static gfx_rv render_one_prt_solid(const ParticleRef iprt);
-    static gfx_rv render_one_prt_trans(const ParticleRef iprt);
+    /// @brief Render the solid portion of solid particles.
+    /// @param particles the particles
+    /// @remark All particles are drawn with a single draw call. Their order does not matter
+    /// as they write into the depth buffer.
+    static gfx_rv render_prt_solid(const std::vector<ParticleRef>& particles);
+    /// @brief Render the transparent portion of particles.
+    /// @param particles the particles, ordered back to front
+    /// @remark The particles are grouped by render state i.e. the alpha-edges of solid sprites,
+    /// alpha sprites and light sprites. Each group is drawn with a single draw call, within a
+    /// group the particles are drawn back to front.
+    static gfx_rv render_prt_trans(const std::vector<ParticleRef>& particles);
     static gfx_rv render_one_prt_ref(const ParticleRef iprt);
     static void render_all_prt_bbox();
     static void render_prt_bbox(const std::shared_ptr<Ego::Particle> &bdl_prt);
     static void render_all_prt_attachment();
     static void prt_draw_attached_point(const std::shared_ptr<Ego::Particle> &bdl_prt);
 private:
+    /// The vertex format of batched billboards.
+    struct BillboardVertex
+    {
+        float x, y, z;
+        float r, g, b, a;
+        float s, t;
+    };
+    /// The vertex buffer billboards are streamed into. Grows as required.
+    static std::unique_ptr<Ego::VertexBuffer> billboardBuffer;
+    /// @brief Get a vertex buffer of at least the specified number of billboards.
+    static Ego::VertexBuffer& getBillboardBuffer(size_t numberOfBillboards);
     static void draw_one_attachment_point(Ego::Graphics::ObjectGraphics& inst, int vrt_offset);
+    template <typename Vertex>
+    static void calc_billboard_verts(const Ego::Texture& texture, Vertex *v, const Ego::Graphics::ParticleGraphics& pinst, float size, bool do_reflect);
     static void calc_billboard_verts(const Ego::Texture& texture, Ego::VertexBuffer& vb, Ego::Graphics::ParticleGraphics& pinst, float size, bool do_reflect);
 };
 
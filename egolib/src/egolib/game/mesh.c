@@ -29,6 +29,7 @@
 #include "egolib/FileFormats/Globals.hpp"
 #include "egolib/game/game.h"
 #include "egolib/game/Module/Module.hpp"
+#include <cstring>
 
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
@@ -39,7 +40,7 @@ const std::shared_ptr<ego_tile_info_t> ego_tile_info_t::NULL_TILE = nullptr;
 //--------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------
 
-MeshStats g_meshStats;
+thread_local MeshStats g_meshStats;
 
 static void warnNumberOfVertices(const char *file, int line, size_t numberOfVertices)
 {
@@ -156,27 +157,127 @@ std::shared_ptr<ego_mesh_t> MeshLoader::convert(const map_t& source) const
 	return target;
 }
 
+//--------------------------------------------------------------------------------------------
+namespace {
+// Read a little endian value at the specified offset of the contents of a map file.
+template <typename T>
+T readFileValue(const char *data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return Endian_FileToHost(value);
+}
+} // namespace
+
+std::shared_ptr<ego_mesh_t> MeshLoader::decode(const char *data, size_t length) const
+{
+    // The file starts with the string "MapD" followed by the vertex count and the tile counts in x and y direction.
+    static const size_t headerSize = 4 + 3 * sizeof(uint32_t);
+    if (!data || length < headerSize)
+    {
+        return nullptr;
+    }
+    if ('M' != data[0] || 'a' != data[1] || 'p' != data[2] || CURRENT_MAP_VERSION_LETTER != data[3])
+    {
+        return nullptr;
+    }
+    map_info_t info(readFileValue<uint32_t>(data, 4), readFileValue<uint32_t>(data, 8), readFileValue<uint32_t>(data, 12));
+    if (!info.validate())
+    {
+        return nullptr;
+    }
+    const size_t tileCount = info.getTileCount(), vertexCount = info.getVertexCount();
+
+    // The header is followed by the tiles (version 1), the tile twists (version 2),
+    // the x-, y- and z-coordinates of the vertices (version 3) and the vertex lighting (version 4).
+    const size_t tilesOffset = headerSize,
+                 twistsOffset = tilesOffset + tileCount * sizeof(uint32_t),
+                 positionsOffset = twistsOffset + tileCount * sizeof(uint8_t),
+                 lightingOffset = positionsOffset + 3 * vertexCount * sizeof(float);
+    if (length < lightingOffset + vertexCount * sizeof(uint8_t))
+    {
+        return nullptr;
+    }
+
+    // Create a mesh.
+    auto target = std::make_shared<ego_mesh_t>(Ego::MeshInfo(info.getVertexCount(), info.getTileCountX(), info.getTileCountY()));
+    tile_mem_t& tmem_dst = target->_tmem;
+
+    // Decode the per-tile info.
+    for (size_t cnt = 0; cnt < tileCount; cnt++)
+    {
+        const uint32_t bits = readFileValue<uint32_t>(data, tilesOffset + cnt * sizeof(uint32_t));
+        ego_tile_info_t& ptile_dst = tmem_dst.get(Index1D(cnt));
+
+        ptile_dst._type = Ego::Math::clipBits<8>(bits >> 24);
+        ptile_dst._img = Ego::Math::clipBits<16>(bits >> 0);
+        ptile_dst._base_fx = Ego::Math::clipBits<8>(bits >> 16);
+        ptile_dst._twist = static_cast<uint8_t>(data[twistsOffset + cnt]);
+
+        // set the local fx flags
+        ptile_dst._pass_fx = ptile_dst._base_fx;
+    }
+
+    // Decode the per-vertex info.
+    for (size_t cnt = 0; cnt < vertexCount; cnt++)
+    {
+        GLXvector3f& ppos_dst = tmem_dst._plst[cnt];
+        GLXvector3f& pcol_dst = tmem_dst._clst[cnt];
+
+        ppos_dst[XX] = readFileValue<float>(data, positionsOffset + (0 * vertexCount + cnt) * sizeof(float));
+        ppos_dst[YY] = readFileValue<float>(data, positionsOffset + (1 * vertexCount + cnt) * sizeof(float));
+        // Cartman scales the z-axis based off of a 4 bit fixed precision number.
+        ppos_dst[ZZ] = readFileValue<float>(data, positionsOffset + (2 * vertexCount + cnt) * sizeof(float)) / 16.0f;
+
+        // default color
+        pcol_dst[RR] = pcol_dst[GG] = pcol_dst[BB] = 0.0f;
+    }
+
+    // copy some of the pre-calculated grid lighting
+    for (size_t cnt = 0; cnt < tileCount; cnt++)
+    {
+        ego_tile_info_t& ptile_dst = tmem_dst.get(Index1D(cnt));
+
+        ptile_dst._a = ptile_dst._vrtstart < vertexCount ? static_cast<uint8_t>(data[lightingOffset + ptile_dst._vrtstart]) : 0;
+        ptile_dst._l = 0;
+    }
+
+    return target;
+}
+
 //--------------------------------------------------------------------------------------------
 std::shared_ptr<ego_mesh_t> MeshLoader::operator()(const std::string& moduleName) const
 {
-	map_t map;
 	// Load the map data.
 	tile_dictionary_load_vfs("mp_data/fans.txt", tile_dict);
-	if (!map.load("mp_data/level.mpd"))
+	// Maps of the current version are read with a single read and decoded directly into the mesh.
+	std::shared_ptr<ego_mesh_t> mesh;
+	char *data = nullptr;
+	size_t length = 0;
+	if (vfs_readEntireFile("mp_data/level.mpd", &data, &length))
 	{
-        Log::Entry entry(Log::Level::Error, __FILE__, __LINE__);
-	    entry << "unable to load mesh of module `" << moduleName << "`" << Log::EndOfEntry;
-        Log::get() << entry;
-		throw idlib::runtime_error(__FILE__, __LINE__, entry.getText());
+		mesh = decode(data, length);
+		std::free(data);
 	}
-	// Create the mesh from map.
-	std::shared_ptr<ego_mesh_t> mesh = convert(map);
 	if (!mesh)
 	{
-        auto e = Log::Entry::create(Log::Level::Error, __FILE__, __LINE__, "unable to convert mesh of module ", "`",
-                                    moduleName, "`", Log::EndOfEntry);
-        Log::get() << e;
-		throw idlib::runtime_error(__FILE__, __LINE__, e.getText());
+		map_t map;
+		if (!map.load("mp_data/level.mpd"))
+		{
+			Log::Entry entry(Log::Level::Error, __FILE__, __LINE__);
+			entry << "unable to load mesh of module `" << moduleName << "`" << Log::EndOfEntry;
+			Log::get() << entry;
+			throw idlib::runtime_error(__FILE__, __LINE__, entry.getText());
+		}
+		// Create the mesh from map.
+		mesh = convert(map);
+		if (!mesh)
+		{
+			auto e = Log::Entry::create(Log::Level::Error, __FILE__, __LINE__, "unable to convert mesh of module ", "`",
+										moduleName, "`", Log::EndOfEntry);
+			Log::get() << e;
+			throw idlib::runtime_error(__FILE__, __LINE__, e.getText());
+		}
 	}
 	mesh->finalize();
 	return mesh;
@@ -838,6 +939,170 @@ bool mpdfx_lists_t::synch( const tile_mem_t& tmem, bool force )
 
 //--------------------------------------------------------------------------------------------
 
+tile_chunks_t::tile_chunks_t(const Ego::MeshInfo& info)
+    : _tileCountX((int)info.getTileCountX()), _tileCountY((int)info.getTileCountY()),
+      _chunkCountX((_tileCountX + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      _chunkCountY((_tileCountY + CHUNK_SIZE - 1) / CHUNK_SIZE),
+      _chunks(_chunkCountX * _chunkCountY), _ranges(info.getTileCount()), _dirty(true),
+      _waterLevel(std::numeric_limits<float>::lowest()) {
+}
+
+size_t tile_chunks_t::getChunkIndex(const Index1D& i) const {
+    const int x = i.i() % _tileCountX,
+              y = i.i() / _tileCountX;
+    return (y / CHUNK_SIZE) * _chunkCountX + (x / CHUNK_SIZE);
+}
+
+void tile_chunks_t::invalidate(const Index1D& i) {
+    if (i.i() < 0 || (size_t)i.i() >= _ranges.size()) {
+        return;
+    }
+    _chunks[getChunkIndex(i)].dirty = true;
+    _dirty = true;
+}
+
+void tile_chunks_t::update(const tile_mem_t& tmem, const tile_dictionary_t& dict) {
+    if (!_dirty) {
+        return;
+    }
+    for (size_t i = 0; i < _chunks.size(); ++i) {
+        if (_chunks[i].dirty) {
+            build(i, tmem, dict);
+        }
+    }
+    _dirty = false;
+}
+
+uint32_t tile_chunks_t::getTextureIndex(const ego_tile_info_t& tile, const tile_dictionary_t& dict) {
+    uint32_t textureIndex = TILE_GET_LOWER_BITS(tile._img);
+    if (tile._type >= dict.offset) {
+        textureIndex += Ego::Graphics::MESH_IMG_COUNT;
+    }
+    return textureIndex;
+}
+
+void tile_chunks_t::build(size_t chunkIndex, const tile_mem_t& tmem, const tile_dictionary_t& dict) {
+    chunk_t& chunk = _chunks[chunkIndex];
+    chunk.indices.clear();
+    chunk.dirty = false;
+
+    const int minX = (chunkIndex % _chunkCountX) * CHUNK_SIZE,
+              minY = (chunkIndex / _chunkCountX) * CHUNK_SIZE;
+    const int maxX = std::min(minX + CHUNK_SIZE, _tileCountX),
+              maxY = std::min(minY + CHUNK_SIZE, _tileCountY);
+
+    // Order the tiles of this chunk by texture index and tile index.
+    std::array<std::pair<uint32_t, size_t>, CHUNK_SIZE * CHUNK_SIZE> tiles;
+    size_t tileCount = 0;
+    for (int y = minY; y < maxY; ++y) {
+        for (int x = minX; x < maxX; ++x) {
+            const size_t i = y * _tileCountX + x;
+            _ranges[i] = range_t();
+            const ego_tile_info_t& tile = tmem.get(i);
+            if (tile.isFanOff()) continue;
+            tiles[tileCount++] = std::make_pair(getTextureIndex(tile, dict), i);
+        }
+    }
+    std::sort(tiles.begin(), tiles.begin() + tileCount);
+
+    // Convert the fans of the tiles into triangles.
+    for (size_t j = 0; j < tileCount; ++j) {
+        const size_t i = tiles[j].second;
+        const ego_tile_info_t& tile = tmem.get(i);
+        const tile_definition_t *def = dict.get(tile._type);
+        if (!def) continue;
+
+        range_t& range = _ranges[i];
+        range.first = (uint32_t)chunk.indices.size();
+        const uint32_t base = (uint32_t)tile._vrtstart;
+        for (size_t command = 0, entry = 0; command < def->command_count; ++command) {
+            const uint8_t numEntries = def->command_entries[command];
+            for (size_t k = 1; k + 1 < numEntries; ++k) {
+                chunk.indices.push_back(base + def->command_verts[entry]);
+                chunk.indices.push_back(base + def->command_verts[entry + k]);
+                chunk.indices.push_back(base + def->command_verts[entry + k + 1]);
+            }
+            entry += numEntries;
+        }
+        range.count = (uint32_t)chunk.indices.size() - range.first;
+    }
+}
+
+void tile_chunks_t::updateBounds(const tile_mem_t& tmem) {
+    _nodes.clear();
+    if (0 == _chunkCountX || 0 == _chunkCountY) {
+        return;
+    }
+    _nodes.resize(1);
+    buildNode(0, 0, 0, _chunkCountX, _chunkCountY, tmem);
+}
+
+void tile_chunks_t::setWaterLevel(float level, const tile_mem_t& tmem) {
+    if (level != _waterLevel) {
+        _waterLevel = level;
+        updateBounds(tmem);
+    }
+}
+
+AxisAlignedBox3f tile_chunks_t::getBounds(const ego_tile_info_t& tile) const {
+    AxisAlignedBox3f bounds = tile._oct.toAxisAlignedBox();
+    // The water surface of a water tile is drawn above its floor.
+    if (0 != tile.testFX(MAPFX_WATER) && _waterLevel > bounds.get_max()[kZ]) {
+        const Point3f min = bounds.get_min(), max = bounds.get_max();
+        bounds = AxisAlignedBox3f(min, Point3f(max[kX], max[kY], _waterLevel));
+    }
+    return bounds;
+}
+
+void tile_chunks_t::buildNode(uint32_t nodeIndex, int minX, int minY, int maxX, int maxY, const tile_mem_t& tmem) {
+    // The arguments are in chunks, the node stores tiles.
+    node_t node;
+    node.minX = minX * CHUNK_SIZE;
+    node.minY = minY * CHUNK_SIZE;
+    node.maxX = std::min(maxX * CHUNK_SIZE, _tileCountX);
+    node.maxY = std::min(maxY * CHUNK_SIZE, _tileCountY);
+
+    if (1 == maxX - minX && 1 == maxY - minY) {
+        // A chunk: join the bounding boxes of its tiles.
+        node.bounds = getBounds(tmem.get(Index1D(node.minY * _tileCountX + node.minX)));
+        for (int y = node.minY; y < node.maxY; ++y) {
+            for (int x = node.minX; x < node.maxX; ++x) {
+                node.bounds.join(getBounds(tmem.get(Index1D(y * _tileCountX + x))));
+            }
+        }
+    } else {
+        // Split into (at most) four quadrants.
+        const int midX = (maxX - minX > 1) ? (minX + maxX + 1) / 2 : maxX,
+                  midY = (maxY - minY > 1) ? (minY + maxY + 1) / 2 : maxY;
+        const int quadrants[4][4] = {
+            { minX, minY, midX, midY },
+            { midX, minY, maxX, midY },
+            { minX, midY, midX, maxY },
+            { midX, midY, maxX, maxY },
+        };
+        node.firstChild = (uint32_t)_nodes.size();
+        for (const auto& quadrant : quadrants) {
+            if (quadrant[0] < quadrant[2] && quadrant[1] < quadrant[3]) {
+                node.childCount++;
+            }
+        }
+        _nodes.resize(_nodes.size() + node.childCount);
+        uint32_t child = node.firstChild;
+        for (const auto& quadrant : quadrants) {
+            if (quadrant[0] < quadrant[2] && quadrant[1] < quadrant[3]) {
+                buildNode(child++, quadrant[0], quadrant[1], quadrant[2], quadrant[3], tmem);
+            }
+        }
+        node.bounds = _nodes[node.firstChild].bounds;
+        for (child = node.firstChild + 1; child < node.firstChild + node.childCount; ++child) {
+            node.bounds.join(_nodes[child].bounds);
+        }
+    }
+    _nodes[nodeIndex] = node;
+}
+
+//--------------------------------------------------------------------------------------------
+
 bool ego_mesh_t::tile_has_bits( const Index2D& i, const BIT_FIELD bits ) const
 {
     // Figure out which tile we are on.
@@ -924,7 +1189,7 @@ bool ego_mesh_t::clear_fx( const Index1D& i, const BIT_FIELD flags )
 	g_meshStats.mpdfxTests++;
 
     if (_tmem.get(i).removeFX(flags)) {
-        _fxlists.dirty = true;
+        invalidate_fx(i, flags);
         return true;
     } else {
         return false;
@@ -945,12 +1210,27 @@ bool ego_mesh_t::add_fx(const Index1D& i, const BIT_FIELD flags)
 
     if ( retval )
     {
-        _fxlists.dirty = true;
+        invalidate_fx(i, flags);
     }
 
     return retval;
 }
 
+void ego_mesh_t::invalidate_fx(const Index1D& i, const BIT_FIELD flags)
+{
+    _fxlists.dirty = true;
+    _fxRevision++;
+
+    // The corners of reflective tiles are lit differently, relight the tile.
+    _tmem.get(i)._lightingCache.setNeedUpdate(true);
+
+    // The bounds of water tiles extend up to the water level.
+    if (HAS_SOME_BITS(flags, MAPFX_WATER))
+    {
+        _chunks.updateBounds(_tmem);
+    }
+}
+
 uint32_t ego_mesh_t::test_fx(const Index1D& i, const BIT_FIELD flags) const
 {
     // test for a trivial value of flags
@@ -1272,7 +1552,7 @@ BIT_FIELD ego_mesh_t::hit_wall(const Vector3f& pos, const float radius, const BI
 }
 
 ego_mesh_t::ego_mesh_t(const Ego::MeshInfo& mesh_info)
-	: _info(mesh_info), _tmem(mesh_info), _fxlists(mesh_info) {
+	: _info(mesh_info), _tmem(mesh_info), _fxlists(mesh_info), _chunks(mesh_info), _fxRevision(0) {
 }
 
 ego_mesh_t::~ego_mesh_t() {
@@ -1320,6 +1600,9 @@ bool ego_mesh_t::update_texture(const Index1D& i)
 	if (!grid_is_valid(i)) {
 		return false;
 	}
+	// The tile must be moved within the index list of its chunk.
+	_chunks.invalidate(i);
+
 	const ego_tile_info_t& tile = _tmem.get(i);
 	uint8_t type = tile._type & 0x3F;
 
@@ -1354,6 +1637,10 @@ void ego_mesh_t::finalize()
 
 	// create some lists to make searching the mesh tiles easier
 	_fxlists.synch(_tmem, true);
+
+	// build the index lists and the bounding boxes for rendering
+	_chunks.update(_tmem, tile_dict);
+	_chunks.updateBounds(_tmem);
 }
 
 float ego_mesh_t::getElevation(const Vector2f& p, bool waterwalk) const
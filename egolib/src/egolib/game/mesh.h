@@ -244,7 +244,7 @@ public:
 												// the lighting info in the upper left hand corner of a grid
 	uint8_t            _a, _l;                 ///< the raw mesh lighting... pretty much ignored
 	lighting_cache_t _cache;                   ///< the per-grid lighting info
-	int              _cache_frame;             ///< the last frame in which the cache was calculated
+	int              _cache_frame;             ///< the last frame in which the cache was calculated, @a -1 if it needs to be calculated
 
 };
 
@@ -343,6 +343,137 @@ struct mpdfx_lists_t
 
 //--------------------------------------------------------------------------------------------
 
+/// Persistent index lists for rendering the tiles of a mesh.
+/// The mesh is split into chunks of CHUNK_SIZE x CHUNK_SIZE tiles. The fans of the tiles of
+/// a chunk are converted into one triangle list which indexes the mesh-wide vertex lists of
+/// tile_mem_t. Within a chunk the tiles are ordered by texture, hence visible neighbouring tiles
+/// of the same texture can be drawn with a single draw call. A chunk is only rebuilt if the
+/// texture of one of its tiles changes.
+/// The chunks are the leaves of a quadtree of bounding boxes which is used to find the tiles
+/// within a view frustum.
+struct tile_chunks_t
+{
+    /// The width and height of a chunk (in tiles).
+    static constexpr int CHUNK_SIZE = 8;
+
+    /// The indices of a tile within the index list of its chunk.
+    struct range_t
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    struct chunk_t
+    {
+        std::vector<uint32_t> indices;  ///< the triangle list of all tiles of this chunk
+        bool dirty = true;              ///< must the triangle list be rebuilt?
+    };
+
+    tile_chunks_t(const Ego::MeshInfo& info);
+
+    /// @brief Mark the chunk containing a tile for rebuilding.
+    /// @param i the tile index
+    void invalidate(const Index1D& i);
+
+    /// @brief Rebuild all chunks marked for rebuilding.
+    /// @param tmem the tile memory
+    /// @param dict the tile dictionary
+    void update(const tile_mem_t& tmem, const tile_dictionary_t& dict);
+
+    /// @brief Get the index of the chunk containing a tile.
+    size_t getChunkIndex(const Index1D& i) const;
+
+    const chunk_t& getChunk(size_t i) const { return _chunks[i]; }
+
+    /// @brief Get the indices of a tile within the index list of its chunk.
+    /// @remark Tiles which are not rendered (e.g. fan off tiles) have an empty range.
+    const range_t& getRange(const Index1D& i) const { return _ranges[i.i()]; }
+
+    /// @brief Get the texture index of a tile.
+    /// @return the texture index in <tt>[0, 2 * Ego::Graphics::MESH_IMG_COUNT)</tt>
+    static uint32_t getTextureIndex(const ego_tile_info_t& tile, const tile_dictionary_t& dict);
+
+    /// @brief (Re)build the quadtree of bounding boxes from the bounding boxes of the tiles.
+    /// @param tmem the tile memory
+    void updateBounds(const tile_mem_t& tmem);
+
+    /// @brief Set the highest level the water surface reaches.
+    /// The bounding boxes of water tiles extend up to this level. The quadtree is rebuilt if the level changed.
+    /// @param level the level i.e. the base height of the water plus the amplitude of its waves
+    /// @param tmem the tile memory
+    void setWaterLevel(float level, const tile_mem_t& tmem);
+
+    /// @brief Get the bounding box of a tile for visibility tests.
+    /// @return the bounding box of the tile, for water tiles extended up to the water level
+    AxisAlignedBox3f getBounds(const ego_tile_info_t& tile) const;
+
+    /// @brief Invoke a visitor for all tiles intersecting a frustum.
+    /// @param tmem the tile memory
+    /// @param frustum the frustum
+    /// @param visitor functor of signature <tt>void(const Index1D&)</tt>
+    /// @remark Subtrees completely inside or outside of the frustum are not tested further.
+    template<typename Visitor>
+    void visit(const tile_mem_t& tmem, const Ego::Graphics::Frustum& frustum, Visitor&& visitor) const {
+        if (!_nodes.empty()) {
+            visit(0, tmem, frustum, visitor);
+        }
+    }
+
+private:
+    struct node_t
+    {
+        AxisAlignedBox3f bounds;        ///< the bounding box of the tiles of this node
+        int minX, minY, maxX, maxY;     ///< the tiles of this node (the maxima are exclusive)
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;        ///< 0 if this node is a chunk
+    };
+
+    template<typename Visitor>
+    void visit(uint32_t nodeIndex, const tile_mem_t& tmem, const Ego::Graphics::Frustum& frustum, Visitor& visitor) const {
+        const node_t& node = _nodes[nodeIndex];
+        switch (frustum.intersects(node.bounds, true)) {
+            case Ego::Math::Relation::outside:
+                return;
+            case Ego::Math::Relation::inside:
+                for (int y = node.minY; y < node.maxY; ++y) {
+                    for (int x = node.minX; x < node.maxX; ++x) {
+                        visitor(Index1D(y * _tileCountX + x));
+                    }
+                }
+                return;
+            default:
+                if (0 == node.childCount) {
+                    for (int y = node.minY; y < node.maxY; ++y) {
+                        for (int x = node.minX; x < node.maxX; ++x) {
+                            const Index1D i(y * _tileCountX + x);
+                            if (frustum.intersects(getBounds(tmem.get(i)), true)) {
+                                visitor(i);
+                            }
+                        }
+                    }
+                } else {
+                    for (uint32_t child = 0; child < node.childCount; ++child) {
+                        visit(node.firstChild + child, tmem, frustum, visitor);
+                    }
+                }
+                return;
+        }
+    }
+
+    void build(size_t chunkIndex, const tile_mem_t& tmem, const tile_dictionary_t& dict);
+    void buildNode(uint32_t nodeIndex, int minX, int minY, int maxX, int maxY, const tile_mem_t& tmem);
+
+    int _tileCountX, _tileCountY;       ///< the size of the mesh (in tiles)
+    int _chunkCountX, _chunkCountY;     ///< the size of the mesh (in chunks)
+    std::vector<chunk_t> _chunks;
+    std::vector<range_t> _ranges;       ///< the ranges of the tiles, indexed by tile index
+    bool _dirty;                        ///< is any chunk marked for rebuilding?
+    float _waterLevel;                  ///< the highest level of the water surface
+    std::vector<node_t> _nodes;         ///< the quadtree, the root is the first node
+};
+
+//--------------------------------------------------------------------------------------------
+
 class ego_mesh_t;
 
 /// struct for caching fome values for wall collisions
@@ -387,6 +518,8 @@ public:
     Ego::MeshInfo _info;
     tile_mem_t _tmem;
     mpdfx_lists_t _fxlists;
+    tile_chunks_t _chunks;
+    uint32_t _fxRevision;   ///< Incremented whenever clear_fx() or add_fx() change a tile.
 
     Vector3f get_diff(const Vector3f& pos, float radius, float center_pressure, const BIT_FIELD bits);
     float get_pressure(const Vector3f& pos, float radius, const BIT_FIELD bits) const;
@@ -427,6 +560,10 @@ public:
 
 	bool clear_fx(const Index1D& i, const BIT_FIELD flags);
 	bool add_fx(const Index1D& i, const BIT_FIELD flags);
+
+    /// @brief Get the FX revision of this mesh.
+    /// @return a counter which changes whenever the FX of a tile change (e.g. if a passage opens or closes)
+    uint32_t getFXRevision() const { return _fxRevision; }
 	uint8_t get_twist(const Index1D& i) const;
 
 	/// @todo @a pos and @a radius should be passed as a sphere.
@@ -478,6 +615,8 @@ private:
 	void make_normals();
 	/// Set the bounding box for each tile, and for the entire mesh
 	void make_bbox();
+	/// Invalidate the state depending on the FX of a tile after clear_fx() or add_fx() changed them.
+	void invalidate_fx(const Index1D& i, const BIT_FIELD flags);
 
 };
 
@@ -516,13 +655,22 @@ struct MeshStats {
 };
 
 // Those are statistics. Move into per-mesh statistics.
-extern MeshStats g_meshStats;
+// Thread-local as meshes are queried concurrently by the physics jobs.
+extern thread_local MeshStats g_meshStats;
 
 //--------------------------------------------------------------------------------------------
 
 /// loading/saving
 struct MeshLoader {
     std::shared_ptr<ego_mesh_t> operator()(const std::string& moduleName) const;
-private:
+    /// @brief Create a mesh from the contents of a map file of the current version.
+    /// @param data, length the contents of the map file
+    /// @return the mesh, a null pointer if the contents are not a complete map of the current version
+    /// @remark The tile and vertex sections are decoded directly into the tile memory of the mesh.
+    /// Maps of older versions are loaded into a map_t and converted.
+    std::shared_ptr<ego_mesh_t> decode(const char *data, size_t length) const;
+    /// @brief Create a mesh from a map loaded by map_t::load.
+    /// @param source the map
+    /// @return the mesh
     std::shared_ptr<ego_mesh_t> convert(const map_t& source) const;
 };
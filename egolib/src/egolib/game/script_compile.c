@@ -22,6 +22,7 @@
 /// @details
 
 #include "egolib/game/script_compile.h"
+#include "egolib/egoboo_setup.h"
 #include "egolib/game/game.h"
 #include "egolib/game/egoboo.h"
 #include "egolib/Script/CLogEntry.hpp"
@@ -598,6 +599,47 @@ Ego::Script::PDLToken parser_state_t::parse_indention(script_info_t& script, lin
     return token;
 }
 
+//--------------------------------------------------------------------------------------------
+static int resolve_reference(const std::string& lexeme)
+{
+    /// @details This function converts an object reference to the slot number of the object,
+    /// loading the object if it is not loaded yet. Returns INVALID_PRO_REF on failure.
+
+    // Invalid profile as default.
+    int value = INVALID_PRO_REF;
+    // Convert reference to slot number.
+    for (const auto& element : ProfileSystem::get().getLoadedProfiles())
+    {
+        const auto& profile = element.second;
+        if (profile == nullptr) continue;
+        // Is this the object we are looking for?
+        if (idlib::is_suffix(profile->getPathname(), lexeme))
+        {
+            value = profile->getSlotNumber().get();
+            break;
+        }
+    }
+
+    // Do we need to load the object?
+    if (!ProfileSystem::get().isLoaded((PRO_REF)value))
+    {
+        auto loadName = "mp_objects/" + lexeme;
+
+        // Find first free slot number.
+        for (PRO_REF ipro = MAX_IMPORT_PER_PLAYER * 4; ipro < INVALID_PRO_REF; ipro++)
+        {
+            //skip loaded profiles
+            if (ProfileSystem::get().isLoaded(ipro)) continue;
+
+            //found a free slot
+            value = ProfileSystem::get().loadOneProfile(loadName, REF_TO_INT(ipro)).get();
+            if (value == ipro) break;
+        }
+    }
+
+    return value;
+}
+
 //--------------------------------------------------------------------------------------------
 Ego::Script::PDLToken parser_state_t::parse_token(ObjectProfile *ppro, script_info_t& script, line_scanner_state_t& state)
 {
@@ -627,38 +669,8 @@ Ego::Script::PDLToken parser_state_t::parse_token(ObjectProfile *ppro, script_in
         if (token.category() == Ego::Script::PDLTokenKind::ReferenceLiteral)
         {
             // If it is a profile reference.
-
-            // Invalid profile as default.
-            token.setValue(INVALID_PRO_REF);
-            // Convert reference to slot number.
-            for (const auto& element : ProfileSystem::get().getLoadedProfiles())
-            {
-                const auto& profile = element.second;
-                if (profile == nullptr) continue;
-                // Is this the object we are looking for?
-                if (idlib::is_suffix(profile->getPathname(), token.get_lexeme()))
-                {
-                    token.setValue(profile->getSlotNumber().get());
-                    break;
-                }
-            }
-
-            // Do we need to load the object?
-            if (!ProfileSystem::get().isLoaded((PRO_REF)token.getValue()))
-            {
-                auto loadName = "mp_objects/" + token.get_lexeme();
-
-                // Find first free slot number.
-                for (PRO_REF ipro = MAX_IMPORT_PER_PLAYER * 4; ipro < INVALID_PRO_REF; ipro++)
-                {
-                    //skip loaded profiles
-                    if (ProfileSystem::get().isLoaded(ipro)) continue;
-
-                    //found a free slot
-                    token.setValue(ProfileSystem::get().loadOneProfile(loadName, REF_TO_INT(ipro)).get());
-                    if (token.getValue() == ipro) break;
-                }
-            }
+            token.setValue(resolve_reference(token.get_lexeme()));
+            _literals.push_back({Ego::Script::CachedLiteral::Kind::Reference, token.get_lexeme(), token.getValue()});
 
             // Failed to load object!
             if (!ProfileSystem::get().isLoaded((PRO_REF)token.getValue()))
@@ -674,6 +686,7 @@ Ego::Script::PDLToken parser_state_t::parse_token(ObjectProfile *ppro, script_in
         {
             // Add the string as a message message to the available messages of the object.
             token.setValue(ppro->addMessage(token.get_lexeme(), true));
+            _literals.push_back({Ego::Script::CachedLiteral::Kind::Message, token.get_lexeme(), token.getValue()});
             token.category(Ego::Script::PDLTokenKind::Constant);
             // Emit a warning that the string is empty.
             Ego::Script::CLogEntry e(Log::Level::Message, __FILE__, __LINE__, __FUNCTION__, token.get_start_location());
@@ -1053,6 +1066,32 @@ bool load_ai_codes_vfs()
     return true;
 }
 
+//--------------------------------------------------------------------------------------------
+static bool load_cached_ai_script(uint64_t keyHash, ObjectProfile *ppro, script_info_t& script)
+{
+    /// @details This function loads a compiled script from the script cache. The literals are
+    /// resolved again in the order in which the compiler resolved them, the cached script is only
+    /// used if their values did not change. Otherwise the script must be compiled. Resolving the
+    /// literals has the same side effects as compiling the script, hence it can be compiled afterwards.
+
+    std::vector<Ego::Script::CachedLiteral> literals;
+    if (!Ego::Script::ScriptCache::load(keyHash, script._instructions, literals))
+    {
+        return false;
+    }
+    for (const auto& literal : literals)
+    {
+        int value = Ego::Script::CachedLiteral::Kind::Message == literal.kind
+                  ? (int)ppro->addMessage(literal.lexeme, true)
+                  : resolve_reference(literal.lexeme);
+        if (value != literal.value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------
 egolib_rv load_ai_script_vfs0(parser_state_t& ps, const std::string& loadname, ObjectProfile *ppro, script_info_t& script)
 {
@@ -1080,14 +1119,36 @@ egolib_rv load_ai_script_vfs0(parser_state_t& ps, const std::string& loadname, O
         // save the filename for error logging
         script._name = loadname;
 
-        // we have parsed nothing yet
-        script._instructions.clear();
+        // the cache entry is keyed by the cache version, the name and the source of the script
+        const bool useCache = egoboo_config_t::get().game_scriptCache_enable.getValue();
+        const std::string key = std::to_string(Ego::Script::ScriptCache::getVersion()) + '\n' + loadname + '\n' + ps._loadBuffer.toString();
+        const uint64_t keyHash = Ego::Script::ScriptCache::hash(key.data(), key.size());
+
+        if (!useCache || !load_cached_ai_script(keyHash, ppro, script))
+        {
+            // we have parsed nothing yet
+            script._instructions.clear();
+            ps._literals.clear();
+
+            // parse/compile the scripts
+            ps.parse_line_by_line(ppro, script);
 
-        // parse/compile the scripts
-        ps.parse_line_by_line(ppro, script);
+            // determine the correct jumps
+            parser_state_t::parse_jumps(script);
 
-        // determine the correct jumps
-        parser_state_t::parse_jumps(script);
+            if (useCache)
+            {
+                Ego::Script::ScriptCache::store(keyHash, script._instructions, ps._literals);
+            }
+        }
+
+        // lower the instructions into a pre-decoded program
+        script._program.clear();
+        if (egoboo_config_t::get().game_decodedScripts_enable.getValue())
+        {
+            scripting_system_begin();
+            script._program.decode(script._instructions);
+        }
     } catch (...) {
         return rv_fail;
     }
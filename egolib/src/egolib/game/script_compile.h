@@ -24,6 +24,7 @@
 #include "egolib/Script/PDLToken.hpp"
 #include "egolib/game/egoboo.h"
 #include "egolib/Script/Buffer.hpp"
+#include "egolib/Script/ScriptCache.hpp"
 #include "egolib/Script/script.h"
 
 //--------------------------------------------------------------------------------------------
@@ -191,6 +192,9 @@ protected:
 public:
     Ego::Script::Buffer _loadBuffer;
 
+    /// @brief The message and object reference literals resolved while compiling the current script.
+    std::vector<Ego::Script::CachedLiteral> _literals;
+
     /// @brief Get the error variable value.
     /// @return the error variable value
     bool get_error() const;
@@ -46,6 +46,7 @@
 #include "egolib/game/Physics/PhysicalConstants.hpp"
 #include "egolib/Script/Interpreter/SafeCast.hpp"
 #include "egolib/game/GUI/MiniMap.hpp"
+#include "egolib/Core/CommandBuffer.hpp"
 
 /**
  * @brief Convert a value of type \f$Value\f$ value into a bit index.
@@ -2162,7 +2163,13 @@ uint8_t scr_PlaySound( script_state_t& state, ai_state_t& self )
 
     if ( pchr->getOldPosition()[kZ] > PITNOSOUND )
     {
-        AudioSystem::get().playSound(pchr->getOldPosition(), ppro->getSoundID(state.argument));
+        // The audio system is not thread-safe, defer if the script runs on a worker thread
+        const Vector3f position = pchr->getOldPosition();
+        const SoundID soundID = ppro->getSoundID(state.argument);
+        Ego::CommandBuffer::submit([position, soundID]
+        {
+            AudioSystem::get().playSound(position, soundID);
+        });
     }
 
     SCRIPT_FUNCTION_END();
@@ -34,6 +34,7 @@
 #include "egolib/game/mesh.h"
 #include "egolib/game/Module/Module.hpp"
 #include "egolib/game/Module/Passage.hpp"
+#include "egolib/Core/CommandBuffer.hpp"
 
 //--------------------------------------------------------------------------------------------
 // wrap generic bitwise conversion macros
@@ -248,10 +249,10 @@ bool FindPath( waypoint_list_t& wplst, Object * pchr, float dst_x, float dst_y,
 #ifdef DEBUG_ASTAR
         printf( "Finding a path from %d,%d to %d,%d: \n", src_ix, src_iy, dst_ix, dst_iy );
 #endif
-        //Try to find a path with the AStar algorithm
-        if ( g_astar.find_path( _currentModule->getMeshPointer(), pchr->stoppedby, src_ix, src_iy, dst_ix, dst_iy ) )
+        //Try to find a path, characters heading for the same destination share the search
+        if ( g_pathCache.find_path( _currentModule->getMeshPointer(), pchr->stoppedby, src_ix, src_iy, dst_ix, dst_iy ) )
         {
-            returncode = g_astar.get_path( dst_x, dst_y, wplst);
+            returncode = g_pathCache.get_path( dst_x, dst_y, wplst);
         }
 
         if ( NULL != used_astar_ptr )
@@ -468,8 +469,12 @@ uint8_t _display_message( const ObjectRef ichr, const PRO_REF iprofile, const in
     const std::shared_ptr<ObjectProfile> &ppro = ProfileSystem::get().getProfile(iprofile);
     if ( !ppro->isValidMessageID(message) ) return false;
 
+    // Expand now as the escape codes refer to the current state, but defer the output if the script runs on a worker thread
     std::string text = expandEscapeCodes(_currentModule->getObjectHandler()[ichr], *pstate, ppro->getMessage(message));
-    DisplayMsg_print(text);
+    Ego::CommandBuffer::submit([text]
+    {
+        DisplayMsg_print(text);
+    });
 
     return true;
 }
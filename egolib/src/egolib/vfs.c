@@ -51,6 +51,10 @@ typedef struct s_vfs_path_data vfs_path_data_t;
  //--------------------------------------------------------------------------------------------
 #define VFS_MAX_PATH 1024
 
+/// The size, in Bytes, of the read buffer of a file opened for reading.
+/// Without a buffer, every read (e.g. vfs_getc) is a read from the archive or the file system.
+#define VFS_READ_BUFFER_SIZE 4096
+
 #define BAIL_IF_NOT_INIT() \
 	if(!_vfs_initialized) { \
 		std::ostringstream os; \
@@ -283,6 +287,9 @@ vfs_FILE *vfs_openRead(const std::string& pathname)
         return nullptr;
     }
 
+    // buffer the reads, a failure only costs performance
+    PHYSFS_setBuffer(ftmp, VFS_READ_BUFFER_SIZE);
+
 	vfs_FILE *vfs_file;
 	try {
 		vfs_file = new vfs_FILE();
@@ -2186,7 +2193,19 @@ void vfs_readEntireFile(const std::string& pathname, std::function<void(size_t,
     if (!file) {
         throw idlib::runtime_error(__FILE__, __LINE__, "unable to open file `" + pathname + "` for reading");
     }
-    // Read in 2048 Byte chunks.
+    // Read the file with a single read if its length is known.
+    long length = vfs_fileLength(file.get());
+    if (length > 0) {
+        std::vector<char> buffer(length);
+        size_t read = vfs_read(buffer.data(), 1, buffer.size(), file.get());
+        if (vfs_error(file.get())) {
+            throw idlib::runtime_error(__FILE__, __LINE__, "error while reading file `" + pathname + "`");
+        }
+        if (0 != read) {
+            receive(read, buffer.data());
+        }
+    }
+    // Read the rest (if any) in 2048 Byte chunks.
     char buffer[2048];
     while (!vfs_eof(file.get())) {
         size_t read = vfs_read(buffer, 1, 2048, file.get());
@@ -0,0 +1,169 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/mesh.h"
+#include "egolib/Tests/utilities.hpp"
+#include <chrono>
+
+namespace Ego { namespace Test { namespace AStar {
+
+TEST(astar_testing, straight_path) {
+    auto mesh = std::make_shared<ego_mesh_t>(Ego::MeshInfo(32, 32));
+    ::AStar astar;
+    ASSERT_TRUE(astar.find_path(mesh, MAPFX_WALL, 2, 2, 20, 2));
+    ASSERT_EQ(19u, astar.getExploredNodeCount());
+
+    waypoint_list_t wplst;
+    ASSERT_TRUE(astar.get_path(20 * Info<int>::Grid::Size(), 2 * Info<int>::Grid::Size(), wplst));
+}
+
+TEST(astar_testing, path_around_wall) {
+    auto mesh = std::make_shared<ego_mesh_t>(Ego::MeshInfo(32, 32));
+    for (int y = 0; y < 31; ++y) {
+        mesh->_tmem.get(Index2D(16, y)).setFX(MAPFX_WALL);
+    }
+    ::AStar astar;
+    ASSERT_TRUE(astar.find_path(mesh, MAPFX_WALL, 2, 2, 30, 2));
+    ASSERT_FALSE(astar.find_path(mesh, MAPFX_WALL, 2, 2, 16, 2));
+
+    //Close the gap
+    mesh->_tmem.get(Index2D(16, 31)).setFX(MAPFX_WALL);
+    ASSERT_FALSE(astar.find_path(mesh, MAPFX_WALL, 2, 2, 30, 2));
+}
+
+TEST(astar_testing, path_cache_shares_searches) {
+    auto mesh = Utilities::aRandomDungeon(64, 64, 64);
+    const Index2D target = Utilities::aRandomFreeTile(*mesh);
+    PathCache cache;
+
+    //Many chasers towards the same target: only the first one runs A*, the others share one flow field
+    for (size_t i = 0; i < 100; ++i) {
+        const Index2D source = Utilities::aRandomFreeTile(*mesh);
+        ::AStar astar;
+        const bool expected = astar.find_path(mesh, MAPFX_WALL, source.x(), source.y(), target.x(), target.y());
+        ASSERT_EQ(expected, cache.find_path(mesh, MAPFX_WALL, source.x(), source.y(), target.x(), target.y()));
+        if (expected) {
+            waypoint_list_t wplst;
+            ASSERT_TRUE(cache.get_path(target.x() * Info<int>::Grid::Size(), target.y() * Info<int>::Grid::Size(), wplst));
+        }
+    }
+    ASSERT_EQ(1u, cache.getBuildCount());
+
+    //Opening or closing a passage invalidates the flow fields
+    const Index2D source = Utilities::aRandomFreeTile(*mesh);
+    mesh->add_fx(mesh->getTileIndex(source), MAPFX_IMPASS);
+    cache.find_path(mesh, MAPFX_WALL, source.x(), source.y(), target.x(), target.y());
+    cache.find_path(mesh, MAPFX_WALL, source.x(), source.y(), target.x(), target.y());
+    ASSERT_EQ(2u, cache.getBuildCount());
+}
+
+TEST(astar_testing, path_cache_respects_node_budget) {
+    //A serpentine corridor, the far end is only reachable after exploring more tiles than A* is allowed to
+    auto mesh = std::make_shared<ego_mesh_t>(Ego::MeshInfo(256, 256));
+    for (int x = 1; x < 255; x += 2) {
+        const int gap = (x / 2) % 2 ? 0 : 255;
+        for (int y = 0; y < 256; ++y) {
+            if (y != gap) mesh->_tmem.get(Index2D(x, y)).setFX(MAPFX_WALL);
+        }
+    }
+    PathCache cache;
+
+    //Sources near the target descend the flow field
+    ASSERT_TRUE(cache.find_path(mesh, MAPFX_WALL, 254, 2, 254, 128));
+    ASSERT_TRUE(cache.find_path(mesh, MAPFX_WALL, 254, 250, 254, 128));
+    ASSERT_EQ(1u, cache.getBuildCount());
+
+    //Sources beyond the tiles the flow field explored get the same answer as from A*
+    ::AStar astar;
+    ASSERT_FALSE(astar.find_path(mesh, MAPFX_WALL, 0, 128, 254, 128));
+    ASSERT_FALSE(cache.find_path(mesh, MAPFX_WALL, 0, 128, 254, 128));
+    ASSERT_EQ(1u, cache.getBuildCount());
+}
+
+/// Time random searches over a mesh, first to random destinations and then to a few shared destinations (chasers).
+static void benchmarkAStar(const std::string& name, const std::shared_ptr<ego_mesh_t>& mesh, const size_t numberOfSearches) {
+    ::AStar astar;
+
+    size_t found = 0, explored = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numberOfSearches; ++i) {
+        const Index2D source = Utilities::aRandomFreeTile(*mesh), target = Utilities::aRandomFreeTile(*mesh);
+        if (astar.find_path(mesh, MAPFX_WALL | MAPFX_IMPASS, source.x(), source.y(), target.x(), target.y())) {
+            found++;
+        }
+        explored += astar.getExploredNodeCount();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    PathCache cache;
+    std::vector<Index2D> targets;
+    for (size_t i = 0; i < 4; ++i) {
+        targets.push_back(Utilities::aRandomFreeTile(*mesh));
+    }
+    size_t foundShared = 0;
+    auto startShared = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < numberOfSearches; ++i) {
+        const Index2D source = Utilities::aRandomFreeTile(*mesh), &target = targets[i % targets.size()];
+        if (cache.find_path(mesh, MAPFX_WALL | MAPFX_IMPASS, source.x(), source.y(), target.x(), target.y())) {
+            foundShared++;
+        }
+    }
+    auto endShared = std::chrono::high_resolution_clock::now();
+
+    std::cout << name << " (" << mesh->getInfo().getTileCountX() << "x" << mesh->getInfo().getTileCountY() << " tiles): "
+              << numberOfSearches << " searches (" << found << " paths found, " << explored << " nodes explored) "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us, "
+              << numberOfSearches << " searches to " << targets.size() << " destinations (" << foundShared << " paths found, " << cache.getBuildCount() << " flow fields) "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endShared - startShared).count() << " us"
+              << std::endl;
+}
+
+TEST(astar_testing, DISABLED_benchmark_astar_64) {
+    benchmarkAStar("random dungeon", Utilities::aRandomDungeon(64, 64, 64 * 64 / 64), 1000);
+}
+
+TEST(astar_testing, DISABLED_benchmark_astar_256) {
+    benchmarkAStar("random dungeon", Utilities::aRandomDungeon(256, 256, 256 * 256 / 64), 1000);
+}
+
+TEST(astar_testing, DISABLED_benchmark_astar_modules) {
+    GameDataModules data;
+    if (data.modules.empty()) {
+        GTEST_SKIP() << "EGOBOO_DATA is not set to a game data directory";
+    }
+    for (const auto& module : data.modules) {
+        const std::string pathname = module + "/gamedat/level.mpd";
+        if (!vfs_exists(pathname)) {
+            continue;
+        }
+        std::vector<char> bytes;
+        vfs_readEntireFile(pathname, [&bytes](size_t numberOfBytes, const char *data) {
+            bytes.insert(bytes.end(), data, data + numberOfBytes);
+        });
+        auto mesh = MeshLoader().decode(bytes.data(), bytes.size());
+        if (!mesh) {
+            continue;
+        }
+        benchmarkAStar(module, mesh, 1000);
+    }
+}
+
+} } } // namespace Ego::Test::AStar
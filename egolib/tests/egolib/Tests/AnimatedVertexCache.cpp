@@ -0,0 +1,89 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/Graphics/AnimatedVertexCache.hpp"
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+#include "egolib/Tests/utilities.hpp"
+
+namespace Ego { namespace Test { namespace AnimatedVertexCache {
+
+using Graphics::AnimatedVertexCache;
+using Graphics::AnimatedVertices;
+
+TEST(animated_vertex_cache_testing, identical_states_share_vertices) {
+    auto model = Utilities::aRandomModel(32, 4);
+    AnimatedVertexCache cache;
+
+    auto a = cache.acquire(model, 0, 1, 0.5f),
+         b = cache.acquire(model, 0, 1, 0.5f + 0.25f / AnimatedVertexCache::FLIP_STEPS),
+         c = cache.acquire(model, 0, 1, 0.5f + 1.0f / AnimatedVertexCache::FLIP_STEPS),
+         d = cache.acquire(model, 1, 2, 0.5f);
+    ASSERT_EQ(a, b);
+    ASSERT_NE(a, c);
+    ASSERT_NE(a, d);
+
+    cache.evict();
+    ASSERT_EQ(3u, cache.getStatistics().entries);
+    ASSERT_EQ(1u, cache.getStatistics().hits);
+    ASSERT_EQ(3u, cache.getStatistics().misses);
+}
+
+TEST(animated_vertex_cache_testing, unreferenced_states_are_evicted) {
+    auto model = Utilities::aRandomModel(32, 4);
+    AnimatedVertexCache cache;
+
+    auto a = cache.acquire(model, 0, 1, 0.25f);
+    cache.acquire(model, 2, 3, 0.75f);
+    cache.evict();
+    ASSERT_EQ(1u, cache.getStatistics().entries);
+
+    std::weak_ptr<AnimatedVertices> weak = a;
+    a = nullptr;
+    cache.evict();
+    ASSERT_EQ(0u, cache.getStatistics().entries);
+    ASSERT_TRUE(weak.expired());
+}
+
+TEST(animated_vertex_cache_testing, partial_updates_match_full_interpolation) {
+    const size_t vertexCount = 45;
+    auto model = Utilities::aRandomModel(vertexCount, 2);
+    AnimatedVertexCache cache;
+
+    const float flip = 0.3f;
+    auto vertices = cache.acquire(model, 0, 1, flip);
+    vertices->update(40, 44);
+    vertices->update(3, 7);
+    vertices->update(0, 20);
+    vertices->update(0, vertexCount - 1);
+
+    std::vector<GLvertex> expected(vertexCount);
+    const float quantizedFlip = float(AnimatedVertexCache::quantize(flip)) / AnimatedVertexCache::FLIP_STEPS;
+    Graphics::interpolateMD2VerticesScalar(model->getFrames()[0].arrays, model->getFrames()[1].arrays,
+                                           0, vertexCount - 1, quantizedFlip, expected.data());
+    ASSERT_EQ(vertexCount, vertices->getVertexCount());
+    for (size_t i = 0; i < vertexCount; ++i) {
+        for (size_t j = 0; j < 4; ++j) ASSERT_EQ(expected[i].pos[j], vertices->getVertex(i).pos[j]) << "vertex " << i;
+        for (size_t j = 0; j < 3; ++j) ASSERT_EQ(expected[i].nrm[j], vertices->getVertex(i).nrm[j]) << "vertex " << i;
+        for (size_t j = 0; j < 2; ++j) ASSERT_EQ(expected[i].env[j], vertices->getVertex(i).env[j]) << "vertex " << i;
+    }
+}
+
+} } } // namespace Ego::Test::AnimatedVertexCache
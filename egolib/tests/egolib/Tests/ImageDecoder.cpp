@@ -0,0 +1,108 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/Graphics/ImageDecoder.hpp"
+#include "egolib/Image/ImageManager.hpp"
+
+namespace Ego { namespace Test { namespace ImageDecoder {
+
+/// Append a little endian value to the contents of a bitmap file.
+template <typename T>
+static void append(std::vector<char>& bytes, T value) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        bytes.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+/// An uncompressed 24 bit bitmap of random pixels.
+static std::vector<char> aRandomBitmap(uint32_t width, uint32_t height) {
+    const uint32_t pitch = (3 * width + 3) & ~3u, size = pitch * height;
+    std::vector<char> bytes = { 'B', 'M' };
+    append<uint32_t>(bytes, 14 + 40 + size);
+    append<uint32_t>(bytes, 0);
+    append<uint32_t>(bytes, 14 + 40);
+    append<uint32_t>(bytes, 40);
+    append<int32_t>(bytes, width);
+    append<int32_t>(bytes, height);
+    append<uint16_t>(bytes, 1);
+    append<uint16_t>(bytes, 24);
+    append<uint32_t>(bytes, 0);
+    append<uint32_t>(bytes, size);
+    append<int32_t>(bytes, 2835);
+    append<int32_t>(bytes, 2835);
+    append<uint32_t>(bytes, 0);
+    append<uint32_t>(bytes, 0);
+    for (uint32_t i = 0; i < size; ++i) {
+        bytes.push_back(static_cast<char>(Random::next<int>(0, 255)));
+    }
+    return bytes;
+}
+
+/// Mounts the debug directory of the user directory to write bitmaps and to decode them.
+struct ImageDecoderTest : public ::testing::Test {
+    static constexpr size_t count = 64;
+    void SetUp() override {
+        ASSERT_EQ(0, vfs_init(nullptr, nullptr));
+        ASSERT_NE(0, vfs_add_mount_point(fs_getUserDirectory(), Ego::FsPath("debug"), Ego::VfsPath("mp_debug"), 1));
+        ImageManager::initialize();
+        for (size_t i = 0; i < count; ++i) {
+            const auto bytes = aRandomBitmap(256, 256);
+            vfs_FILE *file = vfs_openWrite(pathname(i) + ".bmp");
+            ASSERT_NE(nullptr, file);
+            ASSERT_EQ(1, vfs_write(bytes.data(), bytes.size(), 1, file));
+            vfs_close(file);
+        }
+    }
+    void TearDown() override {
+        ImageManager::uninitialize();
+        for (size_t i = 0; i < count; ++i) {
+            vfs_delete_file(pathname(i) + ".bmp");
+        }
+        vfs_remove_mount_point(Ego::VfsPath("mp_debug"));
+    }
+    static std::string pathname(size_t i) {
+        return "/debug/ImageDecoder" + std::to_string(i);
+    }
+};
+
+TEST_F(ImageDecoderTest, unmounting_after_wait_keeps_the_decodes) {
+    std::vector<std::shared_future<Ego::ImageDecoder::DecodedImage>> images;
+    {
+        Ego::ImageDecoder decoder(2);
+        for (size_t i = 0; i < count; ++i) {
+            images.push_back(decoder.submit("mp_debug/ImageDecoder" + std::to_string(i)));
+        }
+        // Unmount while decodes are still running, like a module which is left while its textures stream in.
+        decoder.wait();
+        ASSERT_NE(0, vfs_remove_mount_point(Ego::VfsPath("mp_debug")));
+        for (const auto& image : images) {
+            ASSERT_EQ(std::future_status::ready, image.wait_for(std::chrono::seconds(0)));
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const auto& image = images[i].get();
+        ASSERT_NE(nullptr, image.second);
+        ASSERT_EQ(256, image.second->w);
+        ASSERT_EQ(256, image.second->h);
+    }
+}
+
+} } } // namespace Ego::Test::ImageDecoder
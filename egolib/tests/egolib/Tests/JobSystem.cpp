@@ -0,0 +1,169 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+
+namespace Ego { namespace Test { namespace JobSystem {
+
+struct Body {
+	float position[3];
+	float velocity[3];
+};
+
+/// A small physics-like world: bodies are integrated independently, bounces against the floor
+/// are reported to shared state via CommandBuffer::submit (like sounds played by particles).
+struct World {
+	std::vector<Body> bodies;
+	std::vector<size_t> events;  ///< ids of bounced bodies in the order they were reported
+	float energy = 0.0f;         ///< order-dependent floating-point sum over all bounces
+
+	explicit World(size_t count) : bodies(count) {
+		for (size_t i = 0; i < count; ++i) {
+			Body &body = bodies[i];
+			body.position[0] = static_cast<float>(i % 97);
+			body.position[1] = static_cast<float>(i % 89);
+			body.position[2] = 10.0f + static_cast<float>(i % 13) * 0.37f;
+			body.velocity[0] = 0.1f * static_cast<float>(i % 7) - 0.3f;
+			body.velocity[1] = 0.2f * static_cast<float>(i % 5) - 0.4f;
+			body.velocity[2] = 0.01f * static_cast<float>(i % 17);
+		}
+	}
+
+	void integrate(size_t i) {
+		Body &body = bodies[i];
+		body.velocity[2] -= 0.98f;
+		for (size_t k = 0; k < 3; ++k) {
+			body.position[k] += body.velocity[k];
+		}
+		if (body.position[2] < 0.0f) {
+			body.position[2] = -body.position[2] * 0.5f;
+			body.velocity[2] = -body.velocity[2] * 0.5f;
+			const float impact = body.velocity[2] * body.velocity[2];
+			CommandBuffer::submit([this, i, impact] {
+				events.push_back(i);
+				energy += impact;
+			});
+		}
+	}
+};
+
+static void stepSerial(World &world) {
+	for (size_t i = 0; i < world.bodies.size(); ++i) {
+		world.integrate(i);
+	}
+}
+
+static void stepParallel(World &world, size_t grainSize) {
+	Ego::JobSystem::get().parallelFor(world.bodies.size(), grainSize, [&world](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			world.integrate(i);
+		}
+	});
+}
+
+class JobSystemTest : public ::testing::Test {
+protected:
+	void SetUp() override {
+		Ego::JobSystem::initialize();
+	}
+
+	void TearDown() override {
+		Ego::JobSystem::uninitialize();
+	}
+};
+
+TEST_F(JobSystemTest, command_buffer_executes_immediately_if_not_recording) {
+	int value = 0;
+	ASSERT_FALSE(CommandBuffer::isRecording());
+	CommandBuffer::submit([&value] { value = 1; });
+	ASSERT_EQ(1, value);
+}
+
+TEST_F(JobSystemTest, command_buffer_replays_in_order) {
+	std::vector<int> order;
+	CommandBuffer buffer;
+	{
+		CommandBuffer::Recording recording(buffer);
+		for (int i = 0; i < 10; ++i) {
+			CommandBuffer::submit([&order, i] { order.push_back(i); });
+		}
+	}
+	ASSERT_TRUE(order.empty());
+	ASSERT_EQ(10, buffer.size());
+	buffer.replay();
+	ASSERT_EQ(0, buffer.size());
+	for (int i = 0; i < 10; ++i) {
+		ASSERT_EQ(i, order[i]);
+	}
+}
+
+TEST_F(JobSystemTest, parallel_for_visits_every_element_once) {
+	std::vector<int> visits(10007, 0);
+	Ego::JobSystem::get().parallelFor(visits.size(), 100, [&visits](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			visits[i]++;
+		}
+	});
+	for (int count : visits) {
+		ASSERT_EQ(1, count);
+	}
+}
+
+TEST_F(JobSystemTest, parallel_replay_is_bit_identical_to_serial) {
+	static const size_t BODIES = 5000;
+	static const size_t STEPS = 200;
+
+	for (size_t grainSize : {1, 7, 64, 1000}) {
+		World serial(BODIES), parallel(BODIES);
+		for (size_t step = 0; step < STEPS; ++step) {
+			stepSerial(serial);
+			stepParallel(parallel, grainSize);
+		}
+
+		ASSERT_EQ(0, std::memcmp(serial.bodies.data(), parallel.bodies.data(), BODIES * sizeof(Body)));
+		ASSERT_EQ(serial.events, parallel.events);
+		ASSERT_EQ(0, std::memcmp(&serial.energy, &parallel.energy, sizeof(float)));
+		ASSERT_FALSE(serial.events.empty());
+	}
+}
+
+TEST_F(JobSystemTest, parallel_for_discards_side_effects_of_failed_loops) {
+	if (0 == Ego::JobSystem::get().getWorkerCount()) {
+		return;
+	}
+	for (size_t failingChunk : {0, 5}) {
+		int replayed = 0;
+		ASSERT_THROW(Ego::JobSystem::get().parallelFor(1000, 100, [&replayed, failingChunk](size_t begin, size_t end) {
+			CommandBuffer::submit([&replayed] { replayed++; });
+			if (begin == failingChunk * 100) {
+				throw std::runtime_error("chunk failed");
+			}
+		}), std::runtime_error);
+		ASSERT_EQ(0, replayed);
+
+		// The next loop only replays its own side effects.
+		Ego::JobSystem::get().parallelFor(1000, 100, [&replayed](size_t begin, size_t end) {
+			CommandBuffer::submit([&replayed] { replayed++; });
+		});
+		ASSERT_EQ(10, replayed);
+	}
+}
+
+} } } // namespace Ego::Test::JobSystem
@@ -0,0 +1,283 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/lighting.h"
+#include "egolib/game/Graphics/KeyframeMd2ModelRenderer.hpp"
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace Ego { namespace Test { namespace KeyframeBlending {
+
+using Graphics::Md2ModelRenderer;
+
+/// Append a value to the contents of a model file.
+template <typename T>
+static void append(std::vector<char>& bytes, T value) {
+    value = Endian_HostToFile(value);
+    const char *p = reinterpret_cast<const char *>(&value);
+    bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+/// A MD2 model with random keyframes, triangle strips and triangle fans.
+struct aRandomMd2 {
+    int32_t vertexCount, frameCount;
+    std::vector<uint8_t> vertices; // x, y, z and the normal index of every vertex of every frame
+    std::vector<std::vector<int32_t>> commands; // the indices of a command, a strip if its first entry is positive
+
+    aRandomMd2(int32_t vertexCount, int32_t frameCount, size_t commandCount)
+        : vertexCount(vertexCount), frameCount(frameCount) {
+        for (int32_t i = 0; i < vertexCount * frameCount; ++i) {
+            for (size_t j = 0; j < 3; ++j) vertices.push_back((uint8_t)Random::next<int>(0, 255));
+            // including the "ambient only" normal
+            vertices.push_back((uint8_t)Random::next<int>(0, MD2_MAX_NORMALS));
+        }
+        for (size_t i = 0; i < commandCount; ++i) {
+            const int32_t count = Random::next<int>(3, 12);
+            std::vector<int32_t> command = { Random::next<int>(0, 1) ? count : -count };
+            for (int32_t j = 0; j < count; ++j) command.push_back(Random::next<int>(0, vertexCount - 1));
+            commands.push_back(command);
+        }
+    }
+
+    std::vector<char> bytes() const {
+        const int32_t frameSize = 40 + 4 * vertexCount;
+        int32_t commandSize = 1;
+        for (const auto& command : commands) commandSize += 1 + 3 * (int32_t(command.size()) - 1);
+        const int32_t skins = 68, st = skins + 64, tris = st + 4, frames = tris + 12,
+                      glcmds = frames + frameCount * frameSize, end = glcmds + 4 * commandSize;
+        std::vector<char> bytes;
+        for (int32_t value : { (int32_t)MD2_MAGIC_NUMBER, (int32_t)MD2_VERSION, 256, 256, frameSize,
+                               1, vertexCount, 1, 1, commandSize, frameCount,
+                               skins, st, tris, frames, glcmds, end }) {
+            append<int32_t>(bytes, value);
+        }
+        bytes.resize(st, '\0');
+        for (int16_t value : { 0, 0 }) append<int16_t>(bytes, value);
+        for (uint16_t value : { 0, 0, 0, 0, 0, 0 }) append<uint16_t>(bytes, value);
+        for (int32_t i = 0; i < frameCount; ++i) {
+            for (float value : { 1.0f, 1.0f, 1.0f, -128.0f, -128.0f, 0.0f }) append<float>(bytes, value);
+            bytes.resize(bytes.size() + 16, '\0');
+            bytes.insert(bytes.end(), vertices.begin() + 4 * i * vertexCount, vertices.begin() + 4 * (i + 1) * vertexCount);
+        }
+        for (const auto& command : commands) {
+            append<int32_t>(bytes, command[0]);
+            for (size_t j = 1; j < command.size(); ++j) {
+                append<float>(bytes, Random::nextFloat());
+                append<float>(bytes, Random::nextFloat());
+                append<int32_t>(bytes, command[j]);
+            }
+        }
+        append<int32_t>(bytes, 0);
+        return bytes;
+    }
+};
+
+/// Get a random lighting in model coordinates.
+static lighting_cache_t aRandomLighting() {
+    lighting_cache_t lighting;
+    for (lighting_cache_base_t *level : { &lighting.low, &lighting.hgh }) {
+        for (float& light : level->_lighting) light = (float)Random::next<int>(0, 255);
+    }
+    lighting.max_light();
+    return lighting;
+}
+
+/// Get a random state of an instance of a model.
+static Md2ModelRenderer::KeyframeBlend aRandomBlend(int frameCount, const lighting_cache_t& lighting) {
+    Md2ModelRenderer::KeyframeBlend blend;
+    blend.sourceFrameIndex = Random::next<int>(0, frameCount - 1);
+    blend.targetFrameIndex = Random::next<int>(0, frameCount - 1);
+    blend.flip = Random::nextFloat();
+    blend.uoffset = blend.voffset = 0.0f;
+    for (size_t i = 0; i < 3; ++i) blend.tint[i] = Random::nextFloat();
+    blend.tint[3] = 1.0f;
+    blend.lit = true;
+    blend.ambient = Random::nextFloat() * 0.25f;
+    blend.lighting = &lighting;
+    blend.flash = -1.0f;
+    blend.heightScale = 0.5f + Random::nextFloat();
+    blend.minZ = 0.0f;
+    blend.maxZ = 384.0f;
+    return blend;
+}
+
+/// Render an instance of a model like ObjectGraphicsRenderer::render_tex() from the vertices
+/// interpolated by the AnimatedVertexCache and lit by ObjectGraphics::updateLighting().
+static void renderBlendedOnCpu(MD2Model& model, const Md2ModelRenderer::KeyframeBlend& blend) {
+    const auto& frames = model.getFrames();
+    std::vector<GLvertex> vertices(model.getVertexCount());
+    Graphics::interpolateMD2Vertices(frames[blend.sourceFrameIndex].arrays, frames[blend.targetFrameIndex].arrays,
+                                     0, vertices.size() - 1, blend.flip, vertices.data());
+    const AxisAlignedBox3f bbox(Point3f(-1.0f, -1.0f, blend.minZ), Point3f(+1.0f, +1.0f, blend.maxZ));
+    for (const MD2_GLCommand& command : model.getGLCommands()) {
+        glBegin(command.glMode);
+        for (const id_glcmd_packed_t& cmd : command.data) {
+            if (cmd.index >= (int32_t)vertices.size()) continue;
+            const GLvertex& vertex = vertices[cmd.index];
+            GLint light = blend.flash;
+            if (blend.flash < 0.0f) {
+                const float height = vertex.pos[ZZ] * blend.heightScale + blend.heightScale;
+                if (0.0f == vertex.nrm[0] && 0.0f == vertex.nrm[1] && 0.0f == vertex.nrm[2]) {
+                    light = (lighting_cache_t::lighting_evaluate_cache(*blend.lighting, Vector3f(+1.0f, +1.0f, +1.0f), height, bbox, nullptr, nullptr) +
+                             lighting_cache_t::lighting_evaluate_cache(*blend.lighting, Vector3f(-1.0f, -1.0f, -1.0f), height, bbox, nullptr, nullptr)) / 6.0f;
+                } else {
+                    light = lighting_cache_t::lighting_evaluate_cache(*blend.lighting, Vector3f(vertex.nrm[0], vertex.nrm[1], vertex.nrm[2]), height, bbox, nullptr, nullptr);
+                }
+            }
+            const float colour = Ego::Math::constrain(light * idlib::fraction<float, 1, 255>() + blend.ambient, 0.0f, 1.0f);
+            glColor4f(colour * blend.tint[RR], colour * blend.tint[GG], colour * blend.tint[BB], 1.0f);
+            glVertex3f(vertex.pos[XX], vertex.pos[YY], vertex.pos[ZZ]);
+        }
+        glEnd();
+    }
+}
+
+/// Renders into a framebuffer of a surfaceless EGL context (e.g. Mesa's llvmpipe) and
+/// mounts the debug directory of the user directory to write models and to load them with MD2Model.
+struct KeyframeBlendingTest : public ::testing::Test {
+    static constexpr const char *pathname = "/debug/KeyframeBlending.md2";
+    static constexpr GLsizei size = 128;
+
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLContext context = EGL_NO_CONTEXT;
+    GLuint framebuffer = 0, colourBuffer = 0;
+    Graphics::KeyframeMd2ModelRenderer renderer;
+
+    void SetUp() override {
+        ASSERT_EQ(0, vfs_init(nullptr, nullptr));
+        ASSERT_NE(0, vfs_add_mount_point(fs_getUserDirectory(), Ego::FsPath("debug"), Ego::VfsPath("mp_debug"), 1));
+
+        auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (EGL_NO_DISPLAY == display || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_API)) {
+            GTEST_SKIP() << "no surfaceless EGL display";
+        }
+        const EGLint attributes[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+        EGLConfig config;
+        EGLint configCount = 0;
+        eglChooseConfig(display, attributes, &config, 1, &configCount);
+        context = eglCreateContext(display, 0 < configCount ? config : EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, nullptr);
+        if (EGL_NO_CONTEXT == context || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+            GTEST_SKIP() << "no OpenGL context";
+        }
+        // Without an X display GLEW fails after loading the OpenGL entry points.
+        glewExperimental = GL_TRUE;
+        glewInit();
+        if (!GLEW_VERSION_3_0 || !renderer.canBlendKeyframes()) {
+            GTEST_SKIP() << "OpenGL 3.0 is not available";
+        }
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glGenRenderbuffers(1, &colourBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, colourBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourBuffer);
+        ASSERT_EQ(GL_FRAMEBUFFER_COMPLETE, glCheckFramebufferStatus(GL_FRAMEBUFFER));
+        glViewport(0, 0, size, size);
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(-160.0, +160.0, -160.0, +160.0, -512.0, +512.0);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        glDisable(GL_TEXTURE_2D);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+    }
+
+    void TearDown() override {
+        if (EGL_NO_CONTEXT != context) {
+            renderer.release();
+            glDeleteRenderbuffers(1, &colourBuffer);
+            glDeleteFramebuffers(1, &framebuffer);
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(display, context);
+        }
+        if (EGL_NO_DISPLAY != display) {
+            eglTerminate(display);
+        }
+        vfs_delete_file(pathname);
+        vfs_remove_mount_point(Ego::VfsPath("mp_debug"));
+    }
+
+    std::shared_ptr<MD2Model> load(const aRandomMd2& md2) {
+        const auto bytes = md2.bytes();
+        vfs_FILE *file = vfs_openWrite(pathname);
+        if (!file) return nullptr;
+        vfs_write(bytes.data(), bytes.size(), 1, file);
+        vfs_close(file);
+        return MD2Model::loadFromFile("mp_debug/KeyframeBlending.md2");
+    }
+
+    std::vector<uint8_t> readPixels() {
+        std::vector<uint8_t> pixels(size * size * 4);
+        glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    }
+
+    /// Render an instance on the GPU and on the CPU and compare the images. The vertex positions
+    /// are computed with different instructions, so pixels on the edges of the triangles may differ.
+    void assertBlendsMatch(const std::shared_ptr<MD2Model>& model, const Md2ModelRenderer::KeyframeBlend& blend) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        ASSERT_TRUE(renderer.renderBlended(model, blend));
+        const auto received = readPixels();
+        glClear(GL_COLOR_BUFFER_BIT);
+        renderBlendedOnCpu(*model, blend);
+        const auto expected = readPixels();
+
+        size_t covered = 0, different = 0;
+        for (size_t i = 0; i < expected.size(); i += 4) {
+            int difference = 0;
+            for (size_t j = 0; j < 3; ++j) difference = std::max(difference, std::abs(expected[i + j] - received[i + j]));
+            if (0 != expected[i + 3]) ++covered;
+            if (1 < difference) ++different;
+        }
+        ASSERT_LT(0, covered);
+        ASSERT_GE(covered / 50, different) << different << " of " << covered << " pixels differ";
+    }
+};
+
+TEST_F(KeyframeBlendingTest, gpu_blend_matches_cpu_blend) {
+    const lighting_cache_t lighting = aRandomLighting();
+    for (int32_t vertexCount : { 3, 17, 256 }) {
+        const auto model = load(aRandomMd2(vertexCount, 3, 8));
+        ASSERT_NE(nullptr, model);
+        for (size_t i = 0; i < 8; ++i) {
+            assertBlendsMatch(model, aRandomBlend(3, lighting));
+        }
+    }
+}
+
+TEST_F(KeyframeBlendingTest, gpu_flash_matches_cpu_flash) {
+    const lighting_cache_t lighting = aRandomLighting();
+    const auto model = load(aRandomMd2(64, 2, 8));
+    ASSERT_NE(nullptr, model);
+    for (float flash : { 0.0f, 1.0f, 255.0f }) {
+        auto blend = aRandomBlend(2, lighting);
+        blend.flash = flash;
+        assertBlendsMatch(model, blend);
+    }
+}
+
+} } } // namespace Ego::Test::KeyframeBlending
@@ -0,0 +1,154 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+#include "egolib/Tests/utilities.hpp"
+#include <chrono>
+
+// The reference kernel must round like the kernels under test, which are compiled without contraction.
+#if defined(__clang__)
+    #pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+    #pragma fp_contract(off)
+#endif
+
+namespace Ego { namespace Test { namespace MD2Interpolation {
+
+using namespace Ego::Graphics;
+
+/// The vertex-by-vertex interpolation of the vertex lists.
+static void interpolateVertexLists(const MD2_Frame& source, const MD2_Frame& destination,
+                                   size_t first, size_t last, float flip, GLvertex *target) {
+    auto lerp = [flip](float a, float b) { return a + (b - a) * flip; };
+    for (size_t i = first; i <= last; ++i) {
+        const MD2_Vertex& a = source.vertexList[i], & b = destination.vertexList[i];
+        const MD2_Vertex& c = (1.0f == flip) ? b : a;
+        GLvertex& dst = target[i];
+        for (size_t j = 0; j < 3; ++j) {
+            dst.pos[j] = (0.0f == flip || 1.0f == flip) ? c.pos[j] : lerp(a.pos[j], b.pos[j]);
+            dst.nrm[j] = (0.0f == flip || 1.0f == flip) ? c.nrm[j] : lerp(a.nrm[j], b.nrm[j]);
+        }
+        dst.pos[WW] = 1.0f;
+        dst.env[XX] = (0.0f == flip || 1.0f == flip) ? MD2Model::getEnviroX(c.normal)
+                                                     : lerp(MD2Model::getEnviroX(a.normal), MD2Model::getEnviroX(b.normal));
+        dst.env[YY] = 0.5f * (1.0f + dst.nrm[ZZ]);
+    }
+}
+
+static void assertEqual(const std::vector<GLvertex>& expected, const std::vector<GLvertex>& received) {
+    ASSERT_EQ(expected.size(), received.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        for (size_t j = 0; j < 4; ++j) ASSERT_EQ(expected[i].pos[j], received[i].pos[j]) << "vertex " << i;
+        for (size_t j = 0; j < 3; ++j) ASSERT_EQ(expected[i].nrm[j], received[i].nrm[j]) << "vertex " << i;
+        for (size_t j = 0; j < 2; ++j) ASSERT_EQ(expected[i].env[j], received[i].env[j]) << "vertex " << i;
+    }
+}
+
+TEST(md2_interpolation_testing, scalar_and_vector_match_vertex_lists) {
+    for (size_t vertexCount : { 1, 3, 4, 5, 17, 64, 301 }) {
+        const MD2_Frame source = Utilities::aRandomFrame(vertexCount), destination = Utilities::aRandomFrame(vertexCount);
+        for (float flip : { 0.0f, 1.0f, 0.125f, 0.5f, 0.75f, Random::nextFloat() }) {
+            for (size_t k = 0; k < 8; ++k) {
+                size_t first = Random::next<size_t>(0, vertexCount - 1),
+                       last = Random::next<size_t>(0, vertexCount - 1);
+                if (last < first) std::swap(first, last);
+
+                std::vector<GLvertex> expected(vertexCount), scalar(vertexCount), vector(vertexCount);
+                interpolateVertexLists(source, destination, first, last, flip, expected.data());
+                interpolateMD2VerticesScalar(source.arrays, destination.arrays, first, last, flip, scalar.data());
+                interpolateMD2Vertices(source.arrays, destination.arrays, first, last, flip, vector.data());
+                assertEqual(expected, scalar);
+                assertEqual(expected, vector);
+            }
+        }
+    }
+}
+
+/// Time the interpolation of the models of animated characters, a character per model and update.
+static void benchmarkModels(const std::string& name, const std::vector<std::shared_ptr<MD2Model>>& models,
+                            const size_t numberOfCharacters, const size_t numberOfUpdates) {
+    std::vector<std::vector<GLvertex>> characters(numberOfCharacters);
+    for (size_t i = 0; i < numberOfCharacters; ++i) {
+        characters[i].resize(models[i % models.size()]->getFrames()[0].vertexList.size());
+    }
+
+    auto benchmark = [&](void (*interpolate)(const MD2_FrameArrays&, const MD2_FrameArrays&, size_t, size_t, float, GLvertex*)) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t update = 0; update < numberOfUpdates; ++update) {
+            for (size_t i = 0; i < numberOfCharacters; ++i) {
+                const auto& frames = models[i % models.size()]->getFrames();
+                const size_t frame = (update + i) % frames.size();
+                const float flip = 0.25f * (1 + (update + i) % 3);
+                interpolate(frames[frame].arrays, frames[(frame + 1) % frames.size()].arrays,
+                            0, characters[i].size() - 1, flip, characters[i].data());
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    };
+
+    const auto scalar = benchmark(&interpolateMD2VerticesScalar);
+    const auto vector = benchmark(&interpolateMD2Vertices);
+    std::cout << name << " (" << models.size() << " models): "
+              << numberOfUpdates << " updates of " << numberOfCharacters << " characters: "
+              << "scalar " << scalar << " us, "
+              << "vector " << vector << " us"
+              << std::endl;
+}
+
+TEST(md2_interpolation_testing, DISABLED_benchmark_random_models) {
+    // A module worth of models with 200 animated characters.
+    std::vector<std::shared_ptr<MD2Model>> models;
+    for (size_t i = 0; i < 40; ++i) {
+        models.push_back(Utilities::aRandomModel(Random::next<size_t>(100, 600), 16));
+    }
+    benchmarkModels("random models", models, 200, 100);
+}
+
+TEST(md2_interpolation_testing, DISABLED_benchmark_modules) {
+    GameDataModules data;
+    if (data.modules.empty()) {
+        GTEST_SKIP() << "EGOBOO_DATA is not set to a game data directory";
+    }
+    for (const auto& module : data.modules) {
+        std::vector<std::shared_ptr<MD2Model>> models;
+        SearchContext ctxt(Ego::VfsPath(module + "/objects"), Ego::Extension("obj"), VFS_SEARCH_DIR);
+        while (ctxt.hasData()) {
+            const std::string pathname = ctxt.getData().string() + "/tris.md2";
+            ctxt.nextData();
+            if (!vfs_exists(pathname)) {
+                continue;
+            }
+            auto model = MD2Model::loadFromFile(pathname);
+            if (model && !model->getFrames().empty() && !model->getFrames()[0].vertexList.empty()) {
+                models.push_back(model);
+            }
+        }
+        if (models.empty()) {
+            continue;
+        }
+        benchmarkModels(module, models, 200, 100);
+    }
+}
+
+} } } // namespace Ego::Test::MD2Interpolation
@@ -0,0 +1,156 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/mesh.h"
+#include "egolib/FileFormats/map_file.h"
+
+namespace Ego { namespace Test { namespace MeshLoading {
+
+/// Append a value to the contents of a map file.
+template <typename T>
+static void append(std::vector<char>& bytes, T value) {
+    value = Endian_HostToFile(value);
+    const char *p = reinterpret_cast<const char *>(&value);
+    bytes.insert(bytes.end(), p, p + sizeof(T));
+}
+
+/// A map of the current version with random tiles and vertices.
+struct aRandomMap {
+    uint32_t tileCountX, tileCountY, vertexCount;
+    std::vector<uint32_t> tiles;
+    std::vector<uint8_t> twists;
+    std::vector<float> x, y, z;
+    std::vector<uint8_t> lighting;
+
+    aRandomMap(uint32_t tileCountX, uint32_t tileCountY)
+        : tileCountX(tileCountX), tileCountY(tileCountY), vertexCount(tileCountX * tileCountY * 4) {
+        for (uint32_t i = 0; i < tileCountX * tileCountY; ++i) {
+            tiles.push_back((uint32_t)Random::next<int>(0, 255) << 24 | (uint32_t)Random::next<int>(0, 255) << 16 | (uint32_t)Random::next<int>(0, 0xffff));
+            twists.push_back((uint8_t)Random::next<int>(0, 255));
+        }
+        for (uint32_t i = 0; i < vertexCount; ++i) {
+            x.push_back((float)Random::next<int>(-4096, 4096));
+            y.push_back((float)Random::next<int>(-4096, 4096));
+            z.push_back((float)Random::next<int>(-4096, 4096));
+            lighting.push_back((uint8_t)Random::next<int>(0, 255));
+        }
+    }
+
+    std::vector<char> bytes() const {
+        std::vector<char> bytes = { 'M', 'a', 'p', CURRENT_MAP_VERSION_LETTER };
+        append<uint32_t>(bytes, vertexCount);
+        append<uint32_t>(bytes, tileCountX);
+        append<uint32_t>(bytes, tileCountY);
+        for (auto tile : tiles) append<uint32_t>(bytes, tile);
+        bytes.insert(bytes.end(), twists.begin(), twists.end());
+        for (auto v : x) append<float>(bytes, v);
+        for (auto v : y) append<float>(bytes, v);
+        for (auto v : z) append<float>(bytes, v);
+        bytes.insert(bytes.end(), lighting.begin(), lighting.end());
+        return bytes;
+    }
+};
+
+TEST(MeshLoading, decode) {
+    const aRandomMap map(8, 5);
+    const auto bytes = map.bytes();
+    auto mesh = MeshLoader().decode(bytes.data(), bytes.size());
+    ASSERT_NE(nullptr, mesh);
+    ASSERT_EQ(map.vertexCount, mesh->_info.getVertexCount());
+    ASSERT_EQ(map.tileCountX, mesh->_info.getTileCountX());
+    ASSERT_EQ(map.tileCountY, mesh->_info.getTileCountY());
+    for (uint32_t i = 0; i < map.tiles.size(); ++i) {
+        const auto& tile = mesh->_tmem.get(Index1D(i));
+        ASSERT_EQ(map.tiles[i] >> 24, tile._type);
+        ASSERT_EQ((map.tiles[i] >> 16) & 0xff, tile._base_fx);
+        ASSERT_EQ(map.tiles[i] & 0xffff, tile._img);
+        ASSERT_EQ(map.twists[i], tile._twist);
+        ASSERT_EQ(tile._base_fx, tile._pass_fx);
+        ASSERT_EQ(map.lighting[tile._vrtstart], tile._a);
+    }
+    for (uint32_t i = 0; i < map.vertexCount; ++i) {
+        ASSERT_EQ(map.x[i], mesh->_tmem._plst[i][XX]);
+        ASSERT_EQ(map.y[i], mesh->_tmem._plst[i][YY]);
+        ASSERT_EQ(map.z[i] / 16.0f, mesh->_tmem._plst[i][ZZ]);
+    }
+}
+
+/// Mounts the debug directory of the user directory to write maps and to load them with map_t.
+struct MeshLoadingTest : public ::testing::Test {
+    static constexpr const char *pathname = "/debug/MeshLoading.mpd";
+    void SetUp() override {
+        ASSERT_EQ(0, vfs_init(nullptr, nullptr));
+        ASSERT_NE(0, vfs_add_mount_point(fs_getUserDirectory(), Ego::FsPath("debug"), Ego::VfsPath("mp_debug"), 1));
+    }
+    void TearDown() override {
+        vfs_delete_file(pathname);
+        vfs_remove_mount_point(Ego::VfsPath("mp_debug"));
+    }
+};
+
+TEST_F(MeshLoadingTest, decode_matches_map_loading) {
+    for (const auto& size : { std::make_pair(1, 1), std::make_pair(8, 5), std::make_pair(33, 17) }) {
+        const auto bytes = aRandomMap(size.first, size.second).bytes();
+        vfs_FILE *file = vfs_openWrite(pathname);
+        ASSERT_NE(nullptr, file);
+        ASSERT_EQ(1, vfs_write(bytes.data(), bytes.size(), 1, file));
+        vfs_close(file);
+
+        map_t map;
+        ASSERT_TRUE(map.load("mp_debug/MeshLoading.mpd"));
+        auto expected = MeshLoader().convert(map);
+        auto received = MeshLoader().decode(bytes.data(), bytes.size());
+        ASSERT_NE(nullptr, expected);
+        ASSERT_NE(nullptr, received);
+
+        ASSERT_EQ(expected->_info.getVertexCount(), received->_info.getVertexCount());
+        ASSERT_EQ(expected->_info.getTileCountX(), received->_info.getTileCountX());
+        ASSERT_EQ(expected->_info.getTileCountY(), received->_info.getTileCountY());
+        for (Index1D i = 0; i < expected->_info.getTileCount(); ++i) {
+            const auto& x = expected->_tmem.get(i), & y = received->_tmem.get(i);
+            ASSERT_EQ(x._type, y._type);
+            ASSERT_EQ(x._img, y._img);
+            ASSERT_EQ(x._base_fx, y._base_fx);
+            ASSERT_EQ(x._pass_fx, y._pass_fx);
+            ASSERT_EQ(x._twist, y._twist);
+            ASSERT_EQ(x._vrtstart, y._vrtstart);
+            ASSERT_EQ(x._a, y._a);
+            ASSERT_EQ(x._l, y._l);
+        }
+        for (size_t i = 0; i < expected->_info.getVertexCount(); ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                ASSERT_EQ(expected->_tmem._plst[i][j], received->_tmem._plst[i][j]);
+                ASSERT_EQ(expected->_tmem._clst[i][j], received->_tmem._clst[i][j]);
+            }
+        }
+    }
+}
+
+TEST(MeshLoading, incomplete_or_older_maps_are_not_decoded) {
+    const aRandomMap map(3, 3);
+    auto bytes = map.bytes();
+    ASSERT_EQ(nullptr, MeshLoader().decode(bytes.data(), bytes.size() - 1));
+    ASSERT_EQ(nullptr, MeshLoader().decode(bytes.data(), 4));
+    bytes[3] = CURRENT_MAP_VERSION_LETTER - 1;
+    ASSERT_EQ(nullptr, MeshLoader().decode(bytes.data(), bytes.size()));
+}
+
+} } } // namespace Ego::Test::MeshLoading
@@ -0,0 +1,141 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/egoboo_setup.h"
+#include "egolib/fileutil.h"
+#include "egolib/Script/TextInputFile.hpp"
+#include "egolib/Profiles/ModuleProfile.hpp"
+#include "egolib/Profiles/ParticleProfile.hpp"
+#include "egolib/Profiles/EnchantProfile.hpp"
+#include "egolib/Tests/utilities.hpp"
+#include <chrono>
+
+namespace Ego { namespace Test { namespace ModuleLoading {
+
+/// Get the pathnames of the files with an extension in a directory.
+static std::vector<std::string> filesIn(const std::string& directory, const std::string& extension) {
+    std::vector<std::string> files;
+    SearchContext ctxt(Ego::VfsPath(directory), Ego::Extension(extension), VFS_SEARCH_FILE);
+    while (ctxt.hasData()) {
+        files.push_back(ctxt.getData().string());
+        ctxt.nextData();
+    }
+    return files;
+}
+
+/// Get the pathnames of the directories with an extension in a directory.
+static std::vector<std::string> directoriesIn(const std::string& directory, const std::string& extension) {
+    std::vector<std::string> directories;
+    SearchContext ctxt(Ego::VfsPath(directory), Ego::Extension(extension), VFS_SEARCH_DIR);
+    while (ctxt.hasData()) {
+        directories.push_back(ctxt.getData().string());
+        ctxt.nextData();
+    }
+    return directories;
+}
+
+TEST(module_loading_testing, DISABLED_benchmark_modules) {
+    GameDataModules data;
+    if (data.modules.empty()) {
+        GTEST_SKIP() << "EGOBOO_DATA is not set to a game data directory";
+    }
+    // Parse the files instead of reading the cooked profiles.
+    auto& profileCache = egoboo_config_t::get().game_profileCache_enable;
+    const bool useProfileCache = profileCache.getValue();
+    profileCache.setValue(false);
+
+    // The text files of the modules and of their objects.
+    std::vector<std::string> textFiles, particleFiles, enchantFiles;
+    for (const auto& module : data.modules) {
+        for (const auto& file : filesIn(module + "/gamedat", "txt")) {
+            textFiles.push_back(file);
+        }
+        for (const auto& object : directoriesIn(module + "/objects", "obj")) {
+            for (const auto& file : filesIn(object, "txt")) {
+                textFiles.push_back(file);
+                const std::string name = file.substr(object.size() + 1);
+                if (0 == name.compare(0, 4, "part")) {
+                    particleFiles.push_back(file);
+                } else if ("enchant.txt" == name) {
+                    enchantFiles.push_back(file);
+                }
+            }
+        }
+    }
+
+    size_t loadedModules = 0;
+    auto startModules = std::chrono::high_resolution_clock::now();
+    for (const auto& module : data.modules) {
+        if (ModuleProfile::loadFromFile(module)) {
+            loadedModules++;
+        }
+    }
+    auto endModules = std::chrono::high_resolution_clock::now();
+
+    size_t scanned = 0;
+    auto startScanner = std::chrono::high_resolution_clock::now();
+    for (const auto& file : textFiles) {
+        ReadContext ctxt(file);
+        while (!ctxt.ise(ReadContext::END_OF_INPUT())) {
+            ctxt.next();
+            scanned++;
+        }
+    }
+    auto endScanner = std::chrono::high_resolution_clock::now();
+
+    size_t read = 0;
+    auto startTextInputFile = std::chrono::high_resolution_clock::now();
+    for (const auto& file : textFiles) {
+        Script::TextInputFile<> input(file);
+        for (input.advance(); Script::Traits<char>::endOfInput() != input.get() && Script::Traits<char>::error() != input.get(); input.advance()) {
+            read++;
+        }
+    }
+    auto endTextInputFile = std::chrono::high_resolution_clock::now();
+
+    size_t loadedProfiles = 0;
+    auto startProfiles = std::chrono::high_resolution_clock::now();
+    for (const auto& file : particleFiles) {
+        if (ParticleProfile::readFromFile(file)) {
+            loadedProfiles++;
+        }
+    }
+    for (const auto& file : enchantFiles) {
+        if (EnchantProfile::readFromFile(file)) {
+            loadedProfiles++;
+        }
+    }
+    auto endProfiles = std::chrono::high_resolution_clock::now();
+
+    profileCache.setValue(useProfileCache);
+
+    std::cout << loadedModules << " modules "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endModules - startModules).count() << " us, "
+              << textFiles.size() << " text files (" << scanned << " characters) scanner "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endScanner - startScanner).count() << " us, "
+              << "text input file (" << read << " characters) "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endTextInputFile - startTextInputFile).count() << " us, "
+              << loadedProfiles << " particle and enchant profiles "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endProfiles - startProfiles).count() << " us"
+              << std::endl;
+}
+
+} } } // namespace Ego::Test::ModuleLoading
@@ -0,0 +1,136 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/graphic.h"
+#include "egolib/game/mesh.h"
+#include "egolib/game/Graphics/TileList.hpp"
+
+namespace Ego { namespace Test { namespace ParallelLighting {
+
+/// A terrain of tiles with four vertices, random heights, normals, grid lighting and reflective tiles.
+struct aRandomlyLitTerrain {
+    size_t tileCountX, tileCountY;
+    std::vector<float> heights, normals;
+    std::vector<LightingVector> lighting; // the low and the high lighting of every tile
+    std::vector<bool> reflective;
+
+    aRandomlyLitTerrain(size_t tileCountX, size_t tileCountY)
+        : tileCountX(tileCountX), tileCountY(tileCountY) {
+        for (size_t i = 0; i < tileCountX * tileCountY; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                heights.push_back((float)Random::next<int>(0, 512));
+                const Vector3f normal = normalize(Vector3f(Random::nextFloat() - 0.5f, Random::nextFloat() - 0.5f, 1.0f)).get_vector();
+                for (size_t k = 0; k < 3; ++k) normals.push_back(normal[k]);
+            }
+            for (size_t j = 0; j < 2; ++j) {
+                LightingVector vector;
+                for (float& light : vector) light = (float)Random::next<int>(0, 255);
+                lighting.push_back(vector);
+            }
+            reflective.push_back(0 == Random::next<int>(0, 3));
+        }
+    }
+
+    std::shared_ptr<ego_mesh_t> build() const {
+        static const float ix_off[4] = { 0.0f, 1.0f, 1.0f, 0.0f },
+                           iy_off[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+        const float size = Info<float>::Grid::Size();
+        auto mesh = std::make_shared<ego_mesh_t>(MeshInfo(4 * tileCountX * tileCountY, tileCountX, tileCountY));
+        mesh->_tmem._bbox = AxisAlignedBox3f(Point3f(0.0f, 0.0f, 0.0f), Point3f(tileCountX * size, tileCountY * size, 512.0f));
+        for (size_t i = 0; i < tileCountX * tileCountY; ++i) {
+            ego_tile_info_t& tile = mesh->_tmem.get(Index1D(i));
+            tile._vrtstart = 4 * i;
+            for (size_t j = 0; j < 4; ++j) {
+                GLXvector3f& position = mesh->_tmem._plst[4 * i + j];
+                position[XX] = (i % tileCountX + ix_off[j]) * size;
+                position[YY] = (i / tileCountX + iy_off[j]) * size;
+                position[ZZ] = heights[4 * i + j];
+                for (size_t k = 0; k < 3; ++k) tile._ncache[j][k] = normals[3 * (4 * i + j) + k];
+            }
+            tile._cache.low._lighting = lighting[2 * i + 0];
+            tile._cache.hgh._lighting = lighting[2 * i + 1];
+            tile._cache.max_light();
+            if (reflective[i]) tile.setFX(MAPFX_REFLECTIVE);
+        }
+        return mesh;
+    }
+};
+
+/// Light all tiles of a mesh in a frame.
+static void light(ego_mesh_t& mesh, bool parallel, uint32_t frame) {
+    egoboo_config_t::get().graphic_parallelLighting_enable.setValue(parallel);
+    std::vector<Graphics::ClippingEntry> tiles;
+    for (Index1D i = 0; i < mesh._info.getTileCount(); ++i) {
+        tiles.emplace_back(i, 0.0f);
+    }
+    GridIllumination::light_fans(mesh, tiles, frame);
+}
+
+class ParallelLightingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Ego::JobSystem::initialize();
+    }
+
+    void TearDown() override {
+        egoboo_config_t::get().graphic_parallelLighting_enable.setValue(true);
+        Ego::JobSystem::uninitialize();
+    }
+};
+
+TEST_F(ParallelLightingTest, parallel_lighting_is_bit_identical_to_serial) {
+    for (const auto& size : { std::make_pair(1, 1), std::make_pair(7, 3), std::make_pair(64, 48) }) {
+        const aRandomlyLitTerrain terrain(size.first, size.second);
+        auto expected = terrain.build(), received = terrain.build();
+        for (uint32_t frame = 0; frame < 32; ++frame) {
+            light(*expected, false, frame);
+            light(*received, true, frame);
+            for (Index1D i = 0; i < expected->_info.getTileCount(); ++i) {
+                const auto& x = expected->_tmem.get(i), & y = received->_tmem.get(i);
+                ASSERT_EQ(x._lightingCache.getNeedUpdate(), y._lightingCache.getNeedUpdate());
+                ASSERT_EQ(x._lightingCache._lastFrame, y._lightingCache._lastFrame);
+                ASSERT_EQ(x._vertexLightingCache.getNeedUpdate(), y._vertexLightingCache.getNeedUpdate());
+                ASSERT_EQ(x._vertexLightingCache._lastFrame, y._vertexLightingCache._lastFrame);
+                ASSERT_EQ(0, std::memcmp(x._lightingCache._contents.data(), y._lightingCache._contents.data(), sizeof(light_cache_t)));
+                ASSERT_EQ(0, std::memcmp(x._vertexLightingCache._d1_cache.data(), y._vertexLightingCache._d1_cache.data(), sizeof(light_cache_t)));
+                ASSERT_EQ(0, std::memcmp(x._vertexLightingCache._d2_cache.data(), y._vertexLightingCache._d2_cache.data(), sizeof(light_cache_t)));
+            }
+            ASSERT_EQ(0, std::memcmp(expected->_tmem._clst.get(), received->_tmem._clst.get(), sizeof(GLXvector3f) * expected->_info.getVertexCount()));
+        }
+    }
+}
+
+TEST_F(ParallelLightingTest, changing_the_fx_of_a_tile_relights_it) {
+    auto mesh = aRandomlyLitTerrain(7, 3).build();
+    for (Index1D i = 0; i < mesh->_info.getTileCount(); ++i) {
+        mesh->_tmem.get(i)._lightingCache.setNeedUpdate(false);
+    }
+    for (Index1D i = 0; i < mesh->_info.getTileCount(); ++i) {
+        if (0 != mesh->test_fx(i, MAPFX_REFLECTIVE)) {
+            ASSERT_TRUE(mesh->clear_fx(i, MAPFX_REFLECTIVE));
+        } else {
+            ASSERT_TRUE(mesh->add_fx(i, MAPFX_REFLECTIVE));
+        }
+        ASSERT_TRUE(mesh->_tmem.get(i)._lightingCache.getNeedUpdate());
+    }
+}
+
+} } } // namespace Ego::Test::ParallelLighting
@@ -0,0 +1,151 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/Core/CacheEntry.hpp"
+#include "egolib/Profiles/ProfileCache.hpp"
+
+namespace Ego { namespace Test { namespace ProfileCache {
+
+/// Build a particle profile with random values.
+static std::shared_ptr<ParticleProfile> aRandomParticleProfile() {
+    auto profile = std::make_shared<ParticleProfile>();
+    profile->soundspawn = Random::next<int>(-1, 30);
+    profile->force = Random::nextBool();
+    profile->end_time = Random::next<int>(-1, 1000);
+    profile->end_bump = Random::nextBool();
+    profile->end_sound_floor = Random::next<int>(-1, 30);
+    profile->contspawn._amount = Random::next<int>(0, 255);
+    profile->contspawn._delay = Random::next<int>(0, 1000);
+    profile->contspawn._lpip = LocalParticleProfileRef(Random::next<int>(-1, 29));
+    profile->endspawn._facingAdd = Random::next<int>(0, 0xFFFF);
+    profile->bumpspawn._lpip = LocalParticleProfileRef(Random::next<int>(-1, 29));
+    profile->bump_height = Random::next<int>(0, 1000);
+    profile->damage = idlib::interval<float>(Random::next<int>(0, 100), Random::next<int>(100, 200));
+    profile->damageType = static_cast<DamageType>(Random::next<int>(0, DAMAGE_COUNT - 1));
+    profile->lifeDrain = Random::next<int>(0, 0xFFFF);
+    profile->homing = Random::nextBool();
+    profile->homingaccel = Random::next<int>(0, 100) / 100.0f;
+    profile->dynalight.mode = DYNA_MODE_LOCAL;
+    profile->dynalight.falloff_add = Random::next<int>(-1000, 1000) / 1000.0f;
+    profile->type = SPRITE_LIGHT;
+    profile->image_add.base = Random::next<int>(-100, 100);
+    profile->rotate_add = Random::next<int>(-100, 100);
+    profile->orientation = prt_ori_t::ORIENTATION_V;
+    return profile;
+}
+
+/// Build an enchant profile with random values.
+static std::shared_ptr<EnchantProfile> aRandomEnchantProfile() {
+    auto profile = std::make_shared<EnchantProfile>();
+    profile->retarget = Random::nextBool();
+    profile->required_damagetype = static_cast<DamageType>(Random::next<int>(0, DAMAGE_COUNT - 1));
+    profile->lifetime = Random::next<int>(-1, 1000);
+    profile->removedByIDSZ = IDSZ2("HEAL");
+    profile->_owner._manaDrain = Random::next<int>(-100, 100) / 10.0f;
+    profile->_target._stay = Random::nextBool();
+    for (auto& modifier : profile->_set) {
+        modifier.apply = Random::nextBool();
+        modifier.value = Random::next<int>(-100, 100);
+    }
+    for (auto& modifier : profile->_add) {
+        modifier.apply = Random::nextBool();
+        modifier.value = Random::next<int>(-100, 100) / 10.0f;
+    }
+    profile->contspawn._lpip = LocalParticleProfileRef(Random::next<int>(-1, 29));
+    profile->endmessage = Random::next<int>(-1, 10);
+    profile->setEnchantName("Enchant " + std::to_string(Random::next<int>(0, 1000)));
+    return profile;
+}
+
+static uint64_t aHash(size_t i) {
+    return CacheEntry::hash((const char *)&i, sizeof(i));
+}
+
+TEST(profile_cache_testing, particle_profiles_round_trip) {
+    for (size_t i = 0; i < 100; ++i) {
+        const auto expected = aRandomParticleProfile();
+        const auto entry = Ego::ProfileCache::encode(aHash(i), *expected);
+
+        auto received = std::make_shared<ParticleProfile>();
+        ASSERT_TRUE(Ego::ProfileCache::decode(entry, aHash(i), *received));
+        ASSERT_EQ(entry, Ego::ProfileCache::encode(aHash(i), *received));
+        ASSERT_EQ(expected->end_time, received->end_time);
+        ASSERT_EQ(expected->contspawn._lpip, received->contspawn._lpip);
+        ASSERT_EQ(expected->damage.lower(), received->damage.lower());
+        ASSERT_EQ(expected->damage.upper(), received->damage.upper());
+        ASSERT_EQ(expected->dynalight.falloff_add, received->dynalight.falloff_add);
+        ASSERT_EQ(expected->image_add, received->image_add);
+    }
+}
+
+TEST(profile_cache_testing, enchant_profiles_round_trip) {
+    for (size_t i = 0; i < 100; ++i) {
+        const auto expected = aRandomEnchantProfile();
+        const auto entry = Ego::ProfileCache::encode(aHash(i), *expected);
+
+        auto received = std::make_shared<EnchantProfile>();
+        ASSERT_TRUE(Ego::ProfileCache::decode(entry, aHash(i), *received));
+        ASSERT_EQ(entry, Ego::ProfileCache::encode(aHash(i), *received));
+        ASSERT_EQ(expected->removedByIDSZ, received->removedByIDSZ);
+        ASSERT_EQ(expected->_owner._manaDrain, received->_owner._manaDrain);
+        ASSERT_EQ(expected->getEnchantName(), received->getEnchantName());
+    }
+}
+
+TEST(profile_cache_testing, object_profiles_round_trip) {
+    const auto expected = std::make_shared<ObjectProfile>();
+    const auto entry = Ego::ProfileCache::encode(aHash(0), *expected);
+
+    auto received = std::make_shared<ObjectProfile>();
+    ASSERT_TRUE(Ego::ProfileCache::decode(entry, aHash(0), *received));
+    ASSERT_EQ(entry, Ego::ProfileCache::encode(aHash(0), *received));
+    ASSERT_EQ(expected->getClassName(), received->getClassName());
+    ASSERT_EQ(expected->getSkinOverride(), received->getSkinOverride());
+}
+
+TEST(profile_cache_testing, invalid_entries_are_rejected) {
+    const auto profile = aRandomParticleProfile();
+    const auto entry = Ego::ProfileCache::encode(aHash(0), *profile);
+    auto received = std::make_shared<ParticleProfile>();
+
+    // Another source.
+    ASSERT_FALSE(Ego::ProfileCache::decode(entry, aHash(1), *received));
+
+    // Another kind of profile.
+    auto enchant = std::make_shared<EnchantProfile>();
+    ASSERT_FALSE(Ego::ProfileCache::decode(entry, aHash(0), *enchant));
+
+    // Truncated entries.
+    for (size_t size : { size_t(0), size_t(4), entry.size() / 2, entry.size() - 1 }) {
+        ASSERT_FALSE(Ego::ProfileCache::decode(std::vector<char>(entry.begin(), entry.begin() + size), aHash(0), *received));
+    }
+
+    // Corrupted entries, including the version.
+    for (size_t position = 0; position < entry.size(); position += 7) {
+        auto corrupted = entry;
+        corrupted[position] ^= 0x10;
+        ASSERT_FALSE(Ego::ProfileCache::decode(corrupted, aHash(0), *received));
+    }
+
+    ASSERT_TRUE(Ego::ProfileCache::decode(entry, aHash(0), *received));
+}
+
+} } } // namespace Ego::Test::ProfileCache
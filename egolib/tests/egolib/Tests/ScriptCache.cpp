@@ -0,0 +1,130 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/Script/script.h"
+#include "egolib/Script/ScriptCache.hpp"
+#include "egolib/game/script_compile.h"
+
+namespace Ego { namespace Test { namespace ScriptCache {
+
+using Ego::Script::CachedLiteral;
+
+/// Build an instruction list of random instructions referring to random constants.
+static InstructionList aRandomInstructionList(size_t numberOfInstructions) {
+    InstructionList instructions;
+    for (size_t i = 0; i < numberOfInstructions; ++i) {
+        Ego::Script::ConstantPool::Index index;
+        if (Random::next<int>(0, 9) == 0) {
+            index = instructions.getConstantPool().getOrCreateConstant("constant " + std::to_string(Random::next<int>(0, 7)));
+        } else {
+            index = instructions.getConstantPool().getOrCreateConstant(Random::next<int>(-1000, 1000));
+        }
+        instructions.append(Instruction((Random::nextBool() ? Instruction::FUNCTIONBITS : 0) | SetDataBits(Random::next<int>(0, 15)) | index));
+    }
+    return instructions;
+}
+
+static std::vector<CachedLiteral> someLiterals() {
+    return { { CachedLiteral::Kind::Message, "Hello world!", 3 },
+             { CachedLiteral::Kind::Reference, "book.obj", 57 },
+             { CachedLiteral::Kind::Message, "", 0 },
+             { CachedLiteral::Kind::Reference, "nothing.obj", INVALID_PRO_REF } };
+}
+
+static void assertEqual(const InstructionList& x, const InstructionList& y) {
+    ASSERT_EQ(x.getNumberOfInstructions(), y.getNumberOfInstructions());
+    for (InstructionList::Index i = 0; i < x.getNumberOfInstructions(); ++i) {
+        ASSERT_EQ(x[i].getBits(), y[i].getBits());
+    }
+    ASSERT_EQ(x.getConstantPool().getNumberOfConstants(), y.getConstantPool().getNumberOfConstants());
+    for (Ego::Script::ConstantPool::Index i = 0; i < x.getConstantPool().getNumberOfConstants(); ++i) {
+        ASSERT_TRUE(x.getConstantPool().getConstant(i) == y.getConstantPool().getConstant(i));
+    }
+}
+
+TEST(script_cache_testing, round_trip) {
+    for (size_t i = 0; i < 100; ++i) {
+        const auto expectedInstructions = aRandomInstructionList(Random::next<int>(0, MAXAICOMPILESIZE));
+        const auto expectedLiterals = i % 2 ? someLiterals() : std::vector<CachedLiteral>();
+        const uint64_t hash = Ego::Script::ScriptCache::hash((const char *)&i, sizeof(i));
+        const auto entry = Ego::Script::ScriptCache::encode(hash, expectedInstructions, expectedLiterals);
+
+        InstructionList receivedInstructions;
+        std::vector<CachedLiteral> receivedLiterals;
+        ASSERT_TRUE(Ego::Script::ScriptCache::decode(entry, hash, receivedInstructions, receivedLiterals));
+        assertEqual(expectedInstructions, receivedInstructions);
+        ASSERT_EQ(expectedLiterals, receivedLiterals);
+    }
+}
+
+TEST(script_cache_testing, invalid_entries_are_rejected) {
+    const auto instructions = aRandomInstructionList(64);
+    const std::string source = "IfSpawned\n  DoNothing\nEnd\n";
+    const uint64_t hash = Ego::Script::ScriptCache::hash(source.data(), source.size());
+    const auto entry = Ego::Script::ScriptCache::encode(hash, instructions, someLiterals());
+
+    InstructionList receivedInstructions;
+    std::vector<CachedLiteral> receivedLiterals;
+
+    // Another source.
+    const std::string otherSource = "IfSpawned\n  DoNothing\nEnd\n\n";
+    ASSERT_NE(hash, Ego::Script::ScriptCache::hash(otherSource.data(), otherSource.size()));
+    ASSERT_FALSE(Ego::Script::ScriptCache::decode(entry, Ego::Script::ScriptCache::hash(otherSource.data(), otherSource.size()),
+                                                  receivedInstructions, receivedLiterals));
+
+    // Truncated entries.
+    for (size_t size : { size_t(0), size_t(4), entry.size() / 2, entry.size() - 1 }) {
+        ASSERT_FALSE(Ego::Script::ScriptCache::decode(std::vector<char>(entry.begin(), entry.begin() + size), hash,
+                                                      receivedInstructions, receivedLiterals));
+    }
+
+    // Corrupted entries, including the version.
+    for (size_t position = 0; position < entry.size(); position += 7) {
+        auto corrupted = entry;
+        corrupted[position] ^= 0x10;
+        ASSERT_FALSE(Ego::Script::ScriptCache::decode(corrupted, hash, receivedInstructions, receivedLiterals));
+    }
+
+    ASSERT_TRUE(Ego::Script::ScriptCache::decode(entry, hash, receivedInstructions, receivedLiterals));
+}
+
+TEST(script_cache_testing, entries_of_other_versions_are_rejected) {
+    const auto instructions = aRandomInstructionList(64);
+    const uint64_t hash = Ego::Script::ScriptCache::hash("script", 6);
+    const auto entry = Ego::Script::ScriptCache::encode(hash, instructions, someLiterals());
+    ASSERT_EQ(0, Ego::Script::ScriptCache::getPathname(hash).find(Ego::Script::ScriptCache::getDirectory() + "/"));
+
+    // Change the version (which follows the magic) and compute the checksum of the changed entry.
+    auto other = std::vector<char>(entry.begin(), entry.end() - 8);
+    other[4] ^= 0x01;
+    const uint64_t checksum = Ego::Script::ScriptCache::hash(other.data(), other.size());
+    for (size_t i = 0; i < 8; ++i) {
+        other.push_back(static_cast<char>(checksum >> (8 * i)));
+    }
+
+    InstructionList receivedInstructions;
+    std::vector<CachedLiteral> receivedLiterals;
+    ASSERT_FALSE(Ego::Script::ScriptCache::decode(other, hash, receivedInstructions, receivedLiterals));
+    ASSERT_TRUE(Ego::Script::ScriptCache::decode(entry, hash, receivedInstructions, receivedLiterals));
+}
+
+} } } // namespace Ego::Test::ScriptCache
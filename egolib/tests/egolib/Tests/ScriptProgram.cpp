@@ -0,0 +1,241 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/Script/script.h"
+#include "egolib/game/script_compile.h"
+
+namespace Ego { namespace Test { namespace Script {
+
+/// A script environment without a module.
+/// Function results and variable values are pseudo-random but reproducible.
+/// Every invocation and every load is recorded so that two runs can be compared.
+struct TestEnvironment {
+    std::mt19937 generator;
+    bool selfExists;
+    std::vector<std::array<int32_t, 6>> trace;
+
+    TestEnvironment(uint32_t seed, bool selfExists) : generator(seed), selfExists(selfExists), trace() {
+    }
+
+    uint8_t invoke(uint32_t functionIndex, Ego::Script::NativeInterface::Function *, script_state_t& state, ai_state_t& aiState) {
+        trace.push_back({ static_cast<int32_t>(functionIndex), state.x, state.y, state.turn, state.distance, state.argument });
+        if (Ego::Script::ScriptFunctions::End == functionIndex) {
+            aiState.terminate = true;
+            return false;
+        }
+        return std::uniform_int_distribution<int>(0, 1)(generator);
+    }
+
+    bool resolve(ai_state_t&, script_state_t::Objects& objects) {
+        objects.self = objects.target = objects.owner = nullptr;
+        return selfExists;
+    }
+
+    int32_t load(uint8_t variableIndex, script_state_t&, ai_state_t&, const script_state_t::Objects&) {
+        int32_t value = std::uniform_int_distribution<int32_t>(1, 7)(generator);
+        trace.push_back({ -1, variableIndex, value, 0, 0, 0 });
+        return value;
+    }
+};
+
+struct Outcome {
+    std::vector<std::array<int32_t, 6>> trace;
+    std::array<int32_t, 5> variables;
+    uint32_t indent, indent_last;
+    size_t position;
+    bool terminate;
+};
+
+static void assertEqual(const Outcome& x, const Outcome& y) {
+    ASSERT_EQ(x.trace, y.trace);
+    ASSERT_EQ(x.variables, y.variables);
+    ASSERT_EQ(x.indent, y.indent);
+    ASSERT_EQ(x.indent_last, y.indent_last);
+    ASSERT_EQ(x.position, y.position);
+    ASSERT_EQ(x.terminate, y.terminate);
+}
+
+static Outcome run(script_info_t& script, bool decoded, uint32_t seed, bool selfExists) {
+    TestEnvironment environment(seed, selfExists);
+    script_state_t state;
+    ai_state_t aiState;
+    script.indent = script.indent_last = 0;
+    script.set_pos(0);
+    if (decoded) {
+        state.run_program(aiState, script, environment);
+    }
+    state.run_instructions(aiState, script, environment);
+    return { environment.trace, { state.x, state.y, state.turn, state.distance, state.argument },
+             script.indent, script.indent_last, script.get_pos(), aiState.terminate };
+}
+
+static void emitFunction(script_info_t& script, int indent, int functionIndex) {
+    auto& instructions = script._instructions;
+    instructions.append(Instruction(Instruction::FUNCTIONBITS | SetDataBits(indent) | instructions.getConstantPool().getOrCreateConstant(functionIndex)));
+    instructions.append(Instruction(0));
+}
+
+struct Operand {
+    int operation;
+    bool isConstant;
+    int value;
+};
+
+static void emitOperation(script_info_t& script, int indent, int variableIndex, const std::vector<Operand>& operands) {
+    auto& instructions = script._instructions;
+    instructions.append(Instruction(SetDataBits(indent) | instructions.getConstantPool().getOrCreateConstant(variableIndex)));
+    instructions.append(Instruction(operands.size()));
+    for (const auto& operand : operands) {
+        instructions.append(Instruction((operand.isConstant ? Instruction::FUNCTIONBITS : 0) | SetDataBits(operand.operation) |
+                                        instructions.getConstantPool().getOrCreateConstant(operand.value)));
+    }
+}
+
+/// Build a script of nested conditions and assignments like the ones produced by the script compiler.
+static script_info_t aRandomScript(size_t numberOfLines) {
+    static const int storableVariables[] = { Ego::Script::VARTMPX, Ego::Script::VARTMPY, Ego::Script::VARTMPDISTANCE,
+                                             Ego::Script::VARTMPTURN, Ego::Script::VARTMPARGUMENT };
+    script_info_t script;
+    int indent = 0, maximumIndent = 0;
+    for (size_t i = 0; i < numberOfLines; ++i) {
+        indent = Random::next<int>(0, maximumIndent);
+        if (Random::nextBool()) {
+            int functionIndex;
+            do {
+                functionIndex = Random::next<int>(0, Ego::Script::SCRIPT_FUNCTIONS_COUNT - 1);
+            } while (Ego::Script::ScriptFunctions::End == functionIndex);
+            emitFunction(script, indent, functionIndex);
+            maximumIndent = std::min(indent + 1, 15);
+        } else {
+            std::vector<Operand> operands(Random::next<int>(0, 4));
+            for (auto& operand : operands) {
+                // Shifting negative values to the left is undefined.
+                do {
+                    operand.operation = Random::next<int>(Ego::Script::OPADD, Ego::Script::OPMOD);
+                } while (Ego::Script::OPSHL == operand.operation);
+                operand.isConstant = Random::nextBool();
+                operand.value = operand.isConstant ? Random::next<int>(1, 7) : Random::next<int>(0, Ego::Script::SCRIPT_VARIABLES_COUNT - 1);
+            }
+            emitOperation(script, indent, storableVariables[Random::next<int>(0, 4)], operands);
+            maximumIndent = indent;
+        }
+    }
+    emitFunction(script, 0, Ego::Script::ScriptFunctions::End);
+    parser_state_t::parse_jumps(script);
+    return script;
+}
+
+/// Get the decoded instruction which leaves the program where decoding stopped.
+static const DecodedInstruction& getEnd(const DecodedProgram& program) {
+    return *std::find_if(program.instructions.cbegin(), program.instructions.cend(),
+                         [](const DecodedInstruction& instruction) { return DecodedInstruction::Kind::Leave == instruction.kind; });
+}
+
+struct ScriptProgramTest : public ::testing::Test {
+    void SetUp() override {
+        Ego::Script::Runtime::initialize();
+    }
+    void TearDown() override {
+        Ego::Script::Runtime::uninitialize();
+    }
+};
+
+TEST_F(ScriptProgramTest, decoded_program_matches_interpreter) {
+    for (size_t i = 0; i < 200; ++i) {
+        auto script = aRandomScript(Random::next<int>(1, 64));
+        script._program.decode(script._instructions);
+        // Everything the compiler emits can be decoded.
+        ASSERT_EQ(script._instructions.getNumberOfInstructions(), getEnd(script._program).position);
+        for (uint32_t seed = 0; seed < 4; ++seed) {
+            for (bool selfExists : { true, false }) {
+                auto expected = run(script, false, seed, selfExists);
+                auto received = run(script, true, seed, selfExists);
+                assertEqual(expected, received);
+            }
+        }
+    }
+}
+
+TEST_F(ScriptProgramTest, leading_constants_are_folded) {
+    script_info_t script;
+    // tmpx = 2 + 3 * tmpy + 4 (evaluated from left to right)
+    emitOperation(script, 0, Ego::Script::VARTMPX, { { Ego::Script::OPADD, true, 2 },
+                                                     { Ego::Script::OPADD, true, 3 },
+                                                     { Ego::Script::OPMUL, false, Ego::Script::VARTMPY },
+                                                     { Ego::Script::OPADD, true, 4 } });
+    emitFunction(script, 0, Ego::Script::ScriptFunctions::End);
+    parser_state_t::parse_jumps(script);
+    script._program.decode(script._instructions);
+
+    const auto& operation = script._program.instructions[0];
+    ASSERT_EQ(DecodedInstruction::Kind::Operation, operation.kind);
+    ASSERT_EQ(5, operation.initialValue);
+    ASSERT_EQ(2u, operation.numberOfOperands);
+    assertEqual(run(script, false, 0, true), run(script, true, 0, true));
+}
+
+TEST_F(ScriptProgramTest, undecodable_instructions_are_interpreted) {
+    auto script = aRandomScript(32);
+    // An operation whose operands exceed the instruction list.
+    emitOperation(script, 0, Ego::Script::VARTMPX, { { Ego::Script::OPADD, true, 1 } });
+    script._instructions[script._instructions.getNumberOfInstructions() - 2].setBits(2);
+    script._program.decode(script._instructions);
+
+    ASSERT_EQ(script._instructions.getNumberOfInstructions() - 3, getEnd(script._program).position);
+    for (uint32_t seed = 0; seed < 4; ++seed) {
+        assertEqual(run(script, false, seed, true), run(script, true, seed, true));
+    }
+}
+
+TEST_F(ScriptProgramTest, thread_safety_of_programs) {
+    auto decode = [](script_info_t& script) {
+        emitFunction(script, 0, Ego::Script::ScriptFunctions::End);
+        parser_state_t::parse_jumps(script);
+        script._program.decode(script._instructions);
+        return script._program.threadSafe;
+    };
+    // Aliases share the thread-safety of the function they alias.
+    ASSERT_TRUE(Ego::Script::Runtime::get().isThreadSafe(Ego::Script::ScriptFunctions::IfStateIsParry));
+
+    script_info_t safe;
+    emitFunction(safe, 0, Ego::Script::ScriptFunctions::IfStateIs0);
+    emitOperation(safe, 1, Ego::Script::VARTMPX, { { Ego::Script::OPADD, false, Ego::Script::VARSELFX } });
+    ASSERT_TRUE(decode(safe));
+
+    // A function which modifies other objects.
+    script_info_t issuesOrders;
+    emitFunction(issuesOrders, 0, Ego::Script::ScriptFunctions::IfStateIs0);
+    emitFunction(issuesOrders, 1, Ego::Script::ScriptFunctions::IssueOrder);
+    ASSERT_FALSE(decode(issuesOrders));
+
+    // The random number generator is shared.
+    script_info_t random;
+    emitOperation(random, 0, Ego::Script::VARTMPX, { { Ego::Script::OPADD, false, Ego::Script::VARRAND } });
+    ASSERT_FALSE(decode(random));
+
+    // The instruction interpreter is not thread-safe.
+    script_info_t undecodable;
+    emitOperation(undecodable, 0, Ego::Script::VARTMPX, { { Ego::Script::OPADD, true, 1 } });
+    undecodable._instructions[1].setBits(100);
+    ASSERT_FALSE(decode(undecodable));
+}
+
+} } } // namespace Ego::Test::Script
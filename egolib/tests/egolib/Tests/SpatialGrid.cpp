@@ -0,0 +1,210 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include <chrono>
+#include <map>
+
+namespace Ego { namespace Test { namespace SpatialGrid {
+
+class SpatialGridElement {
+public:
+	SpatialGridElement(float x, float y, float size) : _bounds(Point2f(x - size, y - size), Point2f(x + size, y + size)) {
+		//ctor
+	}
+
+	AxisAlignedBox2f& getAxisAlignedBox2D() { return _bounds; }
+
+private:
+	AxisAlignedBox2f _bounds;
+};
+
+static AxisAlignedBox2f anAABFromARect(float centerX, float centerY, float size) {
+	return AxisAlignedBox2f(Point2f(centerX - size, centerY - size), Point2f(centerX + size, centerY + size));
+}
+
+TEST(spatial_grid_testing, test_spatial_grid) {
+    Ego::SpatialGrid<SpatialGridElement> _grid;
+    std::vector<std::shared_ptr<SpatialGridElement>> _testElements;
+
+    //Put a fat element in the middle of the grid, spanning several cells
+    _testElements.push_back(std::make_shared<SpatialGridElement>(128, 128, 40));
+
+    //Put one element in each corner
+    _testElements.push_back(std::make_shared<SpatialGridElement>(0, 0, 5));
+    _testElements.push_back(std::make_shared<SpatialGridElement>(256, 0, 5));
+    _testElements.push_back(std::make_shared<SpatialGridElement>(0, 256, 5));
+    _testElements.push_back(std::make_shared<SpatialGridElement>(256, 256, 5));
+
+    _grid.reset(0, 0, 256, 256, 32);
+    for (size_t i = 0; i < _testElements.size(); ++i) {
+        _grid.update(i, _testElements[i]);
+    }
+    ASSERT_EQ(_grid.size(), _testElements.size());
+
+    std::vector<std::shared_ptr<SpatialGridElement>> findResults;
+
+    //Searching outside the grid should produce no results
+    _grid.find(anAABFromARect(-50, -50, 20), findResults);
+    ASSERT_TRUE(findResults.empty());
+
+    //Searching around each corner should find one element
+    _grid.find(anAABFromARect(0, 0, 50), findResults);
+    ASSERT_EQ(findResults.size(), 1);
+    findResults.clear();
+
+    _grid.find(anAABFromARect(256, 256, 50), findResults);
+    ASSERT_EQ(findResults.size(), 1);
+    findResults.clear();
+
+    //The fat element is linked into several cells but must be found exactly once
+    _grid.find(anAABFromARect(128, 128, 50), findResults);
+    ASSERT_EQ(findResults.size(), 1);
+    findResults.clear();
+
+    //Searching whole grid should find all elements
+    _grid.find(anAABFromARect(128, 128, 128), findResults);
+    ASSERT_EQ(findResults.size(), _testElements.size());
+    findResults.clear();
+
+    //Now move all elements in bottom right corner and update them incrementally
+    for (size_t i = 0; i < _testElements.size(); ++i) {
+        float x = Random::next(128, 246);
+        float y = Random::next(128, 246);
+        _testElements[i]->getAxisAlignedBox2D() = AxisAlignedBox2f(Point2f(x, y), Point2f(x + 10, y + 10));
+        _grid.update(i, _testElements[i]);
+    }
+    ASSERT_EQ(_grid.size(), _testElements.size());
+
+    //All elements should be found in bottom right now
+    _grid.find(AxisAlignedBox2f(Point2f(128, 128), Point2f(256, 256)), findResults);
+    ASSERT_EQ(findResults.size(), _testElements.size());
+    findResults.clear();
+
+    //If we look top half, we should find nothing now
+    _grid.find(AxisAlignedBox2f(Point2f(0, 0), Point2f(256, 127)), findResults);
+    ASSERT_TRUE(findResults.empty());
+
+    //Removed elements should not be found anymore
+    ASSERT_TRUE(_grid.remove(0));
+    ASSERT_FALSE(_grid.remove(0));
+    _grid.find(AxisAlignedBox2f(Point2f(128, 128), Point2f(256, 256)), findResults);
+    ASSERT_EQ(findResults.size(), _testElements.size() - 1);
+}
+
+TEST(spatial_grid_testing, removed_slots_are_reused) {
+    Ego::SpatialGrid<SpatialGridElement> grid;
+    grid.reset(0, 0, 256, 256, 32);
+
+    //Sparse ids as handed out by a growing object list
+    std::map<size_t, std::shared_ptr<SpatialGridElement>> elements;
+    for (size_t k = 0; k < 1000; ++k) {
+        const size_t id = Random::next<size_t>(0, 1000000);
+        if (elements.count(id) != 0 || (!elements.empty() && Random::nextBool())) {
+            auto it = elements.lower_bound(id);
+            if (it == elements.end()) it = elements.begin();
+            ASSERT_TRUE(grid.remove(it->first));
+            ASSERT_FALSE(grid.contains(it->first));
+            elements.erase(it);
+        } else {
+            auto element = std::make_shared<SpatialGridElement>(Random::next(0, 256), Random::next(0, 256), 5);
+            grid.update(id, element);
+            ASSERT_TRUE(grid.contains(id));
+            elements[id] = element;
+        }
+        ASSERT_EQ(elements.size(), grid.size());
+    }
+
+    std::vector<std::shared_ptr<SpatialGridElement>> findResults;
+    grid.find(anAABFromARect(128, 128, 128), findResults);
+    ASSERT_EQ(elements.size(), findResults.size());
+    for (const auto& element : elements) {
+        ASSERT_NE(findResults.end(), std::find(findResults.begin(), findResults.end(), element.second));
+    }
+}
+
+static float aRandomFloat(float lower, float upper) {
+    return Random::next(idlib::interval<float>(lower, upper));
+}
+
+static void benchmarkSpatialGrid(const size_t numberOfElements) {
+    static const float worldSize = 8192.0f;
+    static const size_t numberOfQueries = 100;
+
+    Ego::SpatialGrid<SpatialGridElement> grid;
+    std::vector<std::shared_ptr<SpatialGridElement>> elements;
+    for (size_t i = 0; i < numberOfElements; ++i) {
+        elements.push_back(std::make_shared<SpatialGridElement>(aRandomFloat(0.0f, worldSize), aRandomFloat(0.0f, worldSize), aRandomFloat(8.0f, 64.0f)));
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    grid.reset(0, 0, worldSize, worldSize, 128.0f);
+    for (size_t i = 0; i < elements.size(); ++i) {
+        grid.update(i, elements[i]);
+    }
+    auto built = std::chrono::high_resolution_clock::now();
+
+    //Large-radius queries return many elements, each element must be reported exactly once
+    std::vector<AxisAlignedBox2f> searchAreas;
+    for (size_t i = 0; i < numberOfQueries; ++i) {
+        searchAreas.push_back(anAABFromARect(aRandomFloat(0.0f, worldSize), aRandomFloat(0.0f, worldSize), worldSize / 4));
+    }
+    size_t found = 0;
+    std::vector<std::shared_ptr<SpatialGridElement>> result;
+    auto startQueries = std::chrono::high_resolution_clock::now();
+    for (const AxisAlignedBox2f &searchArea : searchAreas) {
+        result.clear();
+        grid.find(searchArea, result);
+        found += result.size();
+    }
+    auto queried = std::chrono::high_resolution_clock::now();
+
+    //Visitor queries do not build a result vector
+    size_t visited = 0;
+    for (const AxisAlignedBox2f &searchArea : searchAreas) {
+        grid.find(searchArea, [&visited](const std::shared_ptr<SpatialGridElement>&) { visited++; });
+    }
+    auto visitedAll = std::chrono::high_resolution_clock::now();
+
+    size_t expected = 0;
+    for (const AxisAlignedBox2f &searchArea : searchAreas) {
+        for (const std::shared_ptr<SpatialGridElement> &element : elements) {
+            if (idlib::is_intersecting(element->getAxisAlignedBox2D(), searchArea)) expected++;
+        }
+    }
+    ASSERT_EQ(expected, found);
+    ASSERT_EQ(expected, visited);
+
+    std::cout << numberOfElements << " elements: "
+              << "build " << std::chrono::duration_cast<std::chrono::microseconds>(built - start).count() << " us, "
+              << numberOfQueries << " queries (" << found << " results) " << std::chrono::duration_cast<std::chrono::microseconds>(queried - startQueries).count() << " us, "
+              << numberOfQueries << " visitor queries (" << visited << " results) " << std::chrono::duration_cast<std::chrono::microseconds>(visitedAll - queried).count() << " us"
+              << std::endl;
+}
+
+TEST(spatial_grid_testing, DISABLED_benchmark_spatial_grid_1k) {
+    benchmarkSpatialGrid(1000);
+}
+
+TEST(spatial_grid_testing, DISABLED_benchmark_spatial_grid_10k) {
+    benchmarkSpatialGrid(10000);
+}
+
+} } } // namespace Ego::Test::SpatialGrid
@@ -0,0 +1,160 @@
+//********************************************************************************************
+//*
+//*    This file is part of Egoboo.
+//*
+//*    Egoboo is free software: you can redistribute it and/or modify it
+//*    under the terms of the GNU General Public License as published by
+//*    the Free Software Foundation, either version 3 of the License, or
+//*    (at your option) any later version.
+//*
+//*    Egoboo is distributed in the hope that it will be useful, but
+//*    WITHOUT ANY WARRANTY; without even the implied warranty of
+//*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//*    General Public License for more details.
+//*
+//*    You should have received a copy of the GNU General Public License
+//*    along with Egoboo.  If not, see <http://www.gnu.org/licenses/>.
+//*
+//********************************************************************************************
+
+#include "gtest/gtest.h"
+#include "egolib/egolib.h"
+#include "egolib/game/mesh.h"
+#include "egolib/Tests/utilities.hpp"
+#include <chrono>
+
+namespace Ego { namespace Test { namespace TileVisibility {
+
+/// Get the frustum of a camera looking down at a point of the mesh as the game camera does.
+static Graphics::Frustum aFrustum(const Vector3f& center, float distance, float aspectRatio) {
+    const Vector3f position = center + Vector3f(0.0f, -distance, distance);
+    const auto projection = Math::Transform::perspective(Math::Degrees(60.0f), aspectRatio,
+                                                         Info<float>::Grid::Size() * 0.25f,
+                                                         Info<float>::Grid::Size() * 256 * idlib::sqrt_two<float>());
+    const auto view = Math::Transform::scaling(Vector3f(-1.0f, 1.0f, 1.0f))
+                    * Math::Transform::lookAt(position, center, Vector3f(0.0f, 0.0f, 1.0f));
+    Graphics::Frustum frustum;
+    frustum.calculate(projection, view);
+    return frustum;
+}
+
+/// A camera moving along a circle around the center of the mesh, zooming in and out.
+static Graphics::Frustum aFrustumOnPath(const ego_mesh_t& mesh, size_t step, size_t numberOfSteps) {
+    const float size = Info<float>::Grid::Size();
+    const float angle = 2.0f * idlib::pi<float>() * step / numberOfSteps;
+    const float radius = 0.25f * size * mesh._info.getTileCountX();
+    const Vector3f center(0.5f * size * mesh._info.getTileCountX() + radius * std::cos(angle),
+                          0.5f * size * mesh._info.getTileCountY() + radius * std::sin(angle),
+                          0.0f);
+    return aFrustum(center, size * (8.0f + 16.0f * (step % 3)), (step % 2) ? 4.0f / 3.0f : 2.0f / 3.0f);
+}
+
+static std::vector<Index1D> allTilesInFrustum(const ego_mesh_t& mesh, const Graphics::Frustum& frustum) {
+    std::vector<Index1D> tiles;
+    for (Index1D i = 0; i < mesh._info.getTileCount(); ++i) {
+        if (frustum.intersects(mesh._chunks.getBounds(mesh._tmem.get(i)), true)) {
+            tiles.push_back(i);
+        }
+    }
+    return tiles;
+}
+
+static std::vector<Index1D> visitTilesInFrustum(const ego_mesh_t& mesh, const Graphics::Frustum& frustum) {
+    std::vector<Index1D> tiles;
+    mesh._chunks.visit(mesh._tmem, frustum, [&tiles](const Index1D& i) { tiles.push_back(i); });
+    return tiles;
+}
+
+TEST(tile_visibility_testing, visit_matches_testing_all_tiles) {
+    for (size_t size : { 1, 7, 8, 9, 61, 64 }) {
+        auto mesh = Utilities::aRandomTerrain(size, size + 3);
+        for (size_t step = 0; step < 12; ++step) {
+            const auto frustum = aFrustumOnPath(*mesh, step, 12);
+            auto expected = allTilesInFrustum(*mesh, frustum),
+                 received = visitTilesInFrustum(*mesh, frustum);
+            std::sort(received.begin(), received.end());
+            ASSERT_EQ(expected, received);
+        }
+    }
+}
+
+TEST(tile_visibility_testing, water_tiles_extend_up_to_the_water_level) {
+    for (size_t size : { 9, 64 }) {
+        auto mesh = Utilities::aRandomTerrain(size, size + 3);
+        for (Index1D i = 0; i < mesh->_info.getTileCount(); ++i) {
+            if (Random::next<int>(0, 3) == 0) {
+                mesh->_tmem.get(i).addFX(MAPFX_WATER);
+            }
+        }
+        // above the highest floor of Utilities::aRandomTerrain()
+        const float waterLevel = 4.0f * Info<float>::Grid::Size();
+        mesh->_chunks.setWaterLevel(waterLevel, mesh->_tmem);
+        for (Index1D i = 0; i < mesh->_info.getTileCount(); ++i) {
+            const ego_tile_info_t& tile = mesh->_tmem.get(i);
+            const float expected = 0 != tile.testFX(MAPFX_WATER) ? waterLevel : tile._oct._maxs[OCT_Z];
+            ASSERT_EQ(expected, mesh->_chunks.getBounds(tile).get_max()[kZ]);
+        }
+        for (size_t step = 0; step < 12; ++step) {
+            const auto frustum = aFrustumOnPath(*mesh, step, 12);
+            auto expected = allTilesInFrustum(*mesh, frustum),
+                 received = visitTilesInFrustum(*mesh, frustum);
+            std::sort(received.begin(), received.end());
+            ASSERT_EQ(expected, received);
+        }
+    }
+}
+
+TEST(tile_visibility_testing, changing_water_fx_updates_the_bounds) {
+    auto mesh = Utilities::aRandomTerrain(33, 17);
+    mesh->_chunks.setWaterLevel(4.0f * Info<float>::Grid::Size(), mesh->_tmem);
+    for (size_t k = 0; k < 64; ++k) {
+        const Index1D i = Random::next<int>(0, static_cast<int>(mesh->_info.getTileCount()) - 1);
+        if (0 != mesh->test_fx(i, MAPFX_WATER)) {
+            mesh->clear_fx(i, MAPFX_WATER);
+        } else {
+            mesh->add_fx(i, MAPFX_WATER);
+        }
+        const auto frustum = aFrustumOnPath(*mesh, k, 64);
+        auto expected = allTilesInFrustum(*mesh, frustum),
+             received = visitTilesInFrustum(*mesh, frustum);
+        std::sort(received.begin(), received.end());
+        ASSERT_EQ(expected, received);
+    }
+}
+
+TEST(tile_visibility_testing, DISABLED_benchmark_camera_path) {
+    auto mesh = Utilities::aRandomTerrain(256, 256);
+    for (Index1D i = 0; i < mesh->_info.getTileCount(); ++i) {
+        if (Random::next<int>(0, 3) == 0) {
+            mesh->_tmem.get(i).addFX(MAPFX_WATER);
+        }
+    }
+    mesh->_chunks.setWaterLevel(4.0f * Info<float>::Grid::Size(), mesh->_tmem);
+    const size_t numberOfSteps = 1000;
+
+    size_t visited = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < numberOfSteps; ++step) {
+        const auto frustum = aFrustumOnPath(*mesh, step, numberOfSteps);
+        mesh->_chunks.visit(mesh->_tmem, frustum, [&visited](const Index1D&) { visited++; });
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    size_t tested = 0;
+    auto startAll = std::chrono::high_resolution_clock::now();
+    for (size_t step = 0; step < numberOfSteps; ++step) {
+        const auto frustum = aFrustumOnPath(*mesh, step, numberOfSteps);
+        tested += allTilesInFrustum(*mesh, frustum).size();
+    }
+    auto endAll = std::chrono::high_resolution_clock::now();
+
+    ASSERT_EQ(tested, visited);
+    std::cout << numberOfSteps << " frames: "
+              << visited << " visible tiles, quadtree "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us, "
+              << "all tiles "
+              << std::chrono::duration_cast<std::chrono::microseconds>(endAll - startAll).count() << " us"
+              << std::endl;
+}
+
+} } } // namespace Ego::Test::TileVisibility
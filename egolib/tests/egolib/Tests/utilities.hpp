@@ -0,0 +1,118 @@
+#pragma once
+
+#include "egolib/egolib.h"
+#include "egolib/game/mesh.h"
+#include "egolib/game/Graphics/MD2Interpolation.hpp"
+#include "gtest/gtest.h"
+#include <cstdlib>
+
+namespace Ego { namespace Test {
+
+/// Random meshes and models for the tests of the game code.
+struct Utilities {
+    /// Get a mesh with randomly placed wall blocks, similar to the rooms and pillars of a module.
+    static std::shared_ptr<ego_mesh_t> aRandomDungeon(const size_t tileCountX, const size_t tileCountY, const size_t numberOfWalls) {
+        auto mesh = std::make_shared<ego_mesh_t>(Ego::MeshInfo(tileCountX, tileCountY));
+        for (size_t i = 0; i < numberOfWalls; ++i) {
+            const int x = Random::next<int>(0, static_cast<int>(tileCountX) - 1),
+                      y = Random::next<int>(0, static_cast<int>(tileCountY) - 1),
+                      w = Random::next<int>(1, 8),
+                      h = Random::next<int>(1, 8);
+            for (int iy = y; iy < std::min<int>(y + h, tileCountY); ++iy) {
+                for (int ix = x; ix < std::min<int>(x + w, tileCountX); ++ix) {
+                    mesh->_tmem.get(Index2D(ix, iy)).setFX(MAPFX_WALL);
+                }
+            }
+        }
+        return mesh;
+    }
+
+    /// Get a random tile of a mesh which is not a wall.
+    static Index2D aRandomFreeTile(const ego_mesh_t& mesh) {
+        while (true) {
+            const Index2D index(Random::next<int>(0, static_cast<int>(mesh.getInfo().getTileCountX()) - 1),
+                                Random::next<int>(0, static_cast<int>(mesh.getInfo().getTileCountY()) - 1));
+            if (!mesh.tile_has_bits(index, MAPFX_WALL)) {
+                return index;
+            }
+        }
+    }
+
+    /// Get a mesh of flat tiles with random elevations of up to three grid sizes.
+    static std::shared_ptr<ego_mesh_t> aRandomTerrain(const size_t tileCountX, const size_t tileCountY) {
+        auto mesh = std::make_shared<ego_mesh_t>(Ego::MeshInfo(tileCountX, tileCountY));
+        const float size = Info<float>::Grid::Size();
+        for (int y = 0; y < (int)tileCountY; ++y) {
+            for (int x = 0; x < (int)tileCountX; ++x) {
+                const float z = (float)Random::next<int>(0, 3) * size;
+                oct_bb_t& oct = mesh->_tmem.get(Index2D(x, y))._oct;
+                oct = oct_bb_t(oct_vec_v2_t(Vector3f(x * size, y * size, z)));
+                oct.join(oct_vec_v2_t(Vector3f((x + 1) * size, (y + 1) * size, z + 1.0f)));
+            }
+        }
+        mesh->_chunks.updateBounds(mesh->_tmem);
+        return mesh;
+    }
+
+    /// Get a keyframe of random vertices.
+    static MD2_Frame aRandomFrame(size_t vertexCount) {
+        MD2_Frame frame;
+        frame.vertexList.resize(vertexCount);
+        for (MD2_Vertex& vertex : frame.vertexList) {
+            vertex.pos = Vector3f(Random::nextFloat() * 256.0f - 128.0f,
+                                  Random::nextFloat() * 256.0f - 128.0f,
+                                  Random::nextFloat() * 256.0f);
+            vertex.normal = Random::next<size_t>(0, MD2Model::normalCount - 1);
+            vertex.nrm = Vector3f(MD2Model::getMD2Normal(vertex.normal, 0),
+                                  MD2Model::getMD2Normal(vertex.normal, 1),
+                                  MD2Model::getMD2Normal(vertex.normal, 2));
+        }
+        frame.arrays.assign(frame.vertexList);
+        return frame;
+    }
+
+    /// Get a model of random keyframes.
+    static std::shared_ptr<MD2Model> aRandomModel(size_t vertexCount, size_t frameCount) {
+        auto model = std::make_shared<MD2Model>();
+        for (size_t i = 0; i < frameCount; ++i) {
+            model->getFrames().push_back(aRandomFrame(vertexCount));
+        }
+        return model;
+    }
+};
+
+/// The modules of the game data, mounted for the benchmarks.
+/// The benchmarks are disabled: run them with <tt>--gtest_also_run_disabled_tests</tt> and the
+/// environment variable <tt>EGOBOO_DATA</tt> set to the game data directory (the one containing "modules").
+struct GameDataModules {
+    /// The pathnames of the modules in vfs-specific notation e.g. "mp_modules/adventurer.mod".
+    std::vector<std::string> modules;
+
+    GameDataModules() : _mounted(false) {
+        const char *data = std::getenv("EGOBOO_DATA");
+        if (!data) {
+            return;
+        }
+        vfs_init(nullptr, nullptr);
+        _mounted = 0 < vfs_add_mount_point(data, Ego::FsPath("modules"), Ego::VfsPath("mp_modules"), 1);
+        if (!_mounted) {
+            return;
+        }
+        SearchContext ctxt(Ego::VfsPath("mp_modules"), Ego::Extension("mod"), VFS_SEARCH_DIR);
+        while (ctxt.hasData()) {
+            modules.push_back(ctxt.getData().string());
+            ctxt.nextData();
+        }
+    }
+
+    ~GameDataModules() {
+        if (_mounted) {
+            vfs_remove_mount_point(Ego::VfsPath("mp_modules"));
+        }
+    }
+
+private:
+    bool _mounted;
+};
+
+} } // namespace Ego::Test